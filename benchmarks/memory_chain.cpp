@@ -0,0 +1,81 @@
+#include "memory_chain.h"
+#include <algorithm>
+#include <new>
+#include <numeric>
+#include <random>
+#include <sys/mman.h>
+#include <vector>
+
+using namespace perf::suite;
+
+MemoryChain::MemoryChain(const std::size_t working_set_size,
+                         const std::size_t stride,
+                         const bool is_random,
+                         const bool is_huge_pages)
+{
+  constexpr auto page_size = std::size_t{ 4096U };
+  constexpr auto huge_page_size = std::size_t{ 2U * 1024U * 1024U };
+
+  const auto line_stride = std::max(stride / sizeof(cache_line), std::size_t{ 1U }) * sizeof(cache_line);
+  this->_count_lines = std::max(working_set_size / line_stride, std::size_t{ 1U });
+
+  /// Map the memory directly, such that the page size can be controlled.
+  this->_memory_size = ((this->_count_lines * line_stride + huge_page_size - 1U) / huge_page_size) * huge_page_size;
+  auto* memory = ::mmap(nullptr, this->_memory_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (memory == MAP_FAILED) {
+    throw std::bad_alloc{};
+  }
+  ::madvise(memory, this->_memory_size, is_huge_pages ? MADV_HUGEPAGE : MADV_NOHUGEPAGE);
+  this->_memory = static_cast<std::byte*>(memory);
+
+  /// Place the cache lines; lines of page-spanning strides are shifted within their page to use different cache sets.
+  const auto offset_slots = line_stride >= page_size ? page_size / sizeof(cache_line) : 1U;
+  auto lines = std::vector<cache_line*>(this->_count_lines);
+  for (auto index = 0U; index < this->_count_lines; ++index) {
+    const auto offset = (index % offset_slots) * sizeof(cache_line);
+    lines[index] = new (this->_memory + index * line_stride + offset) cache_line{ nullptr };
+  }
+
+  /// Chain all lines in a single cycle, visiting the lines in ascending or random order.
+  auto order = std::vector<std::size_t>(this->_count_lines);
+  std::iota(order.begin(), order.end(), 0U);
+  if (is_random) {
+    std::shuffle(order.begin(), order.end(), std::mt19937_64{ std::random_device{}() });
+  }
+
+  for (auto index = 0U; index < this->_count_lines; ++index) {
+    lines[order[index]]->next = lines[order[(index + 1U) % this->_count_lines]];
+  }
+  this->_head = lines[order.front()];
+}
+
+MemoryChain::~MemoryChain()
+{
+  if (this->_memory != nullptr) {
+    ::munmap(this->_memory, this->_memory_size);
+  }
+}
+
+const MemoryChain::cache_line*
+MemoryChain::chase(const std::uint64_t count_loads) const noexcept
+{
+  const auto* line = this->_head;
+
+  /// Unroll by eight to keep the loop overhead low compared to the loads.
+  for (auto i = 0ULL; i < count_loads / 8U; ++i) {
+    line = line->next;
+    line = line->next;
+    line = line->next;
+    line = line->next;
+    line = line->next;
+    line = line->next;
+    line = line->next;
+    line = line->next;
+  }
+
+  for (auto i = 0ULL; i < count_loads % 8U; ++i) {
+    line = line->next;
+  }
+
+  return line;
+}
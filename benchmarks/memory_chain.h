@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace perf::suite {
+/**
+ * Chain of cache lines within a working set, where every cache line points to the next one.
+ * Following the chain issues dependent loads (pointer chasing), exposing the latency of the memory level that holds
+ * the working set.
+ */
+class MemoryChain
+{
+public:
+  /**
+   * Object sized of one cache line, pointing to the next cache line of the chain.
+   */
+  struct alignas(64U) cache_line
+  {
+    const cache_line* next;
+  };
+
+  /**
+   * Creates the chain.
+   *
+   * @param working_set_size Size of the memory holding the chain in bytes.
+   * @param stride Distance between two cache lines of the chain in bytes (a multiple of the cache line size); cache
+   * lines of strides spanning at least a page are placed at different offsets within their pages to spread them
+   * across cache sets.
+   * @param is_random True, if the cache lines are chained in random order, false for ascending order.
+   * @param is_huge_pages True, if the memory should be backed by transparent huge pages; false avoids huge pages
+   * (e.g., to measure the TLB).
+   */
+  MemoryChain(std::size_t working_set_size, std::size_t stride, bool is_random, bool is_huge_pages);
+
+  ~MemoryChain();
+
+  MemoryChain(const MemoryChain&) = delete;
+  MemoryChain& operator=(const MemoryChain&) = delete;
+
+  /**
+   * @return Number of cache lines in the chain.
+   */
+  [[nodiscard]] std::size_t size() const noexcept { return _count_lines; }
+
+  /**
+   * Follows the chain for the given number of loads.
+   *
+   * @param count_loads Number of dependent loads.
+   * @return The last loaded cache line, which should be used to avoid that the compiler optimizes away the loads.
+   */
+  [[nodiscard]] const cache_line* chase(std::uint64_t count_loads) const noexcept;
+
+private:
+  std::byte* _memory{ nullptr };
+  std::size_t _memory_size;
+  std::size_t _count_lines;
+  const cache_line* _head{ nullptr };
+};
+}
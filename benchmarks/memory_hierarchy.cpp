@@ -0,0 +1,409 @@
+#include "memory_chain.h"
+#include "suite.h"
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <perfcpp/benchmark.h>
+#include <perfcpp/event_counter.h>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+/**
+ * Probes the memory hierarchy of the machine by following chains of dependent loads (pointer chasing):
+ *  - working-set sweep: random chain over growing working sets, on a single thread and concurrently on multiple
+ *    threads (every thread chasing its private working set),
+ *  - stride sweep: ascending chain with growing strides over the largest working set, and
+ *  - TLB sweep: random chain over one cache line per (4 KB) page for a growing number of pages.
+ * Every point records the latency per load and the misses per load of the L1 data cache, the last-level cache
+ * (cache-misses), and the data TLB, if the counters are available.
+ * From the sweeps, the suite estimates the size and latency of every cache level and the reach of the data TLB;
+ * the cache hierarchy reported by the kernel is written for comparison.
+ *
+ * Every measurement and estimate is written as one line of JSON (to the output file or to stdout); progress and a
+ * summary of the estimates are printed to stderr.
+ *
+ * Usage: memory-hierarchy-benchmark [max working set in MB, default 256] [repetitions, default 5] [output file]
+ */
+
+static constexpr auto SUITE = std::string_view{ "memory-hierarchy" };
+
+/// Number of dependent loads of a single run.
+static constexpr auto COUNT_LOADS = std::uint64_t{ 1U } << 21U;
+
+static constexpr auto CACHE_LINE_SIZE = std::size_t{ 64U };
+static constexpr auto PAGE_SIZE = std::size_t{ 4096U };
+
+/**
+ * Measured point of a sweep.
+ */
+struct point
+{
+  std::size_t working_set_size;
+  double latency;
+  std::optional<double> cycles;
+  std::optional<double> dtlb_misses;
+};
+
+/**
+ * Estimated level of a sweep, i.e., a plateau of similar latencies.
+ */
+struct level
+{
+  /// Largest working set of the plateau.
+  std::size_t working_set_size;
+  double latency;
+  std::optional<double> cycles;
+};
+
+/**
+ * @return Working-set sizes between min and max, growing by factors of 1.5 and 2 alternately.
+ */
+static std::vector<std::size_t>
+working_set_sizes(const std::size_t min_size, const std::size_t max_size)
+{
+  auto sizes = std::vector<std::size_t>{};
+  for (auto size = min_size; size <= max_size; size *= 2U) {
+    sizes.push_back(size);
+    if (size + size / 2U <= max_size) {
+      sizes.push_back(size + size / 2U);
+    }
+  }
+
+  return sizes;
+}
+
+/**
+ * Runs the chain through the benchmark harness and writes the point.
+ */
+static point
+measure(std::ostream& output,
+        perf::Benchmark& benchmark,
+        const perf::suite::MemoryChain& chain,
+        const std::string_view sweep,
+        const std::size_t working_set_size,
+        const std::size_t stride,
+        const std::string_view order)
+{
+  const auto result = benchmark.run(
+    [&chain]() {
+      const auto* line = chain.chase(COUNT_LOADS);
+      asm volatile("" : : "r"(line) : "memory");
+    },
+    COUNT_LOADS);
+
+  output << perf::suite::ResultLine{ SUITE, sweep }
+              .add("threads", std::uint64_t{ 1U })
+              .add("working_set_bytes", std::uint64_t{ working_set_size })
+              .add("stride_bytes", std::uint64_t{ stride })
+              .add("order", order)
+              .add("latency_ns", result.time())
+              .add("counters", result.median())
+              .str()
+         << std::endl;
+
+  const auto cycles = result.get("cycles");
+  const auto dtlb_misses = result.get("dTLB-load-misses");
+  return point{ working_set_size,
+                result.time().median(),
+                cycles.has_value() ? std::make_optional(cycles->median()) : std::nullopt,
+                dtlb_misses.has_value() ? std::make_optional(dtlb_misses->median()) : std::nullopt };
+}
+
+/**
+ * Chases private working sets on multiple (pinned) threads concurrently.
+ */
+static void
+sweep_threads(std::ostream& output,
+              const perf::CounterDefinition& counter_definitions,
+              const std::vector<std::string>& counters,
+              const std::vector<std::size_t>& sizes,
+              const std::size_t max_working_set_size)
+{
+  const auto count_cpus = std::max(std::thread::hardware_concurrency(), 1U);
+
+  for (auto count_threads = 2U; count_threads <= count_cpus; count_threads *= 2U) {
+    for (const auto size : sizes) {
+      /// The threads hold private working sets; limit the memory of all threads.
+      if (size * count_threads > max_working_set_size) {
+        break;
+      }
+      std::cerr << "working-set: " << count_threads << " threads, " << size / 1024U << " KB" << std::endl;
+
+      auto event_counter = perf::MultiThreadEventCounter{ counter_definitions, std::uint16_t(count_threads) };
+      const auto is_recording = !counters.empty() && event_counter.add(counters);
+
+      auto latencies = std::vector<double>(count_threads, .0);
+      auto exceptions = std::vector<std::exception_ptr>(count_threads);
+      auto barrier = perf::suite::Barrier{ count_threads };
+      auto threads = std::vector<std::thread>{};
+      for (auto thread_id = 0U; thread_id < count_threads; ++thread_id) {
+        threads.emplace_back([&, thread_id]() {
+          perf::suite::pin_thread(std::uint16_t(thread_id % count_cpus));
+
+          /// Every thread allocates its chain, such that the memory is local to its CPU; failures are passed to the
+          /// main thread after all threads passed the barrier.
+          auto chain = std::optional<perf::suite::MemoryChain>{};
+          try {
+            chain.emplace(size, CACHE_LINE_SIZE, true, true);
+
+            /// Warm up.
+            const auto* line = chain->chase(COUNT_LOADS);
+            asm volatile("" : : "r"(line) : "memory");
+          } catch (...) {
+            exceptions[thread_id] = std::current_exception();
+          }
+
+          /// Wait for all threads, such that the chains are chased concurrently.
+          barrier.wait();
+          if (!chain.has_value()) {
+            return;
+          }
+
+          if (is_recording) {
+            event_counter.start(std::uint16_t(thread_id));
+          }
+          latencies[thread_id] = perf::suite::measure_ns([&chain]() {
+                                   const auto* chased_line = chain->chase(COUNT_LOADS);
+                                   asm volatile("" : : "r"(chased_line) : "memory");
+                                 }) /
+                                 double(COUNT_LOADS);
+          if (is_recording) {
+            event_counter.stop(std::uint16_t(thread_id));
+          }
+        });
+      }
+
+      for (auto& thread : threads) {
+        thread.join();
+      }
+      for (const auto& exception : exceptions) {
+        if (exception != nullptr) {
+          std::rethrow_exception(exception);
+        }
+      }
+
+      auto line = perf::suite::ResultLine{ SUITE, "working-set" };
+      line.add("threads", std::uint64_t{ count_threads })
+        .add("working_set_bytes", std::uint64_t{ size })
+        .add("stride_bytes", std::uint64_t{ CACHE_LINE_SIZE })
+        .add("order", "random")
+        .add("latency_ns", perf::Statistics{ std::move(latencies) });
+      if (is_recording) {
+        line.add("counters", event_counter.result(COUNT_LOADS * count_threads));
+      }
+      output << line.str() << std::endl;
+    }
+  }
+}
+
+/**
+ * Splits the points of a sweep into plateaus of similar latency: a new plateau starts when the latency exceeds the
+ * median of the current plateau by 30%; the points of the following ramp (latency growing by more than 10% per point)
+ * belong to neither plateau.
+ */
+static std::vector<level>
+estimate_levels(const std::vector<point>& points)
+{
+  constexpr auto transition_factor = 1.3;
+  constexpr auto ramp_factor = 1.1;
+
+  const auto median = [&points](const std::size_t begin, const std::size_t end, auto&& get) {
+    auto values = std::vector<double>{};
+    for (auto index = begin; index < end; ++index) {
+      if (const auto value = get(points[index]); value.has_value()) {
+        values.push_back(value.value());
+      }
+    }
+
+    return values.empty() ? std::nullopt : std::make_optional(perf::Statistics{ std::move(values) }.median());
+  };
+
+  auto levels = std::vector<level>{};
+  auto plateau_begin = std::size_t{ 0U };
+  for (auto index = std::size_t{ 1U }; index <= points.size(); ++index) {
+    const auto latency =
+      median(plateau_begin, index, [](const point& point) { return std::make_optional(point.latency); }).value();
+    if (index < points.size() && points[index].latency <= latency * transition_factor) {
+      continue;
+    }
+
+    levels.push_back(level{ points[index - 1U].working_set_size,
+                            latency,
+                            median(plateau_begin, index, [](const point& point) { return point.cycles; }) });
+
+    while (index + 1U < points.size() && points[index + 1U].latency > points[index].latency * ramp_factor) {
+      ++index;
+    }
+    plateau_begin = index;
+  }
+
+  return levels;
+}
+
+/**
+ * Writes the cache hierarchy the kernel reports for the first CPU.
+ */
+static void
+write_cache_topology(std::ostream& output)
+{
+  for (auto index = 0U;; ++index) {
+    const auto path = "/sys/devices/system/cpu/cpu0/cache/index" + std::to_string(index) + "/";
+    auto level_file = std::ifstream{ path + "level" };
+    auto type_file = std::ifstream{ path + "type" };
+    auto size_file = std::ifstream{ path + "size" };
+    if (!level_file.is_open() || !type_file.is_open() || !size_file.is_open()) {
+      return;
+    }
+
+    auto cache_level = std::uint64_t{ 0U };
+    auto type = std::string{};
+    auto size = std::uint64_t{ 0U };
+    auto unit = char{ 'K' };
+    level_file >> cache_level;
+    type_file >> type;
+    size_file >> size >> unit;
+    size *= unit == 'M' ? 1024U * 1024U : (unit == 'K' ? 1024U : 1U);
+
+    output << perf::suite::ResultLine{ SUITE, "cache-topology" }
+                .add("level", cache_level)
+                .add("type", type)
+                .add("size_bytes", size)
+                .str()
+           << std::endl;
+  }
+}
+
+int
+main(int argc, char** argv)
+{
+  const auto max_working_set_size = std::size_t{ argc > 1 ? std::stoull(argv[1]) : 256U } * 1024U * 1024U;
+  const auto repetitions = std::uint32_t(argc > 2 ? std::stoul(argv[2]) : 5U);
+
+  auto output_file = std::ofstream{};
+  if (argc > 3) {
+    output_file.open(argv[3]);
+    if (!output_file.is_open()) {
+      std::cerr << "Could not open '" << argv[3] << "'." << std::endl;
+      return 1;
+    }
+  }
+  auto& output = argc > 3 ? static_cast<std::ostream&>(output_file) : std::cout;
+
+  /// The perf::CounterDefinition holds all counter names and must be alive until the benchmarks finish.
+  const auto counter_definitions = perf::CounterDefinition{};
+
+  /// Record the counters that are available; the latency is measured in any case.
+  const auto counters = perf::suite::supported_counters(
+    counter_definitions, { "cycles", "L1-dcache-load-misses", "cache-misses", "dTLB-load-misses" });
+  if (counters.empty()) {
+    std::cerr << "No hardware counters available, measuring latencies only." << std::endl;
+  }
+
+  auto benchmark = perf::Benchmark{ counter_definitions };
+  benchmark.add(counters);
+  benchmark.repetitions(repetitions);
+
+  write_cache_topology(output);
+
+  auto working_set_points = std::vector<point>{};
+  auto tlb_points = std::vector<point>{};
+  try {
+    /// Working-set sweep: random chains over all cache lines, backed by huge pages to hide TLB misses.
+    const auto sizes = working_set_sizes(4U * 1024U, max_working_set_size);
+    for (const auto size : sizes) {
+      std::cerr << "working-set: " << size / 1024U << " KB" << std::endl;
+      const auto chain = perf::suite::MemoryChain{ size, CACHE_LINE_SIZE, true, true };
+      working_set_points.push_back(measure(output, benchmark, chain, "working-set", size, CACHE_LINE_SIZE, "random"));
+    }
+    sweep_threads(output, counter_definitions, counters, sizes, max_working_set_size);
+
+    /// Stride sweep: ascending chains over the largest working set, exposing the hardware prefetchers and page walks.
+    for (auto stride = CACHE_LINE_SIZE; stride <= 4U * PAGE_SIZE; stride *= 2U) {
+      std::cerr << "stride: " << stride << " B" << std::endl;
+      const auto chain = perf::suite::MemoryChain{ max_working_set_size, stride, false, false };
+      measure(output, benchmark, chain, "stride", max_working_set_size, stride, "ascending");
+    }
+
+    /// TLB sweep: one cache line per page in random order, without huge pages.
+    for (const auto size : working_set_sizes(4U * PAGE_SIZE, max_working_set_size)) {
+      std::cerr << "tlb: " << size / PAGE_SIZE << " pages" << std::endl;
+      const auto chain = perf::suite::MemoryChain{ size, PAGE_SIZE, true, false };
+      tlb_points.push_back(measure(output, benchmark, chain, "tlb", size, PAGE_SIZE, "random"));
+    }
+  } catch (std::runtime_error& exception) {
+    std::cerr << exception.what() << std::endl;
+    return 1;
+  } catch (std::bad_alloc&) {
+    std::cerr << "Could not allocate the working set." << std::endl;
+    return 1;
+  }
+
+  /// Estimate the cache levels; the last plateau is the main memory (if the largest working set exceeds the caches).
+  std::cerr << std::fixed << std::setprecision(2) << "\nEstimates:" << std::endl;
+  const auto cache_levels = estimate_levels(working_set_points);
+  for (auto index = 0U; index < cache_levels.size(); ++index) {
+    const auto& cache_level = cache_levels[index];
+    const auto is_memory = index + 1U == cache_levels.size() && cache_levels.size() > 1U;
+    const auto name = is_memory ? std::string{ "memory" } : "L" + std::to_string(index + 1U);
+
+    auto line = perf::suite::ResultLine{ SUITE, "estimate" };
+    line.add("kind", "cache").add("level", name).add("latency_ns", cache_level.latency);
+    if (!is_memory) {
+      line.add("size_bytes", std::uint64_t{ cache_level.working_set_size });
+    }
+    if (cache_level.cycles.has_value()) {
+      line.add("latency_cycles", cache_level.cycles.value());
+    }
+    output << line.str() << std::endl;
+
+    std::cerr << std::setw(8) << name << std::setw(12)
+              << (is_memory ? std::string{ "-" } : std::to_string(cache_level.working_set_size / 1024U) + " KB")
+              << std::setw(12) << cache_level.latency << " ns" << std::endl;
+  }
+
+  /// The first latency step of the TLB sweep marks the reach of the first-level data TLB.
+  if (const auto tlb_levels = estimate_levels(tlb_points); tlb_levels.size() > 1U) {
+    const auto entries = tlb_levels.front().working_set_size / PAGE_SIZE;
+    output << perf::suite::ResultLine{ SUITE, "estimate" }
+                .add("kind", "tlb")
+                .add("level", "dTLB")
+                .add("method", "latency")
+                .add("entries", std::uint64_t{ entries })
+                .add("reach_bytes", std::uint64_t{ entries * PAGE_SIZE })
+                .str()
+           << std::endl;
+    std::cerr << std::setw(8) << "dTLB" << std::setw(12) << entries << " entries (latency)" << std::endl;
+  }
+
+  /// With the dTLB-load-misses counter, the last-level TLB covers all pages as long as less than half of the loads
+  /// miss.
+  auto last_level_entries = std::optional<std::size_t>{};
+  for (const auto& tlb_point : tlb_points) {
+    if (!tlb_point.dtlb_misses.has_value() || tlb_point.dtlb_misses.value() >= .5) {
+      break;
+    }
+    last_level_entries = tlb_point.working_set_size / PAGE_SIZE;
+  }
+  if (last_level_entries.has_value()) {
+    output << perf::suite::ResultLine{ SUITE, "estimate" }
+                .add("kind", "tlb")
+                .add("level", "last-level TLB")
+                .add("method", "dTLB-load-misses")
+                .add("entries", std::uint64_t{ last_level_entries.value() })
+                .add("reach_bytes", std::uint64_t{ last_level_entries.value() * PAGE_SIZE })
+                .str()
+           << std::endl;
+    std::cerr << std::setw(8) << "TLB" << std::setw(12) << last_level_entries.value() << " entries (counter)"
+              << std::endl;
+  }
+
+  return 0;
+}
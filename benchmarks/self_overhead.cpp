@@ -0,0 +1,315 @@
+#include "../examples/access_benchmark.h"
+#include "suite.h"
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <perfcpp/benchmark.h>
+#include <perfcpp/event_counter.h>
+#include <perfcpp/sampler.h>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * Measures the overhead of perf-cpp itself, such that regressions in the hot paths of the library become visible:
+ *  - latency of EventCounter::start(), live_result(), stop(), and result() for 1 to N groups,
+ *  - latency of aggregating the results of MultiThreadEventCounter for up to 256 threads,
+ *  - throughput of decoding samples (Sampler::result() and for_each_sample()) for different sample types, and
+ *  - slowdown of AccessBenchmark while sampling at different frequencies.
+ *
+ * Every measurement is written as one line of JSON (to the output file or to stdout); progress is printed to stderr.
+ *
+ * Usage: overhead-benchmark [repetitions, default 100] [output file, default stdout]
+ */
+
+static constexpr auto SUITE = std::string_view{ "self-overhead" };
+
+/**
+ * Runs one pass over the access benchmark.
+ */
+static void
+access(const perf::example::AccessBenchmark& access_benchmark)
+{
+  auto value = 0ULL;
+  for (auto index = 0U; index < access_benchmark.size(); ++index) {
+    value += access_benchmark[index].value;
+  }
+  asm volatile("" : "+r,m"(value) : : "memory");
+}
+
+/**
+ * Measures start(), live_result(), stop(), and result() of the EventCounter with one counter per group.
+ */
+static void
+benchmark_event_counter(std::ostream& output,
+                        const perf::CounterDefinition& counter_definitions,
+                        const std::vector<std::string>& counters,
+                        const std::uint32_t repetitions)
+{
+  for (auto count_groups = 1U; count_groups <= counters.size(); ++count_groups) {
+    std::cerr << "event-counter: " << count_groups << " groups" << std::endl;
+
+    auto config = perf::Config{};
+    config.max_counters_per_group(1U);
+    config.max_groups(std::uint8_t(count_groups));
+
+    auto event_counter = perf::EventCounter{ counter_definitions, config };
+    if (!event_counter.add(std::vector<std::string>{ counters.begin(), counters.begin() + count_groups })) {
+      continue;
+    }
+
+    auto start_times = std::vector<double>{};
+    auto live_result_times = std::vector<double>{};
+    auto stop_times = std::vector<double>{};
+    auto result_times = std::vector<double>{};
+    auto result = perf::CounterResult{};
+
+    for (auto repetition = 0U; repetition < repetitions; ++repetition) {
+      start_times.push_back(perf::suite::measure_ns([&event_counter]() { event_counter.start(); }));
+      live_result_times.push_back(
+        perf::suite::measure_ns([&event_counter, &result]() { result = event_counter.live_result(); }));
+      stop_times.push_back(perf::suite::measure_ns([&event_counter]() { event_counter.stop(); }));
+      result_times.push_back(perf::suite::measure_ns([&event_counter, &result]() { result = event_counter.result(); }));
+    }
+
+    output << perf::suite::ResultLine{ SUITE, "event-counter" }
+                .add("groups", std::uint64_t{ count_groups })
+                .add("start_ns", perf::Statistics{ std::move(start_times) })
+                .add("live_result_ns", perf::Statistics{ std::move(live_result_times) })
+                .add("stop_ns", perf::Statistics{ std::move(stop_times) })
+                .add("result_ns", perf::Statistics{ std::move(result_times) })
+                .str()
+           << std::endl;
+  }
+}
+
+/**
+ * Measures the aggregation of the results of all threads of a MultiThreadEventCounter.
+ */
+static void
+benchmark_multi_thread_event_counter(std::ostream& output,
+                                     const perf::CounterDefinition& counter_definitions,
+                                     const std::vector<std::string>& counters,
+                                     const std::uint32_t repetitions)
+{
+  const auto count_counters = std::min(counters.size(), std::size_t{ perf::Config{}.max_counters_per_group() });
+
+  for (auto count_threads = 1U; count_threads <= 256U; count_threads *= 2U) {
+    std::cerr << "multi-thread-event-counter: " << count_threads << " threads" << std::endl;
+
+    auto event_counter = perf::MultiThreadEventCounter{ counter_definitions, std::uint16_t(count_threads) };
+    if (!event_counter.add(std::vector<std::string>{ counters.begin(), counters.begin() + count_counters })) {
+      continue;
+    }
+
+    /// Record every thread-local counter once (on this thread) such that every thread holds values.
+    for (auto thread_id = 0U; thread_id < count_threads; ++thread_id) {
+      event_counter.start(std::uint16_t(thread_id));
+      event_counter.stop(std::uint16_t(thread_id));
+    }
+
+    auto result_times = std::vector<double>{};
+    auto result = perf::CounterResult{};
+    for (auto repetition = 0U; repetition < repetitions; ++repetition) {
+      result_times.push_back(perf::suite::measure_ns([&event_counter, &result]() { result = event_counter.result(); }));
+    }
+
+    const auto result_statistics = perf::Statistics{ std::move(result_times) };
+    output << perf::suite::ResultLine{ SUITE, "multi-thread-event-counter" }
+                .add("threads", std::uint64_t{ count_threads })
+                .add("counters", std::uint64_t{ count_counters })
+                .add("result_ns", result_statistics)
+                .add("result_per_thread_ns", result_statistics.median() / double(count_threads))
+                .str()
+           << std::endl;
+  }
+}
+
+/**
+ * Measures decoding the samples of different sample types recorded during the access benchmark.
+ */
+static void
+benchmark_sampler_decode(std::ostream& output,
+                         const perf::CounterDefinition& counter_definitions,
+                         const std::vector<std::string>& counters,
+                         const std::uint32_t repetitions)
+{
+  using Type = perf::Sampler::Type;
+
+  const auto sample_types = std::vector<std::pair<std::string_view, std::uint64_t>>{
+    { "ip", Type::InstructionPointer },
+    { "ip,tid,time", Type::InstructionPointer | Type::ThreadId | Type::Time },
+    { "ip,tid,time,cpu,period", Type::InstructionPointer | Type::ThreadId | Type::Time | Type::CPU | Type::Period },
+    { "ip,callchain", Type::InstructionPointer | Type::Callchain },
+    { "ip,user-registers", Type::InstructionPointer | Type::UserRegisters },
+    { "ip,counter-values", Type::InstructionPointer | Type::CounterValues },
+    { "ip,addr,data-src,weight", Type::InstructionPointer | Type::LogicalMemAddress | Type::DataSource | Type::Weight },
+    { "ip,branch-stack", Type::InstructionPointer | Type::BranchStack },
+    { "all",
+      Type::InstructionPointer | Type::ThreadId | Type::Time | Type::CPU | Type::Period | Type::Callchain |
+        Type::UserRegisters | Type::CounterValues | Type::LogicalMemAddress | Type::DataSource | Type::Weight }
+  };
+
+  /// Sample the first supported counter; additional counters are recorded for counter values.
+  const auto is_cycles = counters.front() == "instructions" || counters.front() == "cycles";
+  auto config = perf::SampleConfig{};
+  config.period(is_cycles ? 50000U : 10000U);
+  config.user_registers(perf::Registers{ 0xFFU });
+
+  const auto access_benchmark = perf::example::AccessBenchmark{ true, 64U };
+
+  for (const auto& [sample_type_name, sample_type] : sample_types) {
+    std::cerr << "sampler-decode: " << sample_type_name << std::endl;
+
+    auto sampled_counters = std::vector<std::string>{ counters.front() };
+    if ((sample_type & Type::CounterValues) && counters.size() > 1U) {
+      sampled_counters.push_back(counters[1U]);
+    }
+
+    auto line = perf::suite::ResultLine{ SUITE, "sampler-decode" };
+    line.add("sample_type", sample_type_name).add("counter", counters.front());
+
+    auto sampler = perf::Sampler{ counter_definitions, std::move(sampled_counters), sample_type, config };
+    if (!sampler.start()) {
+      output << line.add("error", std::uint64_t(sampler.last_error())).str() << std::endl;
+      continue;
+    }
+    for (auto pass = 0U; pass < 10U; ++pass) {
+      access(access_benchmark);
+    }
+    sampler.stop();
+
+    const auto count_samples = sampler.result().size();
+    const auto count_bytes = sampler.count_buffered_bytes();
+
+    auto result_times = std::vector<double>{};
+    auto for_each_sample_times = std::vector<double>{};
+    auto count_results = 0ULL;
+    for (auto repetition = 0U; repetition < repetitions; ++repetition) {
+      result_times.push_back(
+        perf::suite::measure_ns([&sampler, &count_results]() { count_results += sampler.result().size(); }));
+      for_each_sample_times.push_back(perf::suite::measure_ns([&sampler, &count_results]() {
+        sampler.for_each_sample(
+          [&count_results](perf::Sample&& sample) { count_results += sample.time().value_or(1U); });
+      }));
+    }
+    asm volatile("" : "+r,m"(count_results) : : "memory");
+    sampler.close();
+
+    const auto result_statistics = perf::Statistics{ std::move(result_times) };
+    const auto result_seconds = result_statistics.median() / 1e9;
+    output << line.add("samples", std::uint64_t{ count_samples })
+                .add("bytes", count_bytes)
+                .add("result_ns", result_statistics)
+                .add("for_each_sample_ns", perf::Statistics{ std::move(for_each_sample_times) })
+                .add("samples_per_second", double(count_samples) / result_seconds)
+                .add("bytes_per_second", double(count_bytes) / result_seconds)
+                .str()
+           << std::endl;
+  }
+}
+
+/**
+ * Measures the slowdown of the access benchmark while sampling at different frequencies.
+ */
+static void
+benchmark_sampling_overhead(std::ostream& output,
+                            const perf::CounterDefinition& counter_definitions,
+                            const std::vector<std::string>& counters,
+                            const std::uint32_t repetitions)
+{
+  const auto access_benchmark = perf::example::AccessBenchmark{ true, 128U };
+  access(access_benchmark);
+
+  auto baseline = .0;
+  for (const auto frequency : { 0U, 100U, 1000U, 10000U, 25000U }) {
+    std::cerr << "sampling-overhead: " << frequency << " Hz" << std::endl;
+
+    auto line = perf::suite::ResultLine{ SUITE, "sampling-overhead" };
+    line.add("frequency", std::uint64_t{ frequency }).add("counter", counters.front());
+
+    auto config = perf::SampleConfig{};
+    config.frequency(frequency);
+    config.buffer_pages(1024U + 1U);
+
+    auto times = std::vector<double>{};
+    auto count_samples = std::vector<double>{};
+    auto error = std::int64_t{ 0 };
+    for (auto repetition = 0U; repetition < repetitions && error == 0; ++repetition) {
+      if (frequency == 0U) {
+        times.push_back(perf::suite::measure_ns([&access_benchmark]() { access(access_benchmark); }));
+        continue;
+      }
+
+      /// The sampler opens its buffer on start(), every repetition uses a new sampler.
+      auto sampler = perf::Sampler{ counter_definitions,
+                                    counters.front(),
+                                    perf::Sampler::Type::InstructionPointer | perf::Sampler::Type::ThreadId |
+                                      perf::Sampler::Type::Time,
+                                    config };
+      if (!sampler.start()) {
+        error = sampler.last_error();
+        break;
+      }
+      times.push_back(perf::suite::measure_ns([&access_benchmark]() { access(access_benchmark); }));
+      sampler.stop();
+      count_samples.push_back(double(sampler.result().size()));
+      sampler.close();
+    }
+
+    if (error != 0) {
+      output << line.add("error", std::uint64_t(error)).str() << std::endl;
+      continue;
+    }
+
+    const auto time_statistics = perf::Statistics{ std::move(times) };
+    if (frequency == 0U) {
+      baseline = time_statistics.median();
+    }
+
+    output << line.add("time_ns", time_statistics)
+                .add("samples", perf::Statistics{ std::move(count_samples) })
+                .add("overhead", time_statistics.median() / baseline - 1.)
+                .str()
+           << std::endl;
+  }
+}
+
+int
+main(int argc, char** argv)
+{
+  const auto repetitions = std::uint32_t(argc > 1 ? std::stoul(argv[1]) : 100U);
+
+  auto output_file = std::ofstream{};
+  if (argc > 2) {
+    output_file.open(argv[2]);
+    if (!output_file.is_open()) {
+      std::cerr << "Could not open '" << argv[2] << "'." << std::endl;
+      return 1;
+    }
+  }
+  auto& output = argc > 2 ? static_cast<std::ostream&>(output_file) : std::cout;
+
+  /// The perf::CounterDefinition holds all counter names and must be alive until the benchmarks finish.
+  const auto counter_definitions = perf::CounterDefinition{};
+
+  /// Hardware counters first, software counters otherwise.
+  const auto counters = perf::suite::supported_counters(
+    counter_definitions,
+    { "instructions", "cycles", "branches", "branch-misses", "cache-misses", "cache-references", "L1-dcache-loads",
+      "task-clock", "cpu-clock", "page-faults", "context-switches", "cpu-migrations" },
+    perf::Group::MAX_MEMBERS);
+  if (counters.empty()) {
+    std::cerr << "No performance counter can be recorded on this machine." << std::endl;
+    return 1;
+  }
+
+  benchmark_event_counter(output, counter_definitions, counters, repetitions);
+  benchmark_multi_thread_event_counter(output, counter_definitions, counters, repetitions);
+  benchmark_sampler_decode(output, counter_definitions, counters, repetitions);
+  benchmark_sampling_overhead(output, counter_definitions, counters, repetitions);
+
+  return 0;
+}
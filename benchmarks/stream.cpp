@@ -0,0 +1,382 @@
+#include "suite.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <optional>
+#include <perfcpp/benchmark.h>
+#include <perfcpp/event_counter.h>
+#include <perfcpp/numa_analyzer.h>
+#include <sched.h>
+#include <string>
+#include <string_view>
+#include <sys/mman.h>
+#include <thread>
+#include <vector>
+
+/**
+ * Measures the sustainable memory bandwidth like STREAM (https://www.cs.virginia.edu/stream/) with the kernels copy,
+ * scale, add, and triad, plus read-only and write-only kernels.
+ * The kernels run on one pinned thread per CPU, for every NUMA node and (with multiple nodes) for all CPUs; every
+ * thread first touches its partition of the arrays, such that the memory is allocated on the local NUMA node.
+ * Every run is recorded via perf::MultiCoreEventCounter on the CPUs of the threads, attributing last-level cache misses
+ * (cache-misses) per byte and stalled cycles to the kernels (as far as the counters are available).
+ *
+ * Bytes are counted like STREAM: every element read or written counts once (write-allocate traffic is not included).
+ * Every array should exceed the last-level cache at least four times.
+ *
+ * Every measurement is written as one line of JSON (to the output file or to stdout); progress and a summary of the
+ * bandwidths are printed to stderr.
+ *
+ * Usage: stream-benchmark [array size in MB, default 256] [repetitions, default 10] [output file]
+ */
+
+static constexpr auto SUITE = std::string_view{ "stream" };
+
+/**
+ * Kernels, each executed on the partition [begin, end) of the arrays a, b, and c.
+ */
+enum class Kernel : std::uint8_t
+{
+  Copy,
+  Scale,
+  Add,
+  Triad,
+  Read,
+  Write
+};
+
+static constexpr auto KERNELS =
+  std::array<Kernel, 6U>{ Kernel::Copy, Kernel::Scale, Kernel::Add, Kernel::Triad, Kernel::Read, Kernel::Write };
+
+static std::string_view
+kernel_name(const Kernel kernel)
+{
+  switch (kernel) {
+    case Kernel::Copy:
+      return "copy";
+    case Kernel::Scale:
+      return "scale";
+    case Kernel::Add:
+      return "add";
+    case Kernel::Triad:
+      return "triad";
+    case Kernel::Read:
+      return "read";
+    case Kernel::Write:
+      return "write";
+  }
+
+  return "unknown";
+}
+
+/**
+ * @return Number of arrays the kernel reads or writes per element.
+ */
+static std::uint64_t
+kernel_accesses(const Kernel kernel)
+{
+  switch (kernel) {
+    case Kernel::Copy:
+    case Kernel::Scale:
+      return 2U;
+    case Kernel::Add:
+    case Kernel::Triad:
+      return 3U;
+    case Kernel::Read:
+    case Kernel::Write:
+      return 1U;
+  }
+
+  return 0U;
+}
+
+static void
+run_kernel(const Kernel kernel,
+           double* __restrict a,
+           double* __restrict b,
+           double* __restrict c,
+           const std::size_t begin,
+           const std::size_t end)
+{
+  constexpr auto scalar = 3.;
+
+  switch (kernel) {
+    case Kernel::Copy:
+      for (auto i = begin; i < end; ++i) {
+        c[i] = a[i];
+      }
+      break;
+    case Kernel::Scale:
+      for (auto i = begin; i < end; ++i) {
+        b[i] = scalar * c[i];
+      }
+      break;
+    case Kernel::Add:
+      for (auto i = begin; i < end; ++i) {
+        c[i] = a[i] + b[i];
+      }
+      break;
+    case Kernel::Triad:
+      for (auto i = begin; i < end; ++i) {
+        a[i] = b[i] + scalar * c[i];
+      }
+      break;
+    case Kernel::Read: {
+      auto sum = .0;
+      for (auto i = begin; i < end; ++i) {
+        sum += a[i];
+      }
+      asm volatile("" : "+r,m"(sum) : : "memory");
+      break;
+    }
+    case Kernel::Write:
+      for (auto i = begin; i < end; ++i) {
+        a[i] = scalar;
+      }
+      break;
+  }
+}
+
+/**
+ * Memory mapped without touching it, such that every page is allocated on the NUMA node of the first thread
+ * writing it.
+ */
+class Array
+{
+public:
+  explicit Array(const std::size_t count_elements)
+    : _size(count_elements * sizeof(double))
+  {
+    auto* memory = ::mmap(nullptr, _size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) {
+      throw std::bad_alloc{};
+    }
+    _data = static_cast<double*>(memory);
+  }
+
+  ~Array() { ::munmap(_data, _size); }
+
+  Array(const Array&) = delete;
+  Array& operator=(const Array&) = delete;
+
+  [[nodiscard]] double* data() noexcept { return _data; }
+
+private:
+  std::size_t _size;
+  double* _data;
+};
+
+/**
+ * Runs all kernels on one pinned thread per CPU and writes a line per kernel.
+ *
+ * @return Median bandwidth (GB/s) per kernel.
+ */
+static std::array<double, KERNELS.size()>
+benchmark_cpus(std::ostream& output,
+               const perf::CounterDefinition& counter_definitions,
+               const std::vector<std::string>& counters,
+               const std::string_view node,
+               const std::vector<std::uint16_t>& cpu_ids,
+               const std::size_t count_elements,
+               const std::uint32_t repetitions)
+{
+  const auto count_threads = std::uint32_t(cpu_ids.size());
+
+  auto a = Array{ count_elements };
+  auto b = Array{ count_elements };
+  auto c = Array{ count_elements };
+
+  /// Record all CPUs of the threads.
+  auto event_counter = perf::MultiCoreEventCounter{ counter_definitions, std::vector<std::uint16_t>{ cpu_ids } };
+  auto is_recording = !counters.empty() && event_counter.add(counters);
+
+  auto times = std::array<std::vector<double>, KERNELS.size()>{};
+  auto results = std::array<std::vector<perf::CounterResult>, KERNELS.size()>{};
+
+  auto barrier = perf::suite::Barrier{ count_threads };
+  const auto worker = [&](const std::uint32_t thread_id) {
+    perf::suite::pin_thread(cpu_ids[thread_id]);
+    const auto begin = count_elements * thread_id / count_threads;
+    const auto end = count_elements * (thread_id + 1U) / count_threads;
+
+    /// First touch the partition from the pinned thread, allocating it on the local NUMA node.
+    for (auto i = begin; i < end; ++i) {
+      a.data()[i] = 1.;
+      b.data()[i] = 2.;
+      c.data()[i] = .0;
+    }
+
+    for (auto repetition = 0U; repetition <= repetitions; ++repetition) {
+      for (auto kernel_index = 0U; kernel_index < KERNELS.size(); ++kernel_index) {
+        /// The first thread starts the counters before and stops them after all threads ran the kernel.
+        if (thread_id == 0U && is_recording && !event_counter.start()) {
+          event_counter.stop();
+          is_recording = false;
+          std::cerr << "Could not start performance counters on the CPUs, recording time only." << std::endl;
+        }
+        barrier.wait();
+        const auto start_time = std::chrono::steady_clock::now();
+
+        run_kernel(KERNELS[kernel_index], a.data(), b.data(), c.data(), begin, end);
+
+        barrier.wait();
+        if (thread_id == 0U) {
+          const auto end_time = std::chrono::steady_clock::now();
+          if (is_recording) {
+            event_counter.stop();
+          }
+
+          /// The first repetition warms up.
+          if (repetition > 0U) {
+            times[kernel_index].push_back(
+              double(std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time).count()));
+            if (is_recording) {
+              results[kernel_index].push_back(event_counter.result());
+            }
+          }
+        }
+      }
+    }
+  };
+
+  auto threads = std::vector<std::thread>{};
+  for (auto thread_id = 1U; thread_id < count_threads; ++thread_id) {
+    threads.emplace_back(worker, thread_id);
+  }
+  worker(0U);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  auto median_bandwidths = std::array<double, KERNELS.size()>{};
+  for (auto kernel_index = 0U; kernel_index < KERNELS.size(); ++kernel_index) {
+    const auto kernel = KERNELS[kernel_index];
+    const auto bytes = count_elements * sizeof(double) * kernel_accesses(kernel);
+
+    auto bandwidths = std::vector<double>{};
+    std::transform(times[kernel_index].begin(),
+                   times[kernel_index].end(),
+                   std::back_inserter(bandwidths),
+                   [bytes](const auto time) { return double(bytes) / time; });
+    const auto bandwidth_statistics = perf::Statistics{ std::move(bandwidths) };
+    median_bandwidths[kernel_index] = bandwidth_statistics.median();
+
+    auto line = perf::suite::ResultLine{ SUITE, kernel_name(kernel) };
+    line.add("node", node)
+      .add("threads", std::uint64_t{ count_threads })
+      .add("bytes", std::uint64_t{ bytes })
+      .add("time_ns", perf::Statistics{ std::move(times[kernel_index]) })
+      .add("bandwidth_gbs", bandwidth_statistics);
+
+    if (!results[kernel_index].empty()) {
+      /// Median of every counter over all repetitions.
+      const auto median = [&results, kernel_index](const std::string_view name) -> std::optional<double> {
+        auto values = std::vector<double>{};
+        for (const auto& result : results[kernel_index]) {
+          if (const auto value = result.get(name); value.has_value()) {
+            values.push_back(value.value());
+          }
+        }
+        return values.empty() ? std::nullopt : std::make_optional(perf::Statistics{ std::move(values) }.median());
+      };
+
+      auto counter_values = std::vector<std::pair<std::string_view, double>>{};
+      for (const auto& counter : counters) {
+        if (const auto value = median(counter); value.has_value()) {
+          counter_values.emplace_back(counter, value.value());
+        }
+      }
+      line.add("counters", perf::CounterResult{ std::move(counter_values) });
+
+      if (const auto cache_misses = median("cache-misses"); cache_misses.has_value()) {
+        line.add("llc_misses_per_byte", cache_misses.value() / double(bytes));
+      }
+
+      /// Share of cycles stalled in the back end (e.g., waiting for memory) and front end.
+      if (const auto cycles = median("cycles"); cycles.value_or(.0) > .0) {
+        if (const auto stalled_cycles = median("stalled-cycles-backend"); stalled_cycles.has_value()) {
+          line.add("backend_stall_ratio", stalled_cycles.value() / cycles.value());
+        }
+        if (const auto stalled_cycles = median("stalled-cycles-frontend"); stalled_cycles.has_value()) {
+          line.add("frontend_stall_ratio", stalled_cycles.value() / cycles.value());
+        }
+      }
+    }
+
+    output << line.str() << std::endl;
+  }
+
+  return median_bandwidths;
+}
+
+int
+main(int argc, char** argv)
+{
+  const auto array_size = std::size_t{ argc > 1 ? std::stoull(argv[1]) : 256U } * 1024U * 1024U;
+  const auto repetitions = std::uint32_t(argc > 2 ? std::stoul(argv[2]) : 10U);
+
+  auto output_file = std::ofstream{};
+  if (argc > 3) {
+    output_file.open(argv[3]);
+    if (!output_file.is_open()) {
+      std::cerr << "Could not open '" << argv[3] << "'." << std::endl;
+      return 1;
+    }
+  }
+  auto& output = argc > 3 ? static_cast<std::ostream&>(output_file) : std::cout;
+
+  /// The perf::CounterDefinition holds all counter names and must be alive until the benchmarks finish.
+  const auto counter_definitions = perf::CounterDefinition{};
+  const auto counters = perf::suite::supported_counters(
+    counter_definitions,
+    { "cycles", "instructions", "cache-misses", "stalled-cycles-backend", "stalled-cycles-frontend" });
+  if (counters.empty()) {
+    std::cerr << "No hardware counters available, measuring bandwidth only." << std::endl;
+  }
+
+  /// Group the CPUs this process may run on by NUMA node.
+  const auto topology = perf::NUMATopology::read();
+  auto allowed_cpus = cpu_set_t{};
+  CPU_ZERO(&allowed_cpus);
+  ::sched_getaffinity(0, sizeof(cpu_set_t), &allowed_cpus);
+
+  auto node_cpu_ids = std::vector<std::vector<std::uint16_t>>(topology.count_nodes());
+  auto all_cpu_ids = std::vector<std::uint16_t>{};
+  for (auto cpu_id = 0U; cpu_id < CPU_SETSIZE; ++cpu_id) {
+    if (CPU_ISSET(cpu_id, &allowed_cpus)) {
+      if (const auto node_id = topology.node_of_cpu(cpu_id); node_id.has_value()) {
+        node_cpu_ids[node_id.value()].push_back(std::uint16_t(cpu_id));
+        all_cpu_ids.push_back(std::uint16_t(cpu_id));
+      }
+    }
+  }
+
+  auto configurations = std::vector<std::pair<std::string, std::vector<std::uint16_t>>>{};
+  for (auto node_id = 0U; node_id < node_cpu_ids.size(); ++node_id) {
+    if (!node_cpu_ids[node_id].empty()) {
+      configurations.emplace_back(std::to_string(node_id), std::move(node_cpu_ids[node_id]));
+    }
+  }
+  if (configurations.size() > 1U) {
+    configurations.emplace_back("all", std::move(all_cpu_ids));
+  }
+
+  std::cerr << std::fixed << std::setprecision(2);
+  for (const auto& [node, cpu_ids] : configurations) {
+    std::cerr << "node " << node << ": " << cpu_ids.size() << " threads" << std::endl;
+    const auto bandwidths = benchmark_cpus(
+      output, counter_definitions, counters, node, cpu_ids, array_size / sizeof(double), repetitions);
+
+    for (auto kernel_index = 0U; kernel_index < KERNELS.size(); ++kernel_index) {
+      std::cerr << std::setw(10) << kernel_name(KERNELS[kernel_index]) << std::setw(12) << bandwidths[kernel_index]
+                << " GB/s" << std::endl;
+    }
+  }
+
+  return 0;
+}
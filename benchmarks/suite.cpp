@@ -0,0 +1,147 @@
+#include "suite.h"
+#include <cmath>
+#include <perfcpp/event_counter.h>
+#include <pthread.h>
+#include <sched.h>
+
+using namespace perf::suite;
+
+ResultLine::ResultLine(const std::string_view suite, const std::string_view benchmark)
+  : _line(256U)
+{
+  this->_line.append('{');
+  this->add("suite", suite);
+  this->add("benchmark", benchmark);
+}
+
+ResultLine&
+ResultLine::add(const std::string_view key, const std::string_view value)
+{
+  this->add_key(key);
+  this->_line.append_json_string(value);
+
+  return *this;
+}
+
+ResultLine&
+ResultLine::add(const std::string_view key, const double value)
+{
+  this->add_key(key);
+  this->add_number(value);
+
+  return *this;
+}
+
+ResultLine&
+ResultLine::add(const std::string_view key, const std::uint64_t value)
+{
+  this->add_key(key);
+  this->_line.append(value);
+
+  return *this;
+}
+
+ResultLine&
+ResultLine::add(const std::string_view key, const Statistics& statistics)
+{
+  this->add_key(key);
+  this->_line.append("{\"mean\":");
+  this->add_number(statistics.mean());
+  this->_line.append(",\"median\":");
+  this->add_number(statistics.median());
+  this->_line.append(",\"stddev\":");
+  this->add_number(statistics.stddev());
+  this->_line.append(",\"min\":");
+  this->add_number(statistics.min());
+  this->_line.append(",\"max\":");
+  this->add_number(statistics.max());
+  this->_line.append(",\"count\":");
+  this->add_number(double(statistics.count()));
+  this->_line.append('}');
+
+  return *this;
+}
+
+ResultLine&
+ResultLine::add(const std::string_view key, const CounterResult& result)
+{
+  this->add_key(key);
+  this->_line.append('{');
+  auto is_first = true;
+  for (const auto& [name, value] : result) {
+    if (!is_first) {
+      this->_line.append(',');
+    }
+    is_first = false;
+
+    this->_line.append_json_string(name);
+    this->_line.append(':');
+    this->add_number(value);
+  }
+  this->_line.append('}');
+
+  return *this;
+}
+
+std::string
+ResultLine::str() const
+{
+  auto line = std::string{ this->_line.view() };
+  line += '}';
+
+  return line;
+}
+
+void
+ResultLine::add_key(const std::string_view key)
+{
+  if (this->_line.view().size() > 1U) {
+    this->_line.append(',');
+  }
+
+  this->_line.append_json_string(key);
+  this->_line.append(':');
+}
+
+void
+ResultLine::add_number(const double value)
+{
+  /// JSON has no representation for NaN and infinity.
+  if (!std::isfinite(value)) {
+    this->_line.append("null");
+    return;
+  }
+
+  this->_line.append(value);
+}
+
+std::vector<std::string>
+perf::suite::supported_counters(const CounterDefinition& counter_definitions,
+                                const std::vector<std::string>& candidates,
+                                const std::size_t max_counters)
+{
+  auto counters = std::vector<std::string>{};
+  for (const auto& candidate : candidates) {
+    if (counters.size() == max_counters) {
+      break;
+    }
+
+    auto event_counter = EventCounter{ counter_definitions };
+    if (event_counter.add(candidate) && event_counter.start()) {
+      counters.push_back(candidate);
+    }
+    event_counter.stop();
+  }
+
+  return counters;
+}
+
+bool
+perf::suite::pin_thread(const std::uint16_t cpu_id)
+{
+  auto cpu_set = cpu_set_t{};
+  CPU_ZERO(&cpu_set);
+  CPU_SET(cpu_id, &cpu_set);
+
+  return ::pthread_setaffinity_np(::pthread_self(), sizeof(cpu_set_t), &cpu_set) == 0;
+}
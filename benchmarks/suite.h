@@ -0,0 +1,128 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <perfcpp/benchmark.h>
+#include <perfcpp/counter.h>
+#include <perfcpp/counter_definition.h>
+#include <perfcpp/output_buffer.h>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace perf::suite {
+/**
+ * Result of a single measurement of a benchmark suite, formatted as one line of JSON (JSON lines), such that results
+ * can be processed by scripts and compared across runs.
+ */
+class ResultLine
+{
+public:
+  /**
+   * Creates the line for the given measurement.
+   *
+   * @param suite Name of the benchmark suite.
+   * @param benchmark Name of the measured benchmark within the suite.
+   */
+  ResultLine(std::string_view suite, std::string_view benchmark);
+
+  ~ResultLine() = default;
+
+  ResultLine& add(std::string_view key, std::string_view value);
+  ResultLine& add(std::string_view key, const char* value) { return add(key, std::string_view{ value }); }
+  ResultLine& add(std::string_view key, double value);
+  ResultLine& add(std::string_view key, std::uint64_t value);
+
+  /**
+   * Adds the statistics as nested object with mean, median, standard deviation, minimum, maximum, and count.
+   */
+  ResultLine& add(std::string_view key, const Statistics& statistics);
+
+  /**
+   * Adds the values of all counters and metrics as nested object.
+   */
+  ResultLine& add(std::string_view key, const CounterResult& result);
+
+  /**
+   * @return The line as JSON object (without trailing newline).
+   */
+  [[nodiscard]] std::string str() const;
+
+private:
+  OutputBuffer _line;
+
+  void add_key(std::string_view key);
+  void add_number(double value);
+};
+
+/**
+ * Filters the counters (or metrics) that can be recorded on this machine, e.g., to fall back to software counters
+ * when hardware counters are not available.
+ *
+ * @param counter_definitions Definitions of counters and metrics.
+ * @param candidates Names of the counters and metrics in order of preference.
+ * @param max_counters Maximal number of returned counters.
+ * @return Names of the candidates that could be started.
+ */
+[[nodiscard]] std::vector<std::string> supported_counters(const CounterDefinition& counter_definitions,
+                                                          const std::vector<std::string>& candidates,
+                                                          std::size_t max_counters = ~std::size_t{ 0U });
+
+/**
+ * Barrier for a fixed number of threads; waiting threads yield, such that oversubscribed CPUs make progress.
+ */
+class Barrier
+{
+public:
+  explicit Barrier(const std::uint32_t count_threads) noexcept
+    : _count_threads(count_threads)
+  {
+  }
+
+  void wait() noexcept
+  {
+    const auto generation = _generation.load();
+    if (_count_waiting.fetch_add(1U) + 1U == _count_threads) {
+      _count_waiting.store(0U);
+      _generation.fetch_add(1U);
+      return;
+    }
+
+    while (_generation.load() == generation) {
+      std::this_thread::yield();
+    }
+  }
+
+private:
+  const std::uint32_t _count_threads;
+  std::atomic<std::uint32_t> _count_waiting{ 0U };
+  std::atomic<std::uint64_t> _generation{ 0U };
+};
+
+/**
+ * Pins the calling thread to the given CPU.
+ *
+ * @param cpu_id Id of the CPU.
+ * @return True, if the thread could be pinned.
+ */
+bool pin_thread(std::uint16_t cpu_id);
+
+/**
+ * Measures the wall-clock time of the callable.
+ *
+ * @param callable Code to measure.
+ * @return Time in nanoseconds.
+ */
+template<typename F>
+[[nodiscard]] double
+measure_ns(F&& callable)
+{
+  const auto begin = std::chrono::steady_clock::now();
+  callable();
+  const auto end = std::chrono::steady_clock::now();
+
+  return double(std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count());
+}
+}
@@ -35,6 +35,11 @@ public:
    */
   [[nodiscard]] const cache_line& operator[](const std::size_t index) const noexcept { return _data[_indices[index]]; }
 
+  /**
+   * @return Begin of the memory chunk that is accessed during the benchmark.
+   */
+  [[nodiscard]] const cache_line* data() const noexcept { return _data.data(); }
+
 private:
   /// Indices, defining the order in which the memory chunk is accessed.
   std::vector<std::uint64_t> _indices;
@@ -0,0 +1,103 @@
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <numeric>
+#include <perfcpp/autotuner.h>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * Gathers the values at the given (random) indices, prefetching the value needed prefetch distance iterations ahead;
+ * the indices are processed in blocks of the given size, a block is prefetched before it is processed.
+ */
+static std::uint64_t
+gather(const std::vector<std::uint64_t>& data,
+       const std::vector<std::uint32_t>& indices,
+       const std::int64_t prefetch_distance,
+       const std::int64_t block_size)
+{
+  auto value = std::uint64_t{ 0U };
+  for (auto block_begin = std::size_t{ 0U }; block_begin < indices.size(); block_begin += std::size_t(block_size)) {
+    const auto block_end = std::min(block_begin + std::size_t(block_size), indices.size());
+    for (auto index = block_begin; index < block_end; ++index) {
+      if (prefetch_distance > 0 && index + std::size_t(prefetch_distance) < indices.size()) {
+        __builtin_prefetch(&data[indices[index + std::size_t(prefetch_distance)]]);
+      }
+      value += data[indices[index]];
+    }
+  }
+
+  return value;
+}
+
+int
+main()
+{
+  std::cout << "libperf-cpp example: Tune the prefetch distance and block size of a gather kernel for cycles per "
+               "element, pruning bad configurations with successive halving."
+            << std::endl;
+
+  /// Create the data (64 MB) and random indices into it.
+  auto data = std::vector<std::uint64_t>(8U * 1024U * 1024U);
+  std::iota(data.begin(), data.end(), 0U);
+  auto indices = std::vector<std::uint32_t>(4U * 1024U * 1024U);
+  auto random_generator = std::mt19937{ std::random_device{}() };
+  auto distribution = std::uniform_int_distribution<std::uint32_t>{ 0U, std::uint32_t(data.size() - 1U) };
+  std::generate(indices.begin(), indices.end(), [&]() { return distribution(random_generator); });
+
+  /// Initialize the autotuner.
+  /// Note that the perf::CounterDefinition holds all counter names and must be
+  /// alive until tuning finishes.
+  auto counter_definitions = perf::CounterDefinition{};
+  auto autotuner = perf::Autotuner{ counter_definitions };
+  autotuner.add("prefetch_distance", { 0, 4, 8, 16, 32, 64, 128 });
+  autotuner.add("block_size", { 64, 1024, 16384 });
+  autotuner.repetitions(2U);
+  autotuner.reduction_factor(2U);
+
+  /// Optimize for cycles per element, i.e., the cycles normalized by the number of indices.
+  if (!autotuner.objective("cycles")) {
+    std::cerr << "Could not set the objective." << std::endl;
+    return 1;
+  }
+
+  std::cout << "Evaluating " << autotuner.configurations().size() << " configurations." << std::endl;
+
+  auto result = perf::TuningResult{};
+  try {
+    result = autotuner.run(
+      [&data, &indices](const perf::TuningConfiguration& configuration) {
+        const auto prefetch_distance = configuration.get("prefetch_distance", 0);
+        const auto block_size = configuration.get("block_size", 1);
+        auto value = gather(data, indices, prefetch_distance, block_size);
+
+        /// Use the value so that the compiler does not get the idea of optimizing away the accesses.
+        asm volatile("" : "+r,m"(value) : : "memory");
+      },
+      indices.size());
+  } catch (std::runtime_error& exception) {
+    std::cerr << exception.what() << std::endl;
+    return 1;
+  }
+
+  /// Print all evaluated configurations; the best is the first.
+  std::cout << "\nHere are the results per element:\n" << std::endl;
+  std::cout << result.to_string() << std::endl;
+
+  /// Store the best configuration for this CPU model...
+  const auto store = perf::TuningStore{ "autotuning.tsv" };
+  if (const auto best = result.best(); best.has_value()) {
+    if (!store.save("gather", best->configuration())) {
+      std::cerr << "Could not store the configuration." << std::endl;
+    }
+  }
+
+  /// ...such that applications can load it at startup.
+  if (const auto configuration = store.load("gather"); configuration.has_value()) {
+    std::cout << "Loaded configuration for '" << perf::SystemInfo::cpu_model() << "': " << configuration->to_string()
+              << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,71 @@
+#include "access_benchmark.h"
+#include <iostream>
+#include <perfcpp/benchmark.h>
+#include <stdexcept>
+
+int
+main()
+{
+  std::cout << "libperf-cpp example: Benchmark the random access to an in-memory array with warm-up and repetitions, "
+               "rotating through more counters than the hardware can record at once."
+            << std::endl;
+
+  /// Initialize the benchmark.
+  /// Note that the perf::CounterDefinition holds all counter names and must be
+  /// alive until the benchmark finishes.
+  auto counter_definitions = perf::CounterDefinition{};
+  auto benchmark = perf::Benchmark{ counter_definitions };
+  benchmark.warm_up(2U);
+  benchmark.repetitions(10U);
+
+  /// Add all the performance counters and metrics we want to record; they are distributed into sets of counters that
+  /// are recorded in turns.
+  if (!benchmark.add(std::vector<std::string>{ "instructions",
+                                               "cycles",
+                                               "branches",
+                                               "branch-misses",
+                                               "cache-misses",
+                                               "cache-references",
+                                               "L1-dcache-loads",
+                                               "L1-dcache-load-misses",
+                                               "dTLB-loads",
+                                               "dTLB-load-misses",
+                                               "cycles-per-instruction" })) {
+    std::cerr << "Could not add performance counters." << std::endl;
+  }
+  std::cout << "Recording " << benchmark.count_counter_sets() << " sets of counters per repetition." << std::endl;
+
+  /// Create random access benchmark.
+  auto access_benchmark = perf::example::AccessBenchmark{ /*randomize the accesses*/ true,
+                                                          /* create benchmark of 512 MB */ 512U };
+
+  /// Run the benchmark; results are normalized per accessed cache line.
+  auto result = perf::BenchmarkResult{};
+  try {
+    result = benchmark.run(
+      [&access_benchmark]() {
+        auto value = 0ULL;
+        for (auto index = 0U; index < access_benchmark.size(); ++index) {
+          value += access_benchmark[index].value;
+        }
+
+        /// Use the value so that the compiler does not get the idea of optimizing away the accesses.
+        asm volatile("" : "+r,m"(value) : : "memory");
+      },
+      access_benchmark.size());
+  } catch (std::runtime_error& exception) {
+    std::cerr << exception.what() << std::endl;
+    return 1;
+  }
+
+  /// Print the statistics per cache line.
+  std::cout << "\nHere are the results per cache line:\n" << std::endl;
+  std::cout << result.to_string() << std::endl;
+
+  /// Or access single statistics.
+  if (const auto cycles = result.get("cycles"); cycles.has_value()) {
+    std::cout << "Median: " << cycles->median() << " cycles per cache line" << std::endl;
+  }
+
+  return 0;
+}
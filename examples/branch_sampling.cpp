@@ -1,5 +1,7 @@
 #include "access_benchmark.h"
 #include <iostream>
+#include <perfcpp/branch_analyzer.h>
+#include <perfcpp/loop_analyzer.h>
 #include <perfcpp/sampler.h>
 
 /**
@@ -95,6 +97,14 @@ main()
   }
   std::cout << std::flush;
 
+  /// Aggregate all branch stacks into executed ranges and costly branches.
+  const auto branch_result = perf::BranchAnalyzer{}.analyze(samples);
+  std::cout << "\n" << branch_result.to_string(/* print the top */ 10U) << std::flush;
+
+  /// Detect loops (backward taken branches) and estimate their trip counts.
+  const auto loop_result = perf::LoopAnalyzer{}.analyze(samples);
+  std::cout << "\nLoops:\n" << loop_result.to_string(/* print the top */ 10U) << std::flush;
+
   /// Close the sampler.
   /// Note that the sampler can only be closed after reading the samples.
   sampler.close();
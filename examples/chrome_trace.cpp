@@ -0,0 +1,121 @@
+#include "access_benchmark.h"
+#include <chrono>
+#include <ctime>
+#include <iostream>
+#include <perfcpp/chrome_trace_exporter.h>
+#include <perfcpp/event_counter.h>
+#include <perfcpp/sampler.h>
+#include <stdexcept>
+#include <thread>
+#include <unistd.h>
+
+/**
+ * @return Current time of the steady (i.e., monotonic) clock in nanoseconds.
+ */
+static std::uint64_t
+now()
+{
+  return std::uint64_t(
+    std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+int
+main()
+{
+  std::cout << "libperf-cpp example: Record perf samples including time, thread id, CPU id, instruction pointer, and "
+               "context switches as well as counter values of regions for single-threaded random access to an "
+               "in-memory array, and write them into a trace for Perfetto UI."
+            << std::endl;
+
+  /// Initialize counter definitions.
+  /// Note that the perf::CounterDefinition holds all counter names and must be
+  /// alive until the benchmark finishes.
+  auto counter_definitions = perf::CounterDefinition{};
+
+  /// Initialize sampler.
+  auto perf_config = perf::SampleConfig{};
+  perf_config.precise_ip(0U);            /// precise_ip controls the amount of skid, see
+                                         /// https://man7.org/linux/man-pages/man2/perf_event_open.2.html
+  perf_config.period(500000U);           /// Record every 500,000th event.
+  perf_config.context_switch(true);      /// Record when the thread is switched in and out.
+  perf_config.clock_id(CLOCK_MONOTONIC); /// Use the clock of std::chrono::steady_clock for sample timestamps.
+
+  auto sampler = perf::Sampler{ counter_definitions,
+                                "cycles", /// Event that generates an overflow which is samples (here we
+                                          /// sample every 500,000th cycle)
+                                perf::Sampler::Type::Time | perf::Sampler::Type::ThreadId | perf::Sampler::Type::CPU |
+                                  perf::Sampler::Type::InstructionPointer, /// Controls what to include into the
+                                                                           /// sample, see
+                                /// https://man7.org/linux/man-pages/man2/perf_event_open.2.html
+                                perf_config };
+
+  /// Counters recording each region.
+  auto event_counter = perf::EventCounter{ counter_definitions };
+  event_counter.add(std::vector<std::string>{ "instructions", "cycles", "cache-misses" });
+
+  /// Create random access benchmark.
+  auto benchmark = perf::example::AccessBenchmark{ /*randomize the accesses*/ true,
+                                                   /* create benchmark of 256 MB */ 256U };
+
+  /// Start sampling.
+  if (!sampler.start()) {
+    std::cerr << "Could not start sampling, errno = " << sampler.last_error() << "." << std::endl;
+    return 1;
+  }
+
+  try {
+    auto trace = perf::ChromeTraceExporter{ "chrome-trace.json" };
+    trace.name_thread(std::uint32_t(::getpid()), std::uint32_t(::gettid()), "benchmark");
+
+    /// Execute the benchmark (accessing cache lines in a random order) in four regions, pausing in between to provoke
+    /// context switches.
+    constexpr auto count_regions = 4U;
+    const auto region_size = benchmark.size() / count_regions;
+    auto value = 0ULL;
+    for (auto region = 0U; region < count_regions; ++region) {
+      const auto begin_time = now();
+      event_counter.start();
+
+      for (auto index = region * region_size; index < (region + 1U) * region_size; ++index) {
+        value += benchmark[index].value;
+      }
+
+      event_counter.stop();
+      const auto end_time = now();
+
+      trace.add_region("region " + std::to_string(region),
+                       begin_time,
+                       end_time,
+                       std::uint32_t(::getpid()),
+                       std::uint32_t(::gettid()),
+                       event_counter.result());
+
+      std::this_thread::sleep_for(std::chrono::milliseconds{ 5U });
+    }
+    asm volatile(""
+                 : "+r,m"(value)
+                 :
+                 : "memory"); /// We do not want the compiler to optimize away
+                              /// this unused value.
+
+    /// Stop sampling.
+    sampler.stop();
+
+    /// Stream the samples and context switches into the trace.
+    sampler.for_each_sample([&trace](perf::Sample&& sample) { trace.add(sample); });
+
+    if (trace.close()) {
+      std::cout << "Wrote " << trace.count_events() << " events into chrome-trace.json; open it in "
+                << "https://ui.perfetto.dev." << std::endl;
+    } else {
+      std::cerr << "Could not write chrome-trace.json." << std::endl;
+    }
+  } catch (std::runtime_error& exception) {
+    std::cerr << exception.what() << std::endl;
+  }
+
+  /// Close the sampler.
+  sampler.close();
+
+  return 0;
+}
@@ -0,0 +1,77 @@
+#include "access_benchmark.h"
+#include <iostream>
+#include <perfcpp/comparison.h>
+#include <stdexcept>
+
+/**
+ * Sums up all cache lines of the benchmark, in the access order of the benchmark.
+ */
+static void
+sum(const perf::example::AccessBenchmark& access_benchmark)
+{
+  auto value = 0ULL;
+  for (auto index = 0U; index < access_benchmark.size(); ++index) {
+    value += access_benchmark[index].value;
+  }
+
+  /// Use the value so that the compiler does not get the idea of optimizing away the accesses.
+  asm volatile("" : "+r,m"(value) : : "memory");
+}
+
+int
+main()
+{
+  std::cout << "libperf-cpp example: Compare random (baseline) and sequential (variant) access to an in-memory array "
+               "in interleaved, randomized runs."
+            << std::endl;
+
+  /// Initialize the comparison.
+  /// Note that the perf::CounterDefinition holds all counter names and must be
+  /// alive until the comparison finishes.
+  auto counter_definitions = perf::CounterDefinition{};
+  auto comparison = perf::Comparison{ counter_definitions };
+  comparison.warm_up(2U);
+  comparison.repetitions(20U);
+  comparison.confidence_level(.95);
+  comparison.resolution(.01);
+
+  /// Add all the performance counters and metrics we want to compare.
+  if (!comparison.add(std::vector<std::string>{
+        "instructions", "cycles", "branches", "cache-misses", "cycles-per-instruction" })) {
+    std::cerr << "Could not add performance counters." << std::endl;
+  }
+
+  /// Create both variants on the same amount of data.
+  const auto random_access = perf::example::AccessBenchmark{ /*randomize the accesses*/ true,
+                                                             /* create benchmark of 64 MB */ 64U };
+  const auto sequential_access = perf::example::AccessBenchmark{ /*randomize the accesses*/ false,
+                                                                 /* create benchmark of 64 MB */ 64U };
+
+  /// Run both variants; results are normalized per accessed cache line.
+  auto result = perf::ComparisonResult{};
+  try {
+    result = comparison.run([&random_access]() { sum(random_access); },
+                            [&sequential_access]() { sum(sequential_access); },
+                            random_access.size());
+  } catch (std::runtime_error& exception) {
+    std::cerr << exception.what() << std::endl;
+    return 1;
+  }
+
+  /// Print the comparison per cache line.
+  std::cout << "\nHere are the results per cache line:\n" << std::endl;
+  std::cout << result.to_string() << std::endl;
+
+  if (result.running_fraction() < 1.) {
+    std::cout << "Counters were multiplexed (scheduled " << result.running_fraction() * 100.
+              << "% of the time); consider recording fewer counters." << std::endl;
+  }
+
+  /// Or access single comparisons.
+  if (const auto cycles = result.get("cycles"); cycles.has_value() && cycles->is_different()) {
+    std::cout << "Sequential access changes cycles per cache line by " << cycles->relative_difference() * 100. << "%."
+              << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,66 @@
+#include "access_benchmark.h"
+#include <benchmark/benchmark.h>
+#include <perfcpp/google_benchmark.h>
+
+/// The perf::CounterDefinition holds all counter names and must be alive until all benchmarks finish.
+static auto counter_definitions = perf::CounterDefinition{};
+
+/// Performance counters and metrics reported as user counters of every benchmark.
+static const auto counter_names =
+  std::vector<std::string>{ "instructions", "cycles", "cache-misses", "cycles-per-instruction" };
+
+/**
+ * Accesses an in-memory array of the given size (in MB, first argument) in random or sequential order.
+ */
+static void
+access(benchmark::State& state, const bool is_random)
+{
+  const auto access_benchmark = perf::example::AccessBenchmark{ is_random, std::uint64_t(state.range(0)) };
+
+  /// Replace the state by the counter in the loop; counters are reported per iteration, i.e., per pass over the array.
+  auto counters = perf::GoogleBenchmarkCounter{ state, counter_definitions, counter_names };
+  for (auto _ : counters) {
+    for (auto index = 0U; index < access_benchmark.size(); ++index) {
+      benchmark::DoNotOptimize(access_benchmark[index].value);
+    }
+  }
+
+  /// Report the accessed cache lines per second.
+  state.SetItemsProcessed(std::int64_t(state.iterations() * access_benchmark.size()));
+}
+
+static void
+BM_RandomAccess(benchmark::State& state)
+{
+  access(state, true);
+}
+
+static void
+BM_SequentialAccess(benchmark::State& state)
+{
+  access(state, false);
+}
+
+/**
+ * Creates a new array in every iteration; creating is excluded from time and counters via pause() and resume().
+ */
+static void
+BM_RandomAccessWithSetup(benchmark::State& state)
+{
+  auto counters = perf::GoogleBenchmarkCounter{ state, counter_definitions, counter_names };
+  for (auto _ : counters) {
+    counters.pause();
+    const auto access_benchmark = perf::example::AccessBenchmark{ true, std::uint64_t(state.range(0)) };
+    counters.resume();
+
+    for (auto index = 0U; index < access_benchmark.size(); ++index) {
+      benchmark::DoNotOptimize(access_benchmark[index].value);
+    }
+  }
+}
+
+BENCHMARK(BM_RandomAccess)->Arg(4)->Arg(64)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_SequentialAccess)->Arg(4)->Arg(64)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_RandomAccessWithSetup)->Arg(16)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
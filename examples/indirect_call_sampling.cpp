@@ -0,0 +1,119 @@
+#include "access_benchmark.h"
+#include <iostream>
+#include <memory>
+#include <perfcpp/indirect_call_analyzer.h>
+#include <perfcpp/sampler.h>
+
+/**
+ * Operations on a cache line, called through virtual dispatch for demonstrating indirect-call sampling.
+ */
+class Operation
+{
+public:
+  virtual ~Operation() = default;
+  [[nodiscard]] virtual std::uint64_t apply(const perf::example::AccessBenchmark::cache_line& cache_line) const = 0;
+};
+
+class AddOperation final : public Operation
+{
+public:
+  [[nodiscard]] std::uint64_t apply(const perf::example::AccessBenchmark::cache_line& cache_line) const override
+  {
+    return cache_line.value + 42U;
+  }
+};
+
+class MultiplyOperation final : public Operation
+{
+public:
+  [[nodiscard]] std::uint64_t apply(const perf::example::AccessBenchmark::cache_line& cache_line) const override
+  {
+    return cache_line.value * 3U;
+  }
+};
+
+class ShiftOperation final : public Operation
+{
+public:
+  [[nodiscard]] std::uint64_t apply(const perf::example::AccessBenchmark::cache_line& cache_line) const override
+  {
+    return cache_line.value >> 2U;
+  }
+};
+
+int
+main()
+{
+  std::cout << "libperf-cpp example: Record perf branch samples of indirect calls (virtual dispatch) and analyze the "
+               "distribution of targets per call site."
+            << std::endl;
+
+  /// Initialize counter definitions.
+  /// Note that the perf::CounterDefinition holds all counter names and must be
+  /// alive until the benchmark finishes.
+  auto counter_definitions = perf::CounterDefinition{};
+
+  /// Initialize sampler.
+  auto perf_config = perf::SampleConfig{};
+  perf_config.precise_ip(0U);   /// precise_ip controls the amount of skid, see
+                                /// https://man7.org/linux/man-pages/man2/perf_event_open.2.html
+  perf_config.period(100000U);  /// Record every 100,000th event.
+  perf_config.branch_type(perf::IndirectCallAnalyzer::branch_type()); /// Only sample indirect calls in user-mode.
+
+  auto sampler = perf::Sampler{ counter_definitions,
+                                "cycles", /// Event generates an overflow which is sampled (here we sample
+                                          /// every 100,000th cycle), the rest is recorded.
+                                perf::Sampler::Type::BranchStack, /// Controls what to include into the sample, see
+                                /// https://man7.org/linux/man-pages/man2/perf_event_open.2.html
+                                perf_config };
+
+  /// Create random access benchmark.
+  auto benchmark = perf::example::AccessBenchmark{ /*randomize the accesses*/ true,
+                                                   /* create benchmark of 512 MB */ 512U };
+
+  /// Create operations; the add operation is called most often.
+  auto operations = std::vector<std::unique_ptr<Operation>>{};
+  operations.emplace_back(std::make_unique<AddOperation>());
+  operations.emplace_back(std::make_unique<AddOperation>());
+  operations.emplace_back(std::make_unique<AddOperation>());
+  operations.emplace_back(std::make_unique<MultiplyOperation>());
+  operations.emplace_back(std::make_unique<ShiftOperation>());
+
+  /// Start sampling.
+  if (!sampler.start()) {
+    std::cerr << "Could not start sampling, errno = " << sampler.last_error() << "." << std::endl;
+    return 1;
+  }
+
+  /// Execute the benchmark (accessing cache lines in a random order and calling a virtual function on each).
+  auto value = 0ULL;
+  for (auto index = 0U; index < benchmark.size(); ++index) {
+    const auto& cache_line = benchmark[index];
+    value += operations[cache_line.value % operations.size()]->apply(cache_line);
+  }
+  asm volatile(""
+               : "+r,m"(value)
+               :
+               : "memory"); /// We do not want the compiler to optimize away
+                            /// this unused value.
+
+  /// Stop sampling.
+  sampler.stop();
+
+  /// Get all the recorded samples.
+  const auto samples = sampler.result();
+  std::cout << "\nRecorded " << samples.size() << " samples." << std::endl;
+
+  /// Aggregate the targets per indirect call site.
+  const auto result = perf::IndirectCallAnalyzer{}.analyze(samples);
+  std::cout << "\n" << result.to_string(/* print the top */ 10U) << std::endl;
+
+  /// Export the profile (offsets within the binaries) for feeding it back into the build.
+  std::cout << result.to_csv() << std::flush;
+
+  /// Close the sampler.
+  /// Note that the sampler can only be closed after reading the samples.
+  sampler.close();
+
+  return 0;
+}
@@ -0,0 +1,69 @@
+#include "access_benchmark.h"
+#include <chrono>
+#include <iostream>
+#include <perfcpp/event_counter.h>
+#include <perfcpp/openmetrics_exporter.h>
+
+int
+main()
+{
+  std::cout << "libperf-cpp example: Expose the live counters of a random access to an in-memory array in the "
+               "OpenMetrics format via HTTP, while the benchmark is running."
+            << std::endl;
+
+  /// Initialize performance counters.
+  /// Note that the perf::CounterDefinition holds all counter names and must be
+  /// alive until the benchmark finishes.
+  auto counter_definitions = perf::CounterDefinition{};
+  auto event_counter = perf::EventCounter{ counter_definitions };
+
+  /// Add all the performance counters (and metrics) we want to expose.
+  if (!event_counter.add(
+        std::vector<std::string>{ "instructions", "cycles", "cache-misses", "cycles-per-instruction" })) {
+    std::cerr << "Could not add performance counters." << std::endl;
+  }
+
+  /// Create random access benchmark.
+  auto benchmark = perf::example::AccessBenchmark{ /*randomize the accesses*/ true,
+                                                   /* create benchmark of 256 MB */ 256U };
+
+  /// Start recording; the counters keep running while being scraped.
+  if (!event_counter.start()) {
+    std::cerr << "Could not start performance counters." << std::endl;
+    return 1;
+  }
+
+  /// Serve the counters on a local port (let the system choose a free one); use serve("/path/to/socket") to serve
+  /// on a Unix socket instead.
+  auto exporter = perf::OpenMetricsExporter{ counter_definitions };
+  exporter.add("main", event_counter);
+  if (!exporter.serve(0U)) {
+    std::cerr << "Could not serve the counters." << std::endl;
+    return 1;
+  }
+  std::cout << "Scrape the counters for the next 30 seconds, e.g., via: curl http://127.0.0.1:" << exporter.port()
+            << "/metrics" << std::endl;
+
+  /// Execute the benchmark repeatedly.
+  auto value = 0ULL;
+  const auto end = std::chrono::steady_clock::now() + std::chrono::seconds{ 30U };
+  while (std::chrono::steady_clock::now() < end) {
+    for (auto index = 0U; index < benchmark.size(); ++index) {
+      value += benchmark[index].value;
+    }
+  }
+
+  /// Stop serving before stopping the counters.
+  exporter.stop();
+  event_counter.stop();
+
+  /// Add up the results so that the compiler does not get the idea of optimizing away the accesses.
+  asm volatile("" : "+r,m"(value) : : "memory");
+
+  std::cout << "Served " << exporter.count_scrapes() << " scrapes. Final values:\n" << std::endl;
+  for (const auto& [counter_name, counter_value] : event_counter.result()) {
+    std::cout << counter_value << " " << counter_name << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,68 @@
+#include <cstdint>
+#include <iostream>
+#include <perfcpp/event_counter.h>
+#include <vector>
+
+int
+main()
+{
+  std::cout << "libperf-cpp example: Record performance counter for a small kernel and subtract the overhead of "
+               "recording (measured for an empty region)."
+            << std::endl;
+
+  /// Initialize performance counters.
+  /// Note that the perf::CounterDefinition holds all counter names and must be
+  /// alive until the benchmark finishes.
+  auto counter_definitions = perf::CounterDefinition{};
+  auto event_counter = perf::EventCounter{ counter_definitions };
+
+  /// Add all the performance counters we want to record.
+  if (!event_counter.add({ "instructions", "cycles", "branches", "cycles-per-instruction" })) {
+    std::cerr << "Could not add performance counters." << std::endl;
+  }
+
+  /// Measure the overhead of start() and stop() for the added counters; the median of 1000 empty regions is stored.
+  if (!event_counter.calibrate(1000U)) {
+    std::cerr << "Could not calibrate performance counters." << std::endl;
+    return 1;
+  }
+
+  /// Print the overhead, i.e., the events recorded although nothing was executed.
+  std::cout << "\nOverhead of an empty region:\n" << std::endl;
+  for (const auto& [counter_name, counter_value] : event_counter.overhead()) {
+    std::cout << counter_value << " " << counter_name << std::endl;
+  }
+
+  /// Create a small kernel: summing up 256 integers.
+  auto data = std::vector<std::uint64_t>(256U, 1U);
+
+  /// Start recording.
+  if (!event_counter.start()) {
+    std::cerr << "Could not start performance counters." << std::endl;
+  }
+
+  /// Execute the kernel.
+  auto value = 0ULL;
+  for (const auto item : data) {
+    value += item;
+
+    /// We do not want the compiler to vectorize or optimize away the loop.
+    asm volatile("" : "+r,m"(value) : : "memory");
+  }
+
+  /// Stop recording counters.
+  event_counter.stop();
+
+  /// Get the result (per element) with and without the overhead.
+  const auto result = event_counter.result(data.size());
+  const auto calibrated_result = event_counter.result(data.size(), /* subtract the overhead */ true);
+
+  /// Print the performance counters.
+  std::cout << "\nHere are the results:\n" << std::endl;
+  for (const auto& [counter_name, counter_value] : result) {
+    std::cout << counter_value << " " << counter_name << " per element (including overhead), "
+              << calibrated_result.get(counter_name).value_or(.0) << " without overhead" << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,80 @@
+#include "access_benchmark.h"
+#include <iostream>
+#include <perfcpp/page_size_analyzer.h>
+#include <perfcpp/sampler.h>
+
+int
+main()
+{
+  std::cout << "libperf-cpp example: Record perf samples including logical memory addresses, instruction pointers, "
+               "data sources, and page sizes for single-threaded random access to an in-memory array and analyze "
+               "the huge page coverage of the accesses."
+            << std::endl;
+  std::cout << "Note that this will work only on Intel CPUs that provide the "
+               "counter `mem_trans_retired.load_latency_gt_X`."
+            << std::endl;
+
+  /// Initialize counter definitions.
+  /// Note that the perf::CounterDefinition holds all counter names and must be
+  /// alive until the benchmark finishes.
+  auto counter_definitions = perf::CounterDefinition{};
+  counter_definitions.add("mem_trans_retired.load_latency_gt_3", perf::CounterConfig{ PERF_TYPE_RAW, 0x1CD, 0x3 });
+
+  /// Initialize sampler.
+  auto perf_config = perf::SampleConfig{};
+  perf_config.precise_ip(3U); /// precise_ip controls the amount of skid, see
+                              /// https://man7.org/linux/man-pages/man2/perf_event_open.2.html
+  perf_config.period(1000U);  /// Record every 1000th event.
+
+  auto sampler = perf::Sampler{ counter_definitions,
+                                "mem_trans_retired.load_latency_gt_3", /// Event that generates an overflow
+                                                                       /// which is samples (here we sample
+                                                                       /// every 1,000 mem load)
+                                perf::Sampler::Type::InstructionPointer | perf::Sampler::Type::LogicalMemAddress |
+                                  perf::Sampler::Type::DataSource | perf::Sampler::Type::DataPageSize |
+                                  perf::Sampler::Type::CodePageSize, /// Controls what to include into the sample, see
+                                /// https://man7.org/linux/man-pages/man2/perf_event_open.2.html
+                                perf_config };
+
+  /// Create random access benchmark.
+  auto benchmark = perf::example::AccessBenchmark{ /*randomize the accesses*/ true,
+                                                   /* create benchmark of 512 MB */ 512U };
+
+  /// Start sampling.
+  if (!sampler.start()) {
+    std::cerr << "Could not start sampling, errno = " << sampler.last_error() << "." << std::endl;
+    return 1;
+  }
+
+  /// Execute the benchmark (accessing cache lines in a random order).
+  auto value = 0ULL;
+  for (auto index = 0U; index < benchmark.size(); ++index) {
+    value += benchmark[index].value;
+  }
+  asm volatile(""
+               : "+r,m"(value)
+               :
+               : "memory"); /// We do not want the compiler to optimize away
+                            /// this unused value.
+
+  /// Stop sampling.
+  sampler.stop();
+
+  /// Get all the recorded samples.
+  const auto samples = sampler.result();
+  std::cout << "\nRecorded " << samples.size() << " samples." << std::endl;
+
+  /// Analyze the samples. The benchmark data is registered as a region to get a dedicated coverage report.
+  auto page_size_analyzer = perf::PageSizeAnalyzer{};
+  page_size_analyzer.add(
+    "benchmark data", benchmark.data(), benchmark.size() * sizeof(perf::example::AccessBenchmark::cache_line));
+  const auto page_size_result = page_size_analyzer.analyze(samples);
+
+  std::cout << "\nPage sizes of the sampled accesses:\n" << page_size_result.to_string() << std::flush;
+
+  /// Close the sampler.
+  /// Note that the sampler can only be closed after reading the samples.
+  sampler.close();
+
+  return 0;
+}
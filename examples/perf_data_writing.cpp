@@ -0,0 +1,97 @@
+#include "access_benchmark.h"
+#include <iostream>
+#include <optional>
+#include <perfcpp/perf_data_reader.h>
+#include <perfcpp/perf_data_writer.h>
+#include <perfcpp/sampler.h>
+#include <stdexcept>
+
+int
+main()
+{
+  std::cout << "libperf-cpp example: Record perf samples including time, thread id, instruction pointer, and cpu id "
+               "for single-threaded random access to an in-memory array, write them into a perf.data file, and read them "
+               "back."
+            << std::endl;
+
+  /// Initialize counter definitions.
+  /// Note that the perf::CounterDefinition holds all counter names and must be
+  /// alive until the benchmark finishes.
+  auto counter_definitions = perf::CounterDefinition{};
+
+  /// Initialize sampler.
+  auto perf_config = perf::SampleConfig{};
+  perf_config.precise_ip(0U);  /// precise_ip controls the amount of skid, see
+                               /// https://man7.org/linux/man-pages/man2/perf_event_open.2.html
+  perf_config.period(100000U); /// Record every 100,000th event.
+
+  auto sampler = perf::Sampler{ counter_definitions,
+                                "cycles", /// Event that generates an overflow which is samples (here we
+                                          /// sample every 100,000th cycle)
+                                perf::Sampler::Type::InstructionPointer | perf::Sampler::Type::ThreadId |
+                                  perf::Sampler::Type::Time | perf::Sampler::Type::CPU |
+                                  perf::Sampler::Type::Period, /// Controls what to include into the sample, see
+                                /// https://man7.org/linux/man-pages/man2/perf_event_open.2.html
+                                perf_config };
+
+  /// Create random access benchmark.
+  auto benchmark = perf::example::AccessBenchmark{ /*randomize the accesses*/ true,
+                                                   /* create benchmark of 512 MB */ 512U };
+
+  /// Start sampling.
+  if (!sampler.start()) {
+    std::cerr << "Could not start sampling, errno = " << sampler.last_error() << "." << std::endl;
+    return 1;
+  }
+
+  /// Execute the benchmark (accessing cache lines in a random order).
+  auto value = 0ULL;
+  for (auto index = 0U; index < benchmark.size(); ++index) {
+    value += benchmark[index].value;
+  }
+  asm volatile(""
+               : "+r,m"(value)
+               :
+               : "memory"); /// We do not want the compiler to optimize away
+                            /// this unused value.
+
+  /// Stop sampling.
+  sampler.stop();
+
+  /// Write the recorded samples (without decoding them) into a perf.data file.
+  if (perf::PerfDataWriter::write("perf-data-writing.data", sampler)) {
+    std::cout << "Wrote samples to perf-data-writing.data; open it with 'perf report -i perf-data-writing.data'."
+              << std::endl;
+  } else {
+    std::cerr << "Could not write perf-data-writing.data." << std::endl;
+  }
+
+  /// Close the sampler.
+  /// Note that the sampler can only be closed after writing the samples.
+  sampler.close();
+
+  /// Read the file back and decode its samples (the same way as sampler.result()).
+  try {
+    const auto reader = perf::PerfDataReader{ "perf-data-writing.data" };
+
+    auto count_samples = 0ULL;
+    auto first_sample_time = std::optional<std::uint64_t>{};
+    reader.for_each_sample([&count_samples, &first_sample_time](perf::Sample&& sample) {
+      ++count_samples;
+      if (!first_sample_time.has_value()) {
+        first_sample_time = sample.time();
+      }
+    });
+
+    std::cout << "Read " << count_samples << " samples of event '" << reader.event_names().front()
+              << "' from perf-data-writing.data";
+    if (first_sample_time.has_value()) {
+      std::cout << " (first sample at time " << first_sample_time.value() << ")";
+    }
+    std::cout << "." << std::endl;
+  } catch (std::runtime_error& exception) {
+    std::cerr << exception.what() << std::endl;
+  }
+
+  return 0;
+}
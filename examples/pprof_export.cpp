@@ -0,0 +1,92 @@
+#include "access_benchmark.h"
+#include <iostream>
+#include <perfcpp/pprof_exporter.h>
+#include <perfcpp/sampler.h>
+#include <thread>
+#include <vector>
+
+int
+main()
+{
+  std::cout << "libperf-cpp example: Record callchains on multiple threads performing random access to an in-memory "
+               "array, merge the per-thread profiles, and write them as pprof profile."
+            << std::endl;
+
+  /// Initialize counter definitions.
+  /// Note that the perf::CounterDefinition holds all counter names and must be
+  /// alive until the benchmark finishes.
+  auto counter_definitions = perf::CounterDefinition{};
+
+  /// Initialize sampler.
+  auto perf_config = perf::SampleConfig{};
+  perf_config.precise_ip(0U);   /// precise_ip controls the amount of skid, see
+                                /// https://man7.org/linux/man-pages/man2/perf_event_open.2.html
+  perf_config.period(1000000U); /// Record every 1,000,000th event.
+
+  constexpr auto count_threads = 2U;
+
+  /// Create random access benchmark.
+  auto benchmark = perf::example::AccessBenchmark{ /*randomize the accesses*/ true,
+                                                   /* create benchmark of 512 MB */ 512U };
+
+  /// One profile per thread, aggregating the callchains sampled by the thread's sampler.
+  auto profiles = std::vector<perf::PprofExporter>{};
+  for (auto thread_index = 0U; thread_index < count_threads; ++thread_index) {
+    profiles.emplace_back("cycles", perf_config.frequency_or_period());
+  }
+
+  auto threads = std::vector<std::thread>{};
+  for (auto thread_index = 0U; thread_index < count_threads; ++thread_index) {
+    threads.emplace_back([thread_index, &counter_definitions, &perf_config, &benchmark, &profiles]() {
+      auto sampler = perf::Sampler{ counter_definitions,
+                                    "cycles", /// Event that generates an overflow which is samples (here we
+                                              /// sample every 1,000,000th cycle)
+                                    perf::Sampler::Type::Callchain | perf::Sampler::Type::InstructionPointer |
+                                      perf::Sampler::Type::Period, /// Controls what to include into the sample, see
+                                    /// https://man7.org/linux/man-pages/man2/perf_event_open.2.html
+                                    perf_config };
+
+      /// Start sampling.
+      if (!sampler.start()) {
+        std::cerr << "Could not start sampling, errno = " << sampler.last_error() << "." << std::endl;
+        return;
+      }
+
+      /// Execute the benchmark (accessing cache lines in a random order).
+      const auto items_per_thread = benchmark.size() / count_threads;
+      auto value = 0ULL;
+      for (auto index = thread_index * items_per_thread; index < (thread_index + 1U) * items_per_thread; ++index) {
+        value += benchmark[index].value;
+      }
+      asm volatile(""
+                   : "+r,m"(value)
+                   :
+                   : "memory"); /// We do not want the compiler to optimize away
+                                /// this unused value.
+
+      /// Stop sampling and aggregate the callchains into the thread's profile.
+      sampler.stop();
+      sampler.for_each_sample([&profile = profiles[thread_index]](perf::Sample&& sample) { profile.add(sample); });
+      sampler.close();
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  /// Merge the per-thread profiles and write a single profile.
+  auto& profile = profiles.front();
+  for (auto thread_index = 1U; thread_index < count_threads; ++thread_index) {
+    profile.merge(profiles[thread_index]);
+  }
+
+  if (profile.write("cycles.pb")) {
+    std::cout << "Wrote " << profile.count_samples() << " samples (" << profile.count_stacks()
+              << " distinct callchains) into cycles.pb; inspect it with 'pprof -top cycles.pb'." << std::endl;
+  } else {
+    std::cerr << "Could not write cycles.pb." << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,120 @@
+#include "access_benchmark.h"
+#include <iostream>
+#include <perfcpp/autofdo_exporter.h>
+#include <perfcpp/bolt_exporter.h>
+#include <perfcpp/sampler.h>
+
+/**
+ * A function using multiple branches hard to optimize for the compiler for
+ * demonstrating the profile export.
+ *
+ * @param cache_line Cache line to use as an input.
+ * @return Another value through a handful of branches.
+ */
+[[nodiscard]] std::uint64_t
+branchy_function(const perf::example::AccessBenchmark::cache_line& cache_line);
+
+int
+main()
+{
+  std::cout << "libperf-cpp example: Record perf branch samples for single-threaded random access to an in-memory "
+               "array and export them as AutoFDO and BOLT profiles."
+            << std::endl;
+
+  /// Initialize counter definitions.
+  /// Note that the perf::CounterDefinition holds all counter names and must be
+  /// alive until the benchmark finishes.
+  auto counter_definitions = perf::CounterDefinition{};
+
+  /// Initialize sampler.
+  auto perf_config = perf::SampleConfig{};
+  perf_config.precise_ip(0U);   /// precise_ip controls the amount of skid, see
+                                /// https://man7.org/linux/man-pages/man2/perf_event_open.2.html
+  perf_config.period(100000U);  /// Record every 100,000th event.
+  perf_config.branch_type(perf::BranchType::User | perf::BranchType::Any); /// Sample all branches in user-mode.
+
+  auto sampler = perf::Sampler{ counter_definitions,
+                                "cycles", /// Event generates an overflow which is sampled (here we sample
+                                          /// every 100,000th cycle), the rest is recorded.
+                                perf::Sampler::Type::InstructionPointer |
+                                  perf::Sampler::Type::BranchStack, /// Controls what to include into the sample, see
+                                /// https://man7.org/linux/man-pages/man2/perf_event_open.2.html
+                                perf_config };
+
+  /// Create random access benchmark.
+  auto benchmark = perf::example::AccessBenchmark{ /*randomize the accesses*/ true,
+                                                   /* create benchmark of 512 MB */ 512U };
+
+  /// Start sampling.
+  if (!sampler.start()) {
+    std::cerr << "Could not start sampling, errno = " << sampler.last_error() << "." << std::endl;
+    return 1;
+  }
+
+  /// Execute the benchmark (accessing cache lines in a random order).
+  auto value = 0ULL;
+  for (auto index = 0U; index < benchmark.size(); ++index) {
+    value += branchy_function(benchmark[index]);
+  }
+  asm volatile(""
+               : "+r,m"(value)
+               :
+               : "memory"); /// We do not want the compiler to optimize away
+                            /// this unused value.
+
+  /// Stop sampling.
+  sampler.stop();
+
+  /// Stream the samples into the exporters, without materializing them as a list.
+  auto autofdo_exporter = perf::AutoFDOExporter{};
+  auto bolt_exporter = perf::BOLTExporter{};
+  auto count_samples = 0ULL;
+  sampler.for_each_sample([&autofdo_exporter, &bolt_exporter, &count_samples](perf::Sample&& sample) {
+    autofdo_exporter.add(sample);
+    bolt_exporter.add(sample);
+    ++count_samples;
+  });
+  std::cout << "\nRecorded " << count_samples << " samples." << std::endl;
+
+  /// Write the profiles of this binary.
+  const auto memory_map = perf::MemoryMap::read();
+  const auto* mapping = memory_map.find(reinterpret_cast<std::uintptr_t>(&branchy_function));
+  if (mapping != nullptr) {
+    if (autofdo_exporter.write("profile-export.afdo", mapping->path())) {
+      std::cout << "Wrote AutoFDO profile of '" << mapping->path() << "' to profile-export.afdo." << std::endl;
+    } else {
+      std::cerr << "Could not write profile-export.afdo." << std::endl;
+    }
+
+    if (bolt_exporter.write_fdata("profile-export.fdata", mapping->path())) {
+      std::cout << "Wrote BOLT profile of '" << mapping->path() << "' (" << bolt_exporter.count_branches()
+                << " distinct branches) to profile-export.fdata." << std::endl;
+    } else {
+      std::cerr << "Could not write profile-export.fdata." << std::endl;
+    }
+  }
+
+  /// Close the sampler.
+  /// Note that the sampler can only be closed after reading the samples.
+  sampler.close();
+
+  return 0;
+}
+
+std::uint64_t
+branchy_function(const perf::example::AccessBenchmark::cache_line& cache_line)
+{
+  auto result = cache_line.value;
+
+  for (auto i = 0U; i < 8U; ++i) {
+    if (((cache_line.value >> i) & 1U) == 1U) {
+      result += cache_line.value * (i + 1U);
+    } else if (((cache_line.value >> (i + 8U)) & 1U) == 1U) {
+      result ^= cache_line.value << i;
+    } else {
+      result /= (cache_line.value >> i) | 1U;
+    }
+  }
+
+  return result;
+}
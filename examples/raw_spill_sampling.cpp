@@ -0,0 +1,94 @@
+#include "access_benchmark.h"
+#include <algorithm>
+#include <iostream>
+#include <perfcpp/raw_spill_reader.h>
+#include <perfcpp/raw_spill_writer.h>
+#include <perfcpp/sampler.h>
+#include <stdexcept>
+
+int
+main()
+{
+  std::cout << "libperf-cpp example: Record perf samples including time, thread id, and instruction pointer for "
+               "single-threaded random access to an in-memory array, spill the raw ring buffer into a file, and "
+               "decode the file afterwards."
+            << std::endl;
+
+  /// Initialize counter definitions.
+  /// Note that the perf::CounterDefinition holds all counter names and must be
+  /// alive until the benchmark finishes.
+  auto counter_definitions = perf::CounterDefinition{};
+
+  /// Initialize sampler.
+  auto perf_config = perf::SampleConfig{};
+  perf_config.precise_ip(0U);    /// precise_ip controls the amount of skid, see
+                                 /// https://man7.org/linux/man-pages/man2/perf_event_open.2.html
+  perf_config.period(10000U);    /// Record every 10,000th event.
+  perf_config.buffer_pages(65U); /// Use a small ring buffer (64 pages), which is drained frequently.
+
+  auto sampler = perf::Sampler{ counter_definitions,
+                                "cycles", /// Event that generates an overflow which is samples (here we
+                                          /// sample every 10,000th cycle)
+                                perf::Sampler::Type::InstructionPointer | perf::Sampler::Type::ThreadId |
+                                  perf::Sampler::Type::Time, /// Controls what to include into the sample, see
+                                /// https://man7.org/linux/man-pages/man2/perf_event_open.2.html
+                                perf_config };
+
+  /// Create random access benchmark.
+  auto benchmark = perf::example::AccessBenchmark{ /*randomize the accesses*/ true,
+                                                   /* create benchmark of 512 MB */ 512U };
+
+  /// Start sampling.
+  if (!sampler.start()) {
+    std::cerr << "Could not start sampling, errno = " << sampler.last_error() << "." << std::endl;
+    return 1;
+  }
+
+  {
+    /// The spill writer needs an opened (i.e., started) sampler.
+    auto spill_writer = perf::RawSpillWriter{ "raw-spill-sampling.raw", sampler };
+
+    /// Execute the benchmark (accessing cache lines in a random order) in batches; after every batch, the raw records
+    /// of the ring buffer are spilled into the file.
+    constexpr auto batch_size = std::size_t{ 1U } << 16U;
+    auto value = 0ULL;
+    for (auto batch = std::size_t{ 0U }; batch < benchmark.size(); batch += batch_size) {
+      for (auto index = batch; index < std::min(batch + batch_size, benchmark.size()); ++index) {
+        value += benchmark[index].value;
+      }
+
+      spill_writer.drain();
+    }
+    asm volatile(""
+                 : "+r,m"(value)
+                 :
+                 : "memory"); /// We do not want the compiler to optimize away
+                              /// this unused value.
+
+    /// Stop sampling and drain the remaining records.
+    sampler.stop();
+    if (!spill_writer.close()) {
+      std::cerr << "Could not write raw-spill-sampling.raw." << std::endl;
+    }
+
+    std::cout << "Spilled " << spill_writer.count_bytes() << " bytes into raw-spill-sampling.raw." << std::endl;
+  }
+
+  /// Close the sampler.
+  sampler.close();
+
+  /// Decode the file (which could also happen in a different process).
+  try {
+    const auto reader = perf::RawSpillReader{ "raw-spill-sampling.raw" };
+
+    auto count_samples = 0ULL;
+    reader.for_each_sample([&count_samples](perf::Sample&&) { ++count_samples; });
+
+    std::cout << "Decoded " << count_samples << " samples of '" << reader.counter_names().front()
+              << "' recorded with period " << reader.config().frequency_or_period() << "." << std::endl;
+  } catch (std::runtime_error& exception) {
+    std::cerr << exception.what() << std::endl;
+  }
+
+  return 0;
+}
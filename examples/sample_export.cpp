@@ -0,0 +1,81 @@
+#include "access_benchmark.h"
+#include <iostream>
+#include <perfcpp/sample_writer.h>
+#include <perfcpp/sampler.h>
+#include <stdexcept>
+
+int
+main()
+{
+  std::cout << "libperf-cpp example: Record perf samples including time, instruction pointer, thread id, and counter "
+               "values for single-threaded random access to an in-memory array, and stream them into a CSV and a JSON "
+               "Lines file."
+            << std::endl;
+
+  /// Initialize counter definitions.
+  /// Note that the perf::CounterDefinition holds all counter names and must be
+  /// alive until the benchmark finishes.
+  auto counter_definitions = perf::CounterDefinition{};
+
+  /// Initialize sampler.
+  auto perf_config = perf::SampleConfig{};
+  perf_config.precise_ip(0U); /// precise_ip controls the amount of skid, see
+                              /// https://man7.org/linux/man-pages/man2/perf_event_open.2.html
+  perf_config.period(50000U); /// Record every 50,000th event.
+
+  auto sampler = perf::Sampler{ counter_definitions,
+                                std::vector<std::string>{ "cycles", "instructions" }, /// Sample every 50,000th cycle
+                                                                                      /// and read the instructions.
+                                perf::Sampler::Type::Time | perf::Sampler::Type::InstructionPointer |
+                                  perf::Sampler::Type::ThreadId | perf::Sampler::Type::CounterValues,
+                                perf_config };
+
+  /// Create random access benchmark.
+  auto benchmark = perf::example::AccessBenchmark{ /*randomize the accesses*/ true,
+                                                   /* create benchmark of 512 MB */ 512U };
+
+  /// Start sampling.
+  if (!sampler.start()) {
+    std::cerr << "Could not start sampling, errno = " << sampler.last_error() << "." << std::endl;
+    return 1;
+  }
+
+  /// Execute the benchmark (accessing cache lines in a random order).
+  auto value = 0ULL;
+  for (auto index = 0U; index < benchmark.size(); ++index) {
+    value += benchmark[index].value;
+  }
+  asm volatile(""
+               : "+r,m"(value)
+               :
+               : "memory"); /// We do not want the compiler to optimize away
+                            /// this unused value.
+
+  /// Stop sampling.
+  sampler.stop();
+
+  /// Stream the samples into the files; samples are decoded one by one and never collected into a list.
+  try {
+    auto csv_writer = perf::SampleWriter{ "samples.csv", sampler };
+    auto json_writer = perf::SampleWriter{ "samples.jsonl", sampler, perf::SampleWriter::Format::JSON };
+
+    sampler.for_each_sample([&csv_writer, &json_writer](perf::Sample&& sample) {
+      csv_writer.write(sample);
+      json_writer.write(sample);
+    });
+
+    if (csv_writer.close() && json_writer.close()) {
+      std::cout << "Wrote " << csv_writer.count_samples() << " samples into samples.csv and samples.jsonl."
+                << std::endl;
+    } else {
+      std::cerr << "Could not write samples.csv or samples.jsonl." << std::endl;
+    }
+  } catch (std::runtime_error& exception) {
+    std::cerr << exception.what() << std::endl;
+  }
+
+  /// Close the sampler.
+  sampler.close();
+
+  return 0;
+}
@@ -0,0 +1,92 @@
+#include "access_benchmark.h"
+#include <iostream>
+#include <perfcpp/sample_file_reader.h>
+#include <perfcpp/sample_file_writer.h>
+#include <perfcpp/sampler.h>
+#include <stdexcept>
+
+int
+main()
+{
+  std::cout << "libperf-cpp example: Record perf samples including time, thread id, instruction pointer, and callchain "
+               "for single-threaded random access to an in-memory array, store them into a compact sample file, and "
+               "read a time range back."
+            << std::endl;
+
+  /// Initialize counter definitions.
+  /// Note that the perf::CounterDefinition holds all counter names and must be
+  /// alive until the benchmark finishes.
+  auto counter_definitions = perf::CounterDefinition{};
+
+  /// Initialize sampler.
+  auto perf_config = perf::SampleConfig{};
+  perf_config.precise_ip(0U);  /// precise_ip controls the amount of skid, see
+                               /// https://man7.org/linux/man-pages/man2/perf_event_open.2.html
+  perf_config.period(100000U); /// Record every 100,000th event.
+
+  auto sampler = perf::Sampler{ counter_definitions,
+                                "cycles", /// Event that generates an overflow which is samples (here we
+                                          /// sample every 100,000th cycle)
+                                perf::Sampler::Type::InstructionPointer | perf::Sampler::Type::ThreadId |
+                                  perf::Sampler::Type::Time | perf::Sampler::Type::CPU |
+                                  perf::Sampler::Type::Callchain, /// Controls what to include into the sample, see
+                                /// https://man7.org/linux/man-pages/man2/perf_event_open.2.html
+                                perf_config };
+
+  /// Create random access benchmark.
+  auto benchmark = perf::example::AccessBenchmark{ /*randomize the accesses*/ true,
+                                                   /* create benchmark of 512 MB */ 512U };
+
+  /// Start sampling.
+  if (!sampler.start()) {
+    std::cerr << "Could not start sampling, errno = " << sampler.last_error() << "." << std::endl;
+    return 1;
+  }
+
+  /// Execute the benchmark (accessing cache lines in a random order).
+  auto value = 0ULL;
+  for (auto index = 0U; index < benchmark.size(); ++index) {
+    value += benchmark[index].value;
+  }
+  asm volatile(""
+               : "+r,m"(value)
+               :
+               : "memory"); /// We do not want the compiler to optimize away
+                            /// this unused value.
+
+  /// Stop sampling.
+  sampler.stop();
+
+  /// Write the samples one by one into the sample file (without holding them in memory).
+  auto writer = perf::SampleFileWriter{ "sample-file.samples" };
+  sampler.for_each_sample([&writer](perf::Sample&& sample) { writer.add(sample); });
+  if (!writer.close()) {
+    std::cerr << "Could not write sample-file.samples." << std::endl;
+    return 1;
+  }
+  std::cout << "Wrote " << writer.count_samples() << " samples to sample-file.samples." << std::endl;
+
+  /// Close the sampler.
+  sampler.close();
+
+  /// Read the samples of the first millisecond back; chunks outside that range are not decoded.
+  try {
+    const auto reader = perf::SampleFileReader{ "sample-file.samples" };
+    if (reader.chunks().empty()) {
+      return 0;
+    }
+
+    const auto begin = reader.chunks().front().min_time;
+    auto filter = perf::SampleFileFilter{};
+    filter.time(begin, begin + 1000000U);
+
+    const auto samples = reader.result(filter);
+    std::cout << "Read " << samples.size() << " of " << reader.count_samples()
+              << " samples recorded in the first millisecond (" << reader.count_stacks() << " distinct callchains)."
+              << std::endl;
+  } catch (std::runtime_error& exception) {
+    std::cerr << exception.what() << std::endl;
+  }
+
+  return 0;
+}
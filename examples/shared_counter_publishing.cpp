@@ -0,0 +1,70 @@
+#include "access_benchmark.h"
+#include <chrono>
+#include <iostream>
+#include <perfcpp/event_counter.h>
+#include <perfcpp/shared_counter_publisher.h>
+
+int
+main()
+{
+  std::cout << "libperf-cpp example: Publish the live counters of a random access to an in-memory array into shared "
+               "memory, where other processes can monitor them while the benchmark is running."
+            << std::endl;
+
+  /// Initialize performance counters.
+  /// Note that the perf::CounterDefinition holds all counter names and must be
+  /// alive until the benchmark finishes.
+  auto counter_definitions = perf::CounterDefinition{};
+  auto event_counter = perf::EventCounter{ counter_definitions };
+
+  /// Add all the performance counters (and metrics) we want to publish.
+  if (!event_counter.add(
+        std::vector<std::string>{ "instructions", "cycles", "cache-misses", "cycles-per-instruction" })) {
+    std::cerr << "Could not add performance counters." << std::endl;
+  }
+
+  /// Create random access benchmark.
+  auto benchmark = perf::example::AccessBenchmark{ /*randomize the accesses*/ true,
+                                                   /* create benchmark of 256 MB */ 256U };
+
+  /// Create the shared-memory table that monitors attach to by its name.
+  auto publisher = perf::SharedCounterPublisher{ "access-benchmark" };
+
+  /// Start recording and publish the live values every 100ms.
+  if (!event_counter.start()) {
+    std::cerr << "Could not start performance counters." << std::endl;
+    return 1;
+  }
+  if (!publisher.start(event_counter, std::chrono::milliseconds{ 100U })) {
+    std::cerr << "Could not start publishing." << std::endl;
+    return 1;
+  }
+  std::cout << "Monitor the counters for the next 30 seconds via: ./tools/bin/perf-monitor access-benchmark"
+            << std::endl;
+
+  /// Execute the benchmark repeatedly.
+  auto value = 0ULL;
+  const auto end = std::chrono::steady_clock::now() + std::chrono::seconds{ 30U };
+  while (std::chrono::steady_clock::now() < end) {
+    for (auto index = 0U; index < benchmark.size(); ++index) {
+      value += benchmark[index].value;
+    }
+  }
+
+  /// Stop publishing before stopping the counters.
+  publisher.stop();
+  event_counter.stop();
+
+  /// Add up the results so that the compiler does not get the idea of optimizing away the accesses.
+  asm volatile("" : "+r,m"(value) : : "memory");
+
+  /// Values can also be published explicitly, e.g., at the end of a region.
+  publisher.publish(event_counter.result());
+
+  std::cout << "Published " << publisher.count_updates() << " updates. Final values:\n" << std::endl;
+  for (const auto& [counter_name, counter_value] : event_counter.result()) {
+    std::cout << counter_value << " " << counter_name << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "hash.h"
+#include "memory_map.h"
+#include "sample.h"
+#include "symbol_resolver.h"
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace perf {
+/**
+ * Aggregates sampled branch stacks (see Sampler::Type::BranchStack) into per-binary range, address, and branch
+ * counts and writes them in the text format of AutoFDO (read by, e.g., create_gcov and create_llvm_prof with
+ * --profiler=text), which compilers use for sample-based profile-guided optimization.
+ *
+ * Samples are added one by one (e.g., via Sampler::for_each_sample()); only the aggregated counts are kept in memory,
+ * which are bounded by the number of distinct addresses, not by the number of samples.
+ * Addresses are translated into the addresses of the binaries as linked (using the memory map of the process and the
+ * program headers of the binaries), such that the profile is independent of the address space layout.
+ */
+class AutoFDOExporter
+{
+public:
+  /**
+   * Creates the exporter.
+   *
+   * @param memory_map Memory map used to attribute addresses to binaries; must be read while the profiled binaries
+   * are still loaded.
+   */
+  explicit AutoFDOExporter(MemoryMap memory_map = MemoryMap::read())
+    : _symbol_resolver(std::move(memory_map), /* AutoFDO resolves symbols itself */ false)
+  {
+  }
+
+  ~AutoFDOExporter() = default;
+
+  /**
+   * Adds the branch stack (and the instruction pointer, if sampled) of a single sample to the profile; context
+   * switches are skipped.
+   *
+   * @param sample Sample to add.
+   */
+  void add(const Sample& sample);
+
+  /**
+   * Adds the branch stacks of all samples to the profile.
+   *
+   * @param samples List of samples.
+   */
+  void add(const std::vector<Sample>& samples)
+  {
+    for (const auto& sample : samples) {
+      add(sample);
+    }
+  }
+
+  /**
+   * @return Paths of all binaries with sampled ranges, addresses, or branches.
+   */
+  [[nodiscard]] std::vector<std::string> binaries() const;
+
+  /**
+   * Writes the profile of a single binary in AutoFDO's text format: the number of ranges followed by
+   * "begin-end:count" lines, the number of addresses followed by "address:count" lines, and the number of branches
+   * followed by "from->to:count" lines (addresses in hexadecimal).
+   *
+   * @param stream Stream to write the profile to.
+   * @param binary Path of the binary (see binaries()).
+   */
+  void write(std::ostream& stream, const std::string& binary) const;
+
+  /**
+   * Writes the profile of a single binary in AutoFDO's text format to a file.
+   *
+   * @param file_name Name of the file.
+   * @param binary Path of the binary (see binaries()).
+   * @return True, if the file was written.
+   */
+  [[nodiscard]] bool write(const std::string& file_name, const std::string& binary) const;
+
+private:
+  /// Aggregated counts of a single binary (addresses of the binary as linked).
+  struct binary_profile
+  {
+    std::unordered_map<std::pair<std::uintptr_t, std::uintptr_t>, std::uint64_t, instruction_pointer_pair_hash>
+      ranges;
+    std::unordered_map<std::uintptr_t, std::uint64_t> addresses;
+    std::unordered_map<std::pair<std::uintptr_t, std::uintptr_t>, std::uint64_t, instruction_pointer_pair_hash>
+      branches;
+  };
+
+  /// Translates sampled addresses into addresses of the binaries as linked.
+  SymbolResolver _symbol_resolver;
+
+  /// Profiles, by path of the binary.
+  std::unordered_map<std::string, binary_profile> _profiles;
+};
+}
@@ -0,0 +1,304 @@
+#pragma once
+
+#include "benchmark.h"
+#include "config.h"
+#include "counter_definition.h"
+#include "system_info.h"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace perf {
+/**
+ * A single configuration of a parameterized kernel, i.e., one value per parameter.
+ */
+class TuningConfiguration
+{
+public:
+  using const_iterator = std::vector<std::pair<std::string, std::int64_t>>::const_iterator;
+
+  TuningConfiguration() = default;
+  explicit TuningConfiguration(std::vector<std::pair<std::string, std::int64_t>>&& values) noexcept
+    : _values(std::move(values))
+  {
+  }
+
+  ~TuningConfiguration() = default;
+
+  /**
+   * Access the value of the parameter with the given name.
+   *
+   * @param name Name of the parameter.
+   * @return The value, or std::nullopt if the configuration does not contain the parameter.
+   */
+  [[nodiscard]] std::optional<std::int64_t> get(std::string_view name) const noexcept;
+
+  /**
+   * Access the value of the parameter with the given name, e.g., to fall back to a default if no tuned
+   * configuration was found.
+   *
+   * @param name Name of the parameter.
+   * @param default_value Value if the configuration does not contain the parameter.
+   * @return The value of the parameter or the default value.
+   */
+  [[nodiscard]] std::int64_t get(const std::string_view name, const std::int64_t default_value) const noexcept
+  {
+    return get(name).value_or(default_value);
+  }
+
+  [[nodiscard]] bool empty() const noexcept { return _values.empty(); }
+  [[nodiscard]] std::size_t size() const noexcept { return _values.size(); }
+
+  [[nodiscard]] const_iterator begin() const { return _values.begin(); }
+  [[nodiscard]] const_iterator end() const { return _values.end(); }
+
+  /**
+   * @return The configuration formatted as "name=value,name=value".
+   */
+  [[nodiscard]] std::string to_string() const;
+
+  /**
+   * Parses a configuration formatted as "name=value,name=value" (see to_string()).
+   *
+   * @param configuration Formatted configuration.
+   * @return The configuration, or std::nullopt if the format is invalid.
+   */
+  [[nodiscard]] static std::optional<TuningConfiguration> from_string(std::string_view configuration);
+
+private:
+  std::vector<std::pair<std::string, std::int64_t>> _values;
+};
+
+/**
+ * Evaluated configuration: the objective (normalized per iteration) over all recorded runs and the number of
+ * successive-halving rounds the configuration survived.
+ */
+class TuningCandidate
+{
+public:
+  TuningCandidate(TuningConfiguration configuration, Statistics objective, const std::uint32_t rounds) noexcept
+    : _configuration(std::move(configuration))
+    , _objective(objective)
+    , _rounds(rounds)
+  {
+  }
+
+  ~TuningCandidate() = default;
+
+  [[nodiscard]] const TuningConfiguration& configuration() const noexcept { return _configuration; }
+  [[nodiscard]] const Statistics& objective() const noexcept { return _objective; }
+  [[nodiscard]] std::uint32_t rounds() const noexcept { return _rounds; }
+
+private:
+  TuningConfiguration _configuration;
+  Statistics _objective;
+  std::uint32_t _rounds;
+};
+
+/**
+ * Result of the autotuner: all evaluated configurations, ordered from best to worst (configurations surviving more
+ * rounds first, then by the median of the objective).
+ */
+class TuningResult
+{
+public:
+  using const_iterator = std::vector<TuningCandidate>::const_iterator;
+
+  TuningResult() = default;
+  TuningResult(std::string objective, std::vector<TuningCandidate>&& candidates) noexcept
+    : _objective(std::move(objective))
+    , _candidates(std::move(candidates))
+  {
+  }
+
+  ~TuningResult() = default;
+
+  /**
+   * @return The best configuration, or std::nullopt if no configuration was evaluated.
+   */
+  [[nodiscard]] std::optional<TuningCandidate> best() const
+  {
+    return !_candidates.empty() ? std::make_optional(_candidates.front()) : std::nullopt;
+  }
+
+  [[nodiscard]] const std::string& objective() const noexcept { return _objective; }
+
+  [[nodiscard]] std::size_t size() const noexcept { return _candidates.size(); }
+  [[nodiscard]] const_iterator begin() const { return _candidates.begin(); }
+  [[nodiscard]] const_iterator end() const { return _candidates.end(); }
+
+  /**
+   * @return Table of all evaluated configurations, one row per configuration.
+   */
+  [[nodiscard]] std::string to_string() const;
+
+private:
+  std::string _objective;
+  std::vector<TuningCandidate> _candidates;
+};
+
+/**
+ * Autotuner for parameterized kernels: evaluates the configurations of a parameter space by recording a counter or
+ * metric (the objective) around the kernel, and prunes bad configurations early using successive halving.
+ *
+ * In the first round, every configuration is recorded for a small number of repetitions; after each round, only the
+ * best 1/reduction factor of the configurations survive and are recorded for reduction factor-times as many
+ * repetitions in the next round (values of earlier rounds are kept). Tuning ends when a single configuration is left.
+ */
+class Autotuner
+{
+public:
+  /**
+   * Creates the autotuner.
+   *
+   * @param counter_definitions Definitions of counters and metrics; must be alive until tuning finishes.
+   * @param config Configuration of the counters.
+   */
+  explicit Autotuner(const CounterDefinition& counter_definitions, Config config = {})
+    : _counter_definitions(counter_definitions)
+    , _config(config)
+  {
+  }
+
+  ~Autotuner() = default;
+
+  /**
+   * Adds a parameter to the parameter space; the space consists of all combinations of all parameter values.
+   *
+   * @param name Name of the parameter.
+   * @param values Values of the parameter to evaluate.
+   * @return True, if the parameter was added (the name is unique and values are given).
+   */
+  bool add(std::string name, std::vector<std::int64_t> values);
+
+  /**
+   * Restricts the parameter space to configurations satisfying the constraint (e.g., the block size must not exceed
+   * the data size).
+   *
+   * @param constraint Callable that returns true for valid configurations.
+   */
+  void constraint(std::function<bool(const TuningConfiguration&)> constraint) { _constraint = std::move(constraint); }
+
+  /**
+   * Sets the counter or metric to optimize, e.g., "cycles" with the number of elements as normalization to optimize
+   * for cycles per element.
+   *
+   * @param name Name of the counter or metric.
+   * @param is_maximize True, if the objective should be maximized instead of minimized.
+   * @return True, if the counter or metric exists.
+   */
+  bool objective(std::string name, bool is_maximize = false);
+
+  /**
+   * Sets the number of (unrecorded) runs of the kernel before recording a configuration in every round.
+   *
+   * @param warm_up Number of warm-up runs.
+   */
+  void warm_up(const std::uint32_t warm_up) noexcept { _warm_up = warm_up; }
+
+  /**
+   * Sets the number of recorded repetitions per configuration in the first round.
+   *
+   * @param repetitions Number of repetitions.
+   */
+  void repetitions(const std::uint32_t repetitions) noexcept { _repetitions = std::max(repetitions, 1U); }
+
+  /**
+   * Sets the factor by which the configurations are reduced (and the repetitions are increased) per round.
+   *
+   * @param reduction_factor Reduction factor, at least 2.
+   */
+  void reduction_factor(const std::uint32_t reduction_factor) noexcept
+  {
+    _reduction_factor = std::max(reduction_factor, 2U);
+  }
+
+  [[nodiscard]] std::uint32_t warm_up() const noexcept { return _warm_up; }
+  [[nodiscard]] std::uint32_t repetitions() const noexcept { return _repetitions; }
+  [[nodiscard]] std::uint32_t reduction_factor() const noexcept { return _reduction_factor; }
+
+  /**
+   * @return All configurations of the parameter space that satisfy the constraint.
+   */
+  [[nodiscard]] std::vector<TuningConfiguration> configurations() const;
+
+  /**
+   * Evaluates the parameter space.
+   * Throws a std::runtime_error if no objective is set or the counters cannot be started.
+   *
+   * @param callable Kernel that runs with the given configuration.
+   * @param normalization Number of iterations the kernel executes per run; the objective is normalized by it.
+   * @return All evaluated configurations, best first.
+   */
+  [[nodiscard]] TuningResult run(const std::function<void(const TuningConfiguration&)>& callable,
+                                 std::uint64_t normalization = 1U);
+
+private:
+  const CounterDefinition& _counter_definitions;
+  Config _config;
+
+  std::vector<std::pair<std::string, std::vector<std::int64_t>>> _parameters;
+  std::function<bool(const TuningConfiguration&)> _constraint;
+
+  std::string _objective;
+  bool _is_maximize{ false };
+
+  std::uint32_t _warm_up{ 1U };
+  std::uint32_t _repetitions{ 3U };
+  std::uint32_t _reduction_factor{ 2U };
+};
+
+/**
+ * Stores tuned configurations of kernels in a file, keyed by the CPU model, such that applications can load the
+ * configuration tuned for the machine they are running on at startup.
+ * The file holds one line per CPU model and kernel: "<CPU model>\t<kernel>\t<configuration>".
+ */
+class TuningStore
+{
+public:
+  explicit TuningStore(std::string file_name)
+    : _file_name(std::move(file_name))
+  {
+  }
+
+  ~TuningStore() = default;
+
+  /**
+   * Stores the configuration of the kernel for the given CPU model, replacing a configuration stored before.
+   *
+   * @param kernel_name Name of the kernel.
+   * @param configuration Configuration to store.
+   * @param cpu_model CPU model, default: the model of this machine.
+   * @return True, if the configuration could be written.
+   */
+  bool save(std::string_view kernel_name,
+            const TuningConfiguration& configuration,
+            const std::string& cpu_model = SystemInfo::cpu_model()) const;
+
+  /**
+   * Loads the configuration of the kernel for the given CPU model.
+   *
+   * @param kernel_name Name of the kernel.
+   * @param cpu_model CPU model, default: the model of this machine.
+   * @return The stored configuration, or std::nullopt if none was stored for the kernel and CPU model.
+   */
+  [[nodiscard]] std::optional<TuningConfiguration> load(
+    std::string_view kernel_name,
+    const std::string& cpu_model = SystemInfo::cpu_model()) const;
+
+private:
+  std::string _file_name;
+
+  /**
+   * Reads all entries (CPU model, kernel, and configuration) of the file.
+   */
+  [[nodiscard]] std::vector<std::array<std::string, 3U>> read() const;
+};
+}
@@ -0,0 +1,213 @@
+#pragma once
+
+#include "config.h"
+#include "counter.h"
+#include "counter_definition.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace perf {
+/**
+ * Statistics over the values of a counter (or metric) recorded in multiple repetitions.
+ */
+class Statistics
+{
+public:
+  Statistics() noexcept = default;
+
+  /**
+   * Calculates the statistics of the given values.
+   *
+   * @param values Values of all repetitions.
+   */
+  explicit Statistics(std::vector<double> values);
+
+  ~Statistics() noexcept = default;
+
+  [[nodiscard]] double mean() const noexcept { return _mean; }
+  [[nodiscard]] double median() const noexcept { return _median; }
+
+  /**
+   * @return Sample standard deviation (0 for less than two values).
+   */
+  [[nodiscard]] double stddev() const noexcept { return _stddev; }
+  [[nodiscard]] double min() const noexcept { return _min; }
+  [[nodiscard]] double max() const noexcept { return _max; }
+
+  /**
+   * @return Number of values.
+   */
+  [[nodiscard]] std::size_t count() const noexcept { return _count; }
+
+private:
+  double _mean{ .0 };
+  double _median{ .0 };
+  double _stddev{ .0 };
+  double _min{ .0 };
+  double _max{ .0 };
+  std::size_t _count{ 0U };
+};
+
+/**
+ * Result of a benchmark: statistics of every counter and metric (normalized per iteration) and of the time.
+ */
+class BenchmarkResult
+{
+public:
+  using const_iterator = std::vector<std::pair<std::string_view, Statistics>>::const_iterator;
+
+  BenchmarkResult() = default;
+  BenchmarkResult(std::vector<std::pair<std::string_view, Statistics>>&& statistics, Statistics time) noexcept
+    : _statistics(std::move(statistics))
+    , _time(time)
+  {
+  }
+
+  ~BenchmarkResult() = default;
+
+  /**
+   * Access the statistics of the counter or metric with the given name.
+   *
+   * @param name Name of the counter or metric.
+   * @return The statistics, or std::nullopt if the counter or metric was not recorded.
+   */
+  [[nodiscard]] std::optional<Statistics> get(std::string_view name) const noexcept;
+
+  /**
+   * @return Statistics of the wall-clock time (in nanoseconds, normalized per iteration) over all repetitions.
+   */
+  [[nodiscard]] const Statistics& time() const noexcept { return _time; }
+
+  /**
+   * @return Mean of every counter and metric, e.g., to print them via CounterResult::to_csv().
+   */
+  [[nodiscard]] CounterResult mean() const;
+
+  /**
+   * @return Median of every counter and metric.
+   */
+  [[nodiscard]] CounterResult median() const;
+
+  [[nodiscard]] const_iterator begin() const { return _statistics.begin(); }
+  [[nodiscard]] const_iterator end() const { return _statistics.end(); }
+
+  /**
+   * @return Table of all statistics, one row per counter and metric.
+   */
+  [[nodiscard]] std::string to_string() const;
+
+private:
+  std::vector<std::pair<std::string_view, Statistics>> _statistics;
+  Statistics _time;
+};
+
+/**
+ * Harness to benchmark a callable: runs the callable for warm-up, and then repeatedly while recording counters.
+ *
+ * Counters and metrics are distributed into sets that fit into a single group of hardware counters (see
+ * Config::max_counters_per_group()); the sets are rotated across repetitions (every set is recorded in every
+ * repetition, one run per set), such that more events than the hardware can count at once are recorded without
+ * multiplexing.
+ * Values are normalized per iteration of the callable (the normalization given to run()) and aggregated into
+ * mean, median, standard deviation, minimum, and maximum over all repetitions.
+ */
+class Benchmark
+{
+public:
+  /**
+   * Creates the benchmark.
+   *
+   * @param counter_definitions Definitions of counters and metrics; must be alive until the benchmark finishes.
+   * @param config Configuration of the counters.
+   */
+  explicit Benchmark(const CounterDefinition& counter_definitions, Config config = {})
+    : _counter_definitions(counter_definitions)
+    , _config(config)
+  {
+  }
+
+  ~Benchmark() = default;
+
+  /**
+   * Adds the specified counter (or metric) to the recorded counters.
+   * The counter must exist within the counter definitions; all counters required by a metric must fit into a single
+   * group.
+   *
+   * @param counter_name Name of the counter or metric.
+   * @return True, if the counter could be added.
+   */
+  bool add(const std::string& counter_name);
+
+  /**
+   * Adds the specified counters (or metrics) to the recorded counters.
+   *
+   * @param counter_names List of names of the counters or metrics.
+   * @return True, if all counters could be added.
+   */
+  bool add(const std::vector<std::string>& counter_names);
+
+  /**
+   * Sets the number of (unrecorded) runs of the callable before recording.
+   *
+   * @param warm_up Number of warm-up runs.
+   */
+  void warm_up(const std::uint32_t warm_up) noexcept { _warm_up = warm_up; }
+
+  /**
+   * Sets the number of recorded repetitions; each repetition runs the callable once per set of counters.
+   *
+   * @param repetitions Number of repetitions.
+   */
+  void repetitions(const std::uint32_t repetitions) noexcept { _repetitions = repetitions; }
+
+  [[nodiscard]] std::uint32_t warm_up() const noexcept { return _warm_up; }
+  [[nodiscard]] std::uint32_t repetitions() const noexcept { return _repetitions; }
+
+  /**
+   * @return Number of counter sets, i.e., the number of runs of the callable per repetition.
+   */
+  [[nodiscard]] std::size_t count_counter_sets() const noexcept
+  {
+    return std::max(_counter_sets.size(), std::size_t{ 1U });
+  }
+
+  /**
+   * Runs the callable for warm-up and all repetitions, recording the counters.
+   * Throws a std::runtime_error if the counters cannot be started.
+   *
+   * @param callable Code to benchmark.
+   * @param normalization Number of iterations the callable executes per run; all values are normalized by it.
+   * @return Statistics of all counters and metrics.
+   */
+  [[nodiscard]] BenchmarkResult run(const std::function<void()>& callable, std::uint64_t normalization = 1U);
+
+private:
+  /**
+   * Counters and metrics that are recorded together in a single group.
+   */
+  struct counter_set
+  {
+    /// Names of the requested counters and metrics.
+    std::vector<std::string> names;
+
+    /// (Hardware) counters needed to record the names.
+    std::vector<std::string_view> counters;
+  };
+
+  const CounterDefinition& _counter_definitions;
+  Config _config;
+
+  std::uint32_t _warm_up{ 1U };
+  std::uint32_t _repetitions{ 10U };
+
+  /// Sets of counters, rotated across repetitions.
+  std::vector<counter_set> _counter_sets;
+};
+}
@@ -0,0 +1,139 @@
+#pragma once
+
+#include "hash.h"
+#include "memory_map.h"
+#include "sample.h"
+#include "symbol_resolver.h"
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace perf {
+/**
+ * Aggregates sampled branch stacks (see Sampler::Type::BranchStack) into branch and fall-through counts for the
+ * post-link optimizer BOLT.
+ *
+ * Branches are aggregated by their sampled (from, to) addresses in a hash map; addresses are translated into binaries
+ * and function symbols only when writing the profile, once per distinct branch.
+ * Two formats are supported:
+ *  - write_fdata() writes BOLT's fdata format ("1 <symbol> <offset> 1 <symbol> <offset> <mispredicted> <count>"),
+ *    which llvm-bolt reads via -data; fdata only holds taken branches.
+ *  - write_preaggregated() writes BOLT's pre-aggregated format ("B <from> <to> <count> <mispredicted>" and
+ *    "F <begin> <end> <count>" for fall-throughs), which perf2bolt converts into fdata via --pa, attributing
+ *    fall-throughs using the control flow graph of the binary.
+ */
+class BOLTExporter
+{
+public:
+  /**
+   * Creates the exporter.
+   *
+   * @param memory_map Memory map used to attribute addresses to binaries; must be read while the profiled binaries
+   * are still loaded.
+   */
+  explicit BOLTExporter(MemoryMap memory_map = MemoryMap::read())
+    : _symbol_resolver(std::move(memory_map))
+  {
+  }
+
+  ~BOLTExporter() = default;
+
+  /**
+   * Adds the branch stack of a single sample to the profile; context switches are skipped.
+   *
+   * @param sample Sample to add.
+   */
+  void add(const Sample& sample);
+
+  /**
+   * Adds the branch stacks of all samples to the profile.
+   *
+   * @param samples List of samples.
+   */
+  void add(const std::vector<Sample>& samples)
+  {
+    for (const auto& sample : samples) {
+      add(sample);
+    }
+  }
+
+  /**
+   * @return Number of distinct sampled (from, to) branches.
+   */
+  [[nodiscard]] std::size_t count_branches() const noexcept { return _branches.size(); }
+
+  /**
+   * @return Paths of all binaries with sampled branches.
+   */
+  [[nodiscard]] std::vector<std::string> binaries() const;
+
+  /**
+   * Writes the branches from or to the given binary in BOLT's fdata format.
+   * Addresses are described by function symbol and offset; addresses without symbol (or outside the binary) are
+   * written as "0 [unknown] <address>".
+   *
+   * @param stream Stream to write the profile to.
+   * @param binary Path of the binary (see binaries()).
+   */
+  void write_fdata(std::ostream& stream, const std::string& binary) const;
+
+  /**
+   * Writes the branches from or to the given binary in BOLT's fdata format to a file.
+   *
+   * @param file_name Name of the file.
+   * @param binary Path of the binary (see binaries()).
+   * @return True, if the file was written.
+   */
+  [[nodiscard]] bool write_fdata(const std::string& file_name, const std::string& binary) const;
+
+  /**
+   * Writes the branches and fall-throughs within the given binary in BOLT's pre-aggregated format, addresses are
+   * hexadecimal addresses of the binary as linked.
+   *
+   * @param stream Stream to write the profile to.
+   * @param binary Path of the binary (see binaries()).
+   */
+  void write_preaggregated(std::ostream& stream, const std::string& binary) const;
+
+  /**
+   * Writes the branches and fall-throughs within the given binary in BOLT's pre-aggregated format to a file.
+   *
+   * @param file_name Name of the file.
+   * @param binary Path of the binary (see binaries()).
+   * @return True, if the file was written.
+   */
+  [[nodiscard]] bool write_preaggregated(const std::string& file_name, const std::string& binary) const;
+
+private:
+  struct branch_counter
+  {
+    std::uint64_t count{ 0U };
+    std::uint64_t count_mispredicted{ 0U };
+  };
+
+  /// Translates addresses and resolves symbols when writing; caches the read binaries.
+  mutable SymbolResolver _symbol_resolver;
+
+  /// Taken branches, by sampled (from, to) addresses.
+  std::unordered_map<std::pair<std::uintptr_t, std::uintptr_t>, branch_counter, instruction_pointer_pair_hash>
+    _branches;
+
+  /// Fall-throughs (straight-line ranges between two consecutive branches), by sampled (begin, end) addresses.
+  std::unordered_map<std::pair<std::uintptr_t, std::uintptr_t>, std::uint64_t, instruction_pointer_pair_hash>
+    _fall_throughs;
+
+  /**
+   * Formats an address as fdata location ("<is symbol> <name> <offset>").
+   *
+   * @param address Translated address, std::nullopt if the address does not belong to a binary.
+   * @param binary Path of the binary the profile is written for.
+   * @return Location in fdata format.
+   */
+  [[nodiscard]] std::string fdata_location(const std::optional<BinaryAddress>& address,
+                                           const std::string& binary) const;
+};
+}
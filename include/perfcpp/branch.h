@@ -19,6 +19,8 @@ enum BranchType : std::uint64_t
   Conditional = PERF_SAMPLE_BRANCH_COND,
   TransactionalMemoryAbort = PERF_SAMPLE_BRANCH_ABORT_TX,
   InTransaction = PERF_SAMPLE_BRANCH_IN_TX,
-  NotInTransaction = PERF_SAMPLE_BRANCH_NO_TX
+  NotInTransaction = PERF_SAMPLE_BRANCH_NO_TX,
+
+  TypeSave = PERF_SAMPLE_BRANCH_TYPE_SAVE
 };
 }
\ No newline at end of file
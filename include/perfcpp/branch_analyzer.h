@@ -0,0 +1,199 @@
+#pragma once
+
+#include "sample.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace perf {
+/**
+ * Straight-line range of instructions, executed between two consecutive branches of a branch stack.
+ */
+class ExecutedRange
+{
+public:
+  ExecutedRange(const std::uintptr_t begin,
+                const std::uintptr_t end,
+                const std::uint64_t count,
+                const std::uint64_t count_with_cycles,
+                const std::uint64_t cycles)
+    : _begin(begin)
+    , _end(end)
+    , _count(count)
+    , _count_with_cycles(count_with_cycles)
+    , _cycles(cycles)
+  {
+  }
+
+  ~ExecutedRange() = default;
+
+  /**
+   * @return Address of the first instruction of the range (target of the previous branch).
+   */
+  [[nodiscard]] std::uintptr_t begin() const noexcept { return _begin; }
+
+  /**
+   * @return Address of the last instruction of the range (source of the next branch).
+   */
+  [[nodiscard]] std::uintptr_t end() const noexcept { return _end; }
+
+  /**
+   * @return Number of times the range was executed within all sampled branch stacks.
+   */
+  [[nodiscard]] std::uint64_t count() const noexcept { return _count; }
+
+  /**
+   * @return Average cycles to execute the range, or 0 if the hardware does not report cycles.
+   */
+  [[nodiscard]] double average_cycles() const noexcept
+  {
+    return _count_with_cycles > 0U ? double(_cycles) / double(_count_with_cycles) : .0;
+  }
+
+private:
+  std::uintptr_t _begin;
+  std::uintptr_t _end;
+  std::uint64_t _count;
+  std::uint64_t _count_with_cycles;
+  std::uint64_t _cycles;
+};
+
+/**
+ * Aggregated statistics of one branch (identified by source and target).
+ */
+class BranchStatistics
+{
+public:
+  BranchStatistics(const std::uintptr_t instruction_pointer_from,
+                   const std::uintptr_t instruction_pointer_to,
+                   const std::uint64_t count,
+                   const std::uint64_t count_mispredicted,
+                   const double estimated_cost,
+                   const bool is_cost_measured)
+    : _instruction_pointer_from(instruction_pointer_from)
+    , _instruction_pointer_to(instruction_pointer_to)
+    , _count(count)
+    , _count_mispredicted(count_mispredicted)
+    , _estimated_cost(estimated_cost)
+    , _is_cost_measured(is_cost_measured)
+  {
+  }
+
+  ~BranchStatistics() = default;
+
+  [[nodiscard]] std::uintptr_t instruction_pointer_from() const noexcept { return _instruction_pointer_from; }
+  [[nodiscard]] std::uintptr_t instruction_pointer_to() const noexcept { return _instruction_pointer_to; }
+
+  /**
+   * @return Number of times the branch was taken within all sampled branch stacks.
+   */
+  [[nodiscard]] std::uint64_t count() const noexcept { return _count; }
+
+  /**
+   * @return Number of times the branch was mispredicted within all sampled branch stacks.
+   */
+  [[nodiscard]] std::uint64_t count_mispredicted() const noexcept { return _count_mispredicted; }
+
+  [[nodiscard]] double misprediction_ratio() const noexcept
+  {
+    return _count > 0U ? double(_count_mispredicted) / double(_count) : .0;
+  }
+
+  /**
+   * @return Estimated cycles lost by mispredictions of that branch.
+   */
+  [[nodiscard]] double estimated_cost() const noexcept { return _estimated_cost; }
+
+  /**
+   * @return True, if the cost was measured from the sampled cycles (see Branch::cycles()); false, if it was estimated
+   * from the constant misprediction penalty of the analyzer.
+   */
+  [[nodiscard]] bool is_cost_measured() const noexcept { return _is_cost_measured; }
+
+private:
+  std::uintptr_t _instruction_pointer_from;
+  std::uintptr_t _instruction_pointer_to;
+  std::uint64_t _count;
+  std::uint64_t _count_mispredicted;
+  double _estimated_cost;
+  bool _is_cost_measured;
+};
+
+/**
+ * Result of the branch stack analysis.
+ */
+class BranchResult
+{
+public:
+  BranchResult(std::vector<ExecutedRange>&& ranges, std::vector<BranchStatistics>&& branches) noexcept
+    : _ranges(std::move(ranges))
+    , _branches(std::move(branches))
+  {
+  }
+
+  ~BranchResult() = default;
+
+  /**
+   * @return Executed straight-line ranges, ordered by execution count (hottest first).
+   */
+  [[nodiscard]] const std::vector<ExecutedRange>& ranges() const noexcept { return _ranges; }
+
+  /**
+   * @return Sampled branches, ordered by estimated misprediction cost and number of mispredictions.
+   */
+  [[nodiscard]] const std::vector<BranchStatistics>& branches() const noexcept { return _branches; }
+
+  /**
+   * Converts the result into a human-readable report.
+   *
+   * @param count_entries Number of ranges and branches to print.
+   * @return Report as a string.
+   */
+  [[nodiscard]] std::string to_string(std::size_t count_entries = 20U) const;
+
+private:
+  std::vector<ExecutedRange> _ranges;
+  std::vector<BranchStatistics> _branches;
+};
+
+/**
+ * Analyzes sampled branch stacks (see Sampler::Type::BranchStack, also known as LBR):
+ * Reconstructs the straight-line ranges executed between consecutive branches including their execution counts and
+ * cycles (from Branch::cycles()), and ranks branches by mispredictions and their estimated cost.
+ *
+ * The cost of a misprediction shows in the cycles of the range executed after the branch (i.e., the cycles of the next
+ * more recent branch record): The penalty per misprediction is the average cycles of that range after mispredicted
+ * executions minus the average after correctly predicted executions. Without sampled cycles, the constant
+ * misprediction penalty is used instead.
+ */
+class BranchAnalyzer
+{
+public:
+  /**
+   * Creates the analyzer.
+   *
+   * @param misprediction_penalty Estimated cycles lost by a single branch misprediction, used for branches without
+   * sampled cycles.
+   * @param max_range_size Ranges larger than this (in bytes) are considered as broken stacks and ignored.
+   */
+  explicit BranchAnalyzer(const double misprediction_penalty = 20., const std::uint64_t max_range_size = 4096U)
+    : _misprediction_penalty(misprediction_penalty)
+    , _max_range_size(max_range_size)
+  {
+  }
+
+  ~BranchAnalyzer() = default;
+
+  /**
+   * Analyzes the branch stacks of the samples.
+   *
+   * @param samples List of samples.
+   * @return Executed ranges and branch statistics.
+   */
+  [[nodiscard]] BranchResult analyze(const std::vector<Sample>& samples) const;
+
+private:
+  double _misprediction_penalty;
+  std::uint64_t _max_range_size;
+};
+}
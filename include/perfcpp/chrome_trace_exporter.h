@@ -0,0 +1,213 @@
+#pragma once
+
+#include "counter.h"
+#include "output_buffer.h"
+#include "sample.h"
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace perf {
+/**
+ * Streams samples, context switches, and counter values into a trace in the Chrome Trace Event format (JSON), which
+ * can be loaded into Perfetto UI (https://ui.perfetto.dev) or chrome://tracing to visualize them on a timeline.
+ *
+ *  - Samples become instant events on the track of their thread (or CPU), holding instruction pointer, CPU, period,
+ *    and memory address (as far as sampled); sampled counter values become counter tracks.
+ *  - Context switches (see SampleConfig::context_switch()) become slices spanning the time a thread was running.
+ *  - Counter values of EventCounters (e.g., recorded per region of code) become counter tracks (add_counters()) or
+ *    slices holding the values as arguments (add_region()).
+ *
+ * Events are formatted into a reusable buffer and written to the file in large blocks; the exporter only keeps the
+ * begin of the currently running slice per thread (or CPU), such that traces of many millions of events are written
+ * in constant memory.
+ * Timestamps are expected in nanoseconds; to correlate samples with timestamps taken by the application, samples
+ * should be recorded with the same clock (see SampleConfig::clock_id()).
+ */
+class ChromeTraceExporter
+{
+public:
+  /**
+   * Track that samples and context switches are assigned to.
+   */
+  enum class Track
+  {
+    /// One track per thread, grouped by process.
+    Thread,
+
+    /// One track per CPU, grouped into a single "CPUs" process.
+    CPU
+  };
+
+  /// Process id of the process holding the CPU tracks (above the maximal process id of Linux).
+  constexpr static inline std::uint32_t CPU_PROCESS_ID = 0x7FFFFFFFU;
+
+  /// Default size of the output buffer.
+  constexpr static inline std::size_t DEFAULT_BUFFER_SIZE = 1024U * 1024U;
+
+  /**
+   * Creates the file and writes the beginning of the trace.
+   * Throws a std::runtime_error if the file cannot be created.
+   *
+   * @param file_name Name of the file.
+   * @param track Track that samples and context switches are assigned to (per thread by default).
+   * @param buffer_size Size of the output buffer; the buffer is written to the file whenever it is full.
+   */
+  explicit ChromeTraceExporter(const std::string& file_name,
+                               Track track = Track::Thread,
+                               std::size_t buffer_size = DEFAULT_BUFFER_SIZE);
+
+  ChromeTraceExporter(const ChromeTraceExporter&) = delete;
+  ChromeTraceExporter& operator=(const ChromeTraceExporter&) = delete;
+
+  /**
+   * Completes and closes the trace, if not already closed.
+   */
+  ~ChromeTraceExporter();
+
+  /**
+   * Adds a sample (or context switch) to the trace; samples without time are skipped.
+   *
+   * @param sample Sample to add.
+   */
+  void add(const Sample& sample);
+
+  /**
+   * Adds a list of samples to the trace.
+   *
+   * @param samples Samples to add.
+   */
+  void add(const std::vector<Sample>& samples);
+
+  /**
+   * Adds a counter event, showing the values of all counters on counter tracks of the given process.
+   *
+   * @param name Name of the counter track.
+   * @param time Time of the values in nanoseconds.
+   * @param process_id Process the counter track belongs to.
+   * @param result Counter values.
+   */
+  void add_counters(std::string_view name, std::uint64_t time, std::uint32_t process_id, const CounterResult& result);
+
+  /**
+   * Adds a slice on the track of the given thread, holding the counter values (e.g., of an EventCounter recording the
+   * region) as arguments.
+   *
+   * @param name Name of the region.
+   * @param begin_time Begin of the region in nanoseconds.
+   * @param end_time End of the region in nanoseconds.
+   * @param process_id Process id of the thread.
+   * @param thread_id Thread id of the thread.
+   * @param result Counter values.
+   */
+  void add_region(std::string_view name,
+                  std::uint64_t begin_time,
+                  std::uint64_t end_time,
+                  std::uint32_t process_id,
+                  std::uint32_t thread_id,
+                  const CounterResult& result);
+
+  /**
+   * Names a process in the trace.
+   *
+   * @param process_id Id of the process.
+   * @param name Name of the process.
+   */
+  void name_process(std::uint32_t process_id, std::string_view name);
+
+  /**
+   * Names a thread in the trace.
+   *
+   * @param process_id Process id of the thread.
+   * @param thread_id Id of the thread.
+   * @param name Name of the thread.
+   */
+  void name_thread(std::uint32_t process_id, std::uint32_t thread_id, std::string_view name);
+
+  /**
+   * Writes the output buffer to the file.
+   *
+   * @return True, if the buffer was written.
+   */
+  bool flush();
+
+  /**
+   * Completes the trace, flushes the output buffer, and closes the file.
+   * Slices of threads that are still running are not written.
+   *
+   * @return True, if the file was written successfully.
+   */
+  bool close();
+
+  /**
+   * @return Number of events written so far.
+   */
+  [[nodiscard]] std::uint64_t count_events() const noexcept { return _count_events; }
+
+private:
+  /**
+   * Begin of a running slice (from switching a thread in until switching it out).
+   */
+  struct running_slice
+  {
+    std::uint64_t begin_time;
+    std::uint32_t process_id;
+    std::uint32_t thread_id;
+  };
+
+  std::ofstream _output;
+  Track _track;
+  bool _is_closed{ false };
+  std::uint64_t _count_events{ 0U };
+
+  OutputBuffer _buffer;
+
+  /// Running slices by thread id (or CPU id).
+  std::unordered_map<std::uint32_t, running_slice> _running_slices;
+
+  /// CPUs that already have a named track.
+  std::vector<bool> _named_cpus;
+
+  /**
+   * Appends a time (or duration) given in nanoseconds as microseconds, the unit of the trace format.
+   *
+   * @param nanoseconds Time in nanoseconds.
+   */
+  void append_microseconds(std::uint64_t nanoseconds);
+
+  /**
+   * Appends all counter values as JSON object; values that are not finite are appended as null.
+   *
+   * @param result Counter values.
+   */
+  void append_counters(const CounterResult& result);
+
+  /**
+   * Begins an event by writing phase, name, process id, and thread id; the caller completes the event with '}'.
+   *
+   * @param phase Phase of the event ('i' for instant, 'X' for complete, 'C' for counter, 'M' for metadata events).
+   * @param name Name of the event.
+   * @param process_id Process id of the event.
+   * @param thread_id Thread id of the event.
+   */
+  void begin_event(char phase, std::string_view name, std::uint32_t process_id, std::uint32_t thread_id);
+
+  /**
+   * Names the track of the given CPU, if not already named.
+   *
+   * @param cpu_id Id of the CPU.
+   */
+  void name_cpu(std::uint32_t cpu_id);
+
+  /**
+   * Adds a context switch, closing or opening the running slice of the thread (or CPU).
+   *
+   * @param sample Sample holding the context switch.
+   */
+  void add_context_switch(const Sample& sample);
+};
+}
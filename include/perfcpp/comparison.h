@@ -0,0 +1,289 @@
+#pragma once
+
+#include "benchmark.h"
+#include "config.h"
+#include "counter_definition.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace perf {
+/**
+ * Comparison of a single counter (or metric) between a baseline and a variant.
+ */
+class CounterComparison
+{
+public:
+  /**
+   * Outcome of the comparison.
+   */
+  enum class Verdict : std::uint8_t
+  {
+    /// The variant records significantly fewer events than the baseline.
+    Lower,
+
+    /// The variant records significantly more events than the baseline.
+    Higher,
+
+    /// The difference is not significant and the confidence interval lies within the resolution, i.e., the variants
+    /// do not differ by more than the resolution.
+    Equivalent,
+
+    /// The difference is not significant, but the confidence interval is wider than the resolution: the noise does
+    /// not allow a decision (more repetitions may resolve it).
+    Noisy,
+
+    /// The counters were multiplexed and the difference is within the extrapolation error (or not significant): the
+    /// multiplexing does not allow a decision (fewer counters may resolve it).
+    Multiplexed
+  };
+
+  CounterComparison() noexcept = default;
+  CounterComparison(Statistics baseline,
+                    Statistics variant,
+                    const double relative_difference,
+                    std::pair<double, double> confidence_interval,
+                    const double p_value,
+                    const Verdict verdict) noexcept
+    : _baseline(baseline)
+    , _variant(variant)
+    , _relative_difference(relative_difference)
+    , _confidence_interval(confidence_interval)
+    , _p_value(p_value)
+    , _verdict(verdict)
+  {
+  }
+
+  ~CounterComparison() noexcept = default;
+
+  [[nodiscard]] const Statistics& baseline() const noexcept { return _baseline; }
+  [[nodiscard]] const Statistics& variant() const noexcept { return _variant; }
+
+  /**
+   * @return Relative difference of the medians, i.e., (variant - baseline) / baseline; NaN if the median of the
+   * baseline is zero but the median of the variant is not.
+   */
+  [[nodiscard]] double relative_difference() const noexcept { return _relative_difference; }
+
+  /**
+   * @return Lower and upper bound of the (bootstrapped) confidence interval of the relative difference.
+   */
+  [[nodiscard]] std::pair<double, double> confidence_interval() const noexcept { return _confidence_interval; }
+
+  /**
+   * @return Two-sided p-value of the Mann-Whitney U test.
+   */
+  [[nodiscard]] double p_value() const noexcept { return _p_value; }
+
+  [[nodiscard]] Verdict verdict() const noexcept { return _verdict; }
+
+  /**
+   * @return True, if the variant differs significantly from the baseline.
+   */
+  [[nodiscard]] bool is_different() const noexcept
+  {
+    return _verdict == Verdict::Lower || _verdict == Verdict::Higher;
+  }
+
+  /**
+   * @return True, if neither noise nor multiplexing prevented a decision.
+   */
+  [[nodiscard]] bool is_resolvable() const noexcept
+  {
+    return _verdict != Verdict::Noisy && _verdict != Verdict::Multiplexed;
+  }
+
+  [[nodiscard]] static std::string_view to_string(Verdict verdict) noexcept;
+
+private:
+  Statistics _baseline;
+  Statistics _variant;
+  double _relative_difference{ .0 };
+  std::pair<double, double> _confidence_interval{ .0, .0 };
+  double _p_value{ 1. };
+  Verdict _verdict{ Verdict::Noisy };
+};
+
+/**
+ * Result of comparing two variants: the comparison of every counter and metric (normalized per iteration) and of the
+ * time.
+ */
+class ComparisonResult
+{
+public:
+  using const_iterator = std::vector<std::pair<std::string_view, CounterComparison>>::const_iterator;
+
+  ComparisonResult() = default;
+  ComparisonResult(std::vector<std::pair<std::string_view, CounterComparison>>&& comparisons,
+                   CounterComparison time,
+                   const double running_fraction) noexcept
+    : _comparisons(std::move(comparisons))
+    , _time(time)
+    , _running_fraction(running_fraction)
+  {
+  }
+
+  ~ComparisonResult() = default;
+
+  /**
+   * Access the comparison of the counter or metric with the given name.
+   *
+   * @param name Name of the counter or metric.
+   * @return The comparison, or std::nullopt if the counter or metric was not recorded.
+   */
+  [[nodiscard]] std::optional<CounterComparison> get(std::string_view name) const noexcept;
+
+  /**
+   * @return Comparison of the wall-clock time (in nanoseconds, normalized per iteration).
+   */
+  [[nodiscard]] const CounterComparison& time() const noexcept { return _time; }
+
+  /**
+   * @return Minimal fraction of time the counters were scheduled on the hardware over all runs (1 = not multiplexed).
+   */
+  [[nodiscard]] double running_fraction() const noexcept { return _running_fraction; }
+
+  [[nodiscard]] const_iterator begin() const { return _comparisons.begin(); }
+  [[nodiscard]] const_iterator end() const { return _comparisons.end(); }
+
+  /**
+   * @return Table of all comparisons, one row per counter and metric.
+   */
+  [[nodiscard]] std::string to_string() const;
+
+private:
+  std::vector<std::pair<std::string_view, CounterComparison>> _comparisons;
+  CounterComparison _time;
+  double _running_fraction{ 1. };
+};
+
+/**
+ * Compares two callables (a baseline and a variant, e.g., before and after an optimization) by recording the same
+ * counters and metrics around both.
+ *
+ * The callables are run alternately in a randomized order per repetition, such that drifts of the system (e.g.,
+ * frequency or thermal) affect both equally. For every counter, metric, and the time, the comparison reports the
+ * relative difference of the medians with a bootstrapped confidence interval, and the p-value of a Mann-Whitney U
+ * test. All counters are recorded in every run; if the hardware cannot record them at once, the kernel multiplexes
+ * them, which is detected and reported.
+ */
+class Comparison
+{
+public:
+  /**
+   * Creates the comparison.
+   *
+   * @param counter_definitions Definitions of counters and metrics; must be alive until the comparison finishes.
+   * @param config Configuration of the counters.
+   */
+  explicit Comparison(const CounterDefinition& counter_definitions, Config config = {})
+    : _counter_definitions(counter_definitions)
+    , _config(config)
+  {
+  }
+
+  ~Comparison() = default;
+
+  /**
+   * Adds the specified counter (or metric) to the recorded counters.
+   * The counter must exist within the counter definitions.
+   *
+   * @param counter_name Name of the counter or metric.
+   * @return True, if the counter could be added.
+   */
+  bool add(std::string counter_name);
+
+  /**
+   * Adds the specified counters (or metrics) to the recorded counters.
+   *
+   * @param counter_names List of names of the counters or metrics.
+   * @return True, if all counters could be added.
+   */
+  bool add(const std::vector<std::string>& counter_names);
+
+  /**
+   * Sets the number of (unrecorded) runs of each callable before recording.
+   *
+   * @param warm_up Number of warm-up runs.
+   */
+  void warm_up(const std::uint32_t warm_up) noexcept { _warm_up = warm_up; }
+
+  /**
+   * Sets the number of recorded repetitions; each repetition runs both callables once.
+   *
+   * @param repetitions Number of repetitions.
+   */
+  void repetitions(const std::uint32_t repetitions) noexcept { _repetitions = repetitions; }
+
+  /**
+   * Sets the confidence level of the confidence intervals; differences are significant if the p-value is below
+   * 1 - confidence level.
+   *
+   * @param confidence_level Confidence level, e.g., 0.95.
+   */
+  void confidence_level(const double confidence_level) noexcept { _confidence_level = confidence_level; }
+
+  /**
+   * Sets the smallest relative difference of interest: if the confidence interval lies within +/- the resolution,
+   * both variants are equivalent; otherwise, not significant differences are reported as noisy.
+   *
+   * @param resolution Relative resolution, e.g., 0.01 for 1%.
+   */
+  void resolution(const double resolution) noexcept { _resolution = resolution; }
+
+  /**
+   * Sets the seed for the order of the callables and the bootstrapping.
+   *
+   * @param seed Seed of the random number generator.
+   */
+  void seed(const std::uint64_t seed) noexcept { _seed = seed; }
+
+  [[nodiscard]] std::uint32_t warm_up() const noexcept { return _warm_up; }
+  [[nodiscard]] std::uint32_t repetitions() const noexcept { return _repetitions; }
+  [[nodiscard]] double confidence_level() const noexcept { return _confidence_level; }
+  [[nodiscard]] double resolution() const noexcept { return _resolution; }
+
+  /**
+   * Runs both callables for warm-up and all repetitions, recording the counters, and compares the variant to the
+   * baseline.
+   * Throws a std::runtime_error if the counters cannot be added or started.
+   *
+   * @param baseline Code to compare against.
+   * @param variant Code to compare.
+   * @param normalization Number of iterations each callable executes per run; all values are normalized by it.
+   * @return Comparison of all counters and metrics.
+   */
+  [[nodiscard]] ComparisonResult run(const std::function<void()>& baseline,
+                                     const std::function<void()>& variant,
+                                     std::uint64_t normalization = 1U);
+
+private:
+  const CounterDefinition& _counter_definitions;
+  Config _config;
+
+  std::uint32_t _warm_up{ 1U };
+  std::uint32_t _repetitions{ 30U };
+  double _confidence_level{ .95 };
+  double _resolution{ .01 };
+  std::uint64_t _seed{ 42U };
+
+  std::vector<std::string> _counter_names;
+
+  /**
+   * Compares the values of a single counter recorded for the baseline and the variant.
+   *
+   * @param baseline_values Values of the baseline, one per repetition.
+   * @param variant_values Values of the variant, one per repetition.
+   * @param running_fraction Minimal fraction of time the counter was scheduled on the hardware.
+   * @return Comparison of the counter.
+   */
+  [[nodiscard]] CounterComparison compare(std::vector<double>&& baseline_values,
+                                          std::vector<double>&& variant_values,
+                                          double running_fraction) const;
+};
+}
@@ -86,6 +86,8 @@ public:
   [[nodiscard]] Registers user_registers() const noexcept { return _user_registers; }
   [[nodiscard]] Registers kernel_registers() const noexcept { return _kernel_registers; }
   [[nodiscard]] std::uint64_t branch_type() const noexcept { return _branch_type; }
+  [[nodiscard]] bool is_context_switch() const noexcept { return _is_context_switch; }
+  [[nodiscard]] std::optional<std::int32_t> clock_id() const noexcept { return _clock_id; }
 
   void frequency(const std::uint64_t frequency) noexcept
   {
@@ -104,6 +106,21 @@ public:
   void branch_type(const std::uint64_t branch_type) noexcept { _branch_type = branch_type; }
   void branch_type(const BranchType branch_type) noexcept { _branch_type = static_cast<std::uint64_t>(branch_type); }
 
+  /**
+   * Records context switches (switching the recorded thread in and out) in addition to samples.
+   *
+   * @param is_context_switch True, if context switches should be recorded.
+   */
+  void context_switch(const bool is_context_switch) noexcept { _is_context_switch = is_context_switch; }
+
+  /**
+   * Sets the clock used for the time of samples (e.g., CLOCK_MONOTONIC to correlate samples with timestamps of
+   * std::chrono::steady_clock); by default, the Linux Kernel uses its internal perf clock.
+   *
+   * @param clock_id Id of the clock (see clock_gettime).
+   */
+  void clock_id(const std::int32_t clock_id) noexcept { _clock_id = clock_id; }
+
 private:
   std::uint64_t _buffer_pages{ 8192U + 1U };
 
@@ -116,5 +133,8 @@ private:
   Registers _kernel_registers;
 
   std::uint64_t _branch_type{ static_cast<std::uint64_t>(BranchType::Any) };
+
+  bool _is_context_switch{ false };
+  std::optional<std::int32_t> _clock_id{ std::nullopt };
 };
 }
\ No newline at end of file
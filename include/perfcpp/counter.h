@@ -100,6 +100,27 @@ public:
    */
   [[nodiscard]] std::string to_csv(char delimiter = ',', bool print_header = true) const;
 
+  /**
+   * Writes the result in JSON format into a caller-provided buffer, without creating temporary strings (e.g., for
+   * high-rate logging).
+   *
+   * @param begin Begin of the buffer.
+   * @param end End of the buffer.
+   * @return Pointer behind the last written char, or nullptr if the buffer is too small.
+   */
+  [[nodiscard]] char* to_json(char* begin, char* end) const noexcept;
+
+  /**
+   * Writes the result in CSV format into a caller-provided buffer, without creating temporary strings.
+   *
+   * @param begin Begin of the buffer.
+   * @param end End of the buffer.
+   * @param delimiter Char to separate columns (',' by default).
+   * @param print_header If true, the header will be printed first (true by default).
+   * @return Pointer behind the last written char, or nullptr if the buffer is too small.
+   */
+  [[nodiscard]] char* to_csv(char* begin, char* end, char delimiter = ',', bool print_header = true) const noexcept;
+
 private:
   std::vector<std::pair<std::string_view, double>> _results;
 };
@@ -122,6 +143,7 @@ public:
   }
 
   [[nodiscard]] perf_event_attr& event_attribute() noexcept { return _event_attribute; }
+  [[nodiscard]] const perf_event_attr& event_attribute() const noexcept { return _event_attribute; }
   [[nodiscard]] std::uint64_t& id() noexcept { return _id; }
   [[nodiscard]] std::uint64_t id() const noexcept { return _id; }
 
@@ -60,6 +60,21 @@ public:
   }
   [[nodiscard]] Metric* metric(std::string_view name) const noexcept { return metric(std::string{ name }); }
 
+  /**
+   * Returns the name of the metric as stored by the definition, which stays valid as long as the definition lives.
+   *
+   * @param name Name of the metric.
+   * @return Stored name, or std::nullopt if no metric with the given name is defined.
+   */
+  [[nodiscard]] std::optional<std::string_view> metric_name(const std::string& name) const noexcept
+  {
+    if (auto iterator = _metrics.find(name); iterator != _metrics.end()) {
+      return std::string_view{ iterator->first };
+    }
+
+    return std::nullopt;
+  }
+
   [[nodiscard]] std::vector<std::string> names() const
   {
     auto names = std::vector<std::string>{};
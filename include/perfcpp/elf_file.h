@@ -0,0 +1,147 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace perf {
+/**
+ * Loadable segment (PT_LOAD program header) of an ELF binary.
+ */
+class ElfSegment
+{
+public:
+  ElfSegment(const std::uint64_t offset,
+             const std::uint64_t virtual_address,
+             const std::uint64_t file_size,
+             const bool is_executable) noexcept
+    : _offset(offset)
+    , _virtual_address(virtual_address)
+    , _file_size(file_size)
+    , _is_executable(is_executable)
+  {
+  }
+
+  ~ElfSegment() = default;
+
+  /**
+   * @return Offset of the segment within the file.
+   */
+  [[nodiscard]] std::uint64_t offset() const noexcept { return _offset; }
+
+  /**
+   * @return Virtual address of the segment as linked (i.e., without load bias).
+   */
+  [[nodiscard]] std::uint64_t virtual_address() const noexcept { return _virtual_address; }
+
+  [[nodiscard]] std::uint64_t file_size() const noexcept { return _file_size; }
+  [[nodiscard]] bool is_executable() const noexcept { return _is_executable; }
+
+  [[nodiscard]] bool contains_offset(const std::uint64_t offset) const noexcept
+  {
+    return offset >= _offset && offset < _offset + _file_size;
+  }
+
+private:
+  std::uint64_t _offset;
+  std::uint64_t _virtual_address;
+  std::uint64_t _file_size;
+  bool _is_executable;
+};
+
+/**
+ * Function symbol of an ELF binary.
+ */
+class ElfSymbol
+{
+public:
+  ElfSymbol(std::string&& name, const std::uint64_t address, const std::uint64_t size)
+    : _name(std::move(name))
+    , _address(address)
+    , _size(size)
+  {
+  }
+
+  ~ElfSymbol() = default;
+
+  /**
+   * @return (Mangled) name of the symbol.
+   */
+  [[nodiscard]] const std::string& name() const noexcept { return _name; }
+
+  /**
+   * @return Virtual address of the symbol as linked.
+   */
+  [[nodiscard]] std::uint64_t address() const noexcept { return _address; }
+
+  [[nodiscard]] std::uint64_t size() const noexcept { return _size; }
+
+  [[nodiscard]] bool contains(const std::uint64_t address) const noexcept
+  {
+    return address >= _address && address < _address + (_size > 0U ? _size : 1U);
+  }
+
+private:
+  std::string _name;
+  std::uint64_t _address;
+  std::uint64_t _size;
+};
+
+/**
+ * Minimal reader for 64-bit ELF binaries, used to translate sampled addresses into the addresses of the binary as
+ * linked (which profile consumers like compilers and post-link optimizers expect).
+ */
+class ElfFile
+{
+public:
+  ElfFile() = default;
+  ~ElfFile() = default;
+
+  /**
+   * Reads the program headers (and, optionally, the function symbols) of an ELF binary.
+   *
+   * @param path Path of the binary.
+   * @param include_symbols If true, function symbols are read from the symbol table (or the dynamic symbol table, if
+   * the binary is stripped).
+   * @return The ELF file, empty if the file could not be read or is no 64-bit ELF binary.
+   */
+  [[nodiscard]] static ElfFile read(const std::string& path, bool include_symbols = false);
+
+  /**
+   * @return True, if the binary is position independent (shared library or PIE).
+   */
+  [[nodiscard]] bool is_position_independent() const noexcept { return _is_position_independent; }
+
+  [[nodiscard]] const std::vector<ElfSegment>& segments() const noexcept { return _segments; }
+  [[nodiscard]] bool empty() const noexcept { return _segments.empty(); }
+
+  /**
+   * Translates an offset within the file into the virtual address of the binary as linked.
+   *
+   * @param offset Offset within the file (see MemoryMapping::file_offset()).
+   * @return Virtual address, or std::nullopt if the offset does not belong to a loadable segment.
+   */
+  [[nodiscard]] std::optional<std::uint64_t> virtual_address(std::uint64_t offset) const noexcept;
+
+  /**
+   * @return Function symbols, ordered by address (empty if not read).
+   */
+  [[nodiscard]] const std::vector<ElfSymbol>& symbols() const noexcept { return _symbols; }
+
+  /**
+   * Looks up the function symbol containing the given address.
+   *
+   * @param address Virtual address as linked (see virtual_address()).
+   * @return Pointer to the symbol, or nullptr if no symbol contains the address.
+   */
+  [[nodiscard]] const ElfSymbol* symbol(std::uint64_t address) const noexcept;
+
+private:
+  bool _is_position_independent{ false };
+  std::vector<ElfSegment> _segments;
+
+  /// Function symbols, sorted by address.
+  std::vector<ElfSymbol> _symbols;
+};
+}
@@ -117,13 +117,76 @@ public:
    */
   void stop();
 
+  /**
+   * Pauses the running performance counters without closing them, e.g., to exclude setup code from the measurement.
+   * Events are not counted until resume(); the values recorded so far are kept.
+   *
+   * @return True, if all performance counters could be paused.
+   */
+  bool pause();
+
+  /**
+   * Resumes recording performance counters after pause().
+   *
+   * @return True, if all performance counters could be resumed.
+   */
+  bool resume();
+
+  /**
+   * Measures the overhead of recording, i.e., the events counted for an empty region between start() and stop(), with
+   * the current counters and configuration. The empty region is recorded the given number of times and the median per
+   * counter is stored, which can be subtracted from later results (see result()).
+   * Must not be called while the counters are running; adding counters or changing the configuration discards the
+   * calibration.
+   *
+   * @param count_runs Number of recorded empty regions, default = 1000.
+   * @return True, if the performance counters could be started for calibration.
+   */
+  bool calibrate(std::uint32_t count_runs = 1000U);
+
+  /**
+   * @return True, if the overhead was calibrated for the current counters and configuration.
+   */
+  [[nodiscard]] bool is_calibrated() const noexcept { return !_overhead.empty(); }
+
+  /**
+   * @return Median overhead per counter as measured by calibrate(); empty, if not calibrated.
+   */
+  [[nodiscard]] CounterResult overhead() const;
+
   /**
    * Returns the result of the performance measurement.
    *
    * @param normalization Normalization value, default = 1.
+   * @param is_subtract_overhead If true, the overhead measured by calibrate() is subtracted from every counter before
+   * normalizing and calculating metrics (values do not drop below zero). Has no effect if not calibrated.
    * @return List of counter names and values.
    */
-  [[nodiscard]] CounterResult result(std::uint64_t normalization = 1U) const;
+  [[nodiscard]] CounterResult result(std::uint64_t normalization = 1U, bool is_subtract_overhead = false) const
+  {
+    return result(normalization, nullptr, is_subtract_overhead);
+  }
+
+  /**
+   * Returns the fraction of the time the counters were scheduled on the hardware between start() and stop().
+   * A value below 1 indicates that the kernel multiplexed the counters (e.g., since more counters were added than the
+   * hardware can record at once) and the results are extrapolated.
+   *
+   * @return Minimal fraction over all groups; 1, if no counters were added.
+   */
+  [[nodiscard]] double running_fraction() const;
+
+  /**
+   * Reads the values of the running performance counters without stopping them, e.g., to expose them periodically.
+   * The values are cumulative since start(); the counters are read by the kernel, the recorded threads are not
+   * interrupted.
+   * The counter is not modified, such that the values can be read from another thread while the counter is running;
+   * the counter must not be opened or closed concurrently, though.
+   *
+   * @param normalization Normalization value, default = 1.
+   * @return List of counter names and values.
+   */
+  [[nodiscard]] CounterResult live_result(std::uint64_t normalization = 1U) const;
 
   /**
    * @return Configuration of the counter.
@@ -135,7 +198,11 @@ public:
    *
    * @param config New config.
    */
-  void config(Config config) noexcept { _config = config; }
+  void config(Config config) noexcept
+  {
+    _config = config;
+    _overhead.clear();
+  }
 
 private:
   const CounterDefinition& _counter_definitions;
@@ -148,6 +215,9 @@ private:
   /// Real counters to measure.
   std::vector<Group> _groups;
 
+  /// Median overhead (in events) of an empty region per entry of _counters (zero for metrics), see calibrate().
+  std::vector<double> _overhead;
+
   /**
    * Add the specified counter to the list of monitored performance counters.
    * The counters must exist within the counter definitions.
@@ -158,6 +228,25 @@ private:
    * @return True, if the counter was added.
    */
   bool add(std::string_view counter_name, CounterConfig counter, bool is_hidden);
+
+  /**
+   * Reads the values of all groups without stopping them.
+   *
+   * @return Values since start(), one list of member values per group.
+   */
+  [[nodiscard]] std::vector<std::vector<double>> read_live() const;
+
+  /**
+   * Returns the result of the performance measurement, either from start() until stop() or from read_live().
+   *
+   * @param normalization Normalization value.
+   * @param live_values Values returned by read_live(), or nullptr to use the values from start() until stop().
+   * @param is_subtract_overhead True, if the calibrated overhead should be subtracted.
+   * @return List of counter names and values.
+   */
+  [[nodiscard]] CounterResult result(std::uint64_t normalization,
+                                     const std::vector<std::vector<double>>* live_values,
+                                     bool is_subtract_overhead) const;
 };
 
 class MultiEventCounterBase
@@ -169,8 +258,13 @@ protected:
 
   [[nodiscard]] static bool add(std::vector<EventCounter>& event_counter, const std::vector<std::string>& counter_names);
 
-  [[nodiscard]] static CounterResult result(const std::vector<EventCounter>& event_counter,
-                                            std::uint64_t normalization = 1U);
+  [[nodiscard]] static CounterResult result(
+    const std::vector<EventCounter>& event_counter,
+    std::uint64_t normalization = 1U,
+    const std::vector<std::vector<std::vector<double>>>* live_values = nullptr);
+
+  [[nodiscard]] static CounterResult live_result(const std::vector<EventCounter>& event_counter,
+                                                 std::uint64_t normalization = 1U);
 };
 
 /**
@@ -350,6 +444,17 @@ public:
     return MultiEventCounterBase::result(_process_local_counter, normalization);
   }
 
+  /**
+   * Reads the values of the running performance counters without stopping them (see EventCounter::live_result()).
+   *
+   * @param normalization Normalization value, default = 1.
+   * @return List of counter names and values, aggregated over all processes.
+   */
+  [[nodiscard]] CounterResult live_result(std::uint64_t normalization = 1U) const
+  {
+    return MultiEventCounterBase::live_result(_process_local_counter, normalization);
+  }
+
 private:
   std::vector<perf::EventCounter> _process_local_counter;
 };
@@ -432,6 +537,17 @@ public:
     return MultiEventCounterBase::result(_cpu_local_counter, normalization);
   }
 
+  /**
+   * Reads the values of the running performance counters without stopping them (see EventCounter::live_result()).
+   *
+   * @param normalization Normalization value, default = 1.
+   * @return List of counter names and values, aggregated over all CPUs.
+   */
+  [[nodiscard]] CounterResult live_result(std::uint64_t normalization = 1U) const
+  {
+    return MultiEventCounterBase::live_result(_cpu_local_counter, normalization);
+  }
+
 private:
   std::vector<perf::EventCounter> _cpu_local_counter;
 };
@@ -0,0 +1,122 @@
+#pragma once
+
+#include "config.h"
+#include "counter_definition.h"
+#include "event_counter.h"
+#include <benchmark/benchmark.h>
+#include <string>
+#include <vector>
+
+namespace perf {
+/**
+ * Records performance counters around the timed loop of a Google Benchmark and reports them as user counters
+ * (benchmark::State::counters), normalized per iteration.
+ *
+ * The counter replaces the state in the range-based for loop:
+ *
+ *   static void BM_Example(benchmark::State& state) {
+ *     auto counters = perf::GoogleBenchmarkCounter{ state, counter_definitions, { "instructions", "cycles" } };
+ *     for (auto _ : counters) { ... }
+ *   }
+ *
+ * Counters are started before and stopped after the timed loop; use pause() and resume() instead of
+ * State::PauseTiming() and State::ResumeTiming() to exclude code from both, the time and the counters.
+ * Every thread of a multi-threaded benchmark records its own counters; Google Benchmark reports the average over all
+ * threads.
+ * If the counters cannot be added or started, the benchmark is skipped with an error.
+ */
+class GoogleBenchmarkCounter
+{
+public:
+  /**
+   * Iterator over the benchmark iterations; stops the counters and reports their values when the loop ends.
+   */
+  class iterator
+  {
+  public:
+    iterator(GoogleBenchmarkCounter* counter, benchmark::State::StateIterator state_iterator) noexcept
+      : _counter(counter)
+      , _state_iterator(state_iterator)
+    {
+    }
+
+    [[nodiscard]] BENCHMARK_ALWAYS_INLINE benchmark::State::StateIterator::Value operator*() const
+    {
+      return *_state_iterator;
+    }
+
+    BENCHMARK_ALWAYS_INLINE iterator& operator++()
+    {
+      ++_state_iterator;
+      return *this;
+    }
+
+    BENCHMARK_ALWAYS_INLINE bool operator!=(const iterator& other) const
+    {
+      if (BENCHMARK_BUILTIN_EXPECT(_state_iterator != other._state_iterator, true)) {
+        return true;
+      }
+
+      /// The state has stopped the timer, stop the counters as well.
+      _counter->finish();
+      return false;
+    }
+
+  private:
+    GoogleBenchmarkCounter* _counter;
+    benchmark::State::StateIterator _state_iterator;
+  };
+
+  /**
+   * Creates the counter for the given benchmark state.
+   *
+   * @param state State of the benchmark.
+   * @param counter_definitions Definitions of counters and metrics; must be alive until the benchmark finishes.
+   * @param counter_names Names of the counters and metrics reported as user counters.
+   * @param config Configuration of the counters.
+   */
+  GoogleBenchmarkCounter(benchmark::State& state,
+                         const CounterDefinition& counter_definitions,
+                         const std::vector<std::string>& counter_names,
+                         Config config = {});
+
+  ~GoogleBenchmarkCounter();
+
+  GoogleBenchmarkCounter(const GoogleBenchmarkCounter&) = delete;
+  GoogleBenchmarkCounter& operator=(const GoogleBenchmarkCounter&) = delete;
+
+  /**
+   * Starts the counters; the timer is started by end() right after.
+   *
+   * @return Iterator to the first iteration.
+   */
+  [[nodiscard]] iterator begin();
+
+  [[nodiscard]] iterator end() { return iterator{ this, _state.end() }; }
+
+  /**
+   * Pauses the counters and the timer of the benchmark.
+   */
+  void pause();
+
+  /**
+   * Resumes the timer of the benchmark and the counters.
+   */
+  void resume();
+
+  /**
+   * @return The underlying event counter, e.g., to access the raw results after the loop.
+   */
+  [[nodiscard]] EventCounter& event_counter() noexcept { return _event_counter; }
+
+private:
+  benchmark::State& _state;
+  EventCounter _event_counter;
+  bool _is_running{ false };
+
+  /**
+   * Stops the counters and reports their values as user counters of the state.
+   */
+  void finish();
+};
+}
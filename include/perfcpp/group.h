@@ -22,6 +22,20 @@ public:
   bool start();
   bool stop();
 
+  /**
+   * Disables the running group without reading or resetting it; events occurring until resume() are not counted.
+   *
+   * @return True, if the group could be paused.
+   */
+  bool pause();
+
+  /**
+   * Re-enables the group after pause(); values keep accumulating from where they were paused.
+   *
+   * @return True, if the group could be resumed.
+   */
+  bool resume();
+
   [[nodiscard]] std::size_t size() const noexcept { return _members.size(); }
   [[nodiscard]] bool empty() const noexcept { return _members.empty(); }
 
@@ -32,6 +46,21 @@ public:
 
   [[nodiscard]] double get(std::size_t index) const;
 
+  /**
+   * @return Fraction of the time (from start() until stop()) the group was scheduled on the hardware while enabled; a
+   * value below 1 indicates that the group was multiplexed and its values are extrapolated.
+   */
+  [[nodiscard]] double running_fraction() const;
+
+  /**
+   * Reads the current values of the running group without stopping it (e.g., to expose them while recording).
+   * The group itself is not modified, such that the values can be read from another thread while the group is running.
+   *
+   * @param values List that receives the value of every member since start(); all zero, if the group cannot be read.
+   * @return True, if the values could be read.
+   */
+  bool read_live(std::vector<double>& values) const;
+
   [[nodiscard]] Counter& member(const std::size_t index) { return _members[index]; }
 
   [[nodiscard]] const Counter& member(const std::size_t index) const { return _members[index]; }
@@ -59,6 +88,8 @@ private:
 
   read_format _end_value;
 
+  [[nodiscard]] double value(std::size_t index, const read_format& read_value) const;
+
   [[nodiscard]] static std::optional<std::uint64_t> value_for_id(const read_format& value,
                                                                  const std::uint64_t id) noexcept
   {
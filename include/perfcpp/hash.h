@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace perf {
+/**
+ * Hash for pairs of instruction pointers, e.g., (from, to) of a branch or (begin, end) of a range.
+ */
+struct instruction_pointer_pair_hash
+{
+  std::size_t operator()(const std::pair<std::uintptr_t, std::uintptr_t>& pair) const noexcept
+  {
+    return std::hash<std::uintptr_t>{}(pair.first ^ (pair.second * 0x9E3779B97F4A7C15ULL));
+  }
+};
+
+/**
+ * Hash for callchains (lists of instruction pointers).
+ */
+struct callchain_hash
+{
+  std::size_t operator()(const std::vector<std::uintptr_t>& callchain) const noexcept
+  {
+    auto hash = std::size_t{ callchain.size() };
+    for (const auto instruction_pointer : callchain) {
+      hash = (hash ^ std::hash<std::uintptr_t>{}(instruction_pointer)) * 0x9E3779B97F4A7C15ULL;
+    }
+    return hash;
+  }
+};
+}
@@ -0,0 +1,195 @@
+#pragma once
+
+#include "branch.h"
+#include "memory_map.h"
+#include "sample.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace perf {
+/**
+ * Code address, attributed to the binary (or other mapping) it belongs to.
+ */
+class CodeLocation
+{
+public:
+  CodeLocation(const std::uintptr_t instruction_pointer, std::string binary, const std::uint64_t offset)
+    : _instruction_pointer(instruction_pointer)
+    , _binary(std::move(binary))
+    , _offset(offset)
+  {
+  }
+
+  ~CodeLocation() = default;
+
+  /**
+   * @return Virtual address of the instruction.
+   */
+  [[nodiscard]] std::uintptr_t instruction_pointer() const noexcept { return _instruction_pointer; }
+
+  /**
+   * @return Path of the binary containing the instruction, or "[unknown]" if the address could not be attributed.
+   */
+  [[nodiscard]] const std::string& binary() const noexcept { return _binary; }
+
+  /**
+   * @return Offset of the instruction within the binary, stable across runs (unlike the virtual address under ASLR).
+   */
+  [[nodiscard]] std::uint64_t offset() const noexcept { return _offset; }
+
+private:
+  std::uintptr_t _instruction_pointer;
+  std::string _binary;
+  std::uint64_t _offset;
+};
+
+/**
+ * Target of an indirect call site and how often it was called.
+ */
+class IndirectCallTarget
+{
+public:
+  IndirectCallTarget(CodeLocation&& location, const std::uint64_t count)
+    : _location(std::move(location))
+    , _count(count)
+  {
+  }
+
+  ~IndirectCallTarget() = default;
+
+  [[nodiscard]] const CodeLocation& location() const noexcept { return _location; }
+  [[nodiscard]] std::uint64_t count() const noexcept { return _count; }
+
+private:
+  CodeLocation _location;
+  std::uint64_t _count;
+};
+
+/**
+ * Indirect call site (e.g., a virtual call or a call through a function pointer) and the distribution of its targets.
+ */
+class IndirectCallSite
+{
+public:
+  IndirectCallSite(CodeLocation&& location, std::vector<IndirectCallTarget>&& targets);
+  ~IndirectCallSite() = default;
+
+  [[nodiscard]] const CodeLocation& location() const noexcept { return _location; }
+
+  /**
+   * @return Targets of the call site, ordered by the number of calls (most frequent first).
+   */
+  [[nodiscard]] const std::vector<IndirectCallTarget>& targets() const noexcept { return _targets; }
+
+  /**
+   * @return Number of sampled calls from this call site.
+   */
+  [[nodiscard]] std::uint64_t count() const noexcept { return _count; }
+
+  /**
+   * @return The most frequent target.
+   */
+  [[nodiscard]] const IndirectCallTarget& dominant_target() const noexcept { return _targets.front(); }
+
+  /**
+   * @return Share of calls to the most frequent target (1.0 = monomorphic call site).
+   */
+  [[nodiscard]] double dominant_share() const noexcept
+  {
+    return _count > 0U ? double(_targets.front().count()) / double(_count) : .0;
+  }
+
+private:
+  CodeLocation _location;
+  std::vector<IndirectCallTarget> _targets;
+  std::uint64_t _count{ 0U };
+};
+
+/**
+ * Result of the indirect call analysis.
+ */
+class IndirectCallResult
+{
+public:
+  explicit IndirectCallResult(std::vector<IndirectCallSite>&& call_sites) noexcept
+    : _call_sites(std::move(call_sites))
+  {
+  }
+
+  ~IndirectCallResult() = default;
+
+  /**
+   * @return Indirect call sites, ordered by the number of sampled calls (hottest first).
+   */
+  [[nodiscard]] const std::vector<IndirectCallSite>& call_sites() const noexcept { return _call_sites; }
+
+  /**
+   * Converts the result into a human-readable report.
+   *
+   * @param count_call_sites Number of call sites to print.
+   * @param count_targets Number of targets to print per call site.
+   * @return Report as a string.
+   */
+  [[nodiscard]] std::string to_string(std::size_t count_call_sites = 20U, std::size_t count_targets = 3U) const;
+
+  /**
+   * Exports the target distributions as CSV, one line per (call site, target) with the header
+   * "call_site_binary,call_site_offset,target_binary,target_offset,count,share".
+   * Offsets are hexadecimal offsets within the binaries and, therefore, independent of address space layout
+   * randomization, which allows to feed the profile back into the build (e.g., for speculative devirtualization).
+   * Binaries are quoted fields (RFC 4180).
+   *
+   * @param min_count Call sites with fewer sampled calls are omitted.
+   * @return Profile as CSV string.
+   */
+  [[nodiscard]] std::string to_csv(std::uint64_t min_count = 1U) const;
+
+private:
+  std::vector<IndirectCallSite> _call_sites;
+};
+
+/**
+ * Aggregates the targets of indirect calls per call site from sampled branch stacks (see
+ * Sampler::Type::BranchStack). Only branch entries whose saved type is an indirect call are considered; the branch
+ * stack has to be recorded with the branch types saved (see IndirectCallAnalyzer::branch_type()).
+ */
+class IndirectCallAnalyzer
+{
+public:
+  /**
+   * Creates the analyzer.
+   *
+   * @param memory_map Memory map used to attribute call sites and targets to binaries; must be read while the
+   * profiled binaries are still loaded.
+   */
+  explicit IndirectCallAnalyzer(MemoryMap memory_map = MemoryMap::read())
+    : _memory_map(std::move(memory_map))
+  {
+  }
+
+  ~IndirectCallAnalyzer() = default;
+
+  /**
+   * @return Branch types to record for indirect call analysis, see SampleConfig::branch_type().
+   */
+  [[nodiscard]] constexpr static std::uint64_t branch_type() noexcept
+  {
+    return static_cast<std::uint64_t>(BranchType::User) | static_cast<std::uint64_t>(BranchType::IndirectCall) |
+           static_cast<std::uint64_t>(BranchType::TypeSave);
+  }
+
+  /**
+   * Analyzes the branch stacks of the samples.
+   *
+   * @param samples List of samples.
+   * @return Target distributions of all sampled indirect call sites.
+   */
+  [[nodiscard]] IndirectCallResult analyze(const std::vector<Sample>& samples) const;
+
+private:
+  MemoryMap _memory_map;
+
+  [[nodiscard]] CodeLocation locate(std::uintptr_t instruction_pointer) const;
+};
+}
@@ -0,0 +1,166 @@
+#pragma once
+
+#include "branch.h"
+#include "sample.h"
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace perf {
+/**
+ * Statistics of a single loop, identified by the address of its head (target of the backward branch).
+ */
+class LoopStatistics
+{
+public:
+  LoopStatistics(const std::uintptr_t head, const std::uintptr_t latch) noexcept
+    : _head(head)
+    , _latch(latch)
+  {
+  }
+
+  ~LoopStatistics() = default;
+
+  /**
+   * @return Address of the loop head (target of the backward branch).
+   */
+  [[nodiscard]] std::uintptr_t head() const noexcept { return _head; }
+
+  /**
+   * @return Address of the (first seen) backward branch closing the loop.
+   */
+  [[nodiscard]] std::uintptr_t latch() const noexcept { return _latch; }
+
+  /**
+   * @return Number of sampled backward branches (i.e., iterations that did not leave the loop).
+   */
+  [[nodiscard]] std::uint64_t count_back_edges() const noexcept { return _count_back_edges; }
+
+  /**
+   * @return Number of sampled loop exits (branches leaving the loop body after a backward branch).
+   */
+  [[nodiscard]] std::uint64_t count_exits() const noexcept { return _count_exits; }
+
+  /**
+   * @return Number of loop executions that were only partially recorded by the branch stack.
+   */
+  [[nodiscard]] std::uint64_t count_truncated() const noexcept { return _count_truncated; }
+
+  /**
+   * @return Distribution of trip counts (trip count, number of executions) for loop executions that were completely
+   * recorded by the branch stack, ordered by trip count.
+   */
+  [[nodiscard]] const std::vector<std::pair<std::uint64_t, std::uint64_t>>& trip_counts() const noexcept
+  {
+    return _trip_counts;
+  }
+
+  /**
+   * Estimates the average trip count from the ratio of back edges to loop exits.
+   * Unlike the trip count distribution, this also considers loops running longer than the branch stack.
+   *
+   * @return Estimated average trip count, 0 if no exit was sampled.
+   */
+  [[nodiscard]] double estimated_trip_count() const noexcept
+  {
+    return _count_exits > 0U ? double(_count_back_edges) / double(_count_exits) + 1. : .0;
+  }
+
+  /**
+   * @return Number of iterations with measured cycles.
+   */
+  [[nodiscard]] std::uint64_t count_measured_iterations() const noexcept { return _count_measured_iterations; }
+
+  /**
+   * @return Average cycles per iteration (from Branch::cycles()), or 0 if the hardware does not report cycles.
+   */
+  [[nodiscard]] double average_cycles_per_iteration() const noexcept
+  {
+    return _count_measured_iterations > 0U ? double(_iteration_cycles) / double(_count_measured_iterations) : .0;
+  }
+
+  /**
+   * @return Minimal cycles per iteration (from Branch::cycles()), or 0 if the hardware does not report cycles.
+   */
+  [[nodiscard]] std::uint64_t min_cycles_per_iteration() const noexcept { return _min_iteration_cycles; }
+
+  void add_back_edge() noexcept { ++_count_back_edges; }
+  void add_exit() noexcept { ++_count_exits; }
+  void add_truncated() noexcept { ++_count_truncated; }
+  void add_trip_count(std::uint64_t trip_count);
+  void add_iteration_cycles(std::uint64_t cycles) noexcept;
+
+private:
+  std::uintptr_t _head;
+  std::uintptr_t _latch;
+  std::uint64_t _count_back_edges{ 0U };
+  std::uint64_t _count_exits{ 0U };
+  std::uint64_t _count_truncated{ 0U };
+  std::vector<std::pair<std::uint64_t, std::uint64_t>> _trip_counts;
+  std::uint64_t _count_measured_iterations{ 0U };
+  std::uint64_t _iteration_cycles{ 0U };
+  std::uint64_t _min_iteration_cycles{ 0U };
+};
+
+/**
+ * Result of the loop analysis.
+ */
+class LoopResult
+{
+public:
+  explicit LoopResult(std::vector<LoopStatistics>&& loops) noexcept
+    : _loops(std::move(loops))
+  {
+  }
+
+  ~LoopResult() = default;
+
+  /**
+   * @return Detected loops, ordered by the number of sampled back edges (hottest first).
+   */
+  [[nodiscard]] const std::vector<LoopStatistics>& loops() const noexcept { return _loops; }
+
+  /**
+   * Converts the result into a human-readable report.
+   *
+   * @param count_loops Number of loops to print.
+   * @return Report as a string.
+   */
+  [[nodiscard]] std::string to_string(std::size_t count_loops = 20U) const;
+
+private:
+  std::vector<LoopStatistics> _loops;
+};
+
+/**
+ * Detects loops within sampled branch stacks (see Sampler::Type::BranchStack) by backward taken branches and
+ * estimates their trip counts and cycles per iteration (from Branch::cycles()), reported per loop head.
+ *
+ * Recording only conditional user-level branches (see LoopAnalyzer::branch_type()) reduces the overhead and keeps
+ * more iterations within the branch stack.
+ * Note that conditional branches in functions called from the loop body are considered as leaving the loop.
+ */
+class LoopAnalyzer
+{
+public:
+  LoopAnalyzer() = default;
+  ~LoopAnalyzer() = default;
+
+  /**
+   * @return Branch types to record for loop analysis, see SampleConfig::branch_type().
+   */
+  [[nodiscard]] constexpr static std::uint64_t branch_type() noexcept
+  {
+    return static_cast<std::uint64_t>(BranchType::User) | static_cast<std::uint64_t>(BranchType::Conditional);
+  }
+
+  /**
+   * Analyzes the branch stacks of the samples.
+   *
+   * @param samples List of samples.
+   * @return Statistics for all detected loops.
+   */
+  [[nodiscard]] LoopResult analyze(const std::vector<Sample>& samples) const;
+};
+}
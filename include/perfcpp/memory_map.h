@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <sys/types.h>
+#include <vector>
+
+namespace perf {
+/**
+ * A single mapping of the virtual address space of a process (i.e., one line of /proc/<pid>/maps).
+ */
+class MemoryMapping
+{
+public:
+  MemoryMapping(const std::uintptr_t begin,
+                const std::uintptr_t end,
+                const std::uint64_t offset,
+                const bool is_readable,
+                const bool is_writable,
+                const bool is_executable,
+                std::string&& path)
+    : _begin(begin)
+    , _end(end)
+    , _offset(offset)
+    , _is_readable(is_readable)
+    , _is_writable(is_writable)
+    , _is_executable(is_executable)
+    , _path(std::move(path))
+  {
+  }
+
+  ~MemoryMapping() = default;
+
+  [[nodiscard]] std::uintptr_t begin() const noexcept { return _begin; }
+  [[nodiscard]] std::uintptr_t end() const noexcept { return _end; }
+  [[nodiscard]] std::size_t size() const noexcept { return _end - _begin; }
+
+  /**
+   * @return Offset of the mapping within the mapped file.
+   */
+  [[nodiscard]] std::uint64_t offset() const noexcept { return _offset; }
+
+  [[nodiscard]] bool is_readable() const noexcept { return _is_readable; }
+  [[nodiscard]] bool is_writable() const noexcept { return _is_writable; }
+  [[nodiscard]] bool is_executable() const noexcept { return _is_executable; }
+
+  /**
+   * @return Path of the mapped file, pseudo-paths like "[heap]" or "[stack]", or an empty string for anonymous memory.
+   */
+  [[nodiscard]] const std::string& path() const noexcept { return _path; }
+
+  /**
+   * @return True, if the mapping is backed by a file (and not anonymous or a pseudo-path).
+   */
+  [[nodiscard]] bool is_file() const noexcept { return !_path.empty() && _path.front() == '/'; }
+
+  [[nodiscard]] bool contains(const std::uintptr_t address) const noexcept
+  {
+    return address >= _begin && address < _end;
+  }
+
+  /**
+   * Translates a virtual address into an offset within the mapped file.
+   *
+   * @param address Virtual address within the mapping.
+   * @return Offset of the address within the mapped file.
+   */
+  [[nodiscard]] std::uint64_t file_offset(const std::uintptr_t address) const noexcept
+  {
+    return address - _begin + _offset;
+  }
+
+private:
+  std::uintptr_t _begin;
+  std::uintptr_t _end;
+  std::uint64_t _offset;
+  bool _is_readable;
+  bool _is_writable;
+  bool _is_executable;
+  std::string _path;
+};
+
+/**
+ * Virtual memory mappings of a process, used to attribute sampled addresses to binaries and other mappings.
+ */
+class MemoryMap
+{
+public:
+  MemoryMap() = default;
+  explicit MemoryMap(std::vector<MemoryMapping>&& mappings);
+  ~MemoryMap() = default;
+
+  /**
+   * Reads the mappings of a process from /proc/<pid>/maps.
+   *
+   * @param process_id Id of the process (0 = calling process).
+   * @return The memory map, empty if the mappings could not be read.
+   */
+  [[nodiscard]] static MemoryMap read(pid_t process_id = 0);
+
+  /**
+   * Looks up the mapping containing the given address.
+   *
+   * @param address Virtual address.
+   * @return Pointer to the mapping, or nullptr if the address is not mapped.
+   */
+  [[nodiscard]] const MemoryMapping* find(std::uintptr_t address) const noexcept;
+
+  [[nodiscard]] const std::vector<MemoryMapping>& mappings() const noexcept { return _mappings; }
+  [[nodiscard]] bool empty() const noexcept { return _mappings.empty(); }
+
+private:
+  /// Mappings, sorted by begin.
+  std::vector<MemoryMapping> _mappings;
+};
+}
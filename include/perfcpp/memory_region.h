@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace perf {
+/**
+ * Named range of (virtual) memory, e.g., a data structure, that sampled addresses can be attributed to.
+ */
+class MemoryRegion
+{
+public:
+  MemoryRegion(std::string&& name, const std::uintptr_t begin, const std::size_t size)
+    : _name(std::move(name))
+    , _begin(begin)
+    , _end(begin + size)
+  {
+  }
+
+  MemoryRegion(std::string&& name, const void* begin, const std::size_t size)
+    : MemoryRegion(std::move(name), reinterpret_cast<std::uintptr_t>(begin), size)
+  {
+  }
+
+  MemoryRegion(const std::string& name, const void* begin, const std::size_t size)
+    : MemoryRegion(std::string{ name }, begin, size)
+  {
+  }
+
+  ~MemoryRegion() = default;
+
+  [[nodiscard]] const std::string& name() const noexcept { return _name; }
+  [[nodiscard]] std::uintptr_t begin() const noexcept { return _begin; }
+  [[nodiscard]] std::uintptr_t end() const noexcept { return _end; }
+  [[nodiscard]] std::size_t size() const noexcept { return _end - _begin; }
+
+  /**
+   * @param address Address to check.
+   * @return True, if the address is located within the region.
+   */
+  [[nodiscard]] bool contains(const std::uintptr_t address) const noexcept
+  {
+    return address >= _begin && address < _end;
+  }
+
+private:
+  std::string _name;
+  std::uintptr_t _begin;
+  std::uintptr_t _end;
+};
+}
@@ -0,0 +1,278 @@
+#pragma once
+
+#include "memory_region.h"
+#include "sample.h"
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <sys/types.h>
+#include <utility>
+#include <vector>
+
+namespace perf {
+/**
+ * Mapping of CPUs and physical memory ranges to NUMA nodes.
+ */
+class NUMATopology
+{
+public:
+  NUMATopology() = default;
+  ~NUMATopology() = default;
+
+  /**
+   * Reads the topology of the current machine from /sys/devices/system/node.
+   *
+   * @return The topology; if the system does not expose NUMA information, all CPUs are assigned to node 0.
+   */
+  [[nodiscard]] static NUMATopology read();
+
+  /**
+   * Assigns a CPU to a NUMA node.
+   *
+   * @param cpu_id Id of the CPU.
+   * @param node_id Id of the NUMA node.
+   */
+  void add_cpu(std::uint32_t cpu_id, std::uint16_t node_id);
+
+  /**
+   * Assigns a range of physical memory to a NUMA node.
+   *
+   * @param begin First physical address of the range.
+   * @param end First physical address after the range.
+   * @param node_id Id of the NUMA node.
+   */
+  void add_physical_memory(std::uintptr_t begin, std::uintptr_t end, std::uint16_t node_id);
+
+  /**
+   * @return Number of NUMA nodes.
+   */
+  [[nodiscard]] std::uint16_t count_nodes() const noexcept { return _count_nodes; }
+
+  /**
+   * @param cpu_id Id of the CPU.
+   * @return The NUMA node of the given CPU, or std::nullopt if the CPU is unknown.
+   */
+  [[nodiscard]] std::optional<std::uint16_t> node_of_cpu(std::uint32_t cpu_id) const noexcept;
+
+  /**
+   * @param address Physical memory address.
+   * @return The NUMA node the physical address is located on, or std::nullopt if the address is unknown.
+   */
+  [[nodiscard]] std::optional<std::uint16_t> node_of_physical_address(std::uintptr_t address) const noexcept;
+
+private:
+  struct physical_memory_range
+  {
+    std::uintptr_t begin;
+    std::uintptr_t end;
+    std::uint16_t node_id;
+  };
+
+  std::uint16_t _count_nodes{ 0U };
+
+  /// Node for every CPU (index), -1 if the CPU is unknown.
+  std::vector<std::int32_t> _cpu_nodes;
+
+  /// Physical memory ranges, sorted by begin.
+  std::vector<physical_memory_range> _physical_memory;
+};
+
+/**
+ * Number of accesses from CPUs on NUMA node X (rows) to memory on NUMA node Y (columns).
+ */
+class NUMAAccessMatrix
+{
+public:
+  explicit NUMAAccessMatrix(const std::uint16_t count_nodes)
+    : _count_nodes(count_nodes)
+    , _accesses(std::size_t(count_nodes) * count_nodes, 0U)
+  {
+  }
+
+  ~NUMAAccessMatrix() = default;
+
+  /**
+   * Adds accesses from the CPU node to the memory node.
+   *
+   * @param cpu_node_id Node of the accessing CPU.
+   * @param memory_node_id Node of the accessed memory.
+   * @param count Number of accesses.
+   * @return True, if both nodes are known to the matrix (i.e., below count_nodes()); otherwise, nothing is added.
+   */
+  bool increment(const std::uint16_t cpu_node_id, const std::uint16_t memory_node_id, const std::uint64_t count = 1U)
+  {
+    if (cpu_node_id >= _count_nodes || memory_node_id >= _count_nodes) {
+      return false;
+    }
+
+    _accesses[cpu_node_id * _count_nodes + memory_node_id] += count;
+    return true;
+  }
+
+  [[nodiscard]] std::uint16_t count_nodes() const noexcept { return _count_nodes; }
+
+  /**
+   * @param cpu_node_id Node of the accessing CPU.
+   * @param memory_node_id Node of the accessed memory.
+   * @return Number of sampled accesses from the CPU node to the memory node; 0 for unknown nodes.
+   */
+  [[nodiscard]] std::uint64_t accesses(const std::uint16_t cpu_node_id, const std::uint16_t memory_node_id) const
+  {
+    if (cpu_node_id >= _count_nodes || memory_node_id >= _count_nodes) {
+      return 0U;
+    }
+
+    return _accesses[cpu_node_id * _count_nodes + memory_node_id];
+  }
+
+  /**
+   * @return Number of sampled accesses where CPU and memory are located on the same node.
+   */
+  [[nodiscard]] std::uint64_t local() const noexcept;
+
+  /**
+   * @return Number of sampled accesses where CPU and memory are located on different nodes.
+   */
+  [[nodiscard]] std::uint64_t remote() const noexcept;
+
+  /**
+   * @return Share of remote accesses of all accesses.
+   */
+  [[nodiscard]] double remote_ratio() const noexcept
+  {
+    const auto count_local = local();
+    const auto count_remote = remote();
+    return count_local + count_remote > 0U ? double(count_remote) / double(count_local + count_remote) : .0;
+  }
+
+  /**
+   * Converts the matrix to a human-readable table.
+   *
+   * @return Matrix as a string.
+   */
+  [[nodiscard]] std::string to_string() const;
+
+private:
+  std::uint16_t _count_nodes;
+  std::vector<std::uint64_t> _accesses;
+};
+
+/**
+ * Result of the NUMA analysis: One access matrix for all samples, one per data region, and one per thread.
+ */
+class NUMAResult
+{
+public:
+  explicit NUMAResult(const std::uint16_t count_nodes)
+    : _total(count_nodes)
+  {
+  }
+
+  ~NUMAResult() = default;
+
+  [[nodiscard]] const NUMAAccessMatrix& total() const noexcept { return _total; }
+  [[nodiscard]] NUMAAccessMatrix& total() noexcept { return _total; }
+
+  /**
+   * @return Access matrix for every data region (in the order the regions were added to the analyzer).
+   */
+  [[nodiscard]] const std::vector<std::pair<std::string, NUMAAccessMatrix>>& regions() const noexcept
+  {
+    return _regions;
+  }
+  [[nodiscard]] std::vector<std::pair<std::string, NUMAAccessMatrix>>& regions() noexcept { return _regions; }
+
+  /**
+   * @return Access matrix for every sampled thread id (ordered by the thread id).
+   */
+  [[nodiscard]] const std::vector<std::pair<std::uint32_t, NUMAAccessMatrix>>& threads() const noexcept
+  {
+    return _threads;
+  }
+  [[nodiscard]] std::vector<std::pair<std::uint32_t, NUMAAccessMatrix>>& threads() noexcept { return _threads; }
+
+  /**
+   * @return Number of samples that could not be mapped to a CPU node or a memory node, including samples mapped to
+   * nodes beyond the number of nodes of the topology.
+   */
+  [[nodiscard]] std::uint64_t count_unresolved() const noexcept { return _count_unresolved; }
+  void count_unresolved(const std::uint64_t count_unresolved) noexcept { _count_unresolved = count_unresolved; }
+
+  /**
+   * Converts the result into a human-readable report.
+   *
+   * @return Report as a string.
+   */
+  [[nodiscard]] std::string to_string() const;
+
+private:
+  NUMAAccessMatrix _total;
+  std::vector<std::pair<std::string, NUMAAccessMatrix>> _regions;
+  std::vector<std::pair<std::uint32_t, NUMAAccessMatrix>> _threads;
+  std::uint64_t _count_unresolved{ 0U };
+};
+
+/**
+ * Maps sampled memory accesses to NUMA nodes and joins them with the NUMA node of the sampling CPU.
+ * The memory node is determined by the physical address (if sampled, see Sampler::Type::PhysicalMemAddress) or by
+ * querying the kernel for the node of the page of the logical address (see Sampler::Type::LogicalMemAddress).
+ * The CPU node is determined by the CPU id of the sample (see Sampler::Type::CPU).
+ */
+class NUMAAnalyzer
+{
+public:
+  explicit NUMAAnalyzer(NUMATopology topology = NUMATopology::read(), const pid_t process_id = 0)
+    : _topology(std::move(topology))
+    , _process_id(process_id)
+  {
+  }
+
+  ~NUMAAnalyzer() = default;
+
+  /**
+   * Adds a data region; accesses to that region will be reported separately.
+   *
+   * @param region Data region.
+   */
+  void add(MemoryRegion&& region) { _regions.emplace_back(std::move(region)); }
+
+  /**
+   * Adds a data region; accesses to that region will be reported separately.
+   *
+   * @param name Name of the region.
+   * @param begin Begin of the region.
+   * @param size Size of the region in bytes.
+   */
+  void add(std::string&& name, const void* begin, const std::size_t size)
+  {
+    add(MemoryRegion{ std::move(name), begin, size });
+  }
+
+  /**
+   * Analyzes the samples.
+   * Note that the nodes of logical addresses are queried when analyzing; the memory must still be mapped.
+   *
+   * @param samples List of samples.
+   * @return Access matrices for all samples, regions, and threads.
+   */
+  [[nodiscard]] NUMAResult analyze(const std::vector<Sample>& samples) const;
+
+  [[nodiscard]] const NUMATopology& topology() const noexcept { return _topology; }
+
+private:
+  NUMATopology _topology;
+
+  /// Process to query logical addresses for (0 = calling process).
+  pid_t _process_id;
+
+  std::vector<MemoryRegion> _regions;
+
+  /**
+   * Queries the NUMA nodes of the pages of the given logical addresses.
+   *
+   * @param logical_addresses List of logical addresses.
+   * @return List of nodes (or -1 if the page is not mapped), one for each address.
+   */
+  [[nodiscard]] std::vector<std::int32_t> query_nodes(const std::vector<std::uintptr_t>& logical_addresses) const;
+};
+}
@@ -0,0 +1,217 @@
+#pragma once
+
+#include "counter.h"
+#include "counter_definition.h"
+#include "event_counter.h"
+#include "output_buffer.h"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace perf {
+/**
+ * Exposes the values of running EventCounters (and MultiCoreEventCounters/MultiProcessEventCounters) in the
+ * OpenMetrics text format (https://openmetrics.io), which is scraped by Prometheus and compatible agents.
+ *
+ * The counters keep running while being exposed: every scrape reads the current values through the live path of the
+ * counters (see EventCounter::live_result()), which only reads the counter file descriptors; the recorded threads are
+ * neither interrupted nor synchronized with.
+ * Counters are exposed as cumulative counters (perf_<name>_total, since start of the counter), metrics as gauges
+ * (perf_<name>); every registered source becomes a label (source="<name>").
+ * Chars that are invalid in metric names are replaced by '_'; names that would collide after replacing (e.g.,
+ * "cache-misses" and "cache_misses") are disambiguated by a numeric suffix in order of appearance
+ * (perf_cache_misses and perf_cache_misses_2).
+ * The exposition is rendered into a reusable buffer, such that a scrape allocates only the (small) results of the
+ * counters.
+ *
+ * The exposition can be served via HTTP on a (local) TCP port or a Unix socket by a background thread; all sources
+ * need to be added before serving, and serving has to be stopped before the counters are stopped.
+ * This component is only built with the CMake option BUILD_OPENMETRICS and links the library perf-cpp-openmetrics.
+ */
+class OpenMetricsExporter
+{
+public:
+  /// Default size of the output buffer (grows if needed).
+  constexpr static inline std::size_t DEFAULT_BUFFER_SIZE = 16U * 1024U;
+
+  /**
+   * Creates the exporter.
+   *
+   * @param counter_definitions Definitions of the exposed counters, used to distinguish counters from metrics.
+   * @param prefix Prefix of all metric names.
+   */
+  explicit OpenMetricsExporter(const CounterDefinition& counter_definitions, std::string prefix = "perf");
+
+  OpenMetricsExporter(const OpenMetricsExporter&) = delete;
+  OpenMetricsExporter& operator=(const OpenMetricsExporter&) = delete;
+
+  /**
+   * Stops serving, if started.
+   */
+  ~OpenMetricsExporter();
+
+  /**
+   * Adds a running EventCounter to the exposition.
+   *
+   * @param source_name Name of the source, exposed as label.
+   * @param event_counter Counter to expose; must outlive the exporter (or serving).
+   */
+  void add(std::string source_name, const EventCounter& event_counter)
+  {
+    add(std::move(source_name), [&event_counter] { return event_counter.live_result(); });
+  }
+
+  /**
+   * Adds a running MultiCoreEventCounter to the exposition; the values are aggregated over all CPUs.
+   *
+   * @param source_name Name of the source, exposed as label.
+   * @param event_counter Counter to expose; must outlive the exporter (or serving).
+   */
+  void add(std::string source_name, const MultiCoreEventCounter& event_counter)
+  {
+    add(std::move(source_name), [&event_counter] { return event_counter.live_result(); });
+  }
+
+  /**
+   * Adds a running MultiProcessEventCounter to the exposition; the values are aggregated over all processes.
+   *
+   * @param source_name Name of the source, exposed as label.
+   * @param event_counter Counter to expose; must outlive the exporter (or serving).
+   */
+  void add(std::string source_name, const MultiProcessEventCounter& event_counter)
+  {
+    add(std::move(source_name), [&event_counter] { return event_counter.live_result(); });
+  }
+
+  /**
+   * Adds a source of counter results to the exposition (e.g., to expose further values of the application).
+   * Values that are not defined as metrics in the counter definitions are exposed as counters.
+   *
+   * @param source_name Name of the source, exposed as label.
+   * @param source Callback returning the current (cumulative) values.
+   */
+  void add(std::string source_name, std::function<CounterResult()>&& source);
+
+  /**
+   * Reads the current values of all sources and renders them in the OpenMetrics text format.
+   * Must not be called while serving, since the server thread renders into the same buffer.
+   *
+   * @return Exposition, valid until the next call.
+   */
+  [[nodiscard]] std::string_view render();
+
+  /**
+   * Starts serving the exposition via HTTP on the given TCP port in a background thread.
+   *
+   * @param port Port to listen on; 0 lets the system choose a free port (see port()).
+   * @param address IPv4 address to listen on; only local clients can connect by default.
+   * @return True, if the server was started.
+   */
+  [[nodiscard]] bool serve(std::uint16_t port, const std::string& address = "127.0.0.1");
+
+  /**
+   * Starts serving the exposition via HTTP on a Unix socket in a background thread; an existing file is replaced.
+   *
+   * @param socket_path Path of the Unix socket.
+   * @return True, if the server was started.
+   */
+  [[nodiscard]] bool serve(const std::string& socket_path);
+
+  /**
+   * Stops serving and closes the socket.
+   */
+  void stop();
+
+  /**
+   * @return True, if the exposition is served.
+   */
+  [[nodiscard]] bool is_serving() const noexcept { return _server_thread.joinable(); }
+
+  /**
+   * @return The TCP port the exposition is served on, or 0 if not served via TCP.
+   */
+  [[nodiscard]] std::uint16_t port() const noexcept { return _port; }
+
+  /**
+   * @return Number of scrapes served so far.
+   */
+  [[nodiscard]] std::uint64_t count_scrapes() const noexcept { return _count_scrapes.load(); }
+
+private:
+  const CounterDefinition& _counter_definitions;
+  std::string _prefix;
+
+  /// Registered sources by name.
+  std::vector<std::pair<std::string, std::function<CounterResult()>>> _sources;
+
+  /// Results of the sources of the current scrape, names of all exposed values (in order of appearance), and the
+  /// (unique) names of their metric families.
+  std::vector<CounterResult> _results;
+  std::vector<std::string_view> _names;
+  std::vector<std::string> _family_names;
+
+  /// Names (sorted) that are known to be a metric (exposed as gauge) or not (exposed as counter).
+  std::vector<std::pair<std::string, bool>> _is_metric;
+
+  OutputBuffer _buffer;
+
+  /// Listening socket, pipe to wake the server thread on stop, and the server thread.
+  std::int32_t _socket_file_descriptor{ -1 };
+  std::array<std::int32_t, 2U> _wake_file_descriptors{ -1, -1 };
+  std::thread _server_thread;
+  std::string _socket_path;
+  std::uint16_t _port{ 0U };
+  std::atomic<std::uint64_t> _count_scrapes{ 0U };
+
+  /**
+   * Starts the server thread on the bound socket.
+   *
+   * @return True, if the server was started.
+   */
+  [[nodiscard]] bool start_server();
+
+  /**
+   * Accepts and answers connections until stopped.
+   */
+  void serve_connections();
+
+  /**
+   * Reads a single HTTP request from the client and answers it.
+   *
+   * @param client_file_descriptor Socket of the client.
+   */
+  void answer(std::int32_t client_file_descriptor);
+
+  /**
+   * @return True, if the value with the given name is a metric (gauge) rather than a counter.
+   */
+  [[nodiscard]] bool is_metric(std::string_view name);
+
+  /**
+   * Appends a value, spelling NaN and infinity as defined by OpenMetrics.
+   *
+   * @param value Value of a counter or metric.
+   */
+  void append_value(double value);
+
+  /**
+   * Builds the names of the metric families of all exposed values into _family_names: the prefix and the name,
+   * replacing all chars that are invalid in metric names by '_', and appending a suffix to names that collide.
+   */
+  void build_family_names();
+
+  /**
+   * Appends a label value, escaping quotes, backslashes, and line breaks.
+   *
+   * @param value Value of the label.
+   */
+  void append_label_value(std::string_view value);
+};
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+namespace perf {
+/**
+ * Buffer for text output (e.g., CSV, JSON, or the OpenMetrics format) of the exporters: values are formatted with
+ * std::to_chars straight into the buffer, without allocating per value.
+ * A buffer attached to a stream is written to the stream whenever it is full (and on flush()); otherwise, the buffer
+ * grows and holds the full output.
+ */
+class OutputBuffer
+{
+public:
+  /**
+   * Creates a buffer that grows as needed.
+   *
+   * @param capacity Initial capacity in bytes.
+   */
+  explicit OutputBuffer(std::size_t capacity);
+
+  /**
+   * Creates a buffer that is written to the stream whenever it is full.
+   *
+   * @param output Stream the buffer is written to; must outlive the buffer.
+   * @param capacity Capacity in bytes.
+   */
+  OutputBuffer(std::ostream& output, std::size_t capacity);
+
+  OutputBuffer(const OutputBuffer&) = delete;
+  OutputBuffer& operator=(const OutputBuffer&) = delete;
+
+  ~OutputBuffer() = default;
+
+  /**
+   * Writes the buffer to the stream (if attached) and empties it.
+   *
+   * @return True, if the stream is in a good state (or no stream is attached).
+   */
+  bool flush();
+
+  /**
+   * Discards the content of the buffer.
+   */
+  void clear() noexcept { _size = 0U; }
+
+  /**
+   * @return Content of the buffer (since the last flush), valid until the next change.
+   */
+  [[nodiscard]] std::string_view view() const noexcept { return std::string_view{ _buffer.data(), _size }; }
+
+  /**
+   * Ensures that the buffer has space for (at least) the given number of bytes, flushing (or growing) it if needed.
+   * Bytes written into the space are added to the content by commit().
+   *
+   * @param size Number of bytes.
+   * @return Pointer to the free space of the buffer.
+   */
+  [[nodiscard]] char* reserve(std::size_t size);
+
+  /**
+   * Adds bytes written into the reserved space to the content.
+   *
+   * @param size Number of bytes.
+   */
+  void commit(const std::size_t size) noexcept { _size += size; }
+
+  void append(std::string_view string);
+  void append(char character);
+  void append(std::uint64_t value);
+  void append(double value);
+
+  /**
+   * Appends the value as hexadecimal number with "0x" prefix.
+   */
+  void append_hex(std::uint64_t value);
+
+  /**
+   * Appends a JSON string, quoted and with quotes, backslashes, and control characters escaped.
+   *
+   * @param string String to append.
+   */
+  void append_json_string(std::string_view string);
+
+private:
+  std::ostream* _output{ nullptr };
+  std::vector<char> _buffer;
+  std::size_t _size{ 0U };
+};
+}
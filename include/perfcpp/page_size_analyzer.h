@@ -0,0 +1,280 @@
+#pragma once
+
+#include "memory_map.h"
+#include "memory_region.h"
+#include "sample.h"
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace perf {
+/**
+ * Number of sampled accesses and TLB misses, broken down by the size of the accessed page. TLB misses are only known
+ * for data accesses (from the data source of the sample); code accesses are counted without TLB misses.
+ */
+class PageSizeCoverage
+{
+public:
+  constexpr static inline auto PAGE_4K = std::uint64_t{ 4096U };
+  constexpr static inline auto PAGE_2M = std::uint64_t{ 2U } * 1024U * 1024U;
+  constexpr static inline auto PAGE_1G = std::uint64_t{ 1024U } * 1024U * 1024U;
+
+  PageSizeCoverage() = default;
+  ~PageSizeCoverage() = default;
+
+  /**
+   * Adds a sampled access without information about the TLB (e.g., an instruction fetch).
+   *
+   * @param page_size Size of the accessed page in bytes.
+   */
+  void add(std::uint64_t page_size);
+
+  /**
+   * Adds a sampled access with information about the TLB.
+   *
+   * @param page_size Size of the accessed page in bytes.
+   * @param is_tlb_miss True, if the access missed the TLB.
+   */
+  void add(std::uint64_t page_size, bool is_tlb_miss);
+
+  /**
+   * @return Number of sampled accesses.
+   */
+  [[nodiscard]] std::uint64_t accesses() const noexcept { return _accesses; }
+
+  /**
+   * @return Number of sampled accesses that missed the TLB.
+   */
+  [[nodiscard]] std::uint64_t tlb_misses() const noexcept { return _tlb_misses; }
+
+  /**
+   * @return True, if any access was added with information about the TLB; otherwise, the TLB misses are unknown.
+   */
+  [[nodiscard]] bool has_tlb_information() const noexcept { return _has_tlb_information; }
+
+  /**
+   * @param page_size Size of the page in bytes.
+   * @return Number of sampled accesses to pages of the given size.
+   */
+  [[nodiscard]] std::uint64_t accesses(std::uint64_t page_size) const noexcept;
+
+  /**
+   * @param page_size Size of the page in bytes.
+   * @return Number of sampled TLB misses to pages of the given size.
+   */
+  [[nodiscard]] std::uint64_t tlb_misses(std::uint64_t page_size) const noexcept;
+
+  /**
+   * @param page_size Size of the page in bytes.
+   * @return Share of sampled accesses that hit pages of the given size.
+   */
+  [[nodiscard]] double access_ratio(const std::uint64_t page_size) const noexcept
+  {
+    return _accesses > 0U ? double(accesses(page_size)) / double(_accesses) : .0;
+  }
+
+  /**
+   * @param page_size Size of the page in bytes.
+   * @return Share of sampled TLB misses that hit pages of the given size.
+   */
+  [[nodiscard]] double tlb_miss_ratio(const std::uint64_t page_size) const noexcept
+  {
+    return _tlb_misses > 0U ? double(tlb_misses(page_size)) / double(_tlb_misses) : .0;
+  }
+
+  /**
+   * @return All sampled page sizes, ascending.
+   */
+  [[nodiscard]] std::vector<std::uint64_t> page_sizes() const;
+
+  /**
+   * Converts the coverage into a human-readable table; TLB misses are only listed if known.
+   *
+   * @return Table as a string.
+   */
+  [[nodiscard]] std::string to_string() const;
+
+private:
+  struct page_size_counter
+  {
+    std::uint64_t page_size;
+    std::uint64_t accesses;
+    std::uint64_t tlb_misses;
+  };
+
+  std::uint64_t _accesses{ 0U };
+  std::uint64_t _tlb_misses{ 0U };
+  bool _has_tlb_information{ false };
+
+  /// Counters per page size, sorted by the page size.
+  std::vector<page_size_counter> _counters;
+};
+
+/**
+ * Range of virtual memory, backed by 4K pages, that would benefit from huge pages.
+ */
+class HugePageCandidate
+{
+public:
+  HugePageCandidate(std::string&& name,
+                    const std::uintptr_t begin,
+                    const std::uintptr_t end,
+                    const std::uint64_t accesses,
+                    const std::uint64_t tlb_misses)
+    : _name(std::move(name))
+    , _begin(begin)
+    , _end(end)
+    , _accesses(accesses)
+    , _tlb_misses(tlb_misses)
+  {
+  }
+
+  ~HugePageCandidate() = default;
+
+  /**
+   * @return Name of the data region, text segment, or mapping the range belongs to.
+   */
+  [[nodiscard]] const std::string& name() const noexcept { return _name; }
+  [[nodiscard]] std::uintptr_t begin() const noexcept { return _begin; }
+  [[nodiscard]] std::uintptr_t end() const noexcept { return _end; }
+  [[nodiscard]] std::uint64_t accesses() const noexcept { return _accesses; }
+
+  /**
+   * @return Number of sampled data accesses to the range that missed the TLB (instruction fetches are not included).
+   */
+  [[nodiscard]] std::uint64_t tlb_misses() const noexcept { return _tlb_misses; }
+
+private:
+  std::string _name;
+  std::uintptr_t _begin;
+  std::uintptr_t _end;
+  std::uint64_t _accesses;
+  std::uint64_t _tlb_misses;
+};
+
+/**
+ * Result of the page size analysis.
+ */
+class PageSizeResult
+{
+public:
+  PageSizeResult() = default;
+  ~PageSizeResult() = default;
+
+  /**
+   * @return Coverage of all sampled data accesses.
+   */
+  [[nodiscard]] const PageSizeCoverage& data() const noexcept { return _data; }
+  [[nodiscard]] PageSizeCoverage& data() noexcept { return _data; }
+
+  /**
+   * @return Coverage of all sampled instruction pointers (without TLB misses, which samples do not provide for code).
+   */
+  [[nodiscard]] const PageSizeCoverage& code() const noexcept { return _code; }
+  [[nodiscard]] PageSizeCoverage& code() noexcept { return _code; }
+
+  /**
+   * @return Coverage of data accesses per data region (in the order the regions were added to the analyzer).
+   */
+  [[nodiscard]] const std::vector<std::pair<std::string, PageSizeCoverage>>& regions() const noexcept
+  {
+    return _regions;
+  }
+  [[nodiscard]] std::vector<std::pair<std::string, PageSizeCoverage>>& regions() noexcept { return _regions; }
+
+  /**
+   * @return Coverage of instruction pointers per text segment (i.e., executable mapping of a binary).
+   */
+  [[nodiscard]] const std::vector<std::pair<std::string, PageSizeCoverage>>& text_segments() const noexcept
+  {
+    return _text_segments;
+  }
+  [[nodiscard]] std::vector<std::pair<std::string, PageSizeCoverage>>& text_segments() noexcept
+  {
+    return _text_segments;
+  }
+
+  /**
+   * @return Hottest 4K-backed ranges (2M aligned), ordered by TLB misses and accesses.
+   */
+  [[nodiscard]] const std::vector<HugePageCandidate>& candidates() const noexcept { return _candidates; }
+  [[nodiscard]] std::vector<HugePageCandidate>& candidates() noexcept { return _candidates; }
+
+  /**
+   * Converts the result into a human-readable report.
+   *
+   * @return Report as a string.
+   */
+  [[nodiscard]] std::string to_string() const;
+
+private:
+  PageSizeCoverage _data;
+  PageSizeCoverage _code;
+  std::vector<std::pair<std::string, PageSizeCoverage>> _regions;
+  std::vector<std::pair<std::string, PageSizeCoverage>> _text_segments;
+  std::vector<HugePageCandidate> _candidates;
+};
+
+/**
+ * Aggregates sampled data and code page sizes (see Sampler::Type::DataPageSize and Sampler::Type::CodePageSize) into
+ * a huge-page coverage report. TLB misses of data accesses are taken from the data source (see
+ * Sampler::Type::DataSource); the data source describes only the data access of a sample, the coverage of code is
+ * therefore reported without TLB misses.
+ */
+class PageSizeAnalyzer
+{
+public:
+  explicit PageSizeAnalyzer(MemoryMap memory_map = MemoryMap::read(), const std::size_t count_candidates = 10U)
+    : _memory_map(std::move(memory_map))
+    , _count_candidates(count_candidates)
+  {
+  }
+
+  ~PageSizeAnalyzer() = default;
+
+  /**
+   * Adds a data region; accesses to that region will be reported separately.
+   *
+   * @param region Data region.
+   */
+  void add(MemoryRegion&& region) { _regions.emplace_back(std::move(region)); }
+
+  /**
+   * Adds a data region; accesses to that region will be reported separately.
+   *
+   * @param name Name of the region.
+   * @param begin Begin of the region.
+   * @param size Size of the region in bytes.
+   */
+  void add(std::string&& name, const void* begin, const std::size_t size)
+  {
+    add(MemoryRegion{ std::move(name), begin, size });
+  }
+
+  /**
+   * Analyzes the samples.
+   *
+   * @param samples List of samples.
+   * @return Page size coverage for data and code, per data region and text segment, and huge page candidates.
+   */
+  [[nodiscard]] PageSizeResult analyze(const std::vector<Sample>& samples) const;
+
+private:
+  /// Mappings of the process, used to identify text segments and name candidates.
+  MemoryMap _memory_map;
+
+  /// Number of huge page candidates to report.
+  std::size_t _count_candidates;
+
+  std::vector<MemoryRegion> _regions;
+
+  /**
+   * Names the given address by the data region or mapping it belongs to.
+   *
+   * @param address Virtual address.
+   * @return Name of the region or mapping.
+   */
+  [[nodiscard]] std::string name_of(std::uintptr_t address) const;
+};
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <linux/perf_event.h>
+
+namespace perf::perf_data {
+/**
+ * On-disk structures of the perf.data file format (version 2), as written by "perf record" and read by "perf report",
+ * "perf script", and other tools (see tools/perf/Documentation/perf.data-file-format.txt of the Linux Kernel).
+ */
+
+/// "PERFILE2" in little endian.
+constexpr static inline std::uint64_t MAGIC = 0x32454c4946524550ULL;
+
+/// Bit of the HEADER_EVENT_DESC feature (names of the events), see file_header::features.
+constexpr static inline std::uint32_t FEATURE_EVENT_DESCRIPTION = 12U;
+
+/**
+ * Section of the file, described by offset and size (in bytes).
+ */
+struct file_section
+{
+  std::uint64_t offset{ 0U };
+  std::uint64_t size{ 0U };
+};
+
+/**
+ * Header at the beginning of the file.
+ */
+struct file_header
+{
+  std::uint64_t magic{ MAGIC };
+
+  /// Size of this header.
+  std::uint64_t size{ sizeof(file_header) };
+
+  /// Size of a single entry of the attribute section (file_attribute).
+  std::uint64_t attribute_size{ 0U };
+
+  file_section attributes;
+  file_section data;
+
+  /// Unused, kept for compatibility.
+  file_section event_types;
+
+  /// Bitmap of optional feature sections following the data section.
+  std::array<std::uint64_t, 4U> features{};
+};
+
+/**
+ * Entry of the attribute section: The event attribute and the section holding the (64-bit) ids of the event.
+ */
+struct file_attribute
+{
+  perf_event_attr attribute;
+  file_section ids;
+};
+
+/**
+ * Record of type PERF_RECORD_MMAP, followed by the (zero-terminated and 8-byte aligned) file name.
+ */
+struct mmap_record
+{
+  perf_event_header header;
+  std::uint32_t process_id;
+  std::uint32_t thread_id;
+  std::uint64_t address;
+  std::uint64_t length;
+  std::uint64_t page_offset;
+};
+
+/**
+ * Record of type PERF_RECORD_COMM, followed by the (zero-terminated and 8-byte aligned) command name.
+ */
+struct comm_record
+{
+  perf_event_header header;
+  std::uint32_t process_id;
+  std::uint32_t thread_id;
+};
+}
@@ -0,0 +1,137 @@
+#pragma once
+
+#include "perf_data_format.h"
+#include "sample.h"
+#include "sample_decoder.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <linux/perf_event.h>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace perf {
+/**
+ * Reads perf.data files (written by "perf record" or the PerfDataWriter) and decodes their samples into the library's
+ * Sample type, such that recorded files can be fed into the analysis types (BranchAnalyzer, NumaAnalyzer, exporters,
+ * ...) the same way as live recordings.
+ *
+ * The data section is read in a single pass through a sliding memory-mapped window; memory consumption is constant and
+ * independent of the file size.
+ */
+class PerfDataReader
+{
+public:
+  /// Default size of the memory-mapped window over the data section.
+  constexpr static inline std::size_t DEFAULT_WINDOW_SIZE = 64U * 1024U * 1024U;
+
+  /**
+   * Opens the file and reads the header, the event attributes, and the event names.
+   * Throws a std::runtime_error if the file cannot be opened or is not a valid perf.data file.
+   *
+   * @param file_name Name of the file.
+   * @param window_size Size of the memory-mapped window over the data section (at least 1 MB).
+   */
+  explicit PerfDataReader(const std::string& file_name, std::size_t window_size = DEFAULT_WINDOW_SIZE);
+
+  PerfDataReader(PerfDataReader&& other) noexcept;
+  PerfDataReader& operator=(PerfDataReader&& other) noexcept;
+  PerfDataReader(const PerfDataReader&) = delete;
+  PerfDataReader& operator=(const PerfDataReader&) = delete;
+
+  ~PerfDataReader();
+
+  /**
+   * @return Attributes of the recorded events.
+   */
+  [[nodiscard]] const std::vector<perf_event_attr>& attributes() const noexcept { return _attributes; }
+
+  /**
+   * @return Names of the recorded events (from the event description of the file or "event-<index>"), one per
+   * attribute.
+   */
+  [[nodiscard]] const std::vector<std::string>& event_names() const noexcept { return _event_names; }
+
+  /**
+   * @return Size of the data section in bytes.
+   */
+  [[nodiscard]] std::uint64_t data_size() const noexcept { return _header.data.size; }
+
+  /**
+   * Passes every record of the data section (samples, MMAP, COMM, ...) to the callback.
+   * The record (header followed by its payload) is only valid during the callback.
+   *
+   * @param callback Callback invoked for every record.
+   */
+  void for_each_record(const std::function<void(const perf_event_header&)>& callback) const;
+
+  /**
+   * Decodes every sample (PERF_RECORD_SAMPLE) according to the attribute of its event and passes it to the callback.
+   * Other records are skipped.
+   *
+   * @param callback Callback invoked for every sample.
+   */
+  void for_each_sample(const std::function<void(Sample&&)>& callback) const;
+
+  /**
+   * Decodes all samples of the file into a list.
+   * Note that the list is held in memory; use for_each_sample() for large files.
+   *
+   * @return List of samples.
+   */
+  [[nodiscard]] std::vector<Sample> result() const;
+
+private:
+  std::int32_t _file_descriptor{ -1 };
+  std::uint64_t _file_size{ 0U };
+  std::size_t _window_size;
+  perf_data::file_header _header;
+
+  /// Attributes, names, ids, and decoders of the recorded events (in the order of the attribute section).
+  std::vector<perf_event_attr> _attributes;
+  std::vector<std::string> _event_names;
+  std::vector<std::vector<std::uint64_t>> _event_ids;
+  std::vector<SampleDecoder> _decoders;
+
+  /// Maps an event id to the index of the attribute.
+  std::unordered_map<std::uint64_t, std::size_t> _attribute_index_by_id;
+
+  /// Position (in 64-bit words) of the id within a sample, used to find the attribute of a sample.
+  std::optional<std::size_t> _sample_id_position;
+
+  /**
+   * Reads exactly the requested bytes at the given offset of the file.
+   *
+   * @param offset Offset in the file.
+   * @param data Destination.
+   * @param size Number of bytes to read.
+   * @return True, if all bytes were read.
+   */
+  [[nodiscard]] bool read(std::uint64_t offset, void* data, std::size_t size) const;
+
+  /**
+   * Reads the event names from the HEADER_EVENT_DESC feature section, if present.
+   */
+  void read_event_description();
+
+  /**
+   * Creates the decoders; sampled counter values are named after the events of the file.
+   */
+  void create_decoders();
+
+  /**
+   * Looks up the decoder for the given sample record.
+   *
+   * @param record Sample record.
+   * @return Decoder of the event that recorded the sample, or nullptr if the event is unknown.
+   */
+  [[nodiscard]] const SampleDecoder* decoder(const perf_event_header& record) const;
+
+  /**
+   * Closes the file.
+   */
+  void close();
+};
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "sampler.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <sys/types.h>
+#include <vector>
+
+namespace perf {
+/**
+ * Writes the recordings of a Sampler into a perf.data file, which can be opened by the standard Linux tools
+ * ("perf report", "perf script", hotspot, ...).
+ *
+ * The file contains the event attributes of all counters of the sampler, synthesized PERF_RECORD_COMM and
+ * PERF_RECORD_MMAP records for the executable mappings that existed before sampling (read from /proc/<pid>/maps),
+ * the raw records of the sampler's ring buffer (samples and MMAP/COMM records emitted by the kernel during
+ * sampling), which are copied without decoding, and the names of the events (HEADER_EVENT_DESC feature).
+ */
+class PerfDataWriter
+{
+public:
+  /**
+   * Writes the recordings of the sampler into a perf.data file.
+   * The sampler must be stopped, but not yet closed.
+   *
+   * @param file_name Name of the file.
+   * @param sampler Sampler to write.
+   * @return True, if the file was written.
+   */
+  [[nodiscard]] static bool write(const std::string& file_name, const Sampler& sampler);
+
+private:
+  /**
+   * Creates PERF_RECORD_COMM and PERF_RECORD_MMAP records for the executable mappings of the given process.
+   * If the attribute sets sample_id_all, every record carries the sample id fields of the attribute (as the records
+   * emitted by the kernel).
+   *
+   * @param process_id Id of the process.
+   * @param attribute Attribute of the sampling counter.
+   * @param id Id of the sampling counter.
+   * @return Records, one after another.
+   */
+  [[nodiscard]] static std::vector<std::byte> synthesize_records(pid_t process_id,
+                                                                 const perf_event_attr& attribute,
+                                                                 std::uint64_t id);
+
+  /**
+   * Creates the sample id fields (struct sample_id, see "man perf_event_open") that follow every record other than
+   * samples if the attribute sets sample_id_all.
+   *
+   * @param process_id Id of the process.
+   * @param attribute Attribute of the sampling counter.
+   * @param id Id of the sampling counter.
+   * @return Sample id fields, or an empty list if the attribute does not set sample_id_all.
+   */
+  [[nodiscard]] static std::vector<std::byte> sample_id(pid_t process_id,
+                                                        const perf_event_attr& attribute,
+                                                        std::uint64_t id);
+
+  /**
+   * Appends the bytes of a value to the buffer.
+   *
+   * @param buffer Buffer to append to.
+   * @param value Value to append.
+   */
+  template <typename T>
+  static void append(std::vector<std::byte>& buffer, const T& value);
+
+  /**
+   * Appends a record with a trailing string (zero-terminated and padded to 8 bytes) and the sample id fields to the
+   * buffer.
+   *
+   * @param buffer Buffer to append to.
+   * @param record Fixed part of the record; the size in its header is updated.
+   * @param string Trailing string.
+   * @param sample_id Sample id fields (see sample_id()).
+   */
+  template <typename R>
+  static void append_record(std::vector<std::byte>& buffer,
+                            R record,
+                            const std::string& string,
+                            const std::vector<std::byte>& sample_id);
+};
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "hash.h"
+#include "memory_map.h"
+#include "sample.h"
+#include "symbol_resolver.h"
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace perf {
+/**
+ * Aggregates sampled callchains (see Sampler::Type::Callchain; or the instruction pointer, if no callchain was
+ * sampled) and writes them as pprof profile (profile.proto, uncompressed), which is read by the pprof tool and
+ * continuous-profiling services.
+ *
+ * Samples are aggregated by their callchain in a hash map, counting samples and summing up their periods; locations,
+ * functions (resolved from the symbol tables of the binaries), and mappings (from the memory map of the process) are
+ * created only when writing the profile, once per distinct address.
+ * Profiles recorded separately (e.g., per thread) can be merged into a single profile before writing.
+ * The protobuf encoding is written by hand; compress the file (e.g., with gzip) if required by the consumer.
+ */
+class PprofExporter
+{
+public:
+  /**
+   * Creates the exporter.
+   *
+   * @param event_name Name of the sampled event (e.g., "cycles"), used as type of the sample values.
+   * @param period Sampling period (see SampleConfig::period()), used for samples without sampled period.
+   * @param memory_map Memory map used to attribute addresses to binaries; must be read while the profiled binaries
+   * are still loaded.
+   */
+  explicit PprofExporter(std::string event_name, std::uint64_t period = 1U, MemoryMap memory_map = MemoryMap::read());
+
+  ~PprofExporter() = default;
+
+  /**
+   * Adds the callchain of a single sample to the profile; context switches are skipped.
+   *
+   * @param sample Sample to add.
+   */
+  void add(const Sample& sample);
+
+  /**
+   * Adds the callchains of all samples to the profile.
+   *
+   * @param samples List of samples.
+   */
+  void add(const std::vector<Sample>& samples)
+  {
+    for (const auto& sample : samples) {
+      add(sample);
+    }
+  }
+
+  /**
+   * Merges the aggregated callchains of another profile (e.g., recorded by another thread) into this profile.
+   *
+   * @param other Profile to merge.
+   */
+  void merge(const PprofExporter& other);
+
+  /**
+   * @return Number of samples added to the profile.
+   */
+  [[nodiscard]] std::uint64_t count_samples() const noexcept { return _count_samples; }
+
+  /**
+   * @return Number of distinct callchains.
+   */
+  [[nodiscard]] std::size_t count_stacks() const noexcept { return _stacks.size(); }
+
+  /**
+   * Writes the profile as (uncompressed) protobuf.
+   *
+   * @param stream Stream to write the profile to.
+   */
+  void write(std::ostream& stream);
+
+  /**
+   * Writes the profile as (uncompressed) protobuf to a file.
+   *
+   * @param file_name Name of the file.
+   * @return True, if the file was written.
+   */
+  [[nodiscard]] bool write(const std::string& file_name);
+
+private:
+  /// Number of samples and sum of their periods.
+  struct stack_values
+  {
+    std::uint64_t count{ 0U };
+    std::uint64_t period{ 0U };
+  };
+
+  std::string _event_name;
+  std::uint64_t _period;
+
+  /// Translates sampled addresses into binaries and symbols.
+  SymbolResolver _symbol_resolver;
+
+  /// Aggregated values by callchain (leaf first).
+  std::unordered_map<std::vector<std::uintptr_t>, stack_values, callchain_hash> _stacks;
+
+  std::uint64_t _count_samples{ 0U };
+
+  /// Wall-clock time of creating the profile in nanoseconds since epoch.
+  std::uint64_t _time_nanos;
+
+  /// Range of the timestamps of the samples (if sampled).
+  std::optional<std::pair<std::uint64_t, std::uint64_t>> _time_range{ std::nullopt };
+};
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <linux/perf_event.h>
+
+namespace perf::raw_spill {
+/**
+ * On-disk structures of raw spill files, written by the RawSpillWriter and decoded offline by the RawSpillReader.
+ *
+ * Layout: file_header | counter (one per counter of the sampler) | data (raw records of the ring buffer, as emitted by
+ * the Linux Kernel, in the order they were drained).
+ */
+
+/// "PERFCPPR" in little endian.
+constexpr static inline std::uint64_t MAGIC = 0x5250504346524550ULL;
+
+/// Version of the format.
+constexpr static inline std::uint32_t VERSION = 1U;
+
+/**
+ * Configuration of the sampler (SampleConfig) at the time of recording.
+ */
+struct sample_config
+{
+  std::uint64_t sample_type{ 0U };
+  std::uint64_t buffer_pages{ 0U };
+  std::uint64_t frequency_or_period{ 0U };
+  std::uint64_t user_registers{ 0U };
+  std::uint64_t kernel_registers{ 0U };
+  std::uint64_t branch_type{ 0U };
+  std::int32_t process_id{ 0 };
+
+  /// Id of the recorded CPU, or -1 if the sampler recorded all CPUs.
+  std::int32_t cpu_id{ -1 };
+  std::uint16_t max_stack{ 0U };
+  std::uint8_t is_frequency{ 0U };
+  std::uint8_t precise_ip{ 0U };
+
+  /// Bits: child threads, kernel, user, hypervisor, idle, guest.
+  std::uint8_t include{ 0U };
+  std::array<std::uint8_t, 3U> reserved{};
+};
+
+/**
+ * Header at the beginning of the file.
+ */
+struct file_header
+{
+  std::uint64_t magic{ MAGIC };
+  std::uint32_t version{ VERSION };
+
+  /// Size of the perf_event_attr of every counter entry.
+  std::uint32_t attribute_size{ sizeof(perf_event_attr) };
+
+  std::uint32_t count_counters{ 0U };
+
+  /// Index of the counter whose attribute defines the layout of samples.
+  std::uint32_t sampling_counter_index{ 0U };
+
+  /// Offset and size of the data; the size is written when the file is closed (0 for incomplete files).
+  std::uint64_t data_offset{ 0U };
+  std::uint64_t data_size{ 0U };
+
+  sample_config config;
+};
+
+/**
+ * Entry describing a counter of the sampler, following the header (and preceded by its perf_event_attr).
+ */
+struct counter
+{
+  std::uint64_t id{ 0U };
+
+  /// Zero-terminated (and possibly truncated) name of the counter.
+  std::array<char, 56U> name{};
+};
+}
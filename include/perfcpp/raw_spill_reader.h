@@ -0,0 +1,98 @@
+#pragma once
+
+#include "config.h"
+#include "raw_spill_format.h"
+#include "sample.h"
+#include "sample_decoder.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <linux/perf_event.h>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace perf {
+/**
+ * Decodes raw spill files (written by the RawSpillWriter) offline, using the counter attributes stored in the file.
+ */
+class RawSpillReader
+{
+public:
+  /**
+   * Opens and maps the file.
+   * Throws a std::runtime_error if the file cannot be opened or is not a raw spill file.
+   *
+   * @param file_name Name of the file.
+   */
+  explicit RawSpillReader(const std::string& file_name);
+
+  RawSpillReader(RawSpillReader&& other) noexcept;
+  RawSpillReader& operator=(RawSpillReader&& other) noexcept;
+  RawSpillReader(const RawSpillReader&) = delete;
+  RawSpillReader& operator=(const RawSpillReader&) = delete;
+
+  ~RawSpillReader();
+
+  /**
+   * @return Configuration of the sampler that recorded the file.
+   */
+  [[nodiscard]] SampleConfig config() const noexcept;
+
+  /**
+   * @return Sample type (combination of Sampler::Type values) of the sampler that recorded the file.
+   */
+  [[nodiscard]] std::uint64_t sample_type() const noexcept { return _header.config.sample_type; }
+
+  /**
+   * @return Attributes of the recorded counters.
+   */
+  [[nodiscard]] const std::vector<perf_event_attr>& attributes() const noexcept { return _attributes; }
+
+  /**
+   * @return Names of the recorded counters.
+   */
+  [[nodiscard]] const std::vector<std::string>& counter_names() const noexcept { return _counter_names; }
+
+  /**
+   * @return Size of the raw records in bytes.
+   */
+  [[nodiscard]] std::uint64_t data_size() const noexcept { return _header.data_size; }
+
+  /**
+   * Passes every raw record (samples, MMAP, COMM, LOST, ...) to the callback.
+   *
+   * @param callback Callback invoked for every record.
+   */
+  void for_each_record(const std::function<void(const perf_event_header&)>& callback) const;
+
+  /**
+   * Decodes every sample and passes it to the callback.
+   *
+   * @param callback Callback invoked for every sample.
+   */
+  void for_each_sample(const std::function<void(Sample&&)>& callback) const;
+
+  /**
+   * Decodes all samples of the file into a list.
+   *
+   * @return List of samples.
+   */
+  [[nodiscard]] std::vector<Sample> result() const;
+
+private:
+  /// Mapped file.
+  const std::byte* _data{ nullptr };
+  std::size_t _size{ 0U };
+
+  raw_spill::file_header _header;
+  std::vector<perf_event_attr> _attributes;
+  std::vector<std::string> _counter_names;
+  std::optional<SampleDecoder> _decoder;
+
+  /**
+   * Unmaps the file.
+   */
+  void close();
+};
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "raw_spill_format.h"
+#include "sampler.h"
+#include <cstdint>
+#include <string>
+
+namespace perf {
+/**
+ * Spills the raw records of a Sampler's ring buffer into a file, without decoding them in the recording process.
+ * Every drain() copies the bytes between data_tail and data_head of the ring buffer into the file (one vectored write
+ * straight from the ring buffer) and releases the space to the Linux Kernel by advancing data_tail; the recording
+ * can therefore run longer than the ring buffer would hold, as long as the buffer is drained frequently enough.
+ *
+ * The file starts with the attributes and the names of all counters and the SampleConfig of the sampler, such that it
+ * can be decoded offline by the RawSpillReader.
+ */
+class RawSpillWriter
+{
+public:
+  /**
+   * Creates the file and writes the header.
+   * The sampler must be started (i.e., opened) and must outlive the writer.
+   * Throws a std::runtime_error if the sampler is not opened or the file cannot be created.
+   *
+   * @param file_name Name of the file.
+   * @param sampler Sampler to drain.
+   */
+  RawSpillWriter(const std::string& file_name, Sampler& sampler);
+
+  RawSpillWriter(const RawSpillWriter&) = delete;
+  RawSpillWriter& operator=(const RawSpillWriter&) = delete;
+
+  /**
+   * Closes the file, if not already closed.
+   */
+  ~RawSpillWriter();
+
+  /**
+   * Writes all records currently held by the ring buffer into the file and releases them from the ring buffer.
+   * Drained records are no longer visible to sampler.result().
+   *
+   * @return True, if the records were written.
+   */
+  bool drain();
+
+  /**
+   * Drains the ring buffer a last time, completes the header, and closes the file.
+   *
+   * @return True, if the file was written successfully.
+   */
+  bool close();
+
+  /**
+   * @return Number of bytes of raw records written so far.
+   */
+  [[nodiscard]] std::uint64_t count_bytes() const noexcept { return _header.data_size; }
+
+private:
+  Sampler& _sampler;
+  std::int32_t _file_descriptor{ -1 };
+  raw_spill::file_header _header;
+};
+}
@@ -151,6 +151,11 @@ public:
 
   Registers() noexcept = default;
 
+  explicit Registers(const std::uint64_t mask) noexcept
+    : _mask(mask)
+  {
+  }
+
   Registers(std::vector<x86>&& registers) noexcept
   {
     for (const auto reg : registers) {
@@ -0,0 +1,380 @@
+#pragma once
+
+#include "benchmark.h"
+#include "counter.h"
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace perf {
+/**
+ * Metadata of a benchmark run, stored along with its results to make runs comparable.
+ */
+class RunMetadata
+{
+public:
+  RunMetadata() = default;
+  RunMetadata(const std::uint64_t timestamp,
+              std::string cpu_model,
+              std::string kernel,
+              std::string git_sha,
+              std::string config) noexcept
+    : _timestamp(timestamp)
+    , _cpu_model(std::move(cpu_model))
+    , _kernel(std::move(kernel))
+    , _git_sha(std::move(git_sha))
+    , _config(std::move(config))
+  {
+  }
+
+  ~RunMetadata() = default;
+
+  /**
+   * Collects the metadata of the current run: the current time, the CPU model, and the release of the Linux kernel
+   * (see SystemInfo).
+   *
+   * @param git_sha Revision of the benchmarked code (e.g., from "git rev-parse HEAD").
+   * @param config Free-form description of the benchmark configuration (e.g., input size or compiler flags).
+   * @return Metadata of the current run.
+   */
+  [[nodiscard]] static RunMetadata current(std::string git_sha = {}, std::string config = {});
+
+  /**
+   * @return Start of the run in seconds since the epoch.
+   */
+  [[nodiscard]] std::uint64_t timestamp() const noexcept { return _timestamp; }
+  [[nodiscard]] const std::string& cpu_model() const noexcept { return _cpu_model; }
+  [[nodiscard]] const std::string& kernel() const noexcept { return _kernel; }
+  [[nodiscard]] const std::string& git_sha() const noexcept { return _git_sha; }
+  [[nodiscard]] const std::string& config() const noexcept { return _config; }
+
+private:
+  std::uint64_t _timestamp{ 0U };
+  std::string _cpu_model;
+  std::string _kernel;
+  std::string _git_sha;
+  std::string _config;
+};
+
+/**
+ * Results (values of counters and metrics) of a single run of a benchmark, as stored in the ResultStore.
+ */
+class StoredResult
+{
+public:
+  using const_iterator = std::vector<std::pair<std::string, double>>::const_iterator;
+
+  StoredResult(std::string benchmark,
+               RunMetadata metadata,
+               std::vector<std::pair<std::string, double>>&& values) noexcept
+    : _benchmark(std::move(benchmark))
+    , _metadata(std::move(metadata))
+    , _values(std::move(values))
+  {
+  }
+
+  ~StoredResult() = default;
+
+  [[nodiscard]] const std::string& benchmark() const noexcept { return _benchmark; }
+  [[nodiscard]] const RunMetadata& metadata() const noexcept { return _metadata; }
+
+  /**
+   * Access the value of the counter or metric with the given name.
+   *
+   * @param name Name of the counter or metric.
+   * @return The value, or std::nullopt if the run did not record the counter or metric.
+   */
+  [[nodiscard]] std::optional<double> get(std::string_view name) const noexcept;
+
+  [[nodiscard]] const_iterator begin() const { return _values.begin(); }
+  [[nodiscard]] const_iterator end() const { return _values.end(); }
+
+private:
+  std::string _benchmark;
+  RunMetadata _metadata;
+  std::vector<std::pair<std::string, double>> _values;
+};
+
+/**
+ * Append-only history of benchmark results in a JSON-lines file: every line holds the values of one run of a
+ * benchmark with the metadata of the run, e.g.,
+ * {"benchmark":"gather","timestamp":1700000000,"metadata":{"cpu_model":"...","kernel":"6.8.0","git_sha":"...",
+ * "config":"..."},"values":{"cycles":12.5,"instructions":7.25}}
+ */
+class ResultStore
+{
+public:
+  explicit ResultStore(std::string file_name)
+    : _file_name(std::move(file_name))
+  {
+  }
+
+  ~ResultStore() = default;
+
+  /**
+   * Appends the values of a run to the store.
+   *
+   * @param benchmark Name of the benchmark.
+   * @param values Values of counters and metrics.
+   * @param metadata Metadata of the run.
+   * @return True, if the line could be appended.
+   */
+  bool append(std::string_view benchmark,
+              const std::vector<std::pair<std::string, double>>& values,
+              const RunMetadata& metadata = RunMetadata::current()) const;
+
+  /**
+   * Appends the result of a run (e.g., of an EventCounter) to the store.
+   *
+   * @param benchmark Name of the benchmark.
+   * @param result Values of counters and metrics.
+   * @param metadata Metadata of the run.
+   * @return True, if the line could be appended.
+   */
+  bool append(std::string_view benchmark,
+              const CounterResult& result,
+              const RunMetadata& metadata = RunMetadata::current()) const;
+
+  /**
+   * Appends the medians of all counters and metrics, and of the time (as "time (ns)"), of a perf::Benchmark run to
+   * the store.
+   *
+   * @param benchmark Name of the benchmark.
+   * @param result Result of the benchmark.
+   * @param metadata Metadata of the run.
+   * @return True, if the line could be appended.
+   */
+  bool append(std::string_view benchmark,
+              const BenchmarkResult& result,
+              const RunMetadata& metadata = RunMetadata::current()) const;
+
+  /**
+   * Reads all results from the store in the order they were appended; malformed lines are skipped.
+   *
+   * @return List of stored results.
+   */
+  [[nodiscard]] std::vector<StoredResult> read() const;
+
+  /**
+   * Reads the results of the given benchmark from the store in the order they were appended.
+   *
+   * @param benchmark Name of the benchmark.
+   * @return List of stored results of the benchmark.
+   */
+  [[nodiscard]] std::vector<StoredResult> read(std::string_view benchmark) const;
+
+  /**
+   * Parses a flat JSON object of numbers, e.g., the output of CounterResult::to_json().
+   *
+   * @param json JSON object.
+   * @return Names and values, or std::nullopt if the JSON is malformed.
+   */
+  [[nodiscard]] static std::optional<std::vector<std::pair<std::string, double>>> parse_values(std::string_view json);
+
+private:
+  std::string _file_name;
+};
+
+/**
+ * Comparison of a single counter (or metric) of the latest run against the baseline.
+ */
+class RegressionCheck
+{
+public:
+  enum class Verdict : std::uint8_t
+  {
+    /// The latest run is significantly worse than the baseline.
+    Regression,
+
+    /// The latest run is significantly better than the baseline.
+    Improvement,
+
+    /// The latest run is within the noise of the baseline.
+    Unchanged,
+
+    /// The baseline holds too few runs to decide.
+    InsufficientHistory
+  };
+
+  RegressionCheck(std::string name,
+                  const double value,
+                  const double baseline,
+                  const double relative_change,
+                  const double score,
+                  const Verdict verdict) noexcept
+    : _name(std::move(name))
+    , _value(value)
+    , _baseline(baseline)
+    , _relative_change(relative_change)
+    , _score(score)
+    , _verdict(verdict)
+  {
+  }
+
+  ~RegressionCheck() = default;
+
+  [[nodiscard]] const std::string& name() const noexcept { return _name; }
+
+  /**
+   * @return Value of the latest run.
+   */
+  [[nodiscard]] double value() const noexcept { return _value; }
+
+  /**
+   * @return Median of the baseline runs.
+   */
+  [[nodiscard]] double baseline() const noexcept { return _baseline; }
+
+  /**
+   * @return Relative change of the latest run to the baseline median, i.e., (value - baseline) / baseline.
+   */
+  [[nodiscard]] double relative_change() const noexcept { return _relative_change; }
+
+  /**
+   * @return Distance of the latest run to the baseline median in robust standard deviations (scaled median absolute
+   * deviation); positive values are worse than the baseline.
+   */
+  [[nodiscard]] double score() const noexcept { return _score; }
+
+  [[nodiscard]] Verdict verdict() const noexcept { return _verdict; }
+
+  [[nodiscard]] static std::string_view to_string(Verdict verdict) noexcept;
+
+private:
+  std::string _name;
+  double _value;
+  double _baseline;
+  double _relative_change;
+  double _score;
+  Verdict _verdict;
+};
+
+/**
+ * Report of checking the latest run of a benchmark against its baseline.
+ */
+class RegressionReport
+{
+public:
+  using const_iterator = std::vector<RegressionCheck>::const_iterator;
+
+  RegressionReport(std::string benchmark,
+                   RunMetadata metadata,
+                   const std::size_t count_baseline_runs,
+                   std::vector<RegressionCheck>&& checks) noexcept
+    : _benchmark(std::move(benchmark))
+    , _metadata(std::move(metadata))
+    , _count_baseline_runs(count_baseline_runs)
+    , _checks(std::move(checks))
+  {
+  }
+
+  ~RegressionReport() = default;
+
+  [[nodiscard]] const std::string& benchmark() const noexcept { return _benchmark; }
+
+  /**
+   * @return Metadata of the latest (checked) run.
+   */
+  [[nodiscard]] const RunMetadata& metadata() const noexcept { return _metadata; }
+
+  /**
+   * @return Number of runs that formed the baseline.
+   */
+  [[nodiscard]] std::size_t count_baseline_runs() const noexcept { return _count_baseline_runs; }
+
+  /**
+   * @return True, if any counter or metric regressed.
+   */
+  [[nodiscard]] bool has_regression() const noexcept;
+
+  [[nodiscard]] const_iterator begin() const { return _checks.begin(); }
+  [[nodiscard]] const_iterator end() const { return _checks.end(); }
+
+  /**
+   * @return Table of all checks, one row per counter and metric.
+   */
+  [[nodiscard]] std::string to_string() const;
+
+private:
+  std::string _benchmark;
+  RunMetadata _metadata;
+  std::size_t _count_baseline_runs;
+  std::vector<RegressionCheck> _checks;
+};
+
+/**
+ * Detects regressions of the latest run of a benchmark against a rolling baseline, formed by the preceding runs on the
+ * same CPU model with the same configuration.
+ *
+ * A counter (or metric) regresses if the latest value is worse than the median of the baseline by more than the
+ * threshold in robust standard deviations (the median absolute deviation scaled by 1.4826) and by more than the
+ * minimal relative change; improvements are detected likewise. By default, lower values are better.
+ */
+class RegressionDetector
+{
+public:
+  RegressionDetector() = default;
+  ~RegressionDetector() = default;
+
+  /**
+   * Sets the maximal number of preceding runs that form the baseline.
+   *
+   * @param window Number of runs.
+   */
+  void window(const std::size_t window) noexcept { _window = window; }
+
+  /**
+   * Sets the minimal number of baseline runs needed to decide.
+   *
+   * @param min_baseline_runs Number of runs.
+   */
+  void min_baseline_runs(const std::size_t min_baseline_runs) noexcept { _min_baseline_runs = min_baseline_runs; }
+
+  /**
+   * Sets the threshold in robust standard deviations.
+   *
+   * @param threshold Threshold, e.g., 3.
+   */
+  void threshold(const double threshold) noexcept { _threshold = threshold; }
+
+  /**
+   * Sets the minimal relative change, such that negligible changes of very stable counters are not flagged.
+   *
+   * @param min_relative_change Relative change, e.g., 0.02 for 2%.
+   */
+  void min_relative_change(const double min_relative_change) noexcept { _min_relative_change = min_relative_change; }
+
+  /**
+   * Marks the counter or metric as higher-is-better (e.g., instructions-per-cycle).
+   *
+   * @param name Name of the counter or metric.
+   */
+  void higher_is_better(std::string name) { _higher_is_better.push_back(std::move(name)); }
+
+  [[nodiscard]] std::size_t window() const noexcept { return _window; }
+  [[nodiscard]] std::size_t min_baseline_runs() const noexcept { return _min_baseline_runs; }
+  [[nodiscard]] double threshold() const noexcept { return _threshold; }
+  [[nodiscard]] double min_relative_change() const noexcept { return _min_relative_change; }
+
+  /**
+   * Checks the latest run of the benchmark against its baseline.
+   *
+   * @param history Stored results in the order they were appended (see ResultStore::read()).
+   * @param benchmark Name of the benchmark.
+   * @return The report, or std::nullopt if the history holds no run of the benchmark.
+   */
+  [[nodiscard]] std::optional<RegressionReport> check(const std::vector<StoredResult>& history,
+                                                      std::string_view benchmark) const;
+
+private:
+  std::size_t _window{ 10U };
+  std::size_t _min_baseline_runs{ 3U };
+  double _threshold{ 3. };
+  double _min_relative_change{ .02 };
+  std::vector<std::string> _higher_is_better;
+};
+}
@@ -211,6 +211,11 @@ public:
    */
   [[nodiscard]] bool is_snoop_hit_modified() const noexcept { return static_cast<bool>(snoop() & PERF_MEM_SNOOP_HITM); }
 
+  /**
+   * @return Raw perf_mem_data_src value as recorded by perf.
+   */
+  [[nodiscard]] std::uint64_t value() const noexcept { return _data_source; }
+
   /**
    * @return Direct access to the MEM_OP structure of the perf_mem_data_src.
    */
@@ -304,7 +309,8 @@ public:
          const bool is_predicted,
          const bool is_in_transaction,
          const bool is_transaction_abort,
-         const std::uint16_t cycles)
+         const std::uint16_t cycles,
+         const std::uint8_t type = PERF_BR_UNKNOWN)
     : _instruction_pointer_from(instruction_pointer_from)
     , _instruction_pointer_to(instruction_pointer_to)
     , _is_mispredicted(is_mispredicted)
@@ -312,6 +318,7 @@ public:
     , _is_in_transaction(is_in_transaction)
     , _is_transaction_abort(is_transaction_abort)
     , _cycles(cycles)
+    , _type(type)
   {
     // Constructor body (if needed for further initialization)
   }
@@ -324,6 +331,12 @@ public:
   [[nodiscard]] bool is_transaction_abort() const noexcept { return _is_transaction_abort; }
   [[nodiscard]] std::uint16_t cycles() const noexcept { return _cycles; }
 
+  /**
+   * @return Type of the branch (PERF_BR_*, e.g., PERF_BR_IND_CALL), if recorded with BranchType::TypeSave;
+   * PERF_BR_UNKNOWN otherwise.
+   */
+  [[nodiscard]] std::uint8_t type() const noexcept { return _type; }
+
 private:
   std::uintptr_t _instruction_pointer_from;
   std::uintptr_t _instruction_pointer_to;
@@ -332,6 +345,7 @@ private:
   bool _is_in_transaction;
   bool _is_transaction_abort;
   std::uint16_t _cycles;
+  std::uint8_t _type;
 };
 
 class Weight
@@ -361,6 +375,65 @@ private:
   std::uint16_t _var3{ 0U };
 };
 
+/**
+ * Context switch of the recorded thread (or CPU), recorded if the SampleConfig enables context switches.
+ */
+class ContextSwitch
+{
+public:
+  ContextSwitch(const bool is_out, const bool is_preempt) noexcept
+    : _is_out(is_out)
+    , _is_preempt(is_preempt)
+  {
+  }
+
+  ContextSwitch(const bool is_out,
+                const bool is_preempt,
+                const std::uint32_t process_id,
+                const std::uint32_t thread_id) noexcept
+    : _is_out(is_out)
+    , _is_preempt(is_preempt)
+    , _process_id(process_id)
+    , _thread_id(thread_id)
+  {
+  }
+
+  ~ContextSwitch() noexcept = default;
+
+  /**
+   * @return True, if the thread was switched out.
+   */
+  [[nodiscard]] bool is_out() const noexcept { return _is_out; }
+
+  /**
+   * @return True, if the thread was switched in.
+   */
+  [[nodiscard]] bool is_in() const noexcept { return !_is_out; }
+
+  /**
+   * @return True, if the thread was switched out while still runnable (i.e., preempted).
+   */
+  [[nodiscard]] bool is_preempt() const noexcept { return _is_preempt; }
+
+  /**
+   * @return Process id of the next (when switching out) or previous (when switching in) process; only recorded when
+   * sampling a CPU.
+   */
+  [[nodiscard]] std::optional<std::uint32_t> process_id() const noexcept { return _process_id; }
+
+  /**
+   * @return Thread id of the next (when switching out) or previous (when switching in) thread; only recorded when
+   * sampling a CPU.
+   */
+  [[nodiscard]] std::optional<std::uint32_t> thread_id() const noexcept { return _thread_id; }
+
+private:
+  bool _is_out;
+  bool _is_preempt;
+  std::optional<std::uint32_t> _process_id{ std::nullopt };
+  std::optional<std::uint32_t> _thread_id{ std::nullopt };
+};
+
 class Sample
 {
 public:
@@ -416,6 +489,7 @@ public:
   void callchain(std::vector<std::uintptr_t>&& callchain) noexcept { _callchain = std::move(callchain); }
   void data_page_size(const std::uint64_t size) noexcept { _data_page_size = size; }
   void code_page_size(const std::uint64_t size) noexcept { _code_page_size = size; }
+  void context_switch(const ContextSwitch context_switch) noexcept { _context_switch = context_switch; }
 
   [[nodiscard]] Mode mode() const noexcept { return _mode; }
   [[nodiscard]] std::optional<std::uint64_t> sample_id() const noexcept { return _sample_id; }
@@ -456,6 +530,12 @@ public:
   [[nodiscard]] std::optional<std::uint64_t> data_page_size() const noexcept { return _data_page_size; }
   [[nodiscard]] std::optional<std::uint64_t> code_page_size() const noexcept { return _code_page_size; }
 
+  /**
+   * @return Context switch, if the sample was created from a context switch record (only recorded if enabled in the
+   * SampleConfig); such samples carry only the thread id, time, CPU id, and sample id (as far as sampled).
+   */
+  [[nodiscard]] std::optional<ContextSwitch> context_switch() const noexcept { return _context_switch; }
+
 private:
   Mode _mode;
   std::optional<std::uint64_t> _sample_id{ std::nullopt };
@@ -479,5 +559,6 @@ private:
   std::optional<std::vector<std::uintptr_t>> _callchain{ std::nullopt };
   std::optional<std::uint64_t> _data_page_size{ std::nullopt };
   std::optional<std::uint64_t> _code_page_size{ std::nullopt };
+  std::optional<ContextSwitch> _context_switch{ std::nullopt };
 };
 }
\ No newline at end of file
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "sample.h"
+#include <bitset>
+#include <cstdint>
+#include <linux/perf_event.h>
+#include <optional>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace perf {
+/**
+ * Decodes PERF_RECORD_SAMPLE records into Samples, following the layout defined by the perf_event_attr the records
+ * were recorded with (sample_type, read_format, branch_sample_type, and register masks).
+ * Used for live recordings (Sampler) as well as for recorded files (PerfDataReader).
+ */
+class SampleDecoder
+{
+public:
+  /**
+   * Creates a decoder for records of the given event.
+   *
+   * @param attribute Attribute of the event that recorded the samples.
+   * @param counter_names Names of the counters (by counter id) to decode sampled counter values; if the read format
+   * does not include ids, the counter values are named in order.
+   */
+  explicit SampleDecoder(const perf_event_attr& attribute,
+                         std::vector<std::pair<std::uint64_t, std::string_view>>&& counter_names = {})
+    : _sample_type(attribute.sample_type)
+    , _read_format(attribute.read_format)
+    , _branch_sample_type(attribute.branch_sample_type)
+    , _count_user_registers(std::bitset<64>{ attribute.sample_regs_user }.count())
+    , _count_kernel_registers(std::bitset<64>{ attribute.sample_regs_intr }.count())
+    , _counter_names(std::move(counter_names))
+  {
+  }
+
+  ~SampleDecoder() = default;
+
+  /**
+   * Decodes a single PERF_RECORD_SAMPLE record, or a context switch record (PERF_RECORD_SWITCH or
+   * PERF_RECORD_SWITCH_CPU_WIDE) into a sample holding the context switch.
+   * Only fields within the record (see perf_event_header::size) are read: decoding stops at the first field that
+   * exceeds a corrupted (or truncated) record, leaving the remaining fields unset.
+   *
+   * @param record Header of the record, followed by the (contiguous) sample.
+   * @return Decoded sample.
+   */
+  [[nodiscard]] Sample decode(const perf_event_header& record) const;
+
+  /**
+   * @param record Header of a record.
+   * @return True, if the record is a context switch record (PERF_RECORD_SWITCH or PERF_RECORD_SWITCH_CPU_WIDE).
+   */
+  [[nodiscard]] static bool is_context_switch(const perf_event_header& record) noexcept;
+
+  [[nodiscard]] std::uint64_t sample_type() const noexcept { return _sample_type; }
+
+private:
+  std::uint64_t _sample_type;
+  std::uint64_t _read_format;
+  std::uint64_t _branch_sample_type;
+  std::uint64_t _count_user_registers;
+  std::uint64_t _count_kernel_registers;
+  std::vector<std::pair<std::uint64_t, std::string_view>> _counter_names;
+
+  /**
+   * Decodes sampled counter values (PERF_SAMPLE_READ) into the sample.
+   *
+   * @param sample Sample to fill.
+   * @param sample_ptr Pointer to the read format; advanced behind the read format.
+   * @param record_end End of the record.
+   * @return True, if the read format is located within the record.
+   */
+  bool decode_counter_values(Sample& sample, std::uintptr_t& sample_ptr, std::uintptr_t record_end) const;
+
+  /**
+   * Decodes a context switch record, including the sample id fields (sample_id_all) at the end of the record.
+   *
+   * @param record Header of the record.
+   * @param sample Sample to fill.
+   */
+  void decode_context_switch(const perf_event_header& record, Sample& sample) const;
+
+  /**
+   * Reads registers (PERF_SAMPLE_REGS_USER or PERF_SAMPLE_REGS_INTR); values are only present if the ABI is set.
+   *
+   * @param sample_ptr Pointer to the ABI; advanced behind the registers.
+   * @param record_end End of the record.
+   * @param count_registers Number of registers in the mask.
+   * @return ABI and register values, or std::nullopt if the registers exceed the record.
+   */
+  [[nodiscard]] static std::optional<std::pair<std::uint64_t, std::vector<std::uint64_t>>> decode_registers(
+    std::uintptr_t& sample_ptr,
+    std::uintptr_t record_end,
+    std::uint64_t count_registers);
+};
+}
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace perf::sample_file {
+/**
+ * On-disk structures of the columnar sample file, written by the SampleFileWriter and read by the SampleFileReader.
+ *
+ * Layout: file_header | chunk 0 | chunk 1 | ... | stack table | counter name table | chunk index (one chunk_entry per
+ * chunk).
+ *
+ * Every chunk stores a fixed maximum number of samples column by column (one byte stream per Column). Every column
+ * starts with a presence bitmap (one bit per sample of the chunk, rounded up to full bytes; bit i is set if sample i
+ * holds a value), followed by the values of the present samples as LEB128 varints. Columns marked as delta-encoded
+ * store the zigzag-encoded difference to the previous value of the column within the chunk, such that every chunk can
+ * be decoded independently. Callchains are stored as references into the stack table, which holds every distinct
+ * callchain once (varint length, followed by delta-encoded instruction pointers). The counter name table holds the
+ * names of all sampled counters (varint length, followed by the characters).
+ *
+ * Lists (counter values, branches, registers) are stored as varint length, followed by their entries:
+ *  - Counter values: index into the counter name table and the bits of the (double) value.
+ *  - Branches: source and target (zigzag-encoded difference to the previous address of the column), flags
+ *    (mispredicted, predicted, in transaction, transaction abort, and the branch type), and cycles.
+ *  - Registers: 1 if the ABI is known (0 otherwise), the ABI (if known), followed by the values.
+ * Context switches are stored as flags (out, preempt, has process id, has thread id), followed by the process and
+ * thread id (if present).
+ */
+
+/// "PERFCPPS" in little endian.
+constexpr static inline std::uint64_t MAGIC = 0x5350504346524550ULL;
+
+/// Version of the format.
+constexpr static inline std::uint32_t VERSION = 3U;
+
+/// Callchains and branch stacks are taken from kernel records of at most 64 kB, holding at most 8192 entries; longer
+/// lists are rejected by the writer and the reader.
+constexpr static inline std::size_t MAX_LIST_LENGTH = 8192U;
+
+/// Registers are selected by a 64-bit mask.
+constexpr static inline std::size_t MAX_REGISTERS = 64U;
+
+/**
+ * Columns of a chunk, in the order they are stored.
+ */
+enum class Column : std::uint8_t
+{
+  Mode,
+  Time,               /// delta-encoded
+  InstructionPointer, /// delta-encoded
+  ProcessId,
+  ThreadId,
+  CPU,
+  Period,
+  LogicalMemoryAddress,  /// delta-encoded
+  PhysicalMemoryAddress, /// delta-encoded
+  DataSource,
+  WeightLatency,
+  WeightVar2,
+  WeightVar3,
+  DataPageSize,
+  CodePageSize,
+  Callchain, /// Index into the stack table.
+  SampleId,
+  Id,
+  CounterValues,   /// List.
+  Branches,        /// List.
+  UserRegisters,   /// List.
+  KernelRegisters, /// List.
+  ContextSwitch
+};
+
+/// Number of columns per chunk.
+constexpr static inline std::size_t COUNT_COLUMNS = std::size_t(Column::ContextSwitch) + 1U;
+
+/// Flags of a branch (Column::Branches).
+constexpr static inline std::uint64_t BRANCH_MISPREDICTED = 1U << 0U;
+constexpr static inline std::uint64_t BRANCH_PREDICTED = 1U << 1U;
+constexpr static inline std::uint64_t BRANCH_IN_TRANSACTION = 1U << 2U;
+constexpr static inline std::uint64_t BRANCH_TRANSACTION_ABORT = 1U << 3U;
+
+/// The type of a branch (PERF_BR_*) is stored in the flags, above the flag bits.
+constexpr static inline std::uint64_t BRANCH_TYPE_SHIFT = 4U;
+
+/// Flags of a context switch (Column::ContextSwitch).
+constexpr static inline std::uint64_t CONTEXT_SWITCH_OUT = 1U << 0U;
+constexpr static inline std::uint64_t CONTEXT_SWITCH_PREEMPT = 1U << 1U;
+constexpr static inline std::uint64_t CONTEXT_SWITCH_PROCESS_ID = 1U << 2U;
+constexpr static inline std::uint64_t CONTEXT_SWITCH_THREAD_ID = 1U << 3U;
+
+/**
+ * Header at the beginning of the file.
+ */
+struct file_header
+{
+  std::uint64_t magic{ MAGIC };
+  std::uint32_t version{ VERSION };
+  std::uint32_t count_columns{ COUNT_COLUMNS };
+  std::uint64_t count_samples{ 0U };
+  std::uint64_t count_chunks{ 0U };
+
+  /// Offset of the stack table, number of distinct callchains, and size of the table in bytes.
+  std::uint64_t stack_table_offset{ 0U };
+  std::uint64_t count_stacks{ 0U };
+  std::uint64_t stack_table_size{ 0U };
+
+  /// Offset of the counter name table, number of names, and size of the table in bytes.
+  std::uint64_t counter_name_table_offset{ 0U };
+  std::uint64_t count_counter_names{ 0U };
+  std::uint64_t counter_name_table_size{ 0U };
+
+  /// Offset of the chunk index (count_chunks entries).
+  std::uint64_t chunk_index_offset{ 0U };
+};
+
+/**
+ * Entry of the chunk index, describing the location and the content of a chunk, such that readers can skip chunks by
+ * time or thread id without decoding them.
+ */
+struct chunk_entry
+{
+  /// Offset of the chunk in the file and size in bytes.
+  std::uint64_t offset{ 0U };
+  std::uint64_t size{ 0U };
+
+  std::uint64_t count_samples{ 0U };
+
+  /// Range of the timestamps of the chunk (only valid if the chunk holds timestamps).
+  std::uint64_t min_time{ 0U };
+  std::uint64_t max_time{ 0U };
+
+  /// Range of the thread ids of the chunk, and a bitmap with bit (thread id % 64) set for every thread of the chunk.
+  std::uint32_t min_thread_id{ 0U };
+  std::uint32_t max_thread_id{ 0U };
+  std::uint64_t thread_id_bitmap{ 0U };
+
+  /// Offset of every column, relative to the beginning of the chunk; the column ends at the offset of the next.
+  std::array<std::uint32_t, COUNT_COLUMNS> column_offsets{};
+
+  /// True, if any sample of the chunk has a timestamp or a thread id, respectively.
+  std::uint8_t has_time{ 0U };
+  std::uint8_t has_thread_id{ 0U };
+  std::array<std::uint8_t, 6U> reserved{};
+};
+}
@@ -0,0 +1,190 @@
+#pragma once
+
+#include "sample.h"
+#include "sample_file_format.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace perf {
+/**
+ * Restricts the samples read from a sample file to a time range and/or a thread.
+ * Chunks that cannot contain matching samples (according to the chunk index) are skipped without decoding.
+ */
+class SampleFileFilter
+{
+public:
+  /**
+   * Only samples with a timestamp in [begin, end) are read.
+   *
+   * @param begin First timestamp.
+   * @param end Timestamp behind the last.
+   */
+  void time(const std::uint64_t begin, const std::uint64_t end) noexcept { _time = std::make_pair(begin, end); }
+
+  /**
+   * Only samples of the given thread are read.
+   *
+   * @param thread_id Id of the thread.
+   */
+  void thread_id(const std::uint32_t thread_id) noexcept { _thread_id = thread_id; }
+
+  [[nodiscard]] std::optional<std::pair<std::uint64_t, std::uint64_t>> time() const noexcept { return _time; }
+  [[nodiscard]] std::optional<std::uint32_t> thread_id() const noexcept { return _thread_id; }
+
+  /**
+   * @param chunk Entry of the chunk index.
+   * @return True, if the chunk may contain samples matching the filter.
+   */
+  [[nodiscard]] bool may_match(const sample_file::chunk_entry& chunk) const noexcept;
+
+  /**
+   * @param time Timestamp of the sample.
+   * @param thread_id Thread id of the sample.
+   * @return True, if a sample with the given timestamp and thread id matches the filter.
+   */
+  [[nodiscard]] bool matches(std::optional<std::uint64_t> time, std::optional<std::uint32_t> thread_id) const noexcept;
+
+private:
+  std::optional<std::pair<std::uint64_t, std::uint64_t>> _time{ std::nullopt };
+  std::optional<std::uint32_t> _thread_id{ std::nullopt };
+};
+
+/**
+ * Reads sample files written by the SampleFileWriter.
+ * The file is memory-mapped; chunks are decoded on demand and skipped entirely if the chunk index shows that they
+ * cannot contain samples matching the filter.
+ */
+class SampleFileReader
+{
+public:
+  /**
+   * Opens and maps the file.
+   * Throws a std::runtime_error if the file cannot be opened, is not a valid sample file, or is corrupted.
+   *
+   * @param file_name Name of the file.
+   */
+  explicit SampleFileReader(const std::string& file_name);
+
+  SampleFileReader(SampleFileReader&& other) noexcept;
+  SampleFileReader& operator=(SampleFileReader&& other) noexcept;
+  SampleFileReader(const SampleFileReader&) = delete;
+  SampleFileReader& operator=(const SampleFileReader&) = delete;
+
+  ~SampleFileReader();
+
+  /**
+   * @return Number of samples in the file.
+   */
+  [[nodiscard]] std::uint64_t count_samples() const noexcept { return _header.count_samples; }
+
+  /**
+   * @return Number of distinct callchains in the file.
+   */
+  [[nodiscard]] std::uint64_t count_stacks() const noexcept { return _header.count_stacks; }
+
+  /**
+   * @return Index of all chunks of the file.
+   */
+  [[nodiscard]] const std::vector<sample_file::chunk_entry>& chunks() const noexcept { return _chunks; }
+
+  /**
+   * Decodes the samples matching the filter and passes them one by one to the callback.
+   * Throws a std::runtime_error if a chunk is corrupted. Names of sampled counter values refer to the reader and are
+   * only valid as long as the reader is alive.
+   *
+   * @param callback Callback invoked for every matching sample.
+   * @param filter Filter for time and thread.
+   */
+  void for_each_sample(const std::function<void(Sample&&)>& callback, const SampleFileFilter& filter = {}) const;
+
+  /**
+   * Decodes the samples matching the filter into a list.
+   *
+   * @param filter Filter for time and thread.
+   * @return List of samples.
+   */
+  [[nodiscard]] std::vector<Sample> result(const SampleFileFilter& filter = {}) const;
+
+private:
+  /// Mapped file.
+  const std::uint8_t* _data{ nullptr };
+  std::size_t _size{ 0U };
+
+  sample_file::file_header _header;
+  std::vector<sample_file::chunk_entry> _chunks;
+
+  /// Offset of every callchain within the stack table.
+  std::vector<std::uint64_t> _stack_offsets;
+
+  /// Names of sampled counters (the counter name table).
+  std::vector<std::string> _counter_names;
+
+  /**
+   * Reads the counter name table and locates the callchains of the stack table.
+   *
+   * @return True, if both tables are valid.
+   */
+  [[nodiscard]] bool read_tables();
+
+  /**
+   * Decodes the callchain from the stack table.
+   *
+   * @param index Index of the callchain.
+   * @return Callchain.
+   */
+  [[nodiscard]] std::vector<std::uintptr_t> callchain(std::uint64_t index) const;
+
+  /**
+   * Decodes a LEB128 varint and advances the cursor; reads a zero when the cursor reached the end.
+   *
+   * @param cursor Cursor into the mapped file.
+   * @param end End of the readable range.
+   * @return Decoded value.
+   */
+  [[nodiscard]] static std::uint64_t read_varint(const std::uint8_t*& cursor, const std::uint8_t* end) noexcept;
+
+  /**
+   * Decodes the length of a list (see sample_file_format.h) and advances the cursor.
+   * Throws a std::runtime_error if the length exceeds the maximal length or the remaining bytes (every entry takes at
+   * least one byte).
+   *
+   * @param cursor Cursor into the mapped file.
+   * @param end End of the readable range.
+   * @param max_length Maximal length of the list.
+   * @return Length of the list.
+   */
+  [[nodiscard]] static std::size_t read_length(const std::uint8_t*& cursor,
+                                               const std::uint8_t* end,
+                                               std::size_t max_length);
+
+  /**
+   * @param chunk Entry of the chunk.
+   * @return Size of the presence bitmap at the beginning of every column of the chunk, in bytes.
+   */
+  [[nodiscard]] static std::uint64_t presence_size(const sample_file::chunk_entry& chunk) noexcept
+  {
+    return chunk.count_samples / 8U + (chunk.count_samples % 8U != 0U ? 1U : 0U);
+  }
+
+  /**
+   * Reverts the zigzag encoding of differences.
+   *
+   * @param value Zigzag-encoded value.
+   * @return Difference.
+   */
+  [[nodiscard]] static std::int64_t unzigzag(const std::uint64_t value) noexcept
+  {
+    return std::int64_t(value >> 1U) ^ -std::int64_t(value & 1U);
+  }
+
+  /**
+   * Unmaps the file.
+   */
+  void close();
+};
+}
@@ -0,0 +1,188 @@
+#pragma once
+
+#include "hash.h"
+#include "sample.h"
+#include "sample_file_format.h"
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace perf {
+/**
+ * Writes samples into a compact, columnar sample file (see sample_file_format.h) for offline analysis.
+ * Samples are collected into chunks of a fixed number of samples; every chunk is encoded column by column
+ * (delta-encoded timestamps and addresses, varint-encoded ids) and written once full, such that the writer only holds
+ * a single chunk and the table of distinct callchains in memory.
+ *
+ * The file stores all fields of a sample: mode, sample id, time, instruction pointer, process/thread id, id, cpu id,
+ * period, logical and physical memory address, data source, weight, page sizes, callchain, counter values, branches,
+ * user and kernel registers, and context switches.
+ */
+class SampleFileWriter
+{
+public:
+  /// Default number of samples per chunk.
+  constexpr static inline std::uint32_t DEFAULT_CHUNK_SIZE = 65536U;
+
+  /**
+   * Creates the file.
+   * Throws a std::runtime_error if the file cannot be created.
+   *
+   * @param file_name Name of the file.
+   * @param chunk_size Number of samples per chunk; smaller chunks allow finer-grained skipping when reading.
+   */
+  explicit SampleFileWriter(const std::string& file_name, std::uint32_t chunk_size = DEFAULT_CHUNK_SIZE);
+
+  SampleFileWriter(const SampleFileWriter&) = delete;
+  SampleFileWriter& operator=(const SampleFileWriter&) = delete;
+
+  /**
+   * Closes the file, if not already closed.
+   */
+  ~SampleFileWriter();
+
+  /**
+   * Adds a single sample to the file.
+   * Throws a std::runtime_error if the callchain, branch stack, counter values, or registers exceed the lengths the
+   * format can hold (see sample_file::MAX_LIST_LENGTH and sample_file::MAX_REGISTERS).
+   *
+   * @param sample Sample to add.
+   */
+  void add(const Sample& sample);
+
+  /**
+   * Adds a list of samples to the file.
+   *
+   * @param samples Samples to add.
+   */
+  void add(const std::vector<Sample>& samples);
+
+  /**
+   * Writes the remaining samples, the stack table, and the chunk index, and closes the file.
+   *
+   * @return True, if the file was written successfully.
+   */
+  bool close();
+
+  /**
+   * @return Number of samples added so far.
+   */
+  [[nodiscard]] std::uint64_t count_samples() const noexcept { return _header.count_samples + _count_chunk_samples; }
+
+private:
+  std::ofstream _output;
+  std::uint32_t _chunk_size;
+  bool _is_closed{ false };
+
+  sample_file::file_header _header;
+  std::vector<sample_file::chunk_entry> _chunk_index;
+
+  /// Columns of the current chunk, their presence bitmaps, the entry describing the chunk, and the last value of every
+  /// delta-encoded column.
+  std::array<std::vector<std::uint8_t>, sample_file::COUNT_COLUMNS> _columns;
+  std::array<std::vector<std::uint8_t>, sample_file::COUNT_COLUMNS> _presence;
+  sample_file::chunk_entry _chunk;
+  std::uint32_t _count_chunk_samples{ 0U };
+  std::array<std::uint64_t, sample_file::COUNT_COLUMNS> _last_values{};
+
+  /// Distinct callchains, mapped to their index in the stack table.
+  std::unordered_map<std::vector<std::uintptr_t>, std::uint64_t, callchain_hash> _stack_indices;
+  std::vector<std::uint8_t> _stack_table;
+
+  /// Distinct names of sampled counters, mapped to their index in the counter name table.
+  std::unordered_map<std::string, std::uint64_t> _counter_name_indices;
+  std::vector<std::uint8_t> _counter_name_table;
+
+  /**
+   * Appends the value to the column; a missing value is only recorded in the presence bitmap of the column.
+   *
+   * @param column Column to append to.
+   * @param value Value to append.
+   */
+  template <typename T>
+  void append(sample_file::Column column, std::optional<T> value);
+
+  /**
+   * Appends the difference to the previous value of the column (zigzag-encoded); a missing value is only recorded in
+   * the presence bitmap of the column.
+   *
+   * @param column Column to append to.
+   * @param value Value to append.
+   */
+  template <typename T>
+  void append_delta(sample_file::Column column, std::optional<T> value);
+
+  /**
+   * Marks the current sample as holding a value of the column.
+   *
+   * @param column Column holding a value.
+   */
+  void mark_present(sample_file::Column column)
+  {
+    _presence[std::size_t(column)][_count_chunk_samples / 8U] |= std::uint8_t(1U << (_count_chunk_samples % 8U));
+  }
+
+  /**
+   * Looks up the index of the callchain in the stack table, adding it if it is not yet known.
+   *
+   * @param callchain Callchain.
+   * @return Index of the callchain in the stack table.
+   */
+  [[nodiscard]] std::uint64_t stack_index(const std::vector<std::uintptr_t>& callchain);
+
+  /**
+   * Looks up the index of the counter name in the counter name table, adding it if it is not yet known.
+   *
+   * @param name Name of the counter.
+   * @return Index of the name in the counter name table.
+   */
+  [[nodiscard]] std::uint64_t counter_name_index(std::string_view name);
+
+  /**
+   * Appends the counter values, branches, registers, and the context switch of the sample to their columns.
+   *
+   * @param sample Sample to append.
+   */
+  void append_lists(const Sample& sample);
+
+  /**
+   * Appends the registers (ABI and values) to the column.
+   *
+   * @param column Column to append to.
+   * @param abi ABI of the registers.
+   * @param registers Values of the registers.
+   */
+  void append_registers(sample_file::Column column,
+                        std::optional<std::uint64_t> abi,
+                        const std::optional<std::vector<std::uint64_t>>& registers);
+
+  /**
+   * Writes the current chunk to the file and resets the chunk.
+   */
+  void flush_chunk();
+
+  /**
+   * Appends a LEB128 varint to the buffer.
+   *
+   * @param buffer Buffer to append to.
+   * @param value Value to append.
+   */
+  static void append_varint(std::vector<std::uint8_t>& buffer, std::uint64_t value);
+
+  /**
+   * Maps signed differences to unsigned values, such that small negative differences are encoded with few bytes.
+   *
+   * @param value Difference.
+   * @return Zigzag-encoded difference.
+   */
+  [[nodiscard]] static std::uint64_t zigzag(std::int64_t value) noexcept
+  {
+    return (std::uint64_t(value) << 1U) ^ std::uint64_t(value >> 63U);
+  }
+};
+}
@@ -0,0 +1,139 @@
+#pragma once
+
+#include "output_buffer.h"
+#include "sample.h"
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace perf {
+class Sampler;
+
+/**
+ * Streams samples into a CSV or JSON Lines file, without collecting all samples first.
+ * Fields are formatted with std::to_chars into a reusable buffer that is flushed to the file in large blocks; the
+ * columns follow the sample type (combination of Sampler::Type values) the samples were recorded with, sampled counter
+ * values become one column per sampled counter (CSV).
+ *
+ * Use together with Sampler::for_each_sample() (or the for_each_sample() of the file readers) to export samples
+ * without materializing them:
+ *
+ *   auto writer = perf::SampleWriter{ "samples.csv", sampler };
+ *   sampler.for_each_sample([&writer](perf::Sample&& sample) { writer.write(sample); });
+ */
+class SampleWriter
+{
+public:
+  enum class Format
+  {
+    CSV,
+
+    /// One JSON object per line.
+    JSON
+  };
+
+  /// Default size of the output buffer.
+  constexpr static inline std::size_t DEFAULT_BUFFER_SIZE = 1024U * 1024U;
+
+  /**
+   * Creates the file for samples of the given sampler; the written fields follow the sample type and the sampled
+   * counters of the sampler.
+   * Throws a std::runtime_error if the file cannot be created.
+   *
+   * @param file_name Name of the file.
+   * @param sampler Sampler recording the samples.
+   * @param format Format of the file (CSV by default).
+   * @param buffer_size Size of the output buffer; the buffer is written to the file whenever it is full.
+   */
+  SampleWriter(const std::string& file_name,
+               const Sampler& sampler,
+               Format format = Format::CSV,
+               std::size_t buffer_size = DEFAULT_BUFFER_SIZE);
+
+  /**
+   * Creates the file for samples of the given sample type (e.g., read from a perf.data file).
+   * Throws a std::runtime_error if the file cannot be created, or if the sample type includes
+   * Sampler::Type::CounterValues but no counter names are given.
+   *
+   * @param file_name Name of the file.
+   * @param sample_type Sample type (combination of Sampler::Type values) defining the written fields.
+   * @param counter_names Names of the sampled counters (only needed for Sampler::Type::CounterValues).
+   * @param format Format of the file (CSV by default).
+   * @param buffer_size Size of the output buffer; the buffer is written to the file whenever it is full.
+   */
+  SampleWriter(const std::string& file_name,
+               std::uint64_t sample_type,
+               std::vector<std::string> counter_names = {},
+               Format format = Format::CSV,
+               std::size_t buffer_size = DEFAULT_BUFFER_SIZE);
+
+  SampleWriter(const SampleWriter&) = delete;
+  SampleWriter& operator=(const SampleWriter&) = delete;
+
+  /**
+   * Flushes and closes the file, if not already closed.
+   */
+  ~SampleWriter();
+
+  /**
+   * Formats a single sample into the output buffer; context switches (see SampleConfig::context_switch()) are
+   * skipped.
+   *
+   * @param sample Sample to write.
+   */
+  void write(const Sample& sample);
+
+  /**
+   * Formats a list of samples into the output buffer.
+   *
+   * @param samples Samples to write.
+   */
+  void write(const std::vector<Sample>& samples);
+
+  /**
+   * Writes the output buffer to the file.
+   *
+   * @return True, if the buffer was written.
+   */
+  bool flush();
+
+  /**
+   * Flushes the output buffer and closes the file.
+   *
+   * @return True, if the file was written successfully.
+   */
+  bool close();
+
+  /**
+   * @return Number of samples written so far.
+   */
+  [[nodiscard]] std::uint64_t count_samples() const noexcept { return _count_samples; }
+
+private:
+  std::ofstream _output;
+  std::uint64_t _sample_type;
+  Format _format;
+  bool _is_closed{ false };
+  std::uint64_t _count_samples{ 0U };
+
+  OutputBuffer _buffer;
+
+  /// Names of the sampled counters, one column per counter (CSV only).
+  std::vector<std::string> _counter_names;
+
+  /**
+   * Writes the name of a JSON field (preceded by a comma, if not the first field).
+   *
+   * @param name Name of the field.
+   * @param is_first True, if the field is the first one of the line.
+   */
+  void begin_field(std::string_view name, bool is_first);
+
+  void write_csv_header();
+  void write_csv(const Sample& sample);
+  void write_json(const Sample& sample);
+};
+}
@@ -98,13 +98,40 @@ public:
   void close();
 
   /**
-   * @return List of sampled events after closing the sampler.
+   * @return List of sampled events after closing the sampler, including context switches (if enabled in the
+   * SampleConfig, see Sample::context_switch()).
    */
   [[nodiscard]] std::vector<Sample> result() const;
 
+  /**
+   * Decodes the sampled events one by one and passes them to the callback, without materializing all samples at
+   * once (e.g., to stream samples into an exporter).
+   *
+   * @param callback Callback invoked for every sample.
+   */
+  void for_each_sample(const std::function<void(Sample&&)>& callback) const;
+
+  /**
+   * @return Number of bytes of (not yet drained) records in the buffer, e.g., to calculate the decoding throughput.
+   */
+  [[nodiscard]] std::uint64_t count_buffered_bytes() const noexcept;
+
+  /**
+   * @return Sample type (combination of Sampler::Type values) the sampler records.
+   */
+  [[nodiscard]] std::uint64_t sample_type() const noexcept { return _sample_type; }
+
+  /**
+   * @return Names of the sampled counters, in the order they were added.
+   */
+  [[nodiscard]] const std::vector<std::string_view>& counter_names() const noexcept { return _counter_names; }
+
   [[nodiscard]] std::int64_t last_error() const noexcept { return _last_error; }
 
 private:
+  friend class PerfDataWriter;
+  friend class RawSpillWriter;
+
   const CounterDefinition& _counter_definitions;
 
   /// Perf config.
@@ -131,29 +158,19 @@ private:
    * @return True, if the sampler could be opened.
    */
   [[nodiscard]] bool open();
-
-  /**
-   * Read format for sampled counter values.
-   */
-  struct read_format
-  {
-    /// Value and ID delivered by perf.
-    struct value
-    {
-      std::uint64_t value;
-      std::uint64_t id;
-    };
-
-    /// Number of counters in the following array.
-    std::uint64_t count_members;
-    std::array<value, Group::MAX_MEMBERS> values;
-  };
 };
 
 class MultiSamplerBase
 {
 protected:
   [[nodiscard]] static std::vector<Sample> result(const std::vector<Sampler>& sampler);
+
+  static void for_each_sample(const std::vector<Sampler>& sampler, const std::function<void(Sample&&)>& callback)
+  {
+    for (const auto& local_sampler : sampler) {
+      local_sampler.for_each_sample(callback);
+    }
+  }
 };
 
 class MultiThreadSampler final : private MultiSamplerBase
@@ -217,6 +234,16 @@ public:
    */
   [[nodiscard]] std::vector<Sample> result() const { return MultiSamplerBase::result(_thread_local_samplers); }
 
+  /**
+   * Passes the sampled events of all samplers one by one to the callback, see Sampler::for_each_sample().
+   *
+   * @param callback Callback invoked for every sample.
+   */
+  void for_each_sample(const std::function<void(Sample&&)>& callback) const
+  {
+    MultiSamplerBase::for_each_sample(_thread_local_samplers, callback);
+  }
+
 private:
   std::vector<Sampler> _thread_local_samplers;
 };
@@ -288,6 +315,16 @@ public:
    */
   [[nodiscard]] std::vector<Sample> result() const { return MultiSamplerBase::result(_core_local_samplers); }
 
+  /**
+   * Passes the sampled events of all samplers one by one to the callback, see Sampler::for_each_sample().
+   *
+   * @param callback Callback invoked for every sample.
+   */
+  void for_each_sample(const std::function<void(Sample&&)>& callback) const
+  {
+    MultiSamplerBase::for_each_sample(_core_local_samplers, callback);
+  }
+
 private:
   std::vector<Sampler> _core_local_samplers;
 };
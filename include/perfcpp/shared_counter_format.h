@@ -0,0 +1,77 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace perf::shared_counter {
+/**
+ * Layout of the shared-memory segment, written by the SharedCounterPublisher and read by SharedCounterReaders in other
+ * processes.
+ *
+ * Layout: table_header | entry (capacity times).
+ * The table is protected by a sequence lock: the publisher makes the sequence odd before and even after updating the
+ * values; readers copy the values and retry if the sequence was odd or changed in the meantime.
+ * Entries are only appended (under the lock) and their names are never changed, such that readers can refer to them.
+ */
+
+/// "PERFCPPS" in little endian.
+constexpr static inline std::uint64_t MAGIC = 0x5350504346524550ULL;
+
+/// Version of the format.
+constexpr static inline std::uint32_t VERSION = 1U;
+
+/// Prefix of the name of the shared-memory segment (see shm_open()).
+constexpr static inline auto NAME_PREFIX = "/perf-cpp.";
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "Shared counters require lock-free 64bit atomics.");
+
+/**
+ * Header at the beginning of the segment.
+ */
+struct table_header
+{
+  std::uint64_t magic{ MAGIC };
+  std::uint32_t version{ VERSION };
+
+  /// Size of every entry.
+  std::uint32_t entry_size{ 0U };
+
+  /// Maximal number of entries.
+  std::uint32_t capacity{ 0U };
+
+  /// Process id of the publisher.
+  std::int32_t process_id{ 0 };
+
+  /// Number of published entries.
+  std::atomic<std::uint64_t> count_entries{ 0U };
+
+  /// Sequence of the lock; odd while the publisher updates the values.
+  std::atomic<std::uint64_t> sequence{ 0U };
+
+  /// Time of the last update (nanoseconds since epoch).
+  std::atomic<std::uint64_t> time{ 0U };
+};
+
+/**
+ * Named value of a counter or metric.
+ */
+struct entry
+{
+  /// Zero-terminated name of the counter or metric; longer names are not published (see SharedCounterPublisher).
+  std::array<char, 56U> name{};
+
+  /// Bits of the value (a double).
+  std::atomic<std::uint64_t> value{ 0U };
+};
+
+/**
+ * @return Name of the shared-memory segment for the given table name.
+ */
+[[nodiscard]] inline std::string
+segment_name(const std::string& name)
+{
+  return NAME_PREFIX + name;
+}
+}
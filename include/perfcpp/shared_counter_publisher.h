@@ -0,0 +1,143 @@
+#pragma once
+
+#include "counter.h"
+#include "event_counter.h"
+#include "shared_counter_format.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+
+namespace perf {
+/**
+ * Publishes counter values into a named shared-memory segment, such that monitors in other processes (see
+ * SharedCounterReader and the perf-monitor tool) can read them without any interaction with the publishing process.
+ *
+ * The segment holds a table of named values, protected by a sequence lock (see shared_counter_format.h): publishing
+ * only writes to memory; readers take consistent snapshots without system calls.
+ * Values are published explicitly (e.g., at the end of a region) or periodically by a background thread from the live
+ * values of a running counter (see EventCounter::live_result()).
+ * There must be only one publisher per segment; publish() must not be called while publishing periodically.
+ */
+class SharedCounterPublisher
+{
+public:
+  /// Default number of values the table can hold.
+  constexpr static inline std::uint32_t DEFAULT_CAPACITY = 64U;
+
+  /// Maximal length of the name of a published value.
+  constexpr static inline std::size_t MAX_NAME_LENGTH = std::tuple_size_v<decltype(shared_counter::entry::name)> - 1U;
+
+  /**
+   * Creates the shared-memory segment (replacing an existing segment with the same name).
+   * Throws a std::runtime_error if the segment cannot be created.
+   *
+   * @param name Name of the table (without '/'), used by readers to attach.
+   * @param capacity Maximal number of values.
+   */
+  explicit SharedCounterPublisher(std::string name, std::uint32_t capacity = DEFAULT_CAPACITY);
+
+  SharedCounterPublisher(const SharedCounterPublisher&) = delete;
+  SharedCounterPublisher& operator=(const SharedCounterPublisher&) = delete;
+
+  /**
+   * Stops publishing periodically and removes the segment; attached readers keep the last values.
+   */
+  ~SharedCounterPublisher();
+
+  /**
+   * Publishes the values of the given result; values not yet in the table are added.
+   * Values with names longer than MAX_NAME_LENGTH are not published, since truncating could make names collide.
+   *
+   * @param result Values to publish.
+   * @return True, if all values were published; false, if the table is full or a name is too long.
+   */
+  bool publish(const CounterResult& result);
+
+  /**
+   * Publishes the live values of the running counter (see EventCounter::live_result()).
+   *
+   * @param event_counter Running counter.
+   * @return True, if all values were published.
+   */
+  bool publish(EventCounter& event_counter) { return publish(event_counter.live_result()); }
+
+  /**
+   * Starts publishing the values returned by the source periodically in a background thread.
+   *
+   * @param source Callback returning the current values (e.g., the live result of a running counter).
+   * @param interval Interval between two updates.
+   * @return True, if publishing was started.
+   */
+  [[nodiscard]] bool start(std::function<CounterResult()>&& source, std::chrono::milliseconds interval);
+
+  /**
+   * Starts publishing the live values of the running counter periodically in a background thread.
+   *
+   * @param event_counter Running counter; must not be stopped before publishing is stopped.
+   * @param interval Interval between two updates.
+   * @return True, if publishing was started.
+   */
+  [[nodiscard]] bool start(EventCounter& event_counter, const std::chrono::milliseconds interval)
+  {
+    return start([&event_counter] { return event_counter.live_result(); }, interval);
+  }
+
+  /**
+   * Starts publishing the live values (aggregated over all CPUs) of the running counter periodically.
+   *
+   * @param event_counter Running counter; must not be stopped before publishing is stopped.
+   * @param interval Interval between two updates.
+   * @return True, if publishing was started.
+   */
+  [[nodiscard]] bool start(MultiCoreEventCounter& event_counter, const std::chrono::milliseconds interval)
+  {
+    return start([&event_counter] { return event_counter.live_result(); }, interval);
+  }
+
+  /**
+   * Stops publishing periodically (after a last update).
+   */
+  void stop();
+
+  /**
+   * @return Name of the table.
+   */
+  [[nodiscard]] const std::string& name() const noexcept { return _name; }
+
+  /**
+   * @return Number of updates published so far.
+   */
+  [[nodiscard]] std::uint64_t count_updates() const noexcept { return _header->sequence.load() / 2U; }
+
+private:
+  std::string _name;
+
+  /// Mapped segment.
+  void* _data{ nullptr };
+  std::size_t _size{ 0U };
+  shared_counter::table_header* _header{ nullptr };
+  shared_counter::entry* _entries{ nullptr };
+
+  /// Background thread publishing periodically and the flag (and condition) to stop it.
+  std::thread _publisher_thread;
+  std::mutex _stop_mutex;
+  std::condition_variable _stop_condition;
+  bool _is_stopped{ false };
+
+  /**
+   * Returns the index of the entry with the given name, adding the entry if not existing.
+   *
+   * @param name Name of the value.
+   * @param expected_index Index where the entry is expected (i.e., its position in the published result).
+   * @return Index of the entry, or capacity if the table is full or the name is too long.
+   */
+  [[nodiscard]] std::uint64_t entry_index(std::string_view name, std::uint64_t expected_index);
+};
+}
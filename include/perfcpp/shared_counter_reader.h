@@ -0,0 +1,72 @@
+#pragma once
+
+#include "shared_counter_format.h"
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace perf {
+/**
+ * Attaches to a table of counter values published into shared memory by a SharedCounterPublisher (in another
+ * process) and reads consistent snapshots of the values.
+ *
+ * Reading only accesses the mapped memory (no system calls, no allocations once the list of values has grown to the
+ * size of the table), such that monitors can poll at high frequency.
+ * The reader is part of the small library perf-cpp-shared-reader, which does not depend on the rest of perf-cpp.
+ */
+class SharedCounterReader
+{
+public:
+  /// Number of attempts to read a consistent snapshot while the publisher is updating the values.
+  constexpr static inline std::uint32_t DEFAULT_MAX_RETRIES = 4096U;
+
+  /**
+   * Attaches to the table with the given name.
+   * Throws a std::runtime_error if the table does not exist or is not a table of perf-cpp.
+   *
+   * @param name Name of the table (as given to the publisher).
+   */
+  explicit SharedCounterReader(const std::string& name);
+
+  SharedCounterReader(SharedCounterReader&& other) noexcept;
+  SharedCounterReader& operator=(SharedCounterReader&& other) noexcept;
+  SharedCounterReader(const SharedCounterReader&) = delete;
+  SharedCounterReader& operator=(const SharedCounterReader&) = delete;
+
+  ~SharedCounterReader();
+
+  /**
+   * Reads a consistent snapshot of all published values.
+   * The names refer to the shared memory and are valid as long as the reader is attached.
+   *
+   * @param values List that is filled with names and values (cleared before).
+   * @param max_retries Number of attempts while the publisher is updating the values.
+   * @return Time of the snapshot (in nanoseconds since epoch, 0 if nothing was published yet), or std::nullopt if no
+   * consistent snapshot could be read (e.g., the publisher crashed during an update).
+   */
+  [[nodiscard]] std::optional<std::uint64_t> read(std::vector<std::pair<std::string_view, double>>& values,
+                                                  std::uint32_t max_retries = DEFAULT_MAX_RETRIES) const;
+
+  /**
+   * @return Process id of the publisher.
+   */
+  [[nodiscard]] std::int32_t process_id() const noexcept { return _header->process_id; }
+
+  /**
+   * @return Number of updates published so far (increases with every update).
+   */
+  [[nodiscard]] std::uint64_t count_updates() const noexcept { return _header->sequence.load() / 2U; }
+
+private:
+  const void* _data{ nullptr };
+  std::size_t _size{ 0U };
+  const shared_counter::table_header* _header{ nullptr };
+  const shared_counter::entry* _entries{ nullptr };
+
+  void close();
+};
+}
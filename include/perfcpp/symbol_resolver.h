@@ -0,0 +1,101 @@
+#pragma once
+
+#include "elf_file.h"
+#include "memory_map.h"
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+namespace perf {
+/**
+ * Sampled address, translated into the binary it belongs to and its address as linked.
+ */
+class BinaryAddress
+{
+public:
+  BinaryAddress(const MemoryMapping& mapping, const std::uint64_t address) noexcept
+    : _mapping(&mapping)
+    , _address(address)
+  {
+  }
+
+  ~BinaryAddress() = default;
+
+  /**
+   * @return Path of the binary.
+   */
+  [[nodiscard]] const std::string& binary() const noexcept { return _mapping->path(); }
+
+  [[nodiscard]] const MemoryMapping& mapping() const noexcept { return *_mapping; }
+
+  /**
+   * @return Virtual address within the binary as linked (or the file offset, if the binary could not be read).
+   */
+  [[nodiscard]] std::uint64_t address() const noexcept { return _address; }
+
+private:
+  const MemoryMapping* _mapping;
+  std::uint64_t _address;
+};
+
+/**
+ * Translates sampled instruction pointers into addresses of binaries as linked (using the memory map of the process
+ * and the program headers of the binaries) and resolves them to function symbols.
+ * Binaries are read lazily and cached.
+ */
+class SymbolResolver
+{
+public:
+  /**
+   * Creates the resolver.
+   *
+   * @param memory_map Memory map used to attribute addresses to binaries; must be read while the profiled binaries
+   * are still loaded.
+   * @param include_symbols If false, only addresses are translated and no symbol tables are read.
+   */
+  explicit SymbolResolver(MemoryMap memory_map = MemoryMap::read(), const bool include_symbols = true)
+    : _memory_map(std::move(memory_map))
+    , _include_symbols(include_symbols)
+  {
+  }
+
+  ~SymbolResolver() = default;
+
+  /**
+   * Translates a sampled address into the address of the binary as linked.
+   *
+   * @param instruction_pointer Sampled address.
+   * @return Binary and address as linked, or std::nullopt if the address does not belong to a file-backed mapping.
+   */
+  [[nodiscard]] std::optional<BinaryAddress> translate(std::uintptr_t instruction_pointer);
+
+  /**
+   * Looks up the function symbol containing the given address.
+   *
+   * @param address Address of a binary (see translate()).
+   * @return Pointer to the symbol, or nullptr if no symbol contains the address (or symbols are not read).
+   */
+  [[nodiscard]] const ElfSymbol* symbol(const BinaryAddress& address)
+  {
+    return elf_file(address.binary()).symbol(address.address());
+  }
+
+  [[nodiscard]] const MemoryMap& memory_map() const noexcept { return _memory_map; }
+
+private:
+  MemoryMap _memory_map;
+  bool _include_symbols;
+
+  /// Binaries seen so far, by path.
+  std::unordered_map<std::string, ElfFile> _elf_files;
+
+  /**
+   * Returns the (cached) ELF file of the given path, reading it on first use.
+   *
+   * @param path Path of the binary.
+   * @return ELF file, empty if the binary could not be read.
+   */
+  [[nodiscard]] const ElfFile& elf_file(const std::string& path);
+};
+}
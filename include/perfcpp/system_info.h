@@ -0,0 +1,22 @@
+#pragma once
+
+#include <string>
+
+namespace perf {
+/**
+ * Describes the machine and system the code runs on, e.g., to store results and configurations per CPU model.
+ */
+class SystemInfo
+{
+public:
+  /**
+   * @return Model name of the CPU of this machine (read from /proc/cpuinfo), or "unknown".
+   */
+  [[nodiscard]] static std::string cpu_model();
+
+  /**
+   * @return Release of the running Linux kernel (e.g., "6.8.0"), or "unknown".
+   */
+  [[nodiscard]] static std::string kernel_release();
+};
+}
@@ -0,0 +1,115 @@
+#include <algorithm>
+#include <fstream>
+#include <perfcpp/autofdo_exporter.h>
+
+void
+perf::AutoFDOExporter::add(const Sample& sample)
+{
+  if (sample.context_switch().has_value()) {
+    return;
+  }
+
+  if (sample.instruction_pointer().has_value()) {
+    if (const auto location = this->_symbol_resolver.translate(sample.instruction_pointer().value());
+        location.has_value()) {
+      ++this->_profiles[location->binary()].addresses[location->address()];
+    }
+  }
+
+  if (!sample.branches().has_value()) {
+    return;
+  }
+
+  /// The branch stack is ordered from the most recent (index 0) to the oldest branch.
+  const auto& branch_stack = sample.branches().value();
+  for (auto i = 0U; i < branch_stack.size(); ++i) {
+    const auto& branch = branch_stack[i];
+
+    const auto from = this->_symbol_resolver.translate(branch.instruction_pointer_from());
+    if (!from.has_value()) {
+      continue;
+    }
+    auto& profile = this->_profiles[from->binary()];
+
+    /// Only branches within the same binary are recorded (like AutoFDO does for perf.data files).
+    if (const auto to = this->_symbol_resolver.translate(branch.instruction_pointer_to());
+        to.has_value() && to->binary() == from->binary()) {
+      ++profile.branches[std::make_pair(from->address(), to->address())];
+    }
+
+    /// The range between the target of the older branch and the source of this branch was executed straight-line.
+    if (i + 1U < branch_stack.size()) {
+      if (const auto begin = this->_symbol_resolver.translate(branch_stack[i + 1U].instruction_pointer_to());
+          begin.has_value() && begin->binary() == from->binary() && begin->address() <= from->address()) {
+        ++profile.ranges[std::make_pair(begin->address(), from->address())];
+      }
+    }
+  }
+}
+
+std::vector<std::string>
+perf::AutoFDOExporter::binaries() const
+{
+  auto binaries = std::vector<std::string>{};
+  binaries.reserve(this->_profiles.size());
+  for (const auto& [binary, _] : this->_profiles) {
+    binaries.push_back(binary);
+  }
+  std::sort(binaries.begin(), binaries.end());
+
+  return binaries;
+}
+
+void
+perf::AutoFDOExporter::write(std::ostream& stream, const std::string& binary) const
+{
+  auto profile_iterator = this->_profiles.find(binary);
+  if (profile_iterator == this->_profiles.end()) {
+    stream << "0\n0\n0\n";
+    return;
+  }
+  const auto& profile = profile_iterator->second;
+
+  /// AutoFDO does not require a particular order, but sorted entries make profiles comparable.
+  auto ranges = std::vector<std::pair<std::pair<std::uintptr_t, std::uintptr_t>, std::uint64_t>>{
+    profile.ranges.begin(), profile.ranges.end()
+  };
+  std::sort(ranges.begin(), ranges.end());
+
+  auto addresses = std::vector<std::pair<std::uintptr_t, std::uint64_t>>{ profile.addresses.begin(),
+                                                                          profile.addresses.end() };
+  std::sort(addresses.begin(), addresses.end());
+
+  auto branches = std::vector<std::pair<std::pair<std::uintptr_t, std::uintptr_t>, std::uint64_t>>{
+    profile.branches.begin(), profile.branches.end()
+  };
+  std::sort(branches.begin(), branches.end());
+
+  stream << std::dec << ranges.size() << "\n";
+  for (const auto& [range, count] : ranges) {
+    stream << std::hex << range.first << "-" << range.second << ":" << std::dec << count << "\n";
+  }
+
+  stream << addresses.size() << "\n";
+  for (const auto& [address, count] : addresses) {
+    stream << std::hex << address << ":" << std::dec << count << "\n";
+  }
+
+  stream << branches.size() << "\n";
+  for (const auto& [branch, count] : branches) {
+    stream << std::hex << branch.first << "->" << branch.second << ":" << std::dec << count << "\n";
+  }
+}
+
+bool
+perf::AutoFDOExporter::write(const std::string& file_name, const std::string& binary) const
+{
+  auto stream = std::ofstream{ file_name };
+  if (!stream.is_open()) {
+    return false;
+  }
+
+  this->write(stream, binary);
+
+  return stream.good();
+}
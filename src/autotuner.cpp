@@ -0,0 +1,333 @@
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <perfcpp/autotuner.h>
+#include <perfcpp/event_counter.h>
+#include <sstream>
+#include <stdexcept>
+
+/**
+ * @return True, if the given name can be stored in a line of the tuning store, i.e., it contains no separators.
+ */
+static bool
+is_storable(const std::string_view name, const std::string_view separators)
+{
+  return name.find_first_of(separators) == std::string_view::npos;
+}
+
+std::optional<std::int64_t>
+perf::TuningConfiguration::get(const std::string_view name) const noexcept
+{
+  if (auto iterator = std::find_if(
+        this->_values.begin(), this->_values.end(), [name](const auto& value) { return value.first == name; });
+      iterator != this->_values.end()) {
+    return iterator->second;
+  }
+
+  return std::nullopt;
+}
+
+std::string
+perf::TuningConfiguration::to_string() const
+{
+  auto stream = std::stringstream{};
+  for (auto i = 0U; i < this->_values.size(); ++i) {
+    if (i > 0U) {
+      stream << ",";
+    }
+    stream << this->_values[i].first << "=" << this->_values[i].second;
+  }
+
+  return stream.str();
+}
+
+std::optional<perf::TuningConfiguration>
+perf::TuningConfiguration::from_string(std::string_view configuration)
+{
+  auto values = std::vector<std::pair<std::string, std::int64_t>>{};
+
+  while (!configuration.empty()) {
+    const auto end = configuration.find(',');
+    const auto item = configuration.substr(0U, end);
+
+    const auto separator = item.find('=');
+    if (separator == std::string_view::npos || separator == 0U) {
+      return std::nullopt;
+    }
+
+    auto value = std::int64_t{ 0 };
+    const auto value_string = item.substr(separator + 1U);
+    const auto* value_end = value_string.data() + value_string.size();
+    const auto [pointer, error] = std::from_chars(value_string.data(), value_end, value);
+    if (error != std::errc{} || pointer != value_end) {
+      return std::nullopt;
+    }
+    values.emplace_back(std::string{ item.substr(0U, separator) }, value);
+
+    configuration = end != std::string_view::npos ? configuration.substr(end + 1U) : std::string_view{};
+  }
+
+  return TuningConfiguration{ std::move(values) };
+}
+
+std::string
+perf::TuningResult::to_string() const
+{
+  auto stream = std::stringstream{};
+  stream << std::fixed << std::setprecision(2);
+
+  stream << std::setw(48) << std::left << "configuration" << std::right << std::setw(16)
+         << (this->_objective + " (median)") << std::setw(16) << "mean" << std::setw(16) << "stddev" << std::setw(8)
+         << "runs" << std::setw(8) << "rounds"
+         << "\n";
+
+  for (const auto& candidate : this->_candidates) {
+    stream << std::setw(48) << std::left << candidate.configuration().to_string() << std::right << std::setw(16)
+           << candidate.objective().median() << std::setw(16) << candidate.objective().mean() << std::setw(16)
+           << candidate.objective().stddev() << std::setw(8) << candidate.objective().count() << std::setw(8)
+           << candidate.rounds() << "\n";
+  }
+
+  return stream.str();
+}
+
+bool
+perf::Autotuner::add(std::string name, std::vector<std::int64_t> values)
+{
+  if (name.empty() || values.empty() || !is_storable(name, "=,\t\n") ||
+      std::find_if(this->_parameters.begin(), this->_parameters.end(), [&name](const auto& parameter) {
+        return parameter.first == name;
+      }) != this->_parameters.end()) {
+    return false;
+  }
+
+  this->_parameters.emplace_back(std::move(name), std::move(values));
+  return true;
+}
+
+bool
+perf::Autotuner::objective(std::string name, const bool is_maximize)
+{
+  if (!this->_counter_definitions.is_metric(name) && !this->_counter_definitions.counter(name).has_value()) {
+    return false;
+  }
+
+  this->_objective = std::move(name);
+  this->_is_maximize = is_maximize;
+  return true;
+}
+
+std::vector<perf::TuningConfiguration>
+perf::Autotuner::configurations() const
+{
+  auto configurations = std::vector<TuningConfiguration>{};
+
+  /// Enumerate all combinations; the indices count through the values of every parameter like an odometer.
+  auto indices = std::vector<std::size_t>(this->_parameters.size(), 0U);
+  while (true) {
+    auto values = std::vector<std::pair<std::string, std::int64_t>>{};
+    values.reserve(this->_parameters.size());
+    for (auto i = 0U; i < this->_parameters.size(); ++i) {
+      values.emplace_back(this->_parameters[i].first, this->_parameters[i].second[indices[i]]);
+    }
+
+    auto configuration = TuningConfiguration{ std::move(values) };
+    if (!this->_constraint || this->_constraint(configuration)) {
+      configurations.push_back(std::move(configuration));
+    }
+
+    auto parameter = 0U;
+    for (; parameter < this->_parameters.size(); ++parameter) {
+      if (++indices[parameter] < this->_parameters[parameter].second.size()) {
+        break;
+      }
+      indices[parameter] = 0U;
+    }
+
+    if (parameter == this->_parameters.size()) {
+      return configurations;
+    }
+  }
+}
+
+perf::TuningResult
+perf::Autotuner::run(const std::function<void(const TuningConfiguration&)>& callable, const std::uint64_t normalization)
+{
+  if (this->_objective.empty()) {
+    throw std::runtime_error{ "No objective set for the autotuner." };
+  }
+
+  /// Only the objective is recorded, such that the counters fit the hardware without multiplexing.
+  auto event_counter = EventCounter{ this->_counter_definitions, this->_config };
+  if (!event_counter.add(this->_objective)) {
+    throw std::runtime_error{ "Could not add the objective of the autotuner." };
+  }
+
+  struct evaluation
+  {
+    TuningConfiguration configuration;
+    std::vector<double> values;
+    std::uint32_t rounds{ 0U };
+    double median{ std::numeric_limits<double>::quiet_NaN() };
+  };
+
+  auto candidates = std::vector<evaluation>{};
+  for (auto& configuration : this->configurations()) {
+    candidates.push_back(evaluation{ std::move(configuration), {}, 0U });
+  }
+
+  /// Orders candidates from best to worst; candidates without values are the worst.
+  const auto is_better = [is_maximize = this->_is_maximize](const evaluation& left, const evaluation& right) {
+    if (left.rounds != right.rounds) {
+      return left.rounds > right.rounds;
+    }
+    if (std::isnan(left.median) || std::isnan(right.median)) {
+      return !std::isnan(left.median) && std::isnan(right.median);
+    }
+    return is_maximize ? left.median > right.median : left.median < right.median;
+  };
+
+  auto survivors = candidates.size();
+  auto repetitions = this->_repetitions;
+  while (survivors > 0U) {
+    /// Record all surviving candidates (that are placed in front of the candidates).
+    for (auto index = 0U; index < survivors; ++index) {
+      auto& candidate = candidates[index];
+
+      for (auto i = 0U; i < this->_warm_up; ++i) {
+        callable(candidate.configuration);
+      }
+
+      for (auto repetition = 0U; repetition < repetitions; ++repetition) {
+        if (!event_counter.start()) {
+          event_counter.stop();
+          throw std::runtime_error{ "Could not start the counters of the autotuner." };
+        }
+        callable(candidate.configuration);
+        event_counter.stop();
+
+        if (const auto value = event_counter.result(normalization).get(this->_objective); value.has_value()) {
+          candidate.values.push_back(value.value());
+        }
+      }
+
+      candidate.median =
+        !candidate.values.empty() ? Statistics{ candidate.values }.median() : std::numeric_limits<double>::quiet_NaN();
+    }
+
+    /// Keep the best 1/reduction factor of the candidates for the next round.
+    std::sort(candidates.begin(), candidates.begin() + std::ptrdiff_t(survivors), is_better);
+    if (survivors == 1U) {
+      break;
+    }
+
+    survivors = (survivors + this->_reduction_factor - 1U) / this->_reduction_factor;
+    for (auto index = 0U; index < survivors; ++index) {
+      ++candidates[index].rounds;
+    }
+    repetitions *= this->_reduction_factor;
+
+    if (survivors == 1U) {
+      break;
+    }
+  }
+
+  std::sort(candidates.begin(), candidates.end(), is_better);
+
+  auto result = std::vector<TuningCandidate>{};
+  result.reserve(candidates.size());
+  for (auto& candidate : candidates) {
+    result.emplace_back(
+      std::move(candidate.configuration), Statistics{ std::move(candidate.values) }, candidate.rounds);
+  }
+
+  return TuningResult{ this->_objective, std::move(result) };
+}
+
+bool
+perf::TuningStore::save(const std::string_view kernel_name,
+                        const TuningConfiguration& configuration,
+                        const std::string& cpu_model) const
+{
+  if (kernel_name.empty() || !is_storable(kernel_name, "\t\n") || !is_storable(cpu_model, "\t\n")) {
+    return false;
+  }
+
+  for (const auto& [name, _] : configuration) {
+    if (name.empty() || !is_storable(name, "=,\t\n")) {
+      return false;
+    }
+  }
+
+  /// Replace the entry of the kernel and CPU model, if stored before.
+  auto entries = this->read();
+  auto iterator = std::find_if(entries.begin(), entries.end(), [&cpu_model, kernel_name](const auto& entry) {
+    return entry[0U] == cpu_model && entry[1U] == kernel_name;
+  });
+  if (iterator != entries.end()) {
+    (*iterator)[2U] = configuration.to_string();
+  } else {
+    entries.push_back({ cpu_model, std::string{ kernel_name }, configuration.to_string() });
+  }
+
+  /// Write into a temporary file and replace the store, such that readers never see a partially written file.
+  const auto temporary_file_name = this->_file_name + ".tmp";
+  {
+    auto file = std::ofstream{ temporary_file_name, std::ios::trunc };
+    if (!file.is_open()) {
+      return false;
+    }
+
+    file << "# CPU model\tkernel\tconfiguration\n";
+    for (const auto& entry : entries) {
+      file << entry[0U] << "\t" << entry[1U] << "\t" << entry[2U] << "\n";
+    }
+
+    if (!file.good()) {
+      return false;
+    }
+  }
+
+  return std::rename(temporary_file_name.c_str(), this->_file_name.c_str()) == 0;
+}
+
+std::optional<perf::TuningConfiguration>
+perf::TuningStore::load(const std::string_view kernel_name, const std::string& cpu_model) const
+{
+  for (const auto& entry : this->read()) {
+    if (entry[0U] == cpu_model && entry[1U] == kernel_name) {
+      return TuningConfiguration::from_string(entry[2U]);
+    }
+  }
+
+  return std::nullopt;
+}
+
+std::vector<std::array<std::string, 3U>>
+perf::TuningStore::read() const
+{
+  auto entries = std::vector<std::array<std::string, 3U>>{};
+
+  auto file = std::ifstream{ this->_file_name };
+  auto line = std::string{};
+  while (std::getline(file, line)) {
+    if (line.empty() || line.front() == '#') {
+      continue;
+    }
+
+    const auto first_separator = line.find('\t');
+    const auto second_separator =
+      first_separator != std::string::npos ? line.find('\t', first_separator + 1U) : std::string::npos;
+    if (second_separator != std::string::npos) {
+      entries.push_back({ line.substr(0U, first_separator),
+                          line.substr(first_separator + 1U, second_separator - first_separator - 1U),
+                          line.substr(second_separator + 1U) });
+    }
+  }
+
+  return entries;
+}
@@ -0,0 +1,230 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <numeric>
+#include <perfcpp/benchmark.h>
+#include <perfcpp/event_counter.h>
+#include <sstream>
+#include <stdexcept>
+
+perf::Statistics::Statistics(std::vector<double> values)
+  : _count(values.size())
+{
+  if (values.empty()) {
+    return;
+  }
+
+  std::sort(values.begin(), values.end());
+  this->_min = values.front();
+  this->_max = values.back();
+
+  const auto middle = values.size() / 2U;
+  this->_median = values.size() % 2U == 0U ? (values[middle - 1U] + values[middle]) / 2. : values[middle];
+
+  this->_mean = std::accumulate(values.begin(), values.end(), .0) / double(values.size());
+
+  if (values.size() > 1U) {
+    auto squared_deviation = .0;
+    for (const auto value : values) {
+      squared_deviation += (value - this->_mean) * (value - this->_mean);
+    }
+    this->_stddev = std::sqrt(squared_deviation / double(values.size() - 1U));
+  }
+}
+
+std::optional<perf::Statistics>
+perf::BenchmarkResult::get(const std::string_view name) const noexcept
+{
+  if (auto iterator = std::find_if(this->_statistics.begin(),
+                                   this->_statistics.end(),
+                                   [name](const auto& statistics) { return statistics.first == name; });
+      iterator != this->_statistics.end()) {
+    return iterator->second;
+  }
+
+  return std::nullopt;
+}
+
+perf::CounterResult
+perf::BenchmarkResult::mean() const
+{
+  auto result = std::vector<std::pair<std::string_view, double>>{};
+  result.reserve(this->_statistics.size());
+  for (const auto& [name, statistics] : this->_statistics) {
+    result.emplace_back(name, statistics.mean());
+  }
+
+  return CounterResult{ std::move(result) };
+}
+
+perf::CounterResult
+perf::BenchmarkResult::median() const
+{
+  auto result = std::vector<std::pair<std::string_view, double>>{};
+  result.reserve(this->_statistics.size());
+  for (const auto& [name, statistics] : this->_statistics) {
+    result.emplace_back(name, statistics.median());
+  }
+
+  return CounterResult{ std::move(result) };
+}
+
+std::string
+perf::BenchmarkResult::to_string() const
+{
+  auto stream = std::stringstream{};
+  stream << std::fixed << std::setprecision(2);
+
+  stream << std::setw(32) << std::left << "counter" << std::right << std::setw(16) << "mean" << std::setw(16)
+         << "median" << std::setw(16) << "stddev" << std::setw(16) << "min" << std::setw(16) << "max"
+         << "\n";
+
+  const auto add_row = [&stream](const std::string_view name, const Statistics& statistics) {
+    stream << std::setw(32) << std::left << name << std::right << std::setw(16) << statistics.mean() << std::setw(16)
+           << statistics.median() << std::setw(16) << statistics.stddev() << std::setw(16) << statistics.min()
+           << std::setw(16) << statistics.max() << "\n";
+  };
+
+  for (const auto& [name, statistics] : this->_statistics) {
+    add_row(name, statistics);
+  }
+  add_row("time (ns)", this->_time);
+
+  return stream.str();
+}
+
+bool
+perf::Benchmark::add(const std::string& counter_name)
+{
+  /// Collect the (hardware) counters needed to record the counter or metric.
+  auto counters = std::vector<std::string_view>{};
+  if (const auto counter = this->_counter_definitions.counter(counter_name); counter.has_value()) {
+    counters.push_back(std::get<0>(counter.value()));
+  } else if (const auto* metric = this->_counter_definitions.metric(counter_name); metric != nullptr) {
+    for (const auto& required_counter_name : metric->required_counter_names()) {
+      const auto required_counter = this->_counter_definitions.counter(required_counter_name);
+      if (!required_counter.has_value()) {
+        return false;
+      }
+
+      if (std::find(counters.begin(), counters.end(), std::get<0>(required_counter.value())) == counters.end()) {
+        counters.push_back(std::get<0>(required_counter.value()));
+      }
+    }
+  } else {
+    return false;
+  }
+
+  const auto capacity = std::size_t{ this->_config.max_counters_per_group() };
+  if (counters.size() > capacity) {
+    return false;
+  }
+
+  /// Skip counters and metrics that are already recorded.
+  for (const auto& counter_set : this->_counter_sets) {
+    if (std::find(counter_set.names.begin(), counter_set.names.end(), counter_name) != counter_set.names.end()) {
+      return true;
+    }
+  }
+
+  /// Add the counter (or metric) to the first set that can hold all its counters, or to a new set.
+  for (auto& counter_set : this->_counter_sets) {
+    auto missing_counters = std::vector<std::string_view>{};
+    std::copy_if(counters.begin(), counters.end(), std::back_inserter(missing_counters), [&counter_set](auto name) {
+      return std::find(counter_set.counters.begin(), counter_set.counters.end(), name) == counter_set.counters.end();
+    });
+
+    if (counter_set.counters.size() + missing_counters.size() <= capacity) {
+      counter_set.names.push_back(counter_name);
+      counter_set.counters.insert(counter_set.counters.end(), missing_counters.begin(), missing_counters.end());
+      return true;
+    }
+  }
+
+  this->_counter_sets.push_back(counter_set{ { counter_name }, std::move(counters) });
+  return true;
+}
+
+bool
+perf::Benchmark::add(const std::vector<std::string>& counter_names)
+{
+  auto is_all_added = true;
+
+  for (const auto& counter_name : counter_names) {
+    is_all_added &= this->add(counter_name);
+  }
+
+  return is_all_added;
+}
+
+perf::BenchmarkResult
+perf::Benchmark::run(const std::function<void()>& callable, const std::uint64_t normalization)
+{
+  /// One event counter per set, recording all counters of the set in a single group.
+  auto event_counters = std::vector<EventCounter>{};
+  event_counters.reserve(this->_counter_sets.size());
+  for (const auto& counter_set : this->_counter_sets) {
+    auto& event_counter = event_counters.emplace_back(this->_counter_definitions, this->_config);
+    if (!event_counter.add(counter_set.names)) {
+      throw std::runtime_error{ "Could not add the counters of the benchmark." };
+    }
+  }
+
+  for (auto i = 0U; i < this->_warm_up; ++i) {
+    callable();
+  }
+
+  /// Values of every counter and metric (in the order of the sets) over all repetitions.
+  auto names = std::vector<std::string_view>{};
+  auto values = std::vector<std::vector<double>>{};
+  auto times = std::vector<double>{};
+  times.reserve(std::size_t{ this->_repetitions } * this->count_counter_sets());
+
+  const auto add_values = [&names, &values](const CounterResult& result) {
+    for (const auto& [name, value] : result) {
+      auto iterator = std::find(names.begin(), names.end(), name);
+      if (iterator == names.end()) {
+        names.push_back(name);
+        values.emplace_back();
+        iterator = std::prev(names.end());
+      }
+      values[std::size_t(std::distance(names.begin(), iterator))].push_back(value);
+    }
+  };
+
+  const auto run_timed = [&callable, &times, normalization]() {
+    const auto begin = std::chrono::steady_clock::now();
+    callable();
+    const auto end = std::chrono::steady_clock::now();
+    times.push_back(double(std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count()) /
+                    double(normalization));
+  };
+
+  for (auto repetition = 0U; repetition < this->_repetitions; ++repetition) {
+    if (event_counters.empty()) {
+      run_timed();
+      continue;
+    }
+
+    /// Rotate through the sets; every set is recorded once per repetition.
+    for (auto& event_counter : event_counters) {
+      if (!event_counter.start()) {
+        event_counter.stop();
+        throw std::runtime_error{ "Could not start the counters of the benchmark." };
+      }
+      run_timed();
+      event_counter.stop();
+
+      add_values(event_counter.result(normalization));
+    }
+  }
+
+  auto statistics = std::vector<std::pair<std::string_view, Statistics>>{};
+  statistics.reserve(names.size());
+  for (auto i = 0U; i < names.size(); ++i) {
+    statistics.emplace_back(names[i], Statistics{ std::move(values[i]) });
+  }
+
+  return BenchmarkResult{ std::move(statistics), Statistics{ std::move(times) } };
+}
@@ -0,0 +1,166 @@
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <perfcpp/bolt_exporter.h>
+#include <set>
+#include <sstream>
+
+void
+perf::BOLTExporter::add(const Sample& sample)
+{
+  if (!sample.branches().has_value() || sample.context_switch().has_value()) {
+    return;
+  }
+
+  /// The branch stack is ordered from the most recent (index 0) to the oldest branch.
+  const auto& branch_stack = sample.branches().value();
+  for (auto i = 0U; i < branch_stack.size(); ++i) {
+    const auto& branch = branch_stack[i];
+
+    auto& counter = this->_branches[std::make_pair(branch.instruction_pointer_from(), branch.instruction_pointer_to())];
+    ++counter.count;
+    counter.count_mispredicted += static_cast<std::uint64_t>(branch.is_mispredicted());
+
+    /// The range between the target of the older branch and the source of this branch was executed straight-line.
+    if (i + 1U < branch_stack.size()) {
+      const auto begin = branch_stack[i + 1U].instruction_pointer_to();
+      const auto end = branch.instruction_pointer_from();
+      if (begin <= end) {
+        ++this->_fall_throughs[std::make_pair(begin, end)];
+      }
+    }
+  }
+}
+
+std::vector<std::string>
+perf::BOLTExporter::binaries() const
+{
+  auto binaries = std::set<std::string>{};
+  for (const auto& [branch, _] : this->_branches) {
+    if (const auto from = this->_symbol_resolver.translate(branch.first); from.has_value()) {
+      binaries.insert(from->binary());
+    }
+    if (const auto to = this->_symbol_resolver.translate(branch.second); to.has_value()) {
+      binaries.insert(to->binary());
+    }
+  }
+
+  return std::vector<std::string>{ binaries.begin(), binaries.end() };
+}
+
+void
+perf::BOLTExporter::write_fdata(std::ostream& stream, const std::string& binary) const
+{
+  /// Translate every distinct branch once; branches resolving to the same locations (e.g., from different processes
+  /// of the same binary) are merged.
+  auto lines = std::unordered_map<std::string, branch_counter>{};
+  for (const auto& [branch, counter] : this->_branches) {
+    const auto from = this->_symbol_resolver.translate(branch.first);
+    const auto to = this->_symbol_resolver.translate(branch.second);
+    if ((!from.has_value() || from->binary() != binary) && (!to.has_value() || to->binary() != binary)) {
+      continue;
+    }
+
+    auto& line_counter = lines[this->fdata_location(from, binary) + " " + this->fdata_location(to, binary)];
+    line_counter.count += counter.count;
+    line_counter.count_mispredicted += counter.count_mispredicted;
+  }
+
+  /// Sorted lines make profiles comparable.
+  auto sorted_lines = std::vector<std::pair<std::string, branch_counter>>{ lines.begin(), lines.end() };
+  std::sort(sorted_lines.begin(), sorted_lines.end(), [](const auto& left, const auto& right) {
+    return left.first < right.first;
+  });
+
+  for (const auto& [line, counter] : sorted_lines) {
+    stream << line << " " << std::dec << counter.count_mispredicted << " " << counter.count << "\n";
+  }
+}
+
+bool
+perf::BOLTExporter::write_fdata(const std::string& file_name, const std::string& binary) const
+{
+  auto stream = std::ofstream{ file_name };
+  if (!stream.is_open()) {
+    return false;
+  }
+
+  this->write_fdata(stream, binary);
+
+  return stream.good();
+}
+
+void
+perf::BOLTExporter::write_preaggregated(std::ostream& stream, const std::string& binary) const
+{
+  /// Translates both addresses, if both belong to the binary.
+  const auto translate = [this, &binary](const std::pair<std::uintptr_t, std::uintptr_t>& addresses)
+    -> std::optional<std::pair<std::uint64_t, std::uint64_t>> {
+    const auto first = this->_symbol_resolver.translate(addresses.first);
+    if (!first.has_value() || first->binary() != binary) {
+      return std::nullopt;
+    }
+
+    const auto second = this->_symbol_resolver.translate(addresses.second);
+    if (!second.has_value() || second->binary() != binary) {
+      return std::nullopt;
+    }
+
+    return std::make_pair(first->address(), second->address());
+  };
+
+  auto branches = std::map<std::pair<std::uint64_t, std::uint64_t>, branch_counter>{};
+  for (const auto& [branch, counter] : this->_branches) {
+    if (const auto addresses = translate(branch); addresses.has_value()) {
+      auto& branch_counter = branches[addresses.value()];
+      branch_counter.count += counter.count;
+      branch_counter.count_mispredicted += counter.count_mispredicted;
+    }
+  }
+
+  auto fall_throughs = std::map<std::pair<std::uint64_t, std::uint64_t>, std::uint64_t>{};
+  for (const auto& [range, count] : this->_fall_throughs) {
+    if (const auto addresses = translate(range); addresses.has_value()) {
+      fall_throughs[addresses.value()] += count;
+    }
+  }
+
+  for (const auto& [branch, counter] : branches) {
+    stream << "B " << std::hex << branch.first << " " << branch.second << " " << std::dec << counter.count << " "
+           << counter.count_mispredicted << "\n";
+  }
+
+  for (const auto& [range, count] : fall_throughs) {
+    stream << "F " << std::hex << range.first << " " << range.second << " " << std::dec << count << "\n";
+  }
+}
+
+bool
+perf::BOLTExporter::write_preaggregated(const std::string& file_name, const std::string& binary) const
+{
+  auto stream = std::ofstream{ file_name };
+  if (!stream.is_open()) {
+    return false;
+  }
+
+  this->write_preaggregated(stream, binary);
+
+  return stream.good();
+}
+
+std::string
+perf::BOLTExporter::fdata_location(const std::optional<BinaryAddress>& address, const std::string& binary) const
+{
+  auto stream = std::stringstream{};
+  stream << std::hex;
+
+  if (!address.has_value() || address->binary() != binary) {
+    stream << "0 [unknown] 0";
+  } else if (const auto* symbol = this->_symbol_resolver.symbol(address.value()); symbol != nullptr) {
+    stream << "1 " << symbol->name() << " " << address->address() - symbol->address();
+  } else {
+    stream << "0 [unknown] " << address->address();
+  }
+
+  return stream.str();
+}
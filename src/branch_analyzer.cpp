@@ -0,0 +1,159 @@
+#include <algorithm>
+#include <iomanip>
+#include <perfcpp/branch_analyzer.h>
+#include <perfcpp/hash.h>
+#include <sstream>
+#include <unordered_map>
+
+std::string
+perf::BranchResult::to_string(const std::size_t count_entries) const
+{
+  auto stream = std::stringstream{};
+  stream << std::fixed << std::setprecision(2);
+
+  stream << "Hottest executed ranges:\n";
+  stream << std::setw(40) << "range" << std::setw(14) << "count" << std::setw(14) << "avg. cycles"
+         << "\n";
+  for (auto i = 0U; i < std::min(count_entries, this->_ranges.size()); ++i) {
+    const auto& range = this->_ranges[i];
+
+    auto range_stream = std::stringstream{};
+    range_stream << "0x" << std::hex << range.begin() << "-0x" << range.end();
+
+    stream << std::setw(40) << range_stream.str() << std::setw(14) << range.count() << std::setw(14)
+           << range.average_cycles() << "\n";
+  }
+
+  stream << "\nMost costly branches:\n";
+  stream << std::setw(40) << "branch" << std::setw(14) << "count" << std::setw(14) << "mispredicted"
+         << std::setw(10) << "%" << std::setw(14) << "cost"
+         << "\n";
+  for (auto i = 0U; i < std::min(count_entries, this->_branches.size()); ++i) {
+    const auto& branch = this->_branches[i];
+
+    auto branch_stream = std::stringstream{};
+    branch_stream << "0x" << std::hex << branch.instruction_pointer_from() << " -> 0x"
+                  << branch.instruction_pointer_to();
+
+    stream << std::setw(40) << branch_stream.str() << std::setw(14) << branch.count() << std::setw(14)
+           << branch.count_mispredicted() << std::setw(10) << branch.misprediction_ratio() * 100. << std::setw(14)
+           << branch.estimated_cost() << (branch.is_cost_measured() ? "" : " (est.)") << "\n";
+  }
+
+  return stream.str();
+}
+
+perf::BranchResult
+perf::BranchAnalyzer::analyze(const std::vector<Sample>& samples) const
+{
+  struct range_counter
+  {
+    std::uint64_t count{ 0U };
+    std::uint64_t count_with_cycles{ 0U };
+    std::uint64_t cycles{ 0U };
+  };
+
+  struct branch_counter
+  {
+    std::uint64_t count{ 0U };
+    std::uint64_t count_mispredicted{ 0U };
+
+    /// Cycles of the range executed after mispredicted and correctly predicted executions of the branch.
+    std::uint64_t count_mispredicted_with_cycles{ 0U };
+    std::uint64_t mispredicted_cycles{ 0U };
+    std::uint64_t count_predicted_with_cycles{ 0U };
+    std::uint64_t predicted_cycles{ 0U };
+  };
+
+  auto ranges =
+    std::unordered_map<std::pair<std::uintptr_t, std::uintptr_t>, range_counter, instruction_pointer_pair_hash>{};
+  auto branches =
+    std::unordered_map<std::pair<std::uintptr_t, std::uintptr_t>, branch_counter, instruction_pointer_pair_hash>{};
+
+  for (const auto& sample : samples) {
+    if (!sample.branches().has_value() || sample.context_switch().has_value()) {
+      continue;
+    }
+
+    /// The branch stack is ordered from the most recent (index 0) to the oldest branch.
+    const auto& branch_stack = sample.branches().value();
+    for (auto i = 0U; i < branch_stack.size(); ++i) {
+      const auto& branch = branch_stack[i];
+
+      auto& branch_counter =
+        branches[std::make_pair(branch.instruction_pointer_from(), branch.instruction_pointer_to())];
+      ++branch_counter.count;
+      branch_counter.count_mispredicted += static_cast<std::uint64_t>(branch.is_mispredicted());
+
+      /// The range after this branch ends with the more recent branch, which holds the cycles spent in between
+      /// (including the pipeline flush of a misprediction).
+      if (i > 0U && branch_stack[i - 1U].cycles() > 0U) {
+        if (branch.is_mispredicted()) {
+          ++branch_counter.count_mispredicted_with_cycles;
+          branch_counter.mispredicted_cycles += branch_stack[i - 1U].cycles();
+        } else {
+          ++branch_counter.count_predicted_with_cycles;
+          branch_counter.predicted_cycles += branch_stack[i - 1U].cycles();
+        }
+      }
+
+      /// The range between the target of the older branch and the source of this branch was executed
+      /// straight-line; the cycles of this branch are the cycles since the older branch.
+      if (i + 1U < branch_stack.size()) {
+        const auto begin = branch_stack[i + 1U].instruction_pointer_to();
+        const auto end = branch.instruction_pointer_from();
+        if (begin <= end && end - begin <= this->_max_range_size) {
+          auto& range_counter = ranges[std::make_pair(begin, end)];
+          ++range_counter.count;
+          if (branch.cycles() > 0U) {
+            ++range_counter.count_with_cycles;
+            range_counter.cycles += branch.cycles();
+          }
+        }
+      }
+    }
+  }
+
+  auto executed_ranges = std::vector<ExecutedRange>{};
+  executed_ranges.reserve(ranges.size());
+  for (const auto& [range, counter] : ranges) {
+    executed_ranges.emplace_back(range.first, range.second, counter.count, counter.count_with_cycles, counter.cycles);
+  }
+  std::sort(executed_ranges.begin(), executed_ranges.end(), [](const auto& left, const auto& right) {
+    return left.count() > right.count() || (left.count() == right.count() && left.begin() < right.begin());
+  });
+
+  auto branch_statistics = std::vector<BranchStatistics>{};
+  branch_statistics.reserve(branches.size());
+  for (const auto& [branch, counter] : branches) {
+    /// Use the sampled cycles, if available: The penalty is the difference of the cycles after mispredicted and
+    /// correctly predicted executions; without the latter, the cycles after mispredictions are the penalty.
+    auto penalty = this->_misprediction_penalty;
+    const auto is_cost_measured = counter.count_mispredicted_with_cycles > 0U;
+    if (is_cost_measured) {
+      penalty = double(counter.mispredicted_cycles) / double(counter.count_mispredicted_with_cycles);
+      if (counter.count_predicted_with_cycles > 0U) {
+        penalty =
+          std::max(.0, penalty - double(counter.predicted_cycles) / double(counter.count_predicted_with_cycles));
+      }
+    }
+
+    branch_statistics.emplace_back(branch.first,
+                                   branch.second,
+                                   counter.count,
+                                   counter.count_mispredicted,
+                                   double(counter.count_mispredicted) * penalty,
+                                   is_cost_measured);
+  }
+  std::sort(branch_statistics.begin(), branch_statistics.end(), [](const auto& left, const auto& right) {
+    if (left.estimated_cost() != right.estimated_cost()) {
+      return left.estimated_cost() > right.estimated_cost();
+    }
+    if (left.count_mispredicted() != right.count_mispredicted()) {
+      return left.count_mispredicted() > right.count_mispredicted();
+    }
+    return left.count() > right.count();
+  });
+
+  return BranchResult{ std::move(executed_ranges), std::move(branch_statistics) };
+}
@@ -0,0 +1,303 @@
+#include <cmath>
+#include <perfcpp/chrome_trace_exporter.h>
+#include <stdexcept>
+
+perf::ChromeTraceExporter::ChromeTraceExporter(const std::string& file_name,
+                                               const Track track,
+                                               const std::size_t buffer_size)
+  : _output(file_name, std::ios::out | std::ios::binary | std::ios::trunc)
+  , _track(track)
+  , _buffer(_output, buffer_size)
+{
+  if (!this->_output.is_open()) {
+    throw std::runtime_error{ "Could not create '" + file_name + "'." };
+  }
+
+  this->_buffer.append("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+
+  if (this->_track == Track::CPU) {
+    this->name_process(CPU_PROCESS_ID, "CPUs");
+  }
+}
+
+perf::ChromeTraceExporter::~ChromeTraceExporter()
+{
+  if (!this->_is_closed) {
+    static_cast<void>(this->close());
+  }
+}
+
+void
+perf::ChromeTraceExporter::add(const Sample& sample)
+{
+  if (!sample.time().has_value()) {
+    return;
+  }
+
+  if (sample.context_switch().has_value()) {
+    this->add_context_switch(sample);
+    return;
+  }
+
+  /// Track of the sample: the thread (if sampled) or the CPU.
+  auto process_id = sample.process_id().value_or(0U);
+  auto thread_id = sample.thread_id().value_or(0U);
+  auto counter_track_name = std::string_view{ "thread" };
+  if (this->_track == Track::CPU) {
+    process_id = CPU_PROCESS_ID;
+    thread_id = sample.cpu_id().value_or(0U);
+    counter_track_name = "CPU";
+    this->name_cpu(thread_id);
+  }
+
+  this->begin_event('i', "sample", process_id, thread_id);
+  this->_buffer.append(",\"s\":\"t\",\"ts\":");
+  this->append_microseconds(sample.time().value());
+  this->_buffer.append(",\"args\":{\"instruction_pointer\":");
+  if (sample.instruction_pointer().has_value()) {
+    this->_buffer.append('"');
+    this->_buffer.append_hex(sample.instruction_pointer().value());
+    this->_buffer.append('"');
+  } else {
+    this->_buffer.append("null");
+  }
+  if (sample.logical_memory_address().has_value()) {
+    this->_buffer.append(",\"logical_memory_address\":\"");
+    this->_buffer.append_hex(sample.logical_memory_address().value());
+    this->_buffer.append('"');
+  }
+  if (this->_track == Track::CPU && sample.thread_id().has_value()) {
+    this->_buffer.append(",\"thread_id\":");
+    this->_buffer.append(std::uint64_t{ sample.thread_id().value() });
+  } else if (this->_track == Track::Thread && sample.cpu_id().has_value()) {
+    this->_buffer.append(",\"cpu_id\":");
+    this->_buffer.append(std::uint64_t{ sample.cpu_id().value() });
+  }
+  if (sample.period().has_value()) {
+    this->_buffer.append(",\"period\":");
+    this->_buffer.append(sample.period().value());
+  }
+  if (sample.weight().has_value()) {
+    this->_buffer.append(",\"weight\":");
+    this->_buffer.append(std::uint64_t{ sample.weight()->latency() });
+  }
+  this->_buffer.append("}}");
+
+  /// Sampled counter values become a counter track per thread (or CPU).
+  if (sample.counter_result().has_value()) {
+    this->begin_event('C', counter_track_name, process_id, thread_id);
+    this->_buffer.append(",\"id\":");
+    this->_buffer.append(std::uint64_t{ thread_id });
+    this->_buffer.append(",\"ts\":");
+    this->append_microseconds(sample.time().value());
+    this->_buffer.append(",\"args\":");
+    this->append_counters(sample.counter_result().value());
+    this->_buffer.append('}');
+  }
+}
+
+void
+perf::ChromeTraceExporter::add(const std::vector<Sample>& samples)
+{
+  for (const auto& sample : samples) {
+    this->add(sample);
+  }
+}
+
+void
+perf::ChromeTraceExporter::add_counters(const std::string_view name,
+                                        const std::uint64_t time,
+                                        const std::uint32_t process_id,
+                                        const CounterResult& result)
+{
+  this->begin_event('C', name, process_id, 0U);
+  this->_buffer.append(",\"ts\":");
+  this->append_microseconds(time);
+  this->_buffer.append(",\"args\":");
+  this->append_counters(result);
+  this->_buffer.append('}');
+}
+
+void
+perf::ChromeTraceExporter::add_region(const std::string_view name,
+                                      const std::uint64_t begin_time,
+                                      const std::uint64_t end_time,
+                                      const std::uint32_t process_id,
+                                      const std::uint32_t thread_id,
+                                      const CounterResult& result)
+{
+  this->begin_event('X', name, process_id, thread_id);
+  this->_buffer.append(",\"ts\":");
+  this->append_microseconds(begin_time);
+  this->_buffer.append(",\"dur\":");
+  this->append_microseconds(end_time > begin_time ? end_time - begin_time : 0U);
+  this->_buffer.append(",\"args\":");
+  this->append_counters(result);
+  this->_buffer.append('}');
+}
+
+void
+perf::ChromeTraceExporter::name_process(const std::uint32_t process_id, const std::string_view name)
+{
+  this->begin_event('M', "process_name", process_id, 0U);
+  this->_buffer.append(",\"args\":{\"name\":");
+  this->_buffer.append_json_string(name);
+  this->_buffer.append("}}");
+}
+
+void
+perf::ChromeTraceExporter::name_thread(const std::uint32_t process_id,
+                                       const std::uint32_t thread_id,
+                                       const std::string_view name)
+{
+  this->begin_event('M', "thread_name", process_id, thread_id);
+  this->_buffer.append(",\"args\":{\"name\":");
+  this->_buffer.append_json_string(name);
+  this->_buffer.append("}}");
+}
+
+bool
+perf::ChromeTraceExporter::flush()
+{
+  return this->_buffer.flush();
+}
+
+bool
+perf::ChromeTraceExporter::close()
+{
+  if (this->_is_closed) {
+    return false;
+  }
+
+  this->_buffer.append("\n]}\n");
+
+  const auto is_flushed = this->flush();
+  this->_output.close();
+  this->_is_closed = true;
+
+  return is_flushed && !this->_output.fail();
+}
+
+void
+perf::ChromeTraceExporter::append_microseconds(const std::uint64_t nanoseconds)
+{
+  /// Written as fixed-point number with three decimals to keep the full precision of large timestamps.
+  this->_buffer.append(nanoseconds / 1000U);
+
+  const auto fraction = nanoseconds % 1000U;
+  if (fraction > 0U) {
+    auto* begin = this->_buffer.reserve(4U);
+    begin[0U] = '.';
+    begin[1U] = char('0' + fraction / 100U);
+    begin[2U] = char('0' + (fraction / 10U) % 10U);
+    begin[3U] = char('0' + fraction % 10U);
+    this->_buffer.commit(4U);
+  }
+}
+
+void
+perf::ChromeTraceExporter::append_counters(const CounterResult& result)
+{
+  this->_buffer.append('{');
+  auto is_first = true;
+  for (const auto& [name, value] : result) {
+    if (!is_first) {
+      this->_buffer.append(',');
+    }
+    is_first = false;
+
+    this->_buffer.append_json_string(name);
+    this->_buffer.append(':');
+    if (std::isfinite(value)) {
+      this->_buffer.append(value);
+    } else {
+      /// JSON has no representation for NaN and infinity (e.g., metrics dividing by zero).
+      this->_buffer.append("null");
+    }
+  }
+  this->_buffer.append('}');
+}
+
+void
+perf::ChromeTraceExporter::begin_event(const char phase,
+                                       const std::string_view name,
+                                       const std::uint32_t process_id,
+                                       const std::uint32_t thread_id)
+{
+  if (this->_count_events > 0U) {
+    this->_buffer.append(",\n");
+  }
+  ++this->_count_events;
+
+  this->_buffer.append("{\"ph\":\"");
+  this->_buffer.append(phase);
+  this->_buffer.append("\",\"name\":");
+  this->_buffer.append_json_string(name);
+  this->_buffer.append(",\"pid\":");
+  this->_buffer.append(std::uint64_t{ process_id });
+  this->_buffer.append(",\"tid\":");
+  this->_buffer.append(std::uint64_t{ thread_id });
+}
+
+void
+perf::ChromeTraceExporter::name_cpu(const std::uint32_t cpu_id)
+{
+  if (cpu_id < this->_named_cpus.size() && this->_named_cpus[cpu_id]) {
+    return;
+  }
+
+  if (cpu_id >= this->_named_cpus.size()) {
+    this->_named_cpus.resize(cpu_id + 1U, false);
+  }
+  this->_named_cpus[cpu_id] = true;
+
+  this->name_thread(CPU_PROCESS_ID, cpu_id, "CPU " + std::to_string(cpu_id));
+}
+
+void
+perf::ChromeTraceExporter::add_context_switch(const Sample& sample)
+{
+  const auto context_switch = sample.context_switch().value();
+  const auto process_id = sample.process_id().value_or(0U);
+  const auto thread_id = sample.thread_id().value_or(0U);
+  const auto cpu_id = sample.cpu_id().value_or(0U);
+
+  /// Slices are tracked per thread, or per CPU when sampling CPUs.
+  const auto key = this->_track == Track::Thread ? thread_id : cpu_id;
+
+  if (context_switch.is_in()) {
+    this->_running_slices[key] = running_slice{ sample.time().value(), process_id, thread_id };
+    return;
+  }
+
+  /// Switching out without having seen the thread switching in (e.g., at the begin of the recording) is skipped.
+  const auto iterator = this->_running_slices.find(key);
+  if (iterator == this->_running_slices.end()) {
+    return;
+  }
+  const auto slice = iterator->second;
+  this->_running_slices.erase(iterator);
+
+  if (this->_track == Track::Thread) {
+    this->begin_event('X', "running", slice.process_id, slice.thread_id);
+  } else {
+    this->name_cpu(cpu_id);
+    this->begin_event('X', "thread " + std::to_string(slice.thread_id), CPU_PROCESS_ID, cpu_id);
+  }
+  this->_buffer.append(",\"ts\":");
+  this->append_microseconds(slice.begin_time);
+  this->_buffer.append(",\"dur\":");
+  this->append_microseconds(sample.time().value() > slice.begin_time ? sample.time().value() - slice.begin_time
+                                                                     : 0U);
+  this->_buffer.append(",\"args\":{\"process_id\":");
+  this->_buffer.append(std::uint64_t{ slice.process_id });
+  this->_buffer.append(",\"thread_id\":");
+  this->_buffer.append(std::uint64_t{ slice.thread_id });
+  if (this->_track == Track::Thread && sample.cpu_id().has_value()) {
+    this->_buffer.append(",\"cpu_id\":");
+    this->_buffer.append(std::uint64_t{ cpu_id });
+  }
+  this->_buffer.append(",\"is_preempted\":");
+  this->_buffer.append(context_switch.is_preempt() ? std::string_view{ "true" } : std::string_view{ "false" });
+  this->_buffer.append("}}");
+}
@@ -0,0 +1,346 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <iomanip>
+#include <limits>
+#include <perfcpp/comparison.h>
+#include <perfcpp/event_counter.h>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+
+/// Number of resamples to bootstrap the confidence interval of the relative difference.
+static constexpr auto BOOTSTRAP_RESAMPLES = 2000U;
+
+/**
+ * Calculates the median of the given values; the values are reordered.
+ */
+static double
+median(std::vector<double>& values)
+{
+  if (values.empty()) {
+    return std::numeric_limits<double>::quiet_NaN();
+  }
+
+  const auto middle = values.begin() + std::ptrdiff_t(values.size() / 2U);
+  std::nth_element(values.begin(), middle, values.end());
+  if (values.size() % 2U == 1U) {
+    return *middle;
+  }
+
+  return (*middle + *std::max_element(values.begin(), middle)) / 2.;
+}
+
+/**
+ * Calculates the relative difference of the variant to the baseline; NaN if the baseline is zero but the variant not.
+ */
+static double
+relative_difference(const double baseline, const double variant)
+{
+  if (baseline == .0) {
+    return variant == .0 ? .0 : std::numeric_limits<double>::quiet_NaN();
+  }
+
+  return (variant - baseline) / std::abs(baseline);
+}
+
+/**
+ * Calculates the two-sided p-value of the Mann-Whitney U test (normal approximation with tie and continuity
+ * correction).
+ */
+static double
+mann_whitney_p_value(const std::vector<double>& baseline_values, const std::vector<double>& variant_values)
+{
+  const auto count_baseline = double(baseline_values.size());
+  const auto count_variant = double(variant_values.size());
+  if (baseline_values.empty() || variant_values.empty()) {
+    return 1.;
+  }
+
+  /// Rank all values; the flag indicates values of the baseline.
+  auto values = std::vector<std::pair<double, bool>>{};
+  values.reserve(baseline_values.size() + variant_values.size());
+  for (const auto value : baseline_values) {
+    values.emplace_back(value, true);
+  }
+  for (const auto value : variant_values) {
+    values.emplace_back(value, false);
+  }
+  std::sort(values.begin(), values.end());
+
+  /// Sum up the ranks of the baseline; ties get the average rank.
+  auto rank_sum_baseline = .0;
+  auto tie_correction = .0;
+  for (auto begin = 0U; begin < values.size();) {
+    auto end = begin + 1U;
+    while (end < values.size() && values[end].first == values[begin].first) {
+      ++end;
+    }
+
+    const auto average_rank = (double(begin + 1U) + double(end)) / 2.;
+    for (auto index = begin; index < end; ++index) {
+      if (values[index].second) {
+        rank_sum_baseline += average_rank;
+      }
+    }
+
+    const auto count_ties = double(end - begin);
+    tie_correction += count_ties * count_ties * count_ties - count_ties;
+    begin = end;
+  }
+
+  const auto count = count_baseline + count_variant;
+  const auto u = rank_sum_baseline - count_baseline * (count_baseline + 1.) / 2.;
+  const auto mean = count_baseline * count_variant / 2.;
+  const auto variance = count_baseline * count_variant / 12. * ((count + 1.) - tie_correction / (count * (count - 1.)));
+  if (variance <= .0) {
+    return 1.;
+  }
+
+  const auto z = std::max(std::abs(u - mean) - .5, .0) / std::sqrt(variance);
+  return std::erfc(z / std::sqrt(2.));
+}
+
+std::string_view
+perf::CounterComparison::to_string(const Verdict verdict) noexcept
+{
+  switch (verdict) {
+    case Verdict::Lower:
+      return "lower";
+    case Verdict::Higher:
+      return "higher";
+    case Verdict::Equivalent:
+      return "equivalent";
+    case Verdict::Noisy:
+      return "unresolvable (noise)";
+    case Verdict::Multiplexed:
+      return "unresolvable (multiplexing)";
+  }
+
+  return "";
+}
+
+std::optional<perf::CounterComparison>
+perf::ComparisonResult::get(const std::string_view name) const noexcept
+{
+  if (auto iterator = std::find_if(this->_comparisons.begin(),
+                                   this->_comparisons.end(),
+                                   [name](const auto& comparison) { return comparison.first == name; });
+      iterator != this->_comparisons.end()) {
+    return iterator->second;
+  }
+
+  return std::nullopt;
+}
+
+std::string
+perf::ComparisonResult::to_string() const
+{
+  auto stream = std::stringstream{};
+  stream << std::fixed << std::setprecision(2);
+
+  stream << std::setw(32) << std::left << "counter" << std::right << std::setw(16) << "baseline" << std::setw(16)
+         << "variant" << std::setw(12) << "difference" << std::setw(26) << "confidence interval" << std::setw(10)
+         << "p-value"
+         << "  verdict\n";
+
+  const auto percent = [](const double value) {
+    auto percent_stream = std::stringstream{};
+    percent_stream << std::fixed << std::setprecision(2) << std::showpos << value * 100. << "%";
+    return percent_stream.str();
+  };
+
+  const auto add_row = [&stream, &percent](const std::string_view name, const CounterComparison& comparison) {
+    const auto [lower, upper] = comparison.confidence_interval();
+    stream << std::setw(32) << std::left << name << std::right << std::setw(16) << comparison.baseline().median()
+           << std::setw(16) << comparison.variant().median() << std::setw(12)
+           << percent(comparison.relative_difference()) << std::setw(26)
+           << ("[" + percent(lower) + ", " + percent(upper) + "]") << std::setw(10) << std::setprecision(4)
+           << comparison.p_value() << std::setprecision(2) << "  "
+           << CounterComparison::to_string(comparison.verdict()) << "\n";
+  };
+
+  for (const auto& [name, comparison] : this->_comparisons) {
+    add_row(name, comparison);
+  }
+  add_row("time (ns)", this->_time);
+
+  return stream.str();
+}
+
+bool
+perf::Comparison::add(std::string counter_name)
+{
+  if (!this->_counter_definitions.is_metric(counter_name) &&
+      !this->_counter_definitions.counter(counter_name).has_value()) {
+    return false;
+  }
+
+  if (std::find(this->_counter_names.begin(), this->_counter_names.end(), counter_name) ==
+      this->_counter_names.end()) {
+    this->_counter_names.push_back(std::move(counter_name));
+  }
+
+  return true;
+}
+
+bool
+perf::Comparison::add(const std::vector<std::string>& counter_names)
+{
+  auto is_all_added = true;
+
+  for (const auto& counter_name : counter_names) {
+    is_all_added &= this->add(counter_name);
+  }
+
+  return is_all_added;
+}
+
+perf::ComparisonResult
+perf::Comparison::run(const std::function<void()>& baseline,
+                      const std::function<void()>& variant,
+                      const std::uint64_t normalization)
+{
+  /// Both callables are recorded with the same counters.
+  auto event_counter = EventCounter{ this->_counter_definitions, this->_config };
+  if (!event_counter.add(this->_counter_names)) {
+    throw std::runtime_error{ "Could not add the counters of the comparison." };
+  }
+
+  for (auto i = 0U; i < this->_warm_up; ++i) {
+    baseline();
+    variant();
+  }
+
+  /// Values of every counter and metric over all repetitions, for the baseline (index 0) and the variant (index 1).
+  auto names = std::vector<std::string_view>{};
+  auto values = std::array<std::vector<std::vector<double>>, 2U>{};
+  auto times = std::array<std::vector<double>, 2U>{};
+  auto running_fraction = 1.;
+
+  const auto run_recorded = [&](const bool is_variant) {
+    if (!event_counter.start()) {
+      event_counter.stop();
+      throw std::runtime_error{ "Could not start the counters of the comparison." };
+    }
+    const auto begin = std::chrono::steady_clock::now();
+    if (is_variant) {
+      variant();
+    } else {
+      baseline();
+    }
+    const auto end = std::chrono::steady_clock::now();
+    event_counter.stop();
+
+    times[is_variant].push_back(double(std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count()) /
+                                double(normalization));
+    running_fraction = std::min(running_fraction, event_counter.running_fraction());
+
+    for (const auto& [name, value] : event_counter.result(normalization)) {
+      auto iterator = std::find(names.begin(), names.end(), name);
+      if (iterator == names.end()) {
+        names.push_back(name);
+        values[0U].emplace_back();
+        values[1U].emplace_back();
+        iterator = std::prev(names.end());
+      }
+      values[is_variant][std::size_t(std::distance(names.begin(), iterator))].push_back(value);
+    }
+  };
+
+  /// Alternate both callables in a random order per repetition.
+  auto random_generator = std::mt19937_64{ this->_seed };
+  for (auto repetition = 0U; repetition < this->_repetitions; ++repetition) {
+    const auto is_variant_first = (random_generator() & 1U) == 1U;
+    run_recorded(is_variant_first);
+    run_recorded(!is_variant_first);
+  }
+
+  auto comparisons = std::vector<std::pair<std::string_view, CounterComparison>>{};
+  comparisons.reserve(names.size());
+  for (auto i = 0U; i < names.size(); ++i) {
+    comparisons.emplace_back(names[i],
+                             this->compare(std::move(values[0U][i]), std::move(values[1U][i]), running_fraction));
+  }
+
+  /// The time is not affected by multiplexing.
+  auto time = this->compare(std::move(times[0U]), std::move(times[1U]), 1.);
+
+  return ComparisonResult{ std::move(comparisons), time, running_fraction };
+}
+
+perf::CounterComparison
+perf::Comparison::compare(std::vector<double>&& baseline_values,
+                          std::vector<double>&& variant_values,
+                          const double running_fraction) const
+{
+  const auto p_value = mann_whitney_p_value(baseline_values, variant_values);
+
+  auto baseline_median_values = baseline_values;
+  auto variant_median_values = variant_values;
+  const auto difference = relative_difference(median(baseline_median_values), median(variant_median_values));
+
+  /// Bootstrap the confidence interval of the relative difference of the medians.
+  auto confidence_interval = std::make_pair(std::numeric_limits<double>::quiet_NaN(),
+                                            std::numeric_limits<double>::quiet_NaN());
+  if (!baseline_values.empty() && !variant_values.empty()) {
+    auto random_generator = std::mt19937_64{ this->_seed };
+    auto baseline_distribution = std::uniform_int_distribution<std::size_t>{ 0U, baseline_values.size() - 1U };
+    auto variant_distribution = std::uniform_int_distribution<std::size_t>{ 0U, variant_values.size() - 1U };
+
+    auto baseline_sample = std::vector<double>(baseline_values.size());
+    auto variant_sample = std::vector<double>(variant_values.size());
+    auto differences = std::vector<double>{};
+    differences.reserve(BOOTSTRAP_RESAMPLES);
+    for (auto resample = 0U; resample < BOOTSTRAP_RESAMPLES; ++resample) {
+      for (auto& value : baseline_sample) {
+        value = baseline_values[baseline_distribution(random_generator)];
+      }
+      for (auto& value : variant_sample) {
+        value = variant_values[variant_distribution(random_generator)];
+      }
+
+      if (const auto resampled_difference = relative_difference(median(baseline_sample), median(variant_sample));
+          std::isfinite(resampled_difference)) {
+        differences.push_back(resampled_difference);
+      }
+    }
+
+    if (!differences.empty()) {
+      std::sort(differences.begin(), differences.end());
+      const auto tail = (1. - this->_confidence_level) / 2.;
+      const auto last = double(differences.size() - 1U);
+      confidence_interval = std::make_pair(differences[std::size_t(std::floor(tail * last))],
+                                           differences[std::size_t(std::ceil((1. - tail) * last))]);
+    }
+  }
+
+  /// Decide on the outcome.
+  const auto is_significant = p_value < 1. - this->_confidence_level;
+  const auto is_interval_finite = std::isfinite(confidence_interval.first) && std::isfinite(confidence_interval.second);
+
+  auto verdict = CounterComparison::Verdict::Noisy;
+  if (running_fraction < 1. &&
+      (!is_significant || !std::isfinite(difference) || std::abs(difference) <= 1. - running_fraction)) {
+    /// Multiplexed counters are extrapolated; differences within the unobserved time cannot be resolved.
+    verdict = CounterComparison::Verdict::Multiplexed;
+  } else if (is_significant && is_interval_finite &&
+             (confidence_interval.first > .0 || confidence_interval.second < .0)) {
+    verdict = difference > .0 ? CounterComparison::Verdict::Higher : CounterComparison::Verdict::Lower;
+  } else if (is_significant && !std::isfinite(difference)) {
+    /// The median of the baseline is zero, but the median of the variant is not.
+    verdict = CounterComparison::Verdict::Higher;
+  } else if (is_interval_finite && confidence_interval.first >= -this->_resolution &&
+             confidence_interval.second <= this->_resolution) {
+    verdict = CounterComparison::Verdict::Equivalent;
+  }
+
+  return CounterComparison{ Statistics{ std::move(baseline_values) },
+                            Statistics{ std::move(variant_values) },
+                            difference,
+                            confidence_interval,
+                            p_value,
+                            verdict };
+}
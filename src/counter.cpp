@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <charconv>
 #include <perfcpp/counter.h>
 #include <sstream>
 
@@ -14,44 +15,119 @@ perf::CounterResult::get(std::string_view name) const noexcept
   return std::nullopt;
 }
 
+/**
+ * Copies the string into the buffer.
+ *
+ * @param begin Begin of the buffer.
+ * @param end End of the buffer.
+ * @param string String to copy.
+ * @return Pointer behind the copied string, or nullptr if the buffer is too small.
+ */
+static char*
+append(char* begin, char* end, const std::string_view string) noexcept
+{
+  if (begin == nullptr || std::size_t(end - begin) < string.size()) {
+    return nullptr;
+  }
+
+  return std::copy(string.begin(), string.end(), begin);
+}
+
+/**
+ * Formats the value into the buffer (shortest representation that reads back to the same value).
+ *
+ * @param begin Begin of the buffer.
+ * @param end End of the buffer.
+ * @param value Value to format.
+ * @return Pointer behind the formatted value, or nullptr if the buffer is too small.
+ */
+static char*
+append(char* begin, char* end, const double value) noexcept
+{
+  if (begin == nullptr) {
+    return nullptr;
+  }
+
+  const auto [pointer, error] = std::to_chars(begin, end, value);
+  return error == std::errc{} ? pointer : nullptr;
+}
+
+/**
+ * Formats into a string by calling the formatter with growing buffers until the result fits.
+ *
+ * @param format Formatter writing into a buffer, returning nullptr if the buffer is too small.
+ * @return Formatted string.
+ */
+template <typename F>
+static std::string
+format_string(F&& format)
+{
+  auto string = std::string(256U, '\0');
+  while (true) {
+    if (auto* end = format(string.data(), string.data() + string.size()); end != nullptr) {
+      string.resize(std::size_t(end - string.data()));
+      return string;
+    }
+
+    string.resize(string.size() * 2U);
+  }
+}
+
 std::string
 perf::CounterResult::to_json() const
 {
-  auto json_stream = std::stringstream{};
+  return format_string([this](char* begin, char* end) { return this->to_json(begin, end); });
+}
 
-  json_stream << "{";
+std::string
+perf::CounterResult::to_csv(const char delimiter, const bool print_header) const
+{
+  return format_string([this, delimiter, print_header](char* begin, char* end) {
+    return this->to_csv(begin, end, delimiter, print_header);
+  });
+}
+
+char*
+perf::CounterResult::to_json(char* begin, char* end) const noexcept
+{
+  begin = append(begin, end, "{");
 
   for (auto i = 0U; i < this->_results.size(); ++i) {
     if (i > 0U) {
-      json_stream << ",";
+      begin = append(begin, end, ",");
     }
 
-    json_stream << "\"" << this->_results[i].first << "\": " << this->_results[i].second;
+    begin = append(begin, end, "\"");
+    begin = append(begin, end, this->_results[i].first);
+    begin = append(begin, end, "\": ");
+    begin = append(begin, end, this->_results[i].second);
   }
 
-  json_stream << "}";
-
-  return json_stream.str();
+  return append(begin, end, "}");
 }
 
-std::string
-perf::CounterResult::to_csv(const char delimiter, const bool print_header) const
+char*
+perf::CounterResult::to_csv(char* begin, char* end, const char delimiter, const bool print_header) const noexcept
 {
-  auto csv_stream = std::stringstream{};
+  const auto delimiter_string = std::string_view{ &delimiter, 1U };
 
   if (print_header) {
-    csv_stream << "counter" << delimiter << "value\n";
+    begin = append(begin, end, "counter");
+    begin = append(begin, end, delimiter_string);
+    begin = append(begin, end, "value\n");
   }
 
   for (auto i = 0U; i < this->_results.size(); ++i) {
     if (i > 0U) {
-      csv_stream << "\n";
+      begin = append(begin, end, "\n");
     }
 
-    csv_stream << this->_results[i].first << delimiter << this->_results[i].second;
+    begin = append(begin, end, this->_results[i].first);
+    begin = append(begin, end, delimiter_string);
+    begin = append(begin, end, this->_results[i].second);
   }
 
-  return csv_stream.str();
+  return begin;
 }
 
 std::string
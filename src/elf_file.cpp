@@ -0,0 +1,142 @@
+#include <algorithm>
+#include <elf.h>
+#include <fstream>
+#include <perfcpp/elf_file.h>
+
+/**
+ * Reads the function symbols from the symbol table.
+ *
+ * @param stream Stream of the opened file.
+ * @param header ELF header of the file.
+ * @return Function symbols, sorted by address (empty if the binary has no symbol table).
+ */
+static std::vector<perf::ElfSymbol>
+read_symbols(std::ifstream& stream, const Elf64_Ehdr& header)
+{
+  auto function_symbols = std::vector<perf::ElfSymbol>{};
+  if (header.e_shentsize != sizeof(Elf64_Shdr) || header.e_shnum == 0U) {
+    return function_symbols;
+  }
+
+  auto section_headers = std::vector<Elf64_Shdr>(header.e_shnum);
+  if (!stream.seekg(std::streamoff(header.e_shoff)) ||
+      !stream.read(reinterpret_cast<char*>(section_headers.data()),
+                   std::streamsize(section_headers.size() * sizeof(Elf64_Shdr)))) {
+    return function_symbols;
+  }
+
+  /// Prefer the full symbol table; stripped binaries only provide the dynamic symbol table.
+  auto symbol_section = std::find_if(section_headers.begin(), section_headers.end(), [](const auto& section) {
+    return section.sh_type == SHT_SYMTAB;
+  });
+  if (symbol_section == section_headers.end()) {
+    symbol_section = std::find_if(section_headers.begin(), section_headers.end(), [](const auto& section) {
+      return section.sh_type == SHT_DYNSYM;
+    });
+  }
+  if (symbol_section == section_headers.end() || symbol_section->sh_link >= section_headers.size() ||
+      symbol_section->sh_entsize != sizeof(Elf64_Sym)) {
+    return function_symbols;
+  }
+
+  /// Read the symbols and the linked string table.
+  const auto& string_section = section_headers[symbol_section->sh_link];
+  auto symbols = std::vector<Elf64_Sym>(symbol_section->sh_size / sizeof(Elf64_Sym));
+  auto strings = std::vector<char>(string_section.sh_size + 1U, '\0');
+  if (!stream.seekg(std::streamoff(symbol_section->sh_offset)) ||
+      !stream.read(reinterpret_cast<char*>(symbols.data()), std::streamsize(symbols.size() * sizeof(Elf64_Sym))) ||
+      !stream.seekg(std::streamoff(string_section.sh_offset)) ||
+      !stream.read(strings.data(), std::streamsize(string_section.sh_size))) {
+    return function_symbols;
+  }
+
+  for (const auto& symbol : symbols) {
+    if (ELF64_ST_TYPE(symbol.st_info) == STT_FUNC && symbol.st_shndx != SHN_UNDEF && symbol.st_value != 0U &&
+        symbol.st_name < string_section.sh_size) {
+      function_symbols.emplace_back(std::string{ strings.data() + symbol.st_name }, symbol.st_value, symbol.st_size);
+    }
+  }
+
+  std::sort(function_symbols.begin(), function_symbols.end(), [](const auto& left, const auto& right) {
+    return left.address() < right.address() || (left.address() == right.address() && left.size() > right.size());
+  });
+
+  /// Aliases (e.g., C1/C2 constructors) share the address; keep the first one.
+  function_symbols.erase(
+    std::unique(function_symbols.begin(),
+                function_symbols.end(),
+                [](const auto& left, const auto& right) { return left.address() == right.address(); }),
+    function_symbols.end());
+
+  return function_symbols;
+}
+
+perf::ElfFile
+perf::ElfFile::read(const std::string& path, const bool include_symbols)
+{
+  auto elf_file = ElfFile{};
+
+  auto stream = std::ifstream{ path, std::ios::binary };
+  if (!stream.is_open()) {
+    return elf_file;
+  }
+
+  auto header = Elf64_Ehdr{};
+  if (!stream.read(reinterpret_cast<char*>(&header), sizeof(Elf64_Ehdr)) ||
+      !std::equal(header.e_ident, header.e_ident + SELFMAG, ELFMAG) ||
+      header.e_ident[EI_CLASS] != ELFCLASS64 || header.e_phentsize != sizeof(Elf64_Phdr)) {
+    return elf_file;
+  }
+
+  elf_file._is_position_independent = header.e_type == ET_DYN;
+
+  auto program_headers = std::vector<Elf64_Phdr>(header.e_phnum);
+  if (!stream.seekg(std::streamoff(header.e_phoff)) ||
+      !stream.read(reinterpret_cast<char*>(program_headers.data()),
+                   std::streamsize(program_headers.size() * sizeof(Elf64_Phdr)))) {
+    return elf_file;
+  }
+
+  for (const auto& program_header : program_headers) {
+    if (program_header.p_type == PT_LOAD) {
+      elf_file._segments.emplace_back(program_header.p_offset,
+                                      program_header.p_vaddr,
+                                      program_header.p_filesz,
+                                      static_cast<bool>(program_header.p_flags & PF_X));
+    }
+  }
+
+  if (include_symbols) {
+    elf_file._symbols = read_symbols(stream, header);
+  }
+
+  return elf_file;
+}
+
+std::optional<std::uint64_t>
+perf::ElfFile::virtual_address(const std::uint64_t offset) const noexcept
+{
+  for (const auto& segment : this->_segments) {
+    if (segment.contains_offset(offset)) {
+      return segment.virtual_address() + (offset - segment.offset());
+    }
+  }
+
+  return std::nullopt;
+}
+
+const perf::ElfSymbol*
+perf::ElfFile::symbol(const std::uint64_t address) const noexcept
+{
+  /// Find the last symbol starting at or before the address.
+  auto iterator = std::upper_bound(
+    this->_symbols.begin(), this->_symbols.end(), address, [](const auto address, const auto& symbol) {
+      return address < symbol.address();
+    });
+  if (iterator == this->_symbols.begin()) {
+    return nullptr;
+  }
+
+  --iterator;
+  return iterator->contains(address) ? &*iterator : nullptr;
+}
@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <cstddef>
 #include <numeric>
 #include <perfcpp/perf.h>
 bool
@@ -25,7 +26,7 @@ perf::EventCounter::add(std::string&& counter_name)
   }
 
   /// Try to add the metric, if the name is a metric.
-  if (this->_counter_definitions.is_metric(counter_name)) {
+  if (const auto metric_name = this->_counter_definitions.metric_name(counter_name); metric_name.has_value()) {
     /// Add all required counters.
     for (auto&& dependent_counter_name : this->_counter_definitions.metric(counter_name)->required_counter_names()) {
       auto dependent_counter_config = this->_counter_definitions.counter(dependent_counter_name);
@@ -40,7 +41,9 @@ perf::EventCounter::add(std::string&& counter_name)
       }
     }
 
-    this->_counters.emplace_back(std::move(counter_name));
+    /// The event refers to the name stored by the definition, since the given name does not outlive this call.
+    this->_counters.emplace_back(metric_name.value());
+    this->_overhead.clear();
     return true;
   }
 
@@ -74,6 +77,7 @@ perf::EventCounter::add(std::string_view counter_name, perf::CounterConfig count
   const auto in_group_id = std::uint8_t(this->_groups.back().size());
   this->_counters.emplace_back(counter_name, is_hidden, group_id, in_group_id);
   this->_groups.back().add(counter);
+  this->_overhead.clear();
 
   return true;
 }
@@ -130,17 +134,143 @@ perf::EventCounter::stop()
   }
 }
 
+bool
+perf::EventCounter::pause()
+{
+  auto is_every_counter_paused = true;
+  for (auto& group : this->_groups) {
+    is_every_counter_paused &= group.pause();
+  }
+
+  return is_every_counter_paused;
+}
+
+bool
+perf::EventCounter::resume()
+{
+  auto is_every_counter_resumed = true;
+  for (auto& group : this->_groups) {
+    is_every_counter_resumed &= group.resume();
+  }
+
+  return is_every_counter_resumed;
+}
+
+bool
+perf::EventCounter::calibrate(const std::uint32_t count_runs)
+{
+  this->_overhead.clear();
+  if (count_runs == 0U) {
+    return false;
+  }
+
+  /// Record the empty region and collect the values of every counter.
+  auto values = std::vector<std::vector<double>>(this->_counters.size());
+  for (auto run = 0U; run < count_runs; ++run) {
+    const auto is_started = this->start();
+    this->stop();
+    if (!is_started) {
+      return false;
+    }
+
+    for (auto index = 0U; index < this->_counters.size(); ++index) {
+      const auto& event = this->_counters[index];
+      if (event.is_counter()) {
+        values[index].emplace_back(this->_groups[event.group_id()].get(event.in_group_id()));
+      }
+    }
+  }
+
+  /// Store the median per counter; metrics have no overhead of their own.
+  this->_overhead.reserve(this->_counters.size());
+  for (auto& counter_values : values) {
+    if (counter_values.empty()) {
+      this->_overhead.emplace_back(.0);
+      continue;
+    }
+
+    const auto middle = counter_values.begin() + std::ptrdiff_t(counter_values.size() / 2U);
+    std::nth_element(counter_values.begin(), middle, counter_values.end());
+    auto median = *middle;
+    if (counter_values.size() % 2U == 0U) {
+      median = (median + *std::max_element(counter_values.begin(), middle)) / 2.;
+    }
+    this->_overhead.emplace_back(median);
+  }
+
+  return true;
+}
+
+perf::CounterResult
+perf::EventCounter::overhead() const
+{
+  auto result = std::vector<std::pair<std::string_view, double>>{};
+  if (this->_overhead.size() == this->_counters.size()) {
+    for (auto index = 0U; index < this->_counters.size(); ++index) {
+      if (this->_counters[index].is_counter() && !this->_counters[index].is_hidden()) {
+        result.emplace_back(this->_counters[index].name(), this->_overhead[index]);
+      }
+    }
+  }
+
+  return CounterResult{ std::move(result) };
+}
+
+double
+perf::EventCounter::running_fraction() const
+{
+  auto fraction = 1.;
+  for (const auto& group : this->_groups) {
+    if (!group.empty()) {
+      fraction = std::min(fraction, group.running_fraction());
+    }
+  }
+
+  return fraction;
+}
+
 perf::CounterResult
-perf::EventCounter::result(std::uint64_t normalization) const
+perf::EventCounter::live_result(const std::uint64_t normalization) const
+{
+  const auto live_values = this->read_live();
+  return this->result(normalization, &live_values, false);
+}
+
+std::vector<std::vector<double>>
+perf::EventCounter::read_live() const
 {
+  auto live_values = std::vector<std::vector<double>>(this->_groups.size());
+  for (auto group_id = 0U; group_id < this->_groups.size(); ++group_id) {
+    std::ignore = this->_groups[group_id].read_live(live_values[group_id]);
+  }
+
+  return live_values;
+}
+
+perf::CounterResult
+perf::EventCounter::result(const std::uint64_t normalization,
+                           const std::vector<std::vector<double>>* live_values,
+                           const bool is_subtract_overhead) const
+{
+  const auto is_overhead_subtracted = is_subtract_overhead && this->_overhead.size() == this->_counters.size();
+
   /// Build result with all counters, including hidden ones.
   auto temporary_result = std::vector<std::pair<std::string_view, double>>{};
   temporary_result.reserve(this->_counters.size());
 
-  for (const auto& event : this->_counters) {
+  for (auto index = 0U; index < this->_counters.size(); ++index) {
+    const auto& event = this->_counters[index];
     if (event.is_counter()) {
-      const auto value = this->_groups[event.group_id()].get(event.in_group_id()) / double(normalization);
-      temporary_result.emplace_back(event.name(), value);
+      const auto& group = this->_groups[event.group_id()];
+      auto value = live_values != nullptr ? (*live_values)[event.group_id()][event.in_group_id()]
+                                           : group.get(event.in_group_id());
+
+      /// Subtract the overhead from the raw value, i.e., before normalization and metrics.
+      if (is_overhead_subtracted) {
+        value = std::max(value - this->_overhead[index], .0);
+      }
+
+      temporary_result.emplace_back(event.name(), value / double(normalization));
     }
   }
 
@@ -217,9 +347,23 @@ perf::MultiEventCounterBase::add(std::vector<EventCounter>& event_counter, const
   return true;
 }
 
+perf::CounterResult
+perf::MultiEventCounterBase::live_result(const std::vector<perf::EventCounter>& event_counters,
+                                         const std::uint64_t normalization)
+{
+  auto live_values = std::vector<std::vector<std::vector<double>>>{};
+  live_values.reserve(event_counters.size());
+  for (const auto& event_counter : event_counters) {
+    live_values.emplace_back(event_counter.read_live());
+  }
+
+  return MultiEventCounterBase::result(event_counters, normalization, &live_values);
+}
+
 perf::CounterResult
 perf::MultiEventCounterBase::result(const std::vector<perf::EventCounter>& event_counters,
-                                    const std::uint64_t normalization)
+                                    const std::uint64_t normalization,
+                                    const std::vector<std::vector<std::vector<double>>>* live_values)
 {
   /// Build result with all counters, including hidden ones.
   const auto& main_perf = event_counters.front();
@@ -229,8 +373,10 @@ perf::MultiEventCounterBase::result(const std::vector<perf::EventCounter>& event
   for (const auto& event : main_perf._counters) {
     if (event.is_counter()) {
       auto value = .0;
-      for (const auto& thread_local_counter : event_counters) {
-        value += thread_local_counter._groups[event.group_id()].get(event.in_group_id());
+      for (auto counter_id = 0U; counter_id < event_counters.size(); ++counter_id) {
+        const auto& group = event_counters[counter_id]._groups[event.group_id()];
+        value += live_values != nullptr ? (*live_values)[counter_id][event.group_id()][event.in_group_id()]
+                                        : group.get(event.in_group_id());
       }
       const auto normalized_value = value / double(normalization);
       temporary_result.emplace_back(event.name(), normalized_value);
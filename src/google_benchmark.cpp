@@ -0,0 +1,76 @@
+#include <cstdint>
+#include <perfcpp/google_benchmark.h>
+#include <string>
+#include <tuple>
+
+perf::GoogleBenchmarkCounter::GoogleBenchmarkCounter(benchmark::State& state,
+                                                     const CounterDefinition& counter_definitions,
+                                                     const std::vector<std::string>& counter_names,
+                                                     Config config)
+  : _state(state)
+  , _event_counter(counter_definitions, config)
+{
+  if (!this->_event_counter.add(counter_names)) {
+    this->_state.SkipWithError("Could not add performance counters.");
+  }
+}
+
+perf::GoogleBenchmarkCounter::~GoogleBenchmarkCounter()
+{
+  if (this->_is_running) {
+    this->_event_counter.stop();
+  }
+}
+
+perf::GoogleBenchmarkCounter::iterator
+perf::GoogleBenchmarkCounter::begin()
+{
+  /// Start the counters before creating the state iterator, an error ends the benchmark before the first iteration.
+  if (!this->_state.error_occurred()) {
+    this->_is_running = this->_event_counter.start();
+    if (!this->_is_running) {
+      this->_event_counter.stop();
+      this->_state.SkipWithError("Could not start performance counters.");
+    }
+  }
+
+  return iterator{ this, this->_state.begin() };
+}
+
+void
+perf::GoogleBenchmarkCounter::pause()
+{
+  if (this->_is_running) {
+    std::ignore = this->_event_counter.pause();
+  }
+  this->_state.PauseTiming();
+}
+
+void
+perf::GoogleBenchmarkCounter::resume()
+{
+  this->_state.ResumeTiming();
+  if (this->_is_running) {
+    std::ignore = this->_event_counter.resume();
+  }
+}
+
+void
+perf::GoogleBenchmarkCounter::finish()
+{
+  if (!this->_is_running) {
+    return;
+  }
+
+  this->_event_counter.stop();
+  this->_is_running = false;
+
+  if (this->_state.error_occurred() || this->_state.iterations() == 0) {
+    return;
+  }
+
+  /// Normalize per iteration; Google Benchmark averages the values of all threads.
+  for (const auto& [name, value] : this->_event_counter.result(std::uint64_t(this->_state.iterations()))) {
+    this->_state.counters[std::string{ name }] = benchmark::Counter{ value, benchmark::Counter::kAvgThreads };
+  }
+}
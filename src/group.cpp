@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <asm/unistd.h>
 #include <cstring>
 #include <iostream>
@@ -109,6 +110,26 @@ perf::Group::stop()
   return read_size > 0U;
 }
 
+bool
+perf::Group::pause()
+{
+  if (this->_members.empty() || !this->_members.front().is_open()) {
+    return false;
+  }
+
+  return ::ioctl(this->leader_file_descriptor(), PERF_EVENT_IOC_DISABLE, 0) == 0;
+}
+
+bool
+perf::Group::resume()
+{
+  if (this->_members.empty() || !this->_members.front().is_open()) {
+    return false;
+  }
+
+  return ::ioctl(this->leader_file_descriptor(), PERF_EVENT_IOC_ENABLE, 0) == 0;
+}
+
 bool
 perf::Group::add(perf::CounterConfig counter)
 {
@@ -116,15 +137,52 @@ perf::Group::add(perf::CounterConfig counter)
   return true;
 }
 
+bool
+perf::Group::read_live(std::vector<double>& values) const
+{
+  values.assign(this->_members.size(), .0);
+  if (this->_members.empty() || !this->_members.front().is_open()) {
+    return false;
+  }
+
+  /// Read into a local value, the start and end values may be accessed by the thread recording the group.
+  auto live_value = read_format{};
+  const auto read_size = ::read(this->leader_file_descriptor(), &live_value, sizeof(read_format));
+  if (read_size <= 0) {
+    return false;
+  }
+
+  for (auto index = 0U; index < this->_members.size(); ++index) {
+    values[index] = this->value(index, live_value);
+  }
+
+  return true;
+}
+
 double
 perf::Group::get(const std::size_t index) const
 {
-  const auto multiplexing_correction = double(this->_end_value.time_enabled - this->_start_value.time_enabled) /
-                                       double(this->_end_value.time_running - this->_start_value.time_running);
+  return this->value(index, this->_end_value);
+}
+
+double
+perf::Group::running_fraction() const
+{
+  const auto time_enabled = this->_end_value.time_enabled - this->_start_value.time_enabled;
+  const auto time_running = this->_end_value.time_running - this->_start_value.time_running;
+
+  return time_enabled > 0U ? std::min(double(time_running) / double(time_enabled), 1.) : 1.;
+}
+
+double
+perf::Group::value(const std::size_t index, const read_format& read_value) const
+{
+  const auto multiplexing_correction = double(read_value.time_enabled - this->_start_value.time_enabled) /
+                                       double(read_value.time_running - this->_start_value.time_running);
 
   const auto& counter = this->_members[index];
   const auto start_value = Group::value_for_id(this->_start_value, counter.id());
-  const auto end_value = Group::value_for_id(this->_end_value, counter.id());
+  const auto end_value = Group::value_for_id(read_value, counter.id());
 
   if (start_value.has_value() && end_value.has_value()) {
     const auto result = double(end_value.value() - start_value.value());
@@ -0,0 +1,150 @@
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+#include <perfcpp/indirect_call_analyzer.h>
+#include <sstream>
+#include <string_view>
+#include <unordered_map>
+
+/**
+ * Writes the field quoted, with quotes doubled (RFC 4180), such that paths holding commas, quotes, or line breaks stay
+ * a single field.
+ */
+static void
+write_csv_field(std::ostream& stream, const std::string_view field)
+{
+  stream << '"';
+  for (const auto character : field) {
+    if (character == '"') {
+      stream << '"';
+    }
+    stream << character;
+  }
+  stream << '"';
+}
+
+perf::IndirectCallSite::IndirectCallSite(CodeLocation&& location, std::vector<IndirectCallTarget>&& targets)
+  : _location(std::move(location))
+  , _targets(std::move(targets))
+{
+  std::sort(this->_targets.begin(), this->_targets.end(), [](const auto& left, const auto& right) {
+    return left.count() > right.count() ||
+           (left.count() == right.count() &&
+            left.location().instruction_pointer() < right.location().instruction_pointer());
+  });
+
+  for (const auto& target : this->_targets) {
+    this->_count += target.count();
+  }
+}
+
+std::string
+perf::IndirectCallResult::to_string(const std::size_t count_call_sites, const std::size_t count_targets) const
+{
+  auto stream = std::stringstream{};
+  stream << std::fixed << std::setprecision(2);
+
+  stream << std::setw(20) << "call site" << std::setw(12) << "calls" << std::setw(10) << "targets" << std::setw(12)
+         << "dominant %"
+         << "  binary\n";
+
+  for (auto i = 0U; i < std::min(count_call_sites, this->_call_sites.size()); ++i) {
+    const auto& call_site = this->_call_sites[i];
+
+    auto address_stream = std::stringstream{};
+    address_stream << "0x" << std::hex << call_site.location().instruction_pointer();
+
+    stream << std::setw(20) << address_stream.str() << std::setw(12) << call_site.count() << std::setw(10)
+           << call_site.targets().size() << std::setw(12) << call_site.dominant_share() * 100. << "  "
+           << call_site.location().binary() << "+0x" << std::hex << call_site.location().offset() << std::dec
+           << "\n";
+
+    for (auto j = 0U; j < std::min(count_targets, call_site.targets().size()); ++j) {
+      const auto& target = call_site.targets()[j];
+      stream << std::setw(24) << "-> 0x" << std::hex << target.location().instruction_pointer() << std::dec << " ("
+             << target.location().binary() << "+0x" << std::hex << target.location().offset() << std::dec
+             << "): " << target.count() << " calls ("
+             << double(target.count()) / double(call_site.count()) * 100. << "%)\n";
+    }
+  }
+
+  return stream.str();
+}
+
+std::string
+perf::IndirectCallResult::to_csv(const std::uint64_t min_count) const
+{
+  auto stream = std::stringstream{};
+  stream << std::fixed << std::setprecision(4);
+
+  stream << "call_site_binary,call_site_offset,target_binary,target_offset,count,share\n";
+
+  for (const auto& call_site : this->_call_sites) {
+    if (call_site.count() < min_count) {
+      continue;
+    }
+
+    for (const auto& target : call_site.targets()) {
+      write_csv_field(stream, call_site.location().binary());
+      stream << ",0x" << std::hex << call_site.location().offset() << std::dec << ",";
+      write_csv_field(stream, target.location().binary());
+      stream << ",0x" << std::hex << target.location().offset() << std::dec << "," << target.count() << ","
+             << double(target.count()) / double(call_site.count()) << "\n";
+    }
+  }
+
+  return stream.str();
+}
+
+perf::IndirectCallResult
+perf::IndirectCallAnalyzer::analyze(const std::vector<Sample>& samples) const
+{
+  /// Number of calls per target, for every call site.
+  auto call_sites = std::unordered_map<std::uintptr_t, std::unordered_map<std::uintptr_t, std::uint64_t>>{};
+
+  for (const auto& sample : samples) {
+    if (!sample.branches().has_value() || sample.context_switch().has_value()) {
+      continue;
+    }
+
+    for (const auto& branch : sample.branches().value()) {
+      /// Branch stacks may hold other branches, e.g., if recorded with a broader branch type.
+      if (branch.type() != PERF_BR_IND_CALL) {
+        continue;
+      }
+
+      ++call_sites[branch.instruction_pointer_from()][branch.instruction_pointer_to()];
+    }
+  }
+
+  auto result = std::vector<IndirectCallSite>{};
+  result.reserve(call_sites.size());
+  for (const auto& [call_site, targets] : call_sites) {
+    auto call_targets = std::vector<IndirectCallTarget>{};
+    call_targets.reserve(targets.size());
+    for (const auto& [target, count] : targets) {
+      call_targets.emplace_back(this->locate(target), count);
+    }
+
+    result.emplace_back(this->locate(call_site), std::move(call_targets));
+  }
+  std::sort(result.begin(), result.end(), [](const auto& left, const auto& right) {
+    return left.count() > right.count() ||
+           (left.count() == right.count() &&
+            left.location().instruction_pointer() < right.location().instruction_pointer());
+  });
+
+  return IndirectCallResult{ std::move(result) };
+}
+
+perf::CodeLocation
+perf::IndirectCallAnalyzer::locate(const std::uintptr_t instruction_pointer) const
+{
+  if (const auto* mapping = this->_memory_map.find(instruction_pointer); mapping != nullptr) {
+    return CodeLocation{ instruction_pointer,
+                         mapping->path().empty() ? std::string{ "[anonymous]" } : mapping->path(),
+                         mapping->file_offset(instruction_pointer) };
+  }
+
+  return CodeLocation{ instruction_pointer, "[unknown]", instruction_pointer };
+}
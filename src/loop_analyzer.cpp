@@ -0,0 +1,191 @@
+#include <algorithm>
+#include <iomanip>
+#include <perfcpp/loop_analyzer.h>
+#include <sstream>
+#include <unordered_map>
+
+void
+perf::LoopStatistics::add_trip_count(const std::uint64_t trip_count)
+{
+  auto iterator = std::lower_bound(
+    this->_trip_counts.begin(), this->_trip_counts.end(), trip_count, [](const auto& entry, const auto trip_count) {
+      return entry.first < trip_count;
+    });
+  if (iterator == this->_trip_counts.end() || iterator->first != trip_count) {
+    iterator = this->_trip_counts.insert(iterator, std::make_pair(trip_count, 0U));
+  }
+
+  ++iterator->second;
+}
+
+void
+perf::LoopStatistics::add_iteration_cycles(const std::uint64_t cycles) noexcept
+{
+  this->_min_iteration_cycles =
+    this->_count_measured_iterations > 0U ? std::min(this->_min_iteration_cycles, cycles) : cycles;
+  this->_iteration_cycles += cycles;
+  ++this->_count_measured_iterations;
+}
+
+std::string
+perf::LoopResult::to_string(const std::size_t count_loops) const
+{
+  auto stream = std::stringstream{};
+  stream << std::fixed << std::setprecision(2);
+
+  stream << std::setw(18) << "head" << std::setw(18) << "latch" << std::setw(12) << "back edges" << std::setw(10)
+         << "exits" << std::setw(12) << "est. trips" << std::setw(30) << "recorded trips (count)" << std::setw(14)
+         << "cycles/iter" << std::setw(10) << "min"
+         << "\n";
+
+  for (auto i = 0U; i < std::min(count_loops, this->_loops.size()); ++i) {
+    const auto& loop = this->_loops[i];
+
+    auto address_stream = std::stringstream{};
+    address_stream << "0x" << std::hex << loop.head() << " 0x" << loop.latch();
+    auto head = std::string{};
+    auto latch = std::string{};
+    address_stream >> head >> latch;
+
+    /// Show the most frequent recorded trip counts.
+    auto trip_counts = loop.trip_counts();
+    std::sort(trip_counts.begin(), trip_counts.end(), [](const auto& left, const auto& right) {
+      return left.second > right.second;
+    });
+    auto trip_count_stream = std::stringstream{};
+    for (auto j = 0U; j < std::min<std::size_t>(3U, trip_counts.size()); ++j) {
+      trip_count_stream << (j > 0U ? ", " : "") << trip_counts[j].first << " (" << trip_counts[j].second << ")";
+    }
+    if (loop.count_truncated() > 0U) {
+      trip_count_stream << (trip_counts.empty() ? "" : ", ") << "truncated (" << loop.count_truncated() << ")";
+    }
+
+    stream << std::setw(18) << head << std::setw(18) << latch << std::setw(12) << loop.count_back_edges()
+           << std::setw(10) << loop.count_exits() << std::setw(12) << loop.estimated_trip_count() << std::setw(30)
+           << trip_count_stream.str() << std::setw(14) << loop.average_cycles_per_iteration() << std::setw(10)
+           << loop.min_cycles_per_iteration() << "\n";
+  }
+
+  return stream.str();
+}
+
+perf::LoopResult
+perf::LoopAnalyzer::analyze(const std::vector<Sample>& samples) const
+{
+  /// Loop that is currently executed while walking through a branch stack.
+  struct active_loop
+  {
+    std::uintptr_t head;
+    std::uintptr_t latch;
+    std::uint64_t count_back_edges;
+
+    /// True, if the branch entering the loop is part of the branch stack.
+    bool is_entry_observed;
+
+    /// Cycles since the last back edge; only valid if every branch since reported cycles.
+    std::uint64_t cycles{ 0U };
+    bool is_cycles_valid{ true };
+
+    [[nodiscard]] bool contains(const Branch& branch) const noexcept
+    {
+      /// Another back edge to the same head (e.g., a "continue") may extend the body.
+      if (branch.instruction_pointer_to() == head && branch.instruction_pointer_from() >= head) {
+        return true;
+      }
+
+      return branch.instruction_pointer_from() >= head && branch.instruction_pointer_from() <= latch &&
+             branch.instruction_pointer_to() >= head && branch.instruction_pointer_to() <= latch;
+    }
+  };
+
+  auto loops = std::unordered_map<std::uintptr_t, LoopStatistics>{};
+  auto active_loops = std::vector<active_loop>{};
+
+  for (const auto& sample : samples) {
+    if (!sample.branches().has_value() || sample.context_switch().has_value()) {
+      continue;
+    }
+
+    /// The branch stack is ordered from the most recent (index 0) to the oldest branch; walk chronologically.
+    const auto& branch_stack = sample.branches().value();
+    active_loops.clear();
+
+    for (auto index = branch_stack.size(); index-- > 0U;) {
+      const auto& branch = branch_stack[index];
+
+      /// Cycles since the previous branch are spent within every active loop.
+      for (auto& loop : active_loops) {
+        loop.cycles += branch.cycles();
+        loop.is_cycles_valid &= branch.cycles() > 0U;
+      }
+
+      /// Branches leaving the body finish the innermost loops.
+      while (!active_loops.empty() && !active_loops.back().contains(branch)) {
+        const auto& loop = active_loops.back();
+        auto& statistics = loops.at(loop.head);
+        statistics.add_exit();
+        if (loop.is_entry_observed) {
+          statistics.add_trip_count(loop.count_back_edges + 1U);
+        } else {
+          statistics.add_truncated();
+        }
+
+        active_loops.pop_back();
+      }
+
+      /// Only backward taken branches close a loop iteration.
+      if (branch.instruction_pointer_to() > branch.instruction_pointer_from()) {
+        continue;
+      }
+
+      const auto head = branch.instruction_pointer_to();
+      const auto latch = branch.instruction_pointer_from();
+
+      /// Next iteration of the current loop.
+      if (!active_loops.empty() && active_loops.back().head == head) {
+        auto& loop = active_loops.back();
+        auto& statistics = loops.at(head);
+        statistics.add_back_edge();
+        if (loop.is_cycles_valid) {
+          statistics.add_iteration_cycles(loop.cycles);
+        }
+
+        ++loop.count_back_edges;
+        loop.latch = std::max(loop.latch, latch);
+        loop.cycles = 0U;
+        loop.is_cycles_valid = true;
+        continue;
+      }
+
+      /// First back edge of a new loop: The loop was entered within the branch stack if an older branch lies
+      /// outside the body; otherwise, the first iteration started before the oldest recorded branch.
+      auto loop = active_loop{ head, latch, 1U, false };
+      for (auto older_index = index + 1U; older_index < branch_stack.size(); ++older_index) {
+        if (!loop.contains(branch_stack[older_index])) {
+          loop.is_entry_observed = true;
+          break;
+        }
+      }
+
+      loops.try_emplace(head, head, latch).first->second.add_back_edge();
+      active_loops.push_back(loop);
+    }
+
+    /// Loops still active at the most recent branch were cut off by the end of the branch stack.
+    for (const auto& loop : active_loops) {
+      loops.at(loop.head).add_truncated();
+    }
+  }
+
+  auto result = std::vector<LoopStatistics>{};
+  result.reserve(loops.size());
+  for (auto& [head, statistics] : loops) {
+    result.emplace_back(std::move(statistics));
+  }
+  std::sort(result.begin(), result.end(), [](const auto& left, const auto& right) {
+    return left.count_back_edges() > right.count_back_edges() ||
+           (left.count_back_edges() == right.count_back_edges() && left.head() < right.head());
+  });
+
+  return LoopResult{ std::move(result) };
+}
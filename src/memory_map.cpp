@@ -0,0 +1,67 @@
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <fstream>
+#include <perfcpp/memory_map.h>
+
+perf::MemoryMap::MemoryMap(std::vector<MemoryMapping>&& mappings)
+  : _mappings(std::move(mappings))
+{
+  std::sort(this->_mappings.begin(), this->_mappings.end(), [](const auto& left, const auto& right) {
+    return left.begin() < right.begin();
+  });
+}
+
+perf::MemoryMap
+perf::MemoryMap::read(const pid_t process_id)
+{
+  const auto maps_path =
+    process_id == 0 ? std::string{ "/proc/self/maps" } : "/proc/" + std::to_string(process_id) + "/maps";
+
+  auto mappings = std::vector<MemoryMapping>{};
+
+  auto maps_stream = std::ifstream{ maps_path };
+  auto line = std::string{};
+  while (std::getline(maps_stream, line)) {
+    /// Lines are formatted like "55d0c0a00000-55d0c0a21000 r-xp 00000000 08:01 1234    /usr/bin/foo".
+    auto begin = std::uintptr_t{ 0U };
+    auto end = std::uintptr_t{ 0U };
+    auto offset = std::uint64_t{ 0U };
+    char permissions[5U] = { 0 };
+    auto path_position = 0;
+
+    if (std::sscanf(line.c_str(),
+                    "%" SCNxPTR "-%" SCNxPTR " %4s %" SCNx64 " %*s %*s %n",
+                    &begin,
+                    &end,
+                    permissions,
+                    &offset,
+                    &path_position) < 4) {
+      continue;
+    }
+
+    auto path = path_position > 0 && std::size_t(path_position) < line.size() ? line.substr(path_position)
+                                                                               : std::string{};
+    mappings.emplace_back(
+      begin, end, offset, permissions[0U] == 'r', permissions[1U] == 'w', permissions[2U] == 'x', std::move(path));
+  }
+
+  return MemoryMap{ std::move(mappings) };
+}
+
+const perf::MemoryMapping*
+perf::MemoryMap::find(const std::uintptr_t address) const noexcept
+{
+  auto iterator = std::upper_bound(this->_mappings.begin(),
+                                   this->_mappings.end(),
+                                   address,
+                                   [](const auto address, const auto& mapping) { return address < mapping.begin(); });
+  if (iterator != this->_mappings.begin()) {
+    const auto& mapping = *std::prev(iterator);
+    if (mapping.contains(address)) {
+      return &mapping;
+    }
+  }
+
+  return nullptr;
+}
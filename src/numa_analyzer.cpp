@@ -0,0 +1,379 @@
+#include <algorithm>
+#include <asm/unistd.h>
+#include <charconv>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <perfcpp/numa_analyzer.h>
+#include <sstream>
+#include <thread>
+#include <unistd.h>
+#include <unordered_map>
+
+/**
+ * Parses a decimal id (e.g., of a node, CPU, or memory block) from sysfs.
+ *
+ * @param text Text holding only the id.
+ * @return The id, or std::nullopt if the text is no valid id.
+ */
+static std::optional<std::uint64_t>
+parse_id(const std::string_view text) noexcept
+{
+  auto id = std::uint64_t{ 0U };
+  const auto* end = text.data() + text.size();
+  const auto [pointer, error] = std::from_chars(text.data(), end, id);
+  if (text.empty() || error != std::errc{} || pointer != end) {
+    return std::nullopt;
+  }
+
+  return id;
+}
+
+perf::NUMATopology
+perf::NUMATopology::read()
+{
+  auto topology = NUMATopology{};
+
+  /// Size of a memory block, the memory of every node is listed as "memoryX" blocks.
+  auto memory_block_size = std::uint64_t{ 0U };
+  if (auto block_size_stream = std::ifstream{ "/sys/devices/system/memory/block_size_bytes" };
+      block_size_stream.is_open()) {
+    block_size_stream >> std::hex >> memory_block_size;
+  }
+
+  auto error = std::error_code{};
+  for (const auto& node_entry : std::filesystem::directory_iterator{ "/sys/devices/system/node", error }) {
+    const auto node_name = node_entry.path().filename().string();
+    const auto node_id_value =
+      node_name.rfind("node", 0U) == 0U ? parse_id(std::string_view{ node_name }.substr(4U)) : std::nullopt;
+    if (!node_id_value.has_value() || node_id_value.value() > std::numeric_limits<std::uint16_t>::max() - 1U) {
+      continue;
+    }
+    const auto node_id = std::uint16_t(node_id_value.value());
+
+    /// Read the CPUs of the node, formatted like "0-3,8-11".
+    if (auto cpu_list_stream = std::ifstream{ node_entry.path() / "cpulist" }; cpu_list_stream.is_open()) {
+      auto cpu_range = std::string{};
+      while (std::getline(cpu_list_stream, cpu_range, ',')) {
+        /// The last range ends with a newline.
+        if (!cpu_range.empty() && cpu_range.back() == '\n') {
+          cpu_range.pop_back();
+        }
+
+        const auto separator = cpu_range.find('-');
+        const auto cpu_range_view = std::string_view{ cpu_range };
+        const auto first_cpu_id = parse_id(cpu_range_view.substr(0U, separator));
+        const auto last_cpu_id =
+          separator != std::string::npos ? parse_id(cpu_range_view.substr(separator + 1U)) : first_cpu_id;
+        if (!first_cpu_id.has_value() || !last_cpu_id.has_value() ||
+            last_cpu_id.value() > std::numeric_limits<std::uint32_t>::max()) {
+          continue;
+        }
+
+        for (auto cpu_id = first_cpu_id.value(); cpu_id <= last_cpu_id.value(); ++cpu_id) {
+          topology.add_cpu(std::uint32_t(cpu_id), node_id);
+        }
+      }
+    }
+
+    /// Read the memory blocks of the node.
+    if (memory_block_size > 0U) {
+      for (const auto& memory_entry : std::filesystem::directory_iterator{ node_entry.path(), error }) {
+        const auto memory_name = memory_entry.path().filename().string();
+        const auto block_id =
+          memory_name.rfind("memory", 0U) == 0U ? parse_id(std::string_view{ memory_name }.substr(6U)) : std::nullopt;
+        if (block_id.has_value()) {
+          topology.add_physical_memory(
+            block_id.value() * memory_block_size, (block_id.value() + 1U) * memory_block_size, node_id);
+        }
+      }
+    }
+
+    topology._count_nodes = std::max<std::uint16_t>(topology._count_nodes, node_id + 1U);
+  }
+
+  /// Without NUMA information, the machine is treated as a single node.
+  if (topology._count_nodes == 0U) {
+    for (auto cpu_id = 0U; cpu_id < std::thread::hardware_concurrency(); ++cpu_id) {
+      topology.add_cpu(cpu_id, 0U);
+    }
+  }
+
+  if (topology._count_nodes == 1U && topology._physical_memory.empty()) {
+    topology.add_physical_memory(0U, std::numeric_limits<std::uintptr_t>::max(), 0U);
+  }
+
+  return topology;
+}
+
+void
+perf::NUMATopology::add_cpu(const std::uint32_t cpu_id, const std::uint16_t node_id)
+{
+  if (cpu_id >= this->_cpu_nodes.size()) {
+    this->_cpu_nodes.resize(cpu_id + 1U, -1);
+  }
+
+  this->_cpu_nodes[cpu_id] = node_id;
+  this->_count_nodes = std::max<std::uint16_t>(this->_count_nodes, node_id + 1U);
+}
+
+void
+perf::NUMATopology::add_physical_memory(const std::uintptr_t begin,
+                                        const std::uintptr_t end,
+                                        const std::uint16_t node_id)
+{
+  auto iterator = std::upper_bound(this->_physical_memory.begin(),
+                                   this->_physical_memory.end(),
+                                   begin,
+                                   [](const auto address, const auto& range) { return address < range.begin; });
+
+  /// Extend the previous range, if it ends where the new one begins (memory blocks are mostly contiguous).
+  if (iterator != this->_physical_memory.begin()) {
+    auto& previous = *std::prev(iterator);
+    if (previous.end == begin && previous.node_id == node_id) {
+      previous.end = end;
+      return;
+    }
+  }
+
+  this->_physical_memory.insert(iterator, physical_memory_range{ begin, end, node_id });
+  this->_count_nodes = std::max<std::uint16_t>(this->_count_nodes, node_id + 1U);
+}
+
+std::optional<std::uint16_t>
+perf::NUMATopology::node_of_cpu(const std::uint32_t cpu_id) const noexcept
+{
+  if (cpu_id < this->_cpu_nodes.size() && this->_cpu_nodes[cpu_id] > -1) {
+    return std::uint16_t(this->_cpu_nodes[cpu_id]);
+  }
+
+  return std::nullopt;
+}
+
+std::optional<std::uint16_t>
+perf::NUMATopology::node_of_physical_address(const std::uintptr_t address) const noexcept
+{
+  auto iterator = std::upper_bound(this->_physical_memory.begin(),
+                                   this->_physical_memory.end(),
+                                   address,
+                                   [](const auto address, const auto& range) { return address < range.begin; });
+  if (iterator != this->_physical_memory.begin()) {
+    const auto& range = *std::prev(iterator);
+    if (address < range.end) {
+      return range.node_id;
+    }
+  }
+
+  return std::nullopt;
+}
+
+std::uint64_t
+perf::NUMAAccessMatrix::local() const noexcept
+{
+  auto count = std::uint64_t{ 0U };
+  for (auto node_id = 0U; node_id < this->_count_nodes; ++node_id) {
+    count += this->_accesses[node_id * this->_count_nodes + node_id];
+  }
+
+  return count;
+}
+
+std::uint64_t
+perf::NUMAAccessMatrix::remote() const noexcept
+{
+  auto count = std::uint64_t{ 0U };
+  for (auto cpu_node_id = 0U; cpu_node_id < this->_count_nodes; ++cpu_node_id) {
+    for (auto memory_node_id = 0U; memory_node_id < this->_count_nodes; ++memory_node_id) {
+      if (cpu_node_id != memory_node_id) {
+        count += this->_accesses[cpu_node_id * this->_count_nodes + memory_node_id];
+      }
+    }
+  }
+
+  return count;
+}
+
+std::string
+perf::NUMAAccessMatrix::to_string() const
+{
+  auto stream = std::stringstream{};
+
+  stream << std::setw(12) << "cpu \\ mem";
+  for (auto memory_node_id = 0U; memory_node_id < this->_count_nodes; ++memory_node_id) {
+    stream << std::setw(12) << ("node " + std::to_string(memory_node_id));
+  }
+  stream << "\n";
+
+  for (auto cpu_node_id = 0U; cpu_node_id < this->_count_nodes; ++cpu_node_id) {
+    stream << std::setw(12) << ("node " + std::to_string(cpu_node_id));
+    for (auto memory_node_id = 0U; memory_node_id < this->_count_nodes; ++memory_node_id) {
+      stream << std::setw(12) << this->accesses(cpu_node_id, memory_node_id);
+    }
+    stream << "\n";
+  }
+
+  return stream.str();
+}
+
+std::string
+perf::NUMAResult::to_string() const
+{
+  auto stream = std::stringstream{};
+  stream << std::fixed << std::setprecision(2);
+
+  stream << "All samples (local = " << this->_total.local() << ", remote = " << this->_total.remote()
+         << ", remote ratio = " << this->_total.remote_ratio() * 100. << "%)\n"
+         << this->_total.to_string();
+
+  for (const auto& [name, matrix] : this->_regions) {
+    stream << "\nRegion '" << name << "' (local = " << matrix.local() << ", remote = " << matrix.remote()
+           << ", remote ratio = " << matrix.remote_ratio() * 100. << "%)\n"
+           << matrix.to_string();
+  }
+
+  for (const auto& [thread_id, matrix] : this->_threads) {
+    stream << "\nThread " << thread_id << " (local = " << matrix.local() << ", remote = " << matrix.remote()
+           << ", remote ratio = " << matrix.remote_ratio() * 100. << "%)\n"
+           << matrix.to_string();
+  }
+
+  if (this->_count_unresolved > 0U) {
+    stream << "\nUnresolved samples: " << this->_count_unresolved << "\n";
+  }
+
+  return stream.str();
+}
+
+perf::NUMAResult
+perf::NUMAAnalyzer::analyze(const std::vector<Sample>& samples) const
+{
+  constexpr auto page_mask = ~std::uintptr_t{ 4096U - 1U };
+
+  const auto count_nodes = this->_topology.count_nodes();
+  auto result = NUMAResult{ count_nodes };
+
+  for (const auto& region : this->_regions) {
+    result.regions().emplace_back(region.name(), NUMAAccessMatrix{ count_nodes });
+  }
+
+  /// Collect all pages that can not be resolved by their physical address and query their nodes at once.
+  auto pages = std::vector<std::uintptr_t>{};
+  for (const auto& sample : samples) {
+    if (sample.context_switch().has_value()) {
+      continue;
+    }
+
+    const auto physical_address = sample.physical_memory_address();
+    if ((!physical_address.has_value() || physical_address.value() == 0U ||
+         !this->_topology.node_of_physical_address(physical_address.value()).has_value()) &&
+        sample.logical_memory_address().has_value()) {
+      pages.push_back(sample.logical_memory_address().value() & page_mask);
+    }
+  }
+  std::sort(pages.begin(), pages.end());
+  pages.erase(std::unique(pages.begin(), pages.end()), pages.end());
+
+  const auto page_nodes = this->query_nodes(pages);
+
+  auto node_of_page = [&pages, &page_nodes](const std::uintptr_t page) -> std::optional<std::uint16_t> {
+    if (auto iterator = std::lower_bound(pages.begin(), pages.end(), page);
+        iterator != pages.end() && *iterator == page) {
+      const auto node_id = page_nodes[std::distance(pages.begin(), iterator)];
+      if (node_id > -1) {
+        return std::uint16_t(node_id);
+      }
+    }
+
+    return std::nullopt;
+  };
+
+  auto thread_indices = std::unordered_map<std::uint32_t, std::size_t>{};
+  auto count_unresolved = std::uint64_t{ 0U };
+
+  for (const auto& sample : samples) {
+    if (sample.context_switch().has_value()) {
+      continue;
+    }
+
+    /// Node of the CPU that executed the access.
+    const auto cpu_node = sample.cpu_id().has_value() ? this->_topology.node_of_cpu(sample.cpu_id().value())
+                                                      : std::optional<std::uint16_t>{ std::nullopt };
+
+    /// Node of the accessed memory: Try the physical address first, then the page of the logical address.
+    auto memory_node = std::optional<std::uint16_t>{ std::nullopt };
+    if (const auto physical_address = sample.physical_memory_address();
+        physical_address.has_value() && physical_address.value() != 0U) {
+      memory_node = this->_topology.node_of_physical_address(physical_address.value());
+    }
+    if (!memory_node.has_value() && sample.logical_memory_address().has_value()) {
+      memory_node = node_of_page(sample.logical_memory_address().value() & page_mask);
+    }
+
+    /// As a last resort, the hardware may tell us that the data was served from local RAM.
+    if (!memory_node.has_value() && sample.data_src().has_value() && sample.data_src()->is_mem_local_ram()) {
+      memory_node = cpu_node;
+    }
+
+    /// Node ids may exceed the topology (e.g., if it was filled by hand or memory moved to a node added later).
+    if (!cpu_node.has_value() || !memory_node.has_value() ||
+        !result.total().increment(cpu_node.value(), memory_node.value())) {
+      ++count_unresolved;
+      continue;
+    }
+
+    if (sample.logical_memory_address().has_value()) {
+      const auto logical_address = sample.logical_memory_address().value();
+      for (auto region_id = 0U; region_id < this->_regions.size(); ++region_id) {
+        if (this->_regions[region_id].contains(logical_address)) {
+          result.regions()[region_id].second.increment(cpu_node.value(), memory_node.value());
+          break;
+        }
+      }
+    }
+
+    if (sample.thread_id().has_value()) {
+      auto [iterator, is_new] =
+        thread_indices.insert(std::make_pair(sample.thread_id().value(), result.threads().size()));
+      if (is_new) {
+        result.threads().emplace_back(sample.thread_id().value(), NUMAAccessMatrix{ count_nodes });
+      }
+      result.threads()[iterator->second].second.increment(cpu_node.value(), memory_node.value());
+    }
+  }
+
+  std::sort(result.threads().begin(), result.threads().end(), [](const auto& left, const auto& right) {
+    return left.first < right.first;
+  });
+  result.count_unresolved(count_unresolved);
+
+  return result;
+}
+
+std::vector<std::int32_t>
+perf::NUMAAnalyzer::query_nodes(const std::vector<std::uintptr_t>& logical_addresses) const
+{
+  constexpr auto batch_size = 4096U;
+
+  auto nodes = std::vector<std::int32_t>(logical_addresses.size(), -1);
+  auto pages = std::vector<void*>{};
+  pages.reserve(std::min<std::size_t>(batch_size, logical_addresses.size()));
+
+  for (auto offset = 0U; offset < logical_addresses.size(); offset += batch_size) {
+    const auto count = std::min<std::size_t>(batch_size, logical_addresses.size() - offset);
+
+    pages.clear();
+    for (auto i = 0U; i < count; ++i) {
+      pages.push_back(reinterpret_cast<void*>(logical_addresses[offset + i]));
+    }
+
+    /// Calling move_pages without target nodes only reports the node of every page.
+    const auto result = ::syscall(
+      __NR_move_pages, this->_process_id, count, pages.data(), nullptr, nodes.data() + offset, 0);
+    if (result < 0) {
+      std::fill_n(nodes.begin() + offset, count, -1);
+    }
+  }
+
+  return nodes;
+}
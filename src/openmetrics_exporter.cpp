@@ -0,0 +1,407 @@
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <iterator>
+#include <netinet/in.h>
+#include <perfcpp/openmetrics_exporter.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <system_error>
+#include <unistd.h>
+
+namespace {
+/**
+ * Sends the full data to the client, continuing after partial writes.
+ *
+ * @return True, if all data was sent.
+ */
+bool
+send_all(const std::int32_t file_descriptor, std::string_view data)
+{
+  while (!data.empty()) {
+    const auto sent_size = ::send(file_descriptor, data.data(), data.size(), MSG_NOSIGNAL);
+    if (sent_size < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    data.remove_prefix(std::size_t(sent_size));
+  }
+
+  return true;
+}
+
+/**
+ * Sends an HTTP response (header and body) to the client.
+ */
+void
+send_response(const std::int32_t file_descriptor,
+              const std::string_view status,
+              const std::string_view content_type,
+              const std::string_view body)
+{
+  auto header = std::array<char, 256U>{};
+  auto* end = header.data();
+
+  const auto copy = [&end](const std::string_view string) { end = std::copy(string.begin(), string.end(), end); };
+  copy("HTTP/1.1 ");
+  copy(status);
+  copy("\r\nContent-Type: ");
+  copy(content_type);
+  copy("\r\nContent-Length: ");
+  const auto [content_length_end, error] = std::to_chars(end, end + 20U, body.size());
+  if (error != std::errc{}) {
+    return;
+  }
+  end = content_length_end;
+  copy("\r\nConnection: close\r\n\r\n");
+
+  if (send_all(file_descriptor, std::string_view{ header.data(), std::size_t(end - header.data()) })) {
+    static_cast<void>(send_all(file_descriptor, body));
+  }
+}
+}
+
+perf::OpenMetricsExporter::OpenMetricsExporter(const CounterDefinition& counter_definitions, std::string prefix)
+  : _counter_definitions(counter_definitions)
+  , _prefix(std::move(prefix))
+  , _buffer(DEFAULT_BUFFER_SIZE)
+{
+}
+
+perf::OpenMetricsExporter::~OpenMetricsExporter()
+{
+  this->stop();
+}
+
+void
+perf::OpenMetricsExporter::add(std::string source_name, std::function<CounterResult()>&& source)
+{
+  this->_sources.emplace_back(std::move(source_name), std::move(source));
+}
+
+std::string_view
+perf::OpenMetricsExporter::render()
+{
+  /// Read the current values of all sources; the lists keep their capacity between scrapes.
+  this->_results.clear();
+  for (auto& source : this->_sources) {
+    this->_results.emplace_back(source.second());
+  }
+
+  this->_names.clear();
+  for (const auto& result : this->_results) {
+    for (const auto& value : result) {
+      if (std::find(this->_names.begin(), this->_names.end(), value.first) == this->_names.end()) {
+        this->_names.push_back(value.first);
+      }
+    }
+  }
+
+  this->build_family_names();
+
+  /// Every counter (or metric) becomes a metric family, holding one value per source.
+  this->_buffer.clear();
+  for (auto name_index = 0U; name_index < this->_names.size(); ++name_index) {
+    const auto name = this->_names[name_index];
+    const auto& family_name = this->_family_names[name_index];
+    const auto is_metric = this->is_metric(name);
+
+    this->_buffer.append("# TYPE ");
+    this->_buffer.append(family_name);
+    this->_buffer.append(is_metric ? std::string_view{ " gauge\n" } : std::string_view{ " counter\n" });
+
+    for (auto source_index = 0U; source_index < this->_sources.size(); ++source_index) {
+      const auto value = this->_results[source_index].get(name);
+      if (!value.has_value()) {
+        continue;
+      }
+
+      this->_buffer.append(family_name);
+      if (!is_metric) {
+        this->_buffer.append("_total");
+      }
+      this->_buffer.append("{source=\"");
+      this->append_label_value(this->_sources[source_index].first);
+      this->_buffer.append("\"} ");
+      this->append_value(value.value());
+      this->_buffer.append('\n');
+    }
+  }
+  this->_buffer.append("# EOF\n");
+
+  return this->_buffer.view();
+}
+
+bool
+perf::OpenMetricsExporter::serve(const std::uint16_t port, const std::string& address)
+{
+  if (this->is_serving()) {
+    return false;
+  }
+
+  auto socket_address = sockaddr_in{};
+  socket_address.sin_family = AF_INET;
+  socket_address.sin_port = htons(port);
+  if (::inet_pton(AF_INET, address.c_str(), &socket_address.sin_addr) != 1) {
+    return false;
+  }
+
+  this->_socket_file_descriptor = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (this->_socket_file_descriptor < 0) {
+    return false;
+  }
+
+  const auto reuse_address = std::int32_t{ 1 };
+  ::setsockopt(this->_socket_file_descriptor, SOL_SOCKET, SO_REUSEADDR, &reuse_address, sizeof(reuse_address));
+
+  auto socket_address_size = socklen_t{ sizeof(socket_address) };
+  auto* address_pointer = reinterpret_cast<sockaddr*>(&socket_address);
+  if (::bind(this->_socket_file_descriptor, address_pointer, sizeof(socket_address)) != 0 ||
+      ::getsockname(this->_socket_file_descriptor, address_pointer, &socket_address_size) != 0) {
+    this->stop();
+    return false;
+  }
+  this->_port = ntohs(socket_address.sin_port);
+
+  return this->start_server();
+}
+
+bool
+perf::OpenMetricsExporter::serve(const std::string& socket_path)
+{
+  if (this->is_serving()) {
+    return false;
+  }
+
+  auto socket_address = sockaddr_un{};
+  socket_address.sun_family = AF_UNIX;
+  if (socket_path.empty() || socket_path.size() >= sizeof(socket_address.sun_path)) {
+    return false;
+  }
+  std::copy(socket_path.begin(), socket_path.end(), socket_address.sun_path);
+
+  this->_socket_file_descriptor = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (this->_socket_file_descriptor < 0) {
+    return false;
+  }
+
+  ::unlink(socket_path.c_str());
+  if (::bind(this->_socket_file_descriptor, reinterpret_cast<sockaddr*>(&socket_address), sizeof(socket_address)) !=
+      0) {
+    this->stop();
+    return false;
+  }
+  this->_socket_path = socket_path;
+
+  return this->start_server();
+}
+
+void
+perf::OpenMetricsExporter::stop()
+{
+  /// Wake the server thread and wait until it finished the current scrape.
+  if (this->_server_thread.joinable()) {
+    const auto wake = char{ 1 };
+    static_cast<void>(::write(this->_wake_file_descriptors[1U], &wake, 1U));
+    this->_server_thread.join();
+  }
+
+  for (auto& file_descriptor : this->_wake_file_descriptors) {
+    if (file_descriptor > -1) {
+      ::close(file_descriptor);
+      file_descriptor = -1;
+    }
+  }
+
+  if (this->_socket_file_descriptor > -1) {
+    ::close(this->_socket_file_descriptor);
+    this->_socket_file_descriptor = -1;
+  }
+
+  if (!this->_socket_path.empty()) {
+    ::unlink(this->_socket_path.c_str());
+    this->_socket_path.clear();
+  }
+
+  this->_port = 0U;
+}
+
+bool
+perf::OpenMetricsExporter::start_server()
+{
+  if (::listen(this->_socket_file_descriptor, 16) != 0 ||
+      ::pipe2(this->_wake_file_descriptors.data(), O_CLOEXEC) != 0) {
+    this->stop();
+    return false;
+  }
+
+  this->_server_thread = std::thread{ [this] { this->serve_connections(); } };
+
+  return true;
+}
+
+void
+perf::OpenMetricsExporter::serve_connections()
+{
+  while (true) {
+    auto poll_file_descriptors = std::array<pollfd, 2U>{ pollfd{ this->_socket_file_descriptor, POLLIN, 0 },
+                                                         pollfd{ this->_wake_file_descriptors[0U], POLLIN, 0 } };
+    if (::poll(poll_file_descriptors.data(), poll_file_descriptors.size(), -1) < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return;
+    }
+
+    /// Stopped.
+    if (poll_file_descriptors[1U].revents != 0) {
+      return;
+    }
+
+    if ((poll_file_descriptors[0U].revents & POLLIN) != 0) {
+      const auto client_file_descriptor = ::accept4(this->_socket_file_descriptor, nullptr, nullptr, SOCK_CLOEXEC);
+      if (client_file_descriptor > -1) {
+        /// Clients that do not send (or receive) within a second are dropped, so that they cannot block the server.
+        const auto timeout = timeval{ 1, 0 };
+        ::setsockopt(client_file_descriptor, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        ::setsockopt(client_file_descriptor, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+        this->answer(client_file_descriptor);
+        ::close(client_file_descriptor);
+      }
+    }
+  }
+}
+
+void
+perf::OpenMetricsExporter::answer(const std::int32_t client_file_descriptor)
+{
+  /// Read the request line and headers (the body of a GET request is ignored).
+  auto request = std::array<char, 4096U>{};
+  auto request_size = std::size_t{ 0U };
+  while (request_size < request.size()) {
+    const auto read_size =
+      ::recv(client_file_descriptor, request.data() + request_size, request.size() - request_size, 0);
+    if (read_size <= 0) {
+      if (read_size < 0 && errno == EINTR) {
+        continue;
+      }
+      break;
+    }
+    request_size += std::size_t(read_size);
+
+    if (std::string_view{ request.data(), request_size }.find("\r\n\r\n") != std::string_view::npos) {
+      break;
+    }
+  }
+
+  auto request_line = std::string_view{ request.data(), request_size };
+  request_line = request_line.substr(0U, request_line.find("\r\n"));
+  if (request_line.empty()) {
+    return;
+  }
+
+  constexpr auto text_content_type = std::string_view{ "text/plain; charset=utf-8" };
+  if (request_line.substr(0U, 4U) != "GET ") {
+    send_response(client_file_descriptor, "405 Method Not Allowed", text_content_type, "Method Not Allowed\n");
+    return;
+  }
+
+  auto path = request_line.substr(4U);
+  path = path.substr(0U, path.find(' '));
+  path = path.substr(0U, path.find('?'));
+  if (path != "/metrics" && path != "/") {
+    send_response(client_file_descriptor, "404 Not Found", text_content_type, "Not Found\n");
+    return;
+  }
+
+  send_response(client_file_descriptor,
+                "200 OK",
+                "application/openmetrics-text; version=1.0.0; charset=utf-8",
+                this->render());
+  ++this->_count_scrapes;
+}
+
+bool
+perf::OpenMetricsExporter::is_metric(const std::string_view name)
+{
+  /// Look up the cached type; only names seen for the first time are looked up in the counter definitions.
+  auto iterator = std::lower_bound(this->_is_metric.begin(),
+                                   this->_is_metric.end(),
+                                   name,
+                                   [](const auto& entry, const std::string_view key) { return entry.first < key; });
+  if (iterator == this->_is_metric.end() || iterator->first != name) {
+    iterator = this->_is_metric.insert(
+      iterator, std::make_pair(std::string{ name }, this->_counter_definitions.is_metric(name)));
+  }
+
+  return iterator->second;
+}
+
+void
+perf::OpenMetricsExporter::append_value(const double value)
+{
+  /// OpenMetrics spells special values differently than std::to_chars.
+  if (std::isnan(value)) {
+    this->_buffer.append("NaN");
+  } else if (std::isinf(value)) {
+    this->_buffer.append(value > .0 ? std::string_view{ "+Inf" } : std::string_view{ "-Inf" });
+  } else {
+    this->_buffer.append(value);
+  }
+}
+
+void
+perf::OpenMetricsExporter::build_family_names()
+{
+  /// The strings keep their capacity between scrapes.
+  this->_family_names.resize(this->_names.size());
+
+  for (auto name_index = 0U; name_index < this->_names.size(); ++name_index) {
+    const auto name = this->_names[name_index];
+    auto& family_name = this->_family_names[name_index];
+
+    family_name.assign(this->_prefix);
+    family_name.push_back('_');
+    std::transform(name.begin(), name.end(), std::back_inserter(family_name), [](const char character) {
+      const auto is_valid = (character >= 'a' && character <= 'z') || (character >= 'A' && character <= 'Z') ||
+                            (character >= '0' && character <= '9') || character == '_';
+      return is_valid ? character : '_';
+    });
+
+    /// Names that collide with a previous family after replacing invalid chars get the first free suffix.
+    const auto previous_end = this->_family_names.begin() + name_index;
+    if (std::find(this->_family_names.begin(), previous_end, family_name) != previous_end) {
+      const auto sanitized_size = family_name.size();
+      auto suffix = std::uint64_t{ 2U };
+      do {
+        family_name.resize(sanitized_size);
+        family_name.push_back('_');
+        family_name.append(std::to_string(suffix++));
+      } while (std::find(this->_family_names.begin(), previous_end, family_name) != previous_end);
+    }
+  }
+}
+
+void
+perf::OpenMetricsExporter::append_label_value(const std::string_view value)
+{
+  for (const auto character : value) {
+    if (character == '"' || character == '\\') {
+      this->_buffer.append('\\');
+      this->_buffer.append(character);
+    } else if (character == '\n') {
+      this->_buffer.append("\\n");
+    } else {
+      this->_buffer.append(character);
+    }
+  }
+}
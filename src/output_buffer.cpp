@@ -0,0 +1,105 @@
+#include <algorithm>
+#include <charconv>
+#include <perfcpp/output_buffer.h>
+
+perf::OutputBuffer::OutputBuffer(const std::size_t capacity)
+  : _buffer(std::max(capacity, std::size_t{ 64U }))
+{
+}
+
+perf::OutputBuffer::OutputBuffer(std::ostream& output, const std::size_t capacity)
+  : _output(&output)
+  , _buffer(std::max(capacity, std::size_t{ 4096U }))
+{
+}
+
+bool
+perf::OutputBuffer::flush()
+{
+  if (this->_output == nullptr) {
+    return true;
+  }
+
+  if (this->_size > 0U) {
+    this->_output->write(this->_buffer.data(), std::streamsize(this->_size));
+    this->_size = 0U;
+  }
+
+  return this->_output->good();
+}
+
+char*
+perf::OutputBuffer::reserve(const std::size_t size)
+{
+  if (this->_buffer.size() - this->_size < size) {
+    if (this->_output != nullptr) {
+      static_cast<void>(this->flush());
+    }
+
+    if (this->_buffer.size() - this->_size < size) {
+      this->_buffer.resize(std::max(this->_buffer.size() * 2U, this->_size + size));
+    }
+  }
+
+  return this->_buffer.data() + this->_size;
+}
+
+void
+perf::OutputBuffer::append(const std::string_view string)
+{
+  auto* begin = this->reserve(string.size());
+  std::copy(string.begin(), string.end(), begin);
+  this->_size += string.size();
+}
+
+void
+perf::OutputBuffer::append(const char character)
+{
+  *this->reserve(1U) = character;
+  ++this->_size;
+}
+
+void
+perf::OutputBuffer::append(const std::uint64_t value)
+{
+  auto* begin = this->reserve(20U);
+  this->_size = std::size_t(std::to_chars(begin, begin + 20U, value).ptr - this->_buffer.data());
+}
+
+void
+perf::OutputBuffer::append(const double value)
+{
+  /// The shortest representation of a double that reads back to the same value needs at most 24 chars.
+  auto* begin = this->reserve(32U);
+  this->_size = std::size_t(std::to_chars(begin, begin + 32U, value).ptr - this->_buffer.data());
+}
+
+void
+perf::OutputBuffer::append_hex(const std::uint64_t value)
+{
+  auto* begin = this->reserve(18U);
+  begin[0U] = '0';
+  begin[1U] = 'x';
+  this->_size = std::size_t(std::to_chars(begin + 2U, begin + 18U, value, 16).ptr - this->_buffer.data());
+}
+
+void
+perf::OutputBuffer::append_json_string(const std::string_view string)
+{
+  constexpr auto hex_digits = std::string_view{ "0123456789abcdef" };
+
+  this->append('"');
+  for (const auto character : string) {
+    if (character == '"' || character == '\\') {
+      this->append('\\');
+      this->append(character);
+    } else if (static_cast<unsigned char>(character) < 0x20U) {
+      this->append("\\u00");
+      this->append(hex_digits[static_cast<unsigned char>(character) >> 4U]);
+      this->append(hex_digits[static_cast<unsigned char>(character) & 0xFU]);
+    } else {
+      this->append(character);
+    }
+  }
+  this->append('"');
+}
@@ -0,0 +1,284 @@
+#include <algorithm>
+#include <iomanip>
+#include <perfcpp/page_size_analyzer.h>
+#include <sstream>
+#include <unordered_map>
+
+/**
+ * Formats a page size like "4K", "2M", or "1G".
+ *
+ * @param page_size Page size in bytes.
+ * @return Formatted page size.
+ */
+static std::string
+page_size_to_string(const std::uint64_t page_size)
+{
+  if (page_size > 0U && page_size % perf::PageSizeCoverage::PAGE_1G == 0U) {
+    return std::to_string(page_size / perf::PageSizeCoverage::PAGE_1G) + "G";
+  }
+
+  if (page_size > 0U && page_size % (1024U * 1024U) == 0U) {
+    return std::to_string(page_size / (1024U * 1024U)) + "M";
+  }
+
+  if (page_size > 0U && page_size % 1024U == 0U) {
+    return std::to_string(page_size / 1024U) + "K";
+  }
+
+  return std::to_string(page_size) + "B";
+}
+
+void
+perf::PageSizeCoverage::add(const std::uint64_t page_size)
+{
+  ++this->_accesses;
+
+  auto iterator = std::lower_bound(
+    this->_counters.begin(), this->_counters.end(), page_size, [](const auto& counter, const auto page_size) {
+      return counter.page_size < page_size;
+    });
+  if (iterator == this->_counters.end() || iterator->page_size != page_size) {
+    iterator = this->_counters.insert(iterator, page_size_counter{ page_size, 0U, 0U });
+  }
+
+  ++iterator->accesses;
+}
+
+void
+perf::PageSizeCoverage::add(const std::uint64_t page_size, const bool is_tlb_miss)
+{
+  this->add(page_size);
+
+  this->_has_tlb_information = true;
+  if (!is_tlb_miss) {
+    return;
+  }
+
+  ++this->_tlb_misses;
+
+  /// The counter of the page size was created by adding the access.
+  auto iterator = std::lower_bound(
+    this->_counters.begin(), this->_counters.end(), page_size, [](const auto& counter, const auto page_size) {
+      return counter.page_size < page_size;
+    });
+  ++iterator->tlb_misses;
+}
+
+std::uint64_t
+perf::PageSizeCoverage::accesses(const std::uint64_t page_size) const noexcept
+{
+  for (const auto& counter : this->_counters) {
+    if (counter.page_size == page_size) {
+      return counter.accesses;
+    }
+  }
+
+  return 0U;
+}
+
+std::uint64_t
+perf::PageSizeCoverage::tlb_misses(const std::uint64_t page_size) const noexcept
+{
+  for (const auto& counter : this->_counters) {
+    if (counter.page_size == page_size) {
+      return counter.tlb_misses;
+    }
+  }
+
+  return 0U;
+}
+
+std::vector<std::uint64_t>
+perf::PageSizeCoverage::page_sizes() const
+{
+  auto page_sizes = std::vector<std::uint64_t>{};
+  page_sizes.reserve(this->_counters.size());
+  std::transform(this->_counters.begin(),
+                 this->_counters.end(),
+                 std::back_inserter(page_sizes),
+                 [](const auto& counter) { return counter.page_size; });
+
+  return page_sizes;
+}
+
+std::string
+perf::PageSizeCoverage::to_string() const
+{
+  auto stream = std::stringstream{};
+  stream << std::fixed << std::setprecision(2);
+
+  stream << std::setw(12) << "page size" << std::setw(14) << "accesses" << std::setw(10) << "%";
+  if (this->_has_tlb_information) {
+    stream << std::setw(14) << "tlb misses" << std::setw(10) << "%";
+  }
+  stream << "\n";
+
+  for (const auto& counter : this->_counters) {
+    stream << std::setw(12) << page_size_to_string(counter.page_size) << std::setw(14) << counter.accesses
+           << std::setw(10) << this->access_ratio(counter.page_size) * 100.;
+    if (this->_has_tlb_information) {
+      stream << std::setw(14) << counter.tlb_misses << std::setw(10) << this->tlb_miss_ratio(counter.page_size) * 100.;
+    }
+    stream << "\n";
+  }
+
+  return stream.str();
+}
+
+std::string
+perf::PageSizeResult::to_string() const
+{
+  auto stream = std::stringstream{};
+
+  stream << "Data (" << this->_data.accesses() << " accesses, " << this->_data.tlb_misses() << " TLB misses)\n"
+         << this->_data.to_string();
+
+  for (const auto& [name, coverage] : this->_regions) {
+    stream << "\nRegion '" << name << "' (" << coverage.accesses() << " accesses, " << coverage.tlb_misses()
+           << " TLB misses)\n"
+           << coverage.to_string();
+  }
+
+  stream << "\nCode (" << this->_code.accesses() << " samples)\n" << this->_code.to_string();
+
+  for (const auto& [name, coverage] : this->_text_segments) {
+    stream << "\nText segment '" << name << "' (" << coverage.accesses() << " samples)\n" << coverage.to_string();
+  }
+
+  if (!this->_candidates.empty()) {
+    stream << "\nHottest 4K-backed ranges (candidates for huge pages):\n";
+    for (const auto& candidate : this->_candidates) {
+      stream << "  0x" << std::hex << candidate.begin() << "-0x" << candidate.end() << std::dec << " ("
+             << candidate.name() << "): " << candidate.accesses() << " accesses, " << candidate.tlb_misses()
+             << " TLB misses\n";
+    }
+  }
+
+  return stream.str();
+}
+
+perf::PageSizeResult
+perf::PageSizeAnalyzer::analyze(const std::vector<Sample>& samples) const
+{
+  constexpr auto huge_page_mask = ~std::uintptr_t{ PageSizeCoverage::PAGE_2M - 1U };
+
+  auto result = PageSizeResult{};
+  for (const auto& region : this->_regions) {
+    result.regions().emplace_back(region.name(), PageSizeCoverage{});
+  }
+
+  /// Index of every text segment (by path) within the result.
+  auto text_segment_indices = std::unordered_map<std::string, std::size_t>{};
+
+  /// Accesses and TLB misses of 4K-backed ranges, aligned to 2M.
+  struct small_page_range
+  {
+    std::uint64_t accesses{ 0U };
+    std::uint64_t tlb_misses{ 0U };
+
+    /// Any sampled address within the range, used to name the range.
+    std::uintptr_t address{ 0U };
+  };
+  auto small_page_ranges = std::unordered_map<std::uintptr_t, small_page_range>{};
+
+  for (const auto& sample : samples) {
+    /// Context switches (if recorded) hold no access.
+    if (sample.context_switch().has_value()) {
+      continue;
+    }
+
+    /// Data accesses.
+    if (sample.data_page_size().has_value() && sample.logical_memory_address().has_value()) {
+      const auto page_size = sample.data_page_size().value();
+      const auto address = sample.logical_memory_address().value();
+      const auto& data_source = sample.data_src();
+      const auto is_tlb_miss = data_source.has_value() && data_source->is_tlb_miss();
+
+      /// Without data source, the TLB misses of the access are unknown.
+      const auto add = [&data_source, page_size, is_tlb_miss](PageSizeCoverage& coverage) {
+        if (data_source.has_value()) {
+          coverage.add(page_size, is_tlb_miss);
+        } else {
+          coverage.add(page_size);
+        }
+      };
+
+      add(result.data());
+
+      for (auto region_id = 0U; region_id < this->_regions.size(); ++region_id) {
+        if (this->_regions[region_id].contains(address)) {
+          add(result.regions()[region_id].second);
+          break;
+        }
+      }
+
+      if (page_size == PageSizeCoverage::PAGE_4K) {
+        auto& range = small_page_ranges[address & huge_page_mask];
+        ++range.accesses;
+        range.tlb_misses += static_cast<std::uint64_t>(is_tlb_miss);
+        range.address = address;
+      }
+    }
+
+    /// Code accesses.
+    if (sample.code_page_size().has_value() && sample.instruction_pointer().has_value()) {
+      const auto page_size = sample.code_page_size().value();
+      const auto instruction_pointer = sample.instruction_pointer().value();
+
+      /// The data source describes only the data access of a sample; TLB misses of the instruction fetch are unknown.
+      result.code().add(page_size);
+
+      if (const auto* mapping = this->_memory_map.find(instruction_pointer);
+          mapping != nullptr && mapping->is_executable()) {
+        const auto& name = mapping->path().empty() ? std::string{ "[anonymous]" } : mapping->path();
+        auto [iterator, is_new] = text_segment_indices.insert(std::make_pair(name, result.text_segments().size()));
+        if (is_new) {
+          result.text_segments().emplace_back(name, PageSizeCoverage{});
+        }
+        result.text_segments()[iterator->second].second.add(page_size);
+      }
+
+      if (page_size == PageSizeCoverage::PAGE_4K) {
+        auto& range = small_page_ranges[instruction_pointer & huge_page_mask];
+        ++range.accesses;
+        range.address = instruction_pointer;
+      }
+    }
+  }
+
+  /// Rank the 4K-backed ranges by TLB misses, then accesses.
+  auto ranges = std::vector<std::pair<std::uintptr_t, small_page_range>>{ small_page_ranges.begin(),
+                                                                           small_page_ranges.end() };
+  const auto count_candidates = std::min(this->_count_candidates, ranges.size());
+  std::partial_sort(
+    ranges.begin(), ranges.begin() + count_candidates, ranges.end(), [](const auto& left, const auto& right) {
+      if (left.second.tlb_misses != right.second.tlb_misses) {
+        return left.second.tlb_misses > right.second.tlb_misses;
+      }
+      return left.second.accesses > right.second.accesses;
+    });
+
+  for (auto i = 0U; i < count_candidates; ++i) {
+    const auto& [begin, range] = ranges[i];
+    result.candidates().emplace_back(
+      this->name_of(range.address), begin, begin + PageSizeCoverage::PAGE_2M, range.accesses, range.tlb_misses);
+  }
+
+  return result;
+}
+
+std::string
+perf::PageSizeAnalyzer::name_of(const std::uintptr_t address) const
+{
+  for (const auto& region : this->_regions) {
+    if (region.contains(address)) {
+      return region.name();
+    }
+  }
+
+  if (const auto* mapping = this->_memory_map.find(address); mapping != nullptr && !mapping->path().empty()) {
+    return mapping->path();
+  }
+
+  return "[anonymous]";
+}
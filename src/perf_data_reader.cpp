@@ -0,0 +1,367 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <perfcpp/perf_data_reader.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+
+/// Minimal size of the memory-mapped window; every record (at most 64 kB) needs to fit into the window.
+constexpr static auto MIN_WINDOW_SIZE = std::size_t{ 1024U * 1024U };
+
+perf::PerfDataReader::PerfDataReader(const std::string& file_name, const std::size_t window_size)
+  : _window_size(std::max(window_size, MIN_WINDOW_SIZE))
+{
+  this->_file_descriptor = ::open(file_name.c_str(), O_RDONLY);
+  if (this->_file_descriptor < 0) {
+    throw std::runtime_error{ "Could not open '" + file_name + "' (errno = " + std::to_string(errno) + ")." };
+  }
+
+  struct stat file_status
+  {};
+  if (::fstat(this->_file_descriptor, &file_status) != 0) {
+    this->close();
+    throw std::runtime_error{ "Could not read the size of '" + file_name + "'." };
+  }
+  this->_file_size = std::uint64_t(file_status.st_size);
+
+  /// Header.
+  if (!this->read(0U, &this->_header, sizeof(perf_data::file_header)) || this->_header.magic != perf_data::MAGIC ||
+      this->_header.size != sizeof(perf_data::file_header)) {
+    this->close();
+    throw std::runtime_error{ "'" + file_name + "' is not a perf.data file (or written in pipe mode)." };
+  }
+
+  /// A file of an interrupted recording has no data size, the data reaches to the end of the file.
+  if (this->_header.data.size == 0U && this->_header.data.offset < this->_file_size) {
+    this->_header.data.size = this->_file_size - this->_header.data.offset;
+  }
+
+  if (this->_header.attribute_size <= sizeof(perf_data::file_section) ||
+      this->_header.attributes.size % this->_header.attribute_size != 0U ||
+      this->_header.attributes.offset + this->_header.attributes.size > this->_file_size ||
+      this->_header.data.offset + this->_header.data.size > this->_file_size) {
+    this->close();
+    throw std::runtime_error{ "The header of '" + file_name + "' is corrupted." };
+  }
+
+  /// Attributes: Every entry is the perf_event_attr (whose size depends on the version of the recording tool) followed
+  /// by the section of the event's ids.
+  const auto count_attributes = this->_header.attributes.size / this->_header.attribute_size;
+  const auto event_attribute_size = this->_header.attribute_size - sizeof(perf_data::file_section);
+  for (auto index = 0U; index < count_attributes; ++index) {
+    const auto offset = this->_header.attributes.offset + index * this->_header.attribute_size;
+
+    auto attribute = perf_event_attr{};
+    auto ids_section = perf_data::file_section{};
+    if (!this->read(offset, &attribute, std::min(event_attribute_size, sizeof(perf_event_attr))) ||
+        !this->read(offset + event_attribute_size, &ids_section, sizeof(perf_data::file_section))) {
+      this->close();
+      throw std::runtime_error{ "Could not read the attributes of '" + file_name + "'." };
+    }
+
+    /// The ids are allocated only if the section is located within the file.
+    if (ids_section.offset > this->_file_size || ids_section.size > this->_file_size - ids_section.offset) {
+      this->close();
+      throw std::runtime_error{ "The event ids of '" + file_name + "' are corrupted." };
+    }
+
+    auto ids = std::vector<std::uint64_t>(ids_section.size / sizeof(std::uint64_t));
+    if (!this->read(ids_section.offset, ids.data(), ids.size() * sizeof(std::uint64_t))) {
+      this->close();
+      throw std::runtime_error{ "Could not read the event ids of '" + file_name + "'." };
+    }
+
+    for (const auto id : ids) {
+      this->_attribute_index_by_id.insert(std::make_pair(id, index));
+    }
+
+    this->_attributes.push_back(attribute);
+    this->_event_ids.push_back(std::move(ids));
+  }
+
+  if (this->_attributes.empty()) {
+    this->close();
+    throw std::runtime_error{ "'" + file_name + "' does not contain any events." };
+  }
+
+  /// Samples are assigned to events by their id, which is either the first value (PERF_SAMPLE_IDENTIFIER) or
+  /// located behind ip, tid, time, and addr (PERF_SAMPLE_ID). The sample type is equal for all events of a file.
+  const auto sample_type = this->_attributes.front().sample_type;
+  if (sample_type & PERF_SAMPLE_IDENTIFIER) {
+    this->_sample_id_position = 0U;
+  } else if (sample_type & PERF_SAMPLE_ID) {
+    auto position = std::size_t{ 0U };
+    for (const auto type : { PERF_SAMPLE_IP, PERF_SAMPLE_TID, PERF_SAMPLE_TIME, PERF_SAMPLE_ADDR }) {
+      position += static_cast<std::size_t>((sample_type & std::uint64_t(type)) != 0U);
+    }
+    this->_sample_id_position = position;
+  }
+
+  this->read_event_description();
+  this->create_decoders();
+}
+
+perf::PerfDataReader::PerfDataReader(PerfDataReader&& other) noexcept
+  : _file_descriptor(std::exchange(other._file_descriptor, -1))
+  , _file_size(other._file_size)
+  , _window_size(other._window_size)
+  , _header(other._header)
+  , _attributes(std::move(other._attributes))
+  , _event_names(std::move(other._event_names))
+  , _event_ids(std::move(other._event_ids))
+  , _decoders(std::move(other._decoders))
+  , _attribute_index_by_id(std::move(other._attribute_index_by_id))
+  , _sample_id_position(other._sample_id_position)
+{
+}
+
+perf::PerfDataReader&
+perf::PerfDataReader::operator=(PerfDataReader&& other) noexcept
+{
+  if (this != &other) {
+    this->close();
+
+    this->_file_descriptor = std::exchange(other._file_descriptor, -1);
+    this->_file_size = other._file_size;
+    this->_window_size = other._window_size;
+    this->_header = other._header;
+    this->_attributes = std::move(other._attributes);
+    this->_event_names = std::move(other._event_names);
+    this->_event_ids = std::move(other._event_ids);
+    this->_decoders = std::move(other._decoders);
+    this->_attribute_index_by_id = std::move(other._attribute_index_by_id);
+    this->_sample_id_position = other._sample_id_position;
+  }
+
+  return *this;
+}
+
+perf::PerfDataReader::~PerfDataReader()
+{
+  this->close();
+}
+
+void
+perf::PerfDataReader::close()
+{
+  if (this->_file_descriptor > -1) {
+    ::close(this->_file_descriptor);
+    this->_file_descriptor = -1;
+  }
+}
+
+bool
+perf::PerfDataReader::read(std::uint64_t offset, void* data, std::size_t size) const
+{
+  auto* begin = reinterpret_cast<std::byte*>(data);
+  while (size > 0U) {
+    const auto count_read = ::pread(this->_file_descriptor, begin, size, off_t(offset));
+    if (count_read < 0 && errno == EINTR) {
+      continue;
+    }
+    if (count_read <= 0) {
+      return false;
+    }
+
+    begin += count_read;
+    offset += std::uint64_t(count_read);
+    size -= std::size_t(count_read);
+  }
+
+  return true;
+}
+
+void
+perf::PerfDataReader::read_event_description()
+{
+  /// Feature sections follow the data section, one section for every feature bit set in the header.
+  auto feature_section_index = 0U;
+  for (auto feature = 0U; feature < perf_data::FEATURE_EVENT_DESCRIPTION; ++feature) {
+    feature_section_index +=
+      static_cast<std::uint32_t>((this->_header.features[feature / 64U] >> (feature % 64U)) & 1U);
+  }
+
+  auto section = perf_data::file_section{};
+  const auto has_event_description = (this->_header.features[0U] >> perf_data::FEATURE_EVENT_DESCRIPTION) & 1U;
+  if (has_event_description &&
+      this->read(this->_header.data.offset + this->_header.data.size +
+                   feature_section_index * sizeof(perf_data::file_section),
+                 &section,
+                 sizeof(perf_data::file_section)) &&
+      section.offset + section.size <= this->_file_size) {
+    /// Layout: u32 count_events, u32 attribute_size, and per event: attribute, u32 count_ids, string (u32 length and
+    /// zero-padded characters), and u64 ids[count_ids].
+    auto description = std::vector<std::byte>(section.size);
+    if (this->read(section.offset, description.data(), description.size())) {
+      auto position = std::size_t{ 0U };
+      const auto read_u32 = [&description, &position]() -> std::optional<std::uint32_t> {
+        if (position + sizeof(std::uint32_t) > description.size()) {
+          return std::nullopt;
+        }
+
+        auto value = std::uint32_t{ 0U };
+        std::memcpy(&value, description.data() + position, sizeof(std::uint32_t));
+        position += sizeof(std::uint32_t);
+        return value;
+      };
+
+      const auto count_events = read_u32();
+      const auto attribute_size = read_u32();
+      if (count_events.has_value() && attribute_size.has_value()) {
+        for (auto event = 0U; event < count_events.value(); ++event) {
+          position += attribute_size.value();
+
+          const auto count_ids = read_u32();
+          const auto name_length = read_u32();
+          if (!count_ids.has_value() || !name_length.has_value() ||
+              position + name_length.value() > description.size()) {
+            break;
+          }
+
+          /// The name is zero-terminated and padded.
+          const auto* name = reinterpret_cast<const char*>(description.data() + position);
+          this->_event_names.emplace_back(name, ::strnlen(name, name_length.value()));
+          position += name_length.value() + count_ids.value() * sizeof(std::uint64_t);
+        }
+      }
+    }
+  }
+
+  /// Events without description are named by their index.
+  this->_event_names.resize(std::min(this->_event_names.size(), this->_attributes.size()));
+  for (auto index = this->_event_names.size(); index < this->_attributes.size(); ++index) {
+    this->_event_names.emplace_back("event-" + std::to_string(index));
+  }
+}
+
+void
+perf::PerfDataReader::create_decoders()
+{
+  for (const auto& attribute : this->_attributes) {
+    /// Counter values are named by id, if the read format includes ids; every event has an id per recorded CPU (or
+    /// thread) and all of them carry the name of the event. Otherwise, counter values are named in order of the events.
+    const auto is_named_by_id = (attribute.read_format & PERF_FORMAT_ID) != 0U;
+    auto counter_names = std::vector<std::pair<std::uint64_t, std::string_view>>{};
+    for (auto index = 0U; index < this->_attributes.size(); ++index) {
+      if (is_named_by_id) {
+        for (const auto id : this->_event_ids[index]) {
+          counter_names.emplace_back(id, this->_event_names[index]);
+        }
+      } else {
+        counter_names.emplace_back(0U, this->_event_names[index]);
+      }
+    }
+
+    this->_decoders.emplace_back(attribute, std::move(counter_names));
+  }
+}
+
+const perf::SampleDecoder*
+perf::PerfDataReader::decoder(const perf_event_header& record) const
+{
+  /// Without ids in the samples (or with a single event), all samples belong to the first event (e.g., the sampling
+  /// leader of a group).
+  if (this->_decoders.size() == 1U || !this->_sample_id_position.has_value()) {
+    return &this->_decoders.front();
+  }
+
+  if (sizeof(perf_event_header) + (this->_sample_id_position.value() + 1U) * sizeof(std::uint64_t) <= record.size) {
+    const auto* values = reinterpret_cast<const std::uint64_t*>(&record + 1U);
+    if (const auto iterator = this->_attribute_index_by_id.find(values[this->_sample_id_position.value()]);
+        iterator != this->_attribute_index_by_id.end()) {
+      return &this->_decoders[iterator->second];
+    }
+  }
+
+  return nullptr;
+}
+
+void
+perf::PerfDataReader::for_each_record(const std::function<void(const perf_event_header&)>& callback) const
+{
+  const auto page_size = std::uint64_t(::sysconf(_SC_PAGESIZE));
+
+  /// Window of the file that is currently mapped; remapped (page-aligned) when a record crosses its end.
+  void* window = nullptr;
+  auto window_begin = std::uint64_t{ 0U };
+  auto window_end = std::uint64_t{ 0U };
+
+  const auto map_window = [&](const std::uint64_t position) {
+    if (window != nullptr) {
+      ::munmap(window, window_end - window_begin);
+    }
+
+    window_begin = position & ~(page_size - 1U);
+    window_end = std::min(window_begin + this->_window_size, this->_file_size);
+    window =
+      ::mmap(nullptr, window_end - window_begin, PROT_READ, MAP_PRIVATE, this->_file_descriptor, off_t(window_begin));
+    if (window == MAP_FAILED) {
+      window = nullptr;
+      throw std::runtime_error{ "Could not map the perf.data file (errno = " + std::to_string(errno) + ")." };
+    }
+
+    ::madvise(window, window_end - window_begin, MADV_SEQUENTIAL);
+  };
+
+  const auto record_at = [&](const std::uint64_t position) {
+    return reinterpret_cast<const perf_event_header*>(reinterpret_cast<const std::byte*>(window) +
+                                                      (position - window_begin));
+  };
+
+  auto position = this->_header.data.offset;
+  const auto end = this->_header.data.offset + this->_header.data.size;
+
+  while (position + sizeof(perf_event_header) <= end) {
+    if (position + sizeof(perf_event_header) > window_end) {
+      map_window(position);
+    }
+
+    /// Stop at a corrupted (or truncated) record.
+    const auto record_size = record_at(position)->size;
+    if (record_size < sizeof(perf_event_header) || position + record_size > end) {
+      break;
+    }
+
+    if (position + record_size > window_end) {
+      map_window(position);
+    }
+
+    callback(*record_at(position));
+
+    position += record_size;
+  }
+
+  if (window != nullptr) {
+    ::munmap(window, window_end - window_begin);
+  }
+}
+
+void
+perf::PerfDataReader::for_each_sample(const std::function<void(Sample&&)>& callback) const
+{
+  this->for_each_record([this, &callback](const perf_event_header& record) {
+    if (record.type == PERF_RECORD_SAMPLE) {
+      if (const auto* decoder = this->decoder(record); decoder != nullptr) {
+        callback(decoder->decode(record));
+      }
+    } else if (SampleDecoder::is_context_switch(record)) {
+      /// Context switches are recorded by the leader, which is the first event.
+      callback(this->_decoders.front().decode(record));
+    }
+  });
+}
+
+std::vector<perf::Sample>
+perf::PerfDataReader::result() const
+{
+  auto result = std::vector<Sample>{};
+  result.reserve(2048U);
+
+  this->for_each_sample([&result](Sample&& sample) { result.push_back(std::move(sample)); });
+
+  return result;
+}
@@ -0,0 +1,245 @@
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <perfcpp/memory_map.h>
+#include <perfcpp/perf_data_format.h>
+#include <perfcpp/perf_data_writer.h>
+#include <unistd.h>
+
+/**
+ * Writes the complete buffer to the file, retrying on partial writes.
+ *
+ * @param file_descriptor File descriptor to write to.
+ * @param data Data to write.
+ * @param size Size of the data in bytes.
+ * @return True, if all data was written.
+ */
+static bool
+write_all(const std::int32_t file_descriptor, const void* data, std::size_t size)
+{
+  const auto* begin = reinterpret_cast<const std::byte*>(data);
+  while (size > 0U) {
+    const auto written = ::write(file_descriptor, begin, size);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+
+    begin += written;
+    size -= std::size_t(written);
+  }
+
+  return true;
+}
+
+bool
+perf::PerfDataWriter::write(const std::string& file_name, const Sampler& sampler)
+{
+  if (sampler._buffer == nullptr || sampler._group.empty()) {
+    return false;
+  }
+
+  /// If the leader is an "auxiliary" counter (like on Sapphire Rapid), the second counter is sampled.
+  const auto sampling_counter_index =
+    sampler._group.member(0U).is_auxiliary() && sampler._group.size() > 1U ? 1U : 0U;
+  const auto& sampling_attribute = sampler._group.member(sampling_counter_index).event_attribute();
+
+  /// Tools assign the records to the attributes by their id; without ids, only a single attribute can be written.
+  const auto has_ids = (sampling_attribute.sample_type & (PERF_SAMPLE_IDENTIFIER | PERF_SAMPLE_ID)) != 0U;
+  if (sampler._group.size() > 1U && !has_ids) {
+    return false;
+  }
+
+  /// Records of the ring buffer, which are located between data_tail and data_head (both are only growing; the
+  /// position in the buffer is the value modulo the buffer size).
+  auto* mmap_page = reinterpret_cast<perf_event_mmap_page*>(sampler._buffer);
+  const auto head = mmap_page->data_head;
+  std::atomic_thread_fence(std::memory_order_acquire);
+  const auto tail = mmap_page->data_tail;
+  const auto* ring_buffer = reinterpret_cast<const std::byte*>(sampler._buffer) + 4096U;
+  const auto ring_buffer_size = (sampler._config.buffer_pages() - 1U) * 4096U;
+  const auto ring_begin = tail % ring_buffer_size;
+  const auto ring_size = head - tail;
+  const auto first_part_size = std::min(ring_size, ring_buffer_size - ring_begin);
+
+  /// Records for the mappings that already existed when sampling started.
+  const auto process_id = sampler._config.process_id() > 0 ? sampler._config.process_id() : ::getpid();
+  const auto synthesized_records = PerfDataWriter::synthesize_records(
+    process_id, sampling_attribute, sampler._group.member(sampling_counter_index).id());
+
+  /// Ids of every counter (one per counter, since samplers are not inherited to other CPUs).
+  auto ids = std::vector<std::uint64_t>{};
+  for (auto i = 0U; i < sampler._group.size(); ++i) {
+    ids.push_back(sampler._group.member(i).id());
+  }
+
+  /// Layout: header | ids | attributes | data (synthesized records, ring buffer records) | event description.
+  auto header = perf_data::file_header{};
+  header.attribute_size = sizeof(perf_data::file_attribute);
+
+  const auto ids_offset = std::uint64_t{ sizeof(perf_data::file_header) };
+  header.attributes.offset = ids_offset + ids.size() * sizeof(std::uint64_t);
+  header.attributes.size = sampler._group.size() * sizeof(perf_data::file_attribute);
+  header.data.offset = header.attributes.offset + header.attributes.size;
+  header.data.size = synthesized_records.size() + ring_size;
+
+  auto attributes = std::vector<perf_data::file_attribute>{};
+  for (auto i = 0U; i < sampler._group.size(); ++i) {
+    auto attribute = perf_data::file_attribute{};
+    attribute.attribute = sampler._group.member(i).event_attribute();
+
+    /// Tools expect an identical sample layout for all events of the file; only the sampling counter (and an
+    /// auxiliary leader) are opened with a sample type.
+    attribute.attribute.sample_type = sampling_attribute.sample_type;
+    attribute.attribute.sample_id_all = sampling_attribute.sample_id_all;
+    attribute.attribute.read_format = sampling_attribute.read_format;
+
+    attribute.ids.offset = ids_offset + i * sizeof(std::uint64_t);
+    attribute.ids.size = sizeof(std::uint64_t);
+    attributes.push_back(attribute);
+  }
+
+  /// Feature section HEADER_EVENT_DESC (following the data section), naming the events of the attribute section.
+  auto event_description = std::vector<std::byte>{};
+  PerfDataWriter::append(event_description, std::uint32_t(attributes.size()));
+  PerfDataWriter::append(event_description, std::uint32_t(sizeof(perf_event_attr)));
+  for (auto i = 0U; i < attributes.size(); ++i) {
+    /// The name is zero-terminated and padded to 4 bytes.
+    const auto& name = sampler._counter_names[i];
+    const auto name_size = (name.size() + 1U + 3U) & ~std::size_t{ 3U };
+
+    PerfDataWriter::append(event_description, attributes[i].attribute);
+    PerfDataWriter::append(event_description, std::uint32_t{ 1U });
+    PerfDataWriter::append(event_description, std::uint32_t(name_size));
+    const auto name_offset = event_description.size();
+    event_description.resize(name_offset + name_size, std::byte{ 0 });
+    std::memcpy(event_description.data() + name_offset, name.data(), name.size());
+    PerfDataWriter::append(event_description, ids[i]);
+  }
+
+  header.features[0U] |= std::uint64_t(1U) << perf_data::FEATURE_EVENT_DESCRIPTION;
+  auto event_description_section = perf_data::file_section{};
+  event_description_section.offset = header.data.offset + header.data.size + sizeof(perf_data::file_section);
+  event_description_section.size = event_description.size();
+
+  const auto file_descriptor = ::open(file_name.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (file_descriptor < 0) {
+    return false;
+  }
+
+  /// The ring buffer is written as it is, without decoding the records.
+  const auto is_written = write_all(file_descriptor, &header, sizeof(header)) &&
+                          write_all(file_descriptor, ids.data(), ids.size() * sizeof(std::uint64_t)) &&
+                          write_all(file_descriptor, attributes.data(), header.attributes.size) &&
+                          write_all(file_descriptor, synthesized_records.data(), synthesized_records.size()) &&
+                          write_all(file_descriptor, ring_buffer + ring_begin, first_part_size) &&
+                          write_all(file_descriptor, ring_buffer, ring_size - first_part_size) &&
+                          write_all(file_descriptor, &event_description_section, sizeof(perf_data::file_section)) &&
+                          write_all(file_descriptor, event_description.data(), event_description.size());
+
+  return ::close(file_descriptor) == 0 && is_written;
+}
+
+std::vector<std::byte>
+perf::PerfDataWriter::synthesize_records(const pid_t process_id,
+                                         const perf_event_attr& attribute,
+                                         const std::uint64_t id)
+{
+  auto records = std::vector<std::byte>{};
+  const auto sample_id = PerfDataWriter::sample_id(process_id, attribute, id);
+
+  /// Name of the command.
+  auto comm = std::string{};
+  auto comm_stream = std::ifstream{ "/proc/" + std::to_string(process_id) + "/comm" };
+  std::getline(comm_stream, comm);
+
+  auto comm_record = perf_data::comm_record{};
+  comm_record.header.type = PERF_RECORD_COMM;
+  comm_record.header.misc = 0U;
+  comm_record.process_id = std::uint32_t(process_id);
+  comm_record.thread_id = std::uint32_t(process_id);
+  PerfDataWriter::append_record(records, comm_record, comm, sample_id);
+
+  /// Executable mappings, such that tools can attribute sampled instruction pointers to binaries and symbols.
+  const auto memory_map = MemoryMap::read(process_id);
+  for (const auto& mapping : memory_map.mappings()) {
+    if (!mapping.is_executable() || (!mapping.is_file() && mapping.path() != "[vdso]")) {
+      continue;
+    }
+
+    auto mmap_record = perf_data::mmap_record{};
+    mmap_record.header.type = PERF_RECORD_MMAP;
+    mmap_record.header.misc = PERF_RECORD_MISC_USER;
+    mmap_record.process_id = std::uint32_t(process_id);
+    mmap_record.thread_id = std::uint32_t(process_id);
+    mmap_record.address = mapping.begin();
+    mmap_record.length = mapping.size();
+    mmap_record.page_offset = mapping.offset();
+    PerfDataWriter::append_record(records, mmap_record, mapping.path(), sample_id);
+  }
+
+  return records;
+}
+
+std::vector<std::byte>
+perf::PerfDataWriter::sample_id(const pid_t process_id, const perf_event_attr& attribute, const std::uint64_t id)
+{
+  auto sample_id = std::vector<std::byte>{};
+  if (!attribute.sample_id_all) {
+    return sample_id;
+  }
+
+  /// The fields follow the order of struct sample_id; the records describe the state before sampling started.
+  if (attribute.sample_type & PERF_SAMPLE_TID) {
+    PerfDataWriter::append(sample_id, std::uint32_t(process_id));
+    PerfDataWriter::append(sample_id, std::uint32_t(process_id));
+  }
+  if (attribute.sample_type & PERF_SAMPLE_TIME) {
+    PerfDataWriter::append(sample_id, std::uint64_t{ 0U });
+  }
+  if (attribute.sample_type & PERF_SAMPLE_ID) {
+    PerfDataWriter::append(sample_id, id);
+  }
+  if (attribute.sample_type & PERF_SAMPLE_STREAM_ID) {
+    PerfDataWriter::append(sample_id, id);
+  }
+  if (attribute.sample_type & PERF_SAMPLE_CPU) {
+    PerfDataWriter::append(sample_id, std::uint64_t{ 0U });
+  }
+  if (attribute.sample_type & PERF_SAMPLE_IDENTIFIER) {
+    PerfDataWriter::append(sample_id, id);
+  }
+
+  return sample_id;
+}
+
+template <typename T>
+void
+perf::PerfDataWriter::append(std::vector<std::byte>& buffer, const T& value)
+{
+  const auto offset = buffer.size();
+  buffer.resize(offset + sizeof(T));
+  std::memcpy(buffer.data() + offset, &value, sizeof(T));
+}
+
+template <typename R>
+void
+perf::PerfDataWriter::append_record(std::vector<std::byte>& buffer,
+                                    R record,
+                                    const std::string& string,
+                                    const std::vector<std::byte>& sample_id)
+{
+  /// The string is zero-terminated and padded to 8 bytes.
+  const auto string_size = (string.size() + 1U + 7U) & ~std::size_t{ 7U };
+  record.header.size = std::uint16_t(sizeof(R) + string_size + sample_id.size());
+
+  const auto offset = buffer.size();
+  buffer.resize(offset + record.header.size, std::byte{ 0 });
+  std::memcpy(buffer.data() + offset, &record, sizeof(R));
+  std::memcpy(buffer.data() + offset + sizeof(R), string.data(), string.size());
+  std::copy(sample_id.begin(), sample_id.end(), buffer.begin() + std::ptrdiff_t(offset + sizeof(R) + string_size));
+}
@@ -0,0 +1,297 @@
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <linux/perf_event.h>
+#include <perfcpp/pprof_exporter.h>
+#include <string_view>
+#include <unordered_map>
+
+namespace {
+/**
+ * Minimal encoder for protobuf messages (https://protobuf.dev/programming-guides/encoding/): fields are appended to a
+ * string, nested messages are encoded into their own string and appended as length-delimited field.
+ */
+class ProtobufMessage
+{
+public:
+  /**
+   * Appends a varint field; zero values (the default of protobuf) are omitted.
+   */
+  void varint(const std::uint32_t field, const std::uint64_t value)
+  {
+    if (value != 0U) {
+      tag(field, 0U);
+      raw_varint(value);
+    }
+  }
+
+  /**
+   * Appends a length-delimited field (a string, bytes, or a nested message).
+   */
+  void bytes(const std::uint32_t field, const std::string_view value)
+  {
+    tag(field, 2U);
+    raw_varint(value.size());
+    _data.append(value);
+  }
+
+  /**
+   * Appends a repeated varint field in packed encoding.
+   */
+  void packed(const std::uint32_t field, const std::vector<std::uint64_t>& values)
+  {
+    auto packed_values = ProtobufMessage{};
+    for (const auto value : values) {
+      packed_values.raw_varint(value);
+    }
+    bytes(field, packed_values.data());
+  }
+
+  [[nodiscard]] const std::string& data() const noexcept { return _data; }
+
+private:
+  std::string _data;
+
+  void tag(const std::uint32_t field, const std::uint32_t wire_type) { raw_varint((field << 3U) | wire_type); }
+
+  void raw_varint(std::uint64_t value)
+  {
+    while (value >= 0x80U) {
+      _data.push_back(char((value & 0x7FU) | 0x80U));
+      value >>= 7U;
+    }
+    _data.push_back(char(value));
+  }
+};
+
+/**
+ * Table of strings, referenced by their index (as required by profile.proto; the first string is empty).
+ */
+class StringTable
+{
+public:
+  StringTable() { index(""); }
+
+  /**
+   * @return Index of the string, adding it to the table if not already contained.
+   */
+  std::uint64_t index(const std::string& string)
+  {
+    if (auto iterator = _indices.find(string); iterator != _indices.end()) {
+      return iterator->second;
+    }
+
+    _strings.push_back(string);
+    return _indices.insert(std::make_pair(string, _strings.size() - 1U)).first->second;
+  }
+
+  [[nodiscard]] const std::vector<std::string>& strings() const noexcept { return _strings; }
+
+private:
+  std::vector<std::string> _strings;
+  std::unordered_map<std::string, std::uint64_t> _indices;
+};
+}
+
+perf::PprofExporter::PprofExporter(std::string event_name, const std::uint64_t period, MemoryMap memory_map)
+  : _event_name(std::move(event_name))
+  , _period(period)
+  , _symbol_resolver(std::move(memory_map))
+  , _time_nanos(std::uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                std::chrono::system_clock::now().time_since_epoch())
+                                .count()))
+{
+}
+
+void
+perf::PprofExporter::add(const Sample& sample)
+{
+  /// Context switches are no samples of the stack.
+  if (sample.context_switch().has_value()) {
+    return;
+  }
+
+  /// Callchains are ordered from the leaf to the root, as expected by pprof; context markers (like
+  /// PERF_CONTEXT_USER) are skipped.
+  auto stack = std::vector<std::uintptr_t>{};
+  if (sample.callchain().has_value()) {
+    stack.reserve(sample.callchain()->size());
+    for (const auto instruction_pointer : sample.callchain().value()) {
+      if (instruction_pointer < std::uintptr_t(PERF_CONTEXT_MAX)) {
+        stack.push_back(instruction_pointer);
+      }
+    }
+  } else if (sample.instruction_pointer().has_value()) {
+    stack.push_back(sample.instruction_pointer().value());
+  }
+
+  if (stack.empty()) {
+    return;
+  }
+
+  auto& values = this->_stacks[std::move(stack)];
+  ++values.count;
+  values.period += sample.period().value_or(this->_period);
+  ++this->_count_samples;
+
+  if (sample.time().has_value()) {
+    const auto time = sample.time().value();
+    if (this->_time_range.has_value()) {
+      this->_time_range->first = std::min(this->_time_range->first, time);
+      this->_time_range->second = std::max(this->_time_range->second, time);
+    } else {
+      this->_time_range = std::make_pair(time, time);
+    }
+  }
+}
+
+void
+perf::PprofExporter::merge(const PprofExporter& other)
+{
+  for (const auto& [stack, other_values] : other._stacks) {
+    auto& values = this->_stacks[stack];
+    values.count += other_values.count;
+    values.period += other_values.period;
+  }
+  this->_count_samples += other._count_samples;
+
+  if (other._time_range.has_value()) {
+    if (this->_time_range.has_value()) {
+      this->_time_range->first = std::min(this->_time_range->first, other._time_range->first);
+      this->_time_range->second = std::max(this->_time_range->second, other._time_range->second);
+    } else {
+      this->_time_range = other._time_range;
+    }
+  }
+}
+
+void
+perf::PprofExporter::write(std::ostream& stream)
+{
+  auto strings = StringTable{};
+  auto profile = ProtobufMessage{};
+
+  /// Values of every sample: the number of samples and the sum of periods of the event (e.g., nanoseconds for clock
+  /// events like "cpu-clock").
+  const auto event_unit = this->_event_name.find("clock") != std::string::npos ? "nanoseconds" : "count";
+  auto samples_type = ProtobufMessage{};
+  samples_type.varint(1U, strings.index("samples"));
+  samples_type.varint(2U, strings.index("count"));
+  profile.bytes(1U, samples_type.data());
+
+  auto event_type = ProtobufMessage{};
+  event_type.varint(1U, strings.index(this->_event_name));
+  event_type.varint(2U, strings.index(event_unit));
+  profile.bytes(1U, event_type.data());
+
+  /// Locations (one per distinct address), referenced by the samples.
+  auto location_ids = std::unordered_map<std::uintptr_t, std::uint64_t>{};
+  auto location_addresses = std::vector<std::uintptr_t>{};
+
+  for (const auto& [stack, values] : this->_stacks) {
+    auto location_ids_of_stack = std::vector<std::uint64_t>{};
+    location_ids_of_stack.reserve(stack.size());
+    for (const auto instruction_pointer : stack) {
+      auto iterator = location_ids.find(instruction_pointer);
+      if (iterator == location_ids.end()) {
+        location_addresses.push_back(instruction_pointer);
+        iterator = location_ids.insert(std::make_pair(instruction_pointer, location_addresses.size())).first;
+      }
+      location_ids_of_stack.push_back(iterator->second);
+    }
+
+    auto sample = ProtobufMessage{};
+    sample.packed(1U, location_ids_of_stack);
+    sample.packed(2U, std::vector<std::uint64_t>{ values.count, values.period });
+    profile.bytes(2U, sample.data());
+  }
+
+  /// Mappings and functions (one per distinct symbol) of the locations.
+  auto mapping_ids = std::unordered_map<const MemoryMapping*, std::uint64_t>{};
+  auto mappings = std::vector<std::pair<const MemoryMapping*, bool>>{}; /// Mapping and whether it has functions.
+  auto function_ids = std::unordered_map<std::string, std::uint64_t>{};
+
+  for (auto location_index = 0U; location_index < location_addresses.size(); ++location_index) {
+    const auto address = location_addresses[location_index];
+
+    auto location = ProtobufMessage{};
+    location.varint(1U, location_index + 1U);
+
+    if (const auto* mapping = this->_symbol_resolver.memory_map().find(address); mapping != nullptr) {
+      auto mapping_iterator = mapping_ids.find(mapping);
+      if (mapping_iterator == mapping_ids.end()) {
+        mappings.emplace_back(mapping, false);
+        mapping_iterator = mapping_ids.insert(std::make_pair(mapping, mappings.size())).first;
+      }
+      location.varint(2U, mapping_iterator->second);
+
+      /// Resolve the function via the symbol table of the binary.
+      if (const auto binary_address = this->_symbol_resolver.translate(address); binary_address.has_value()) {
+        if (const auto* symbol = this->_symbol_resolver.symbol(binary_address.value()); symbol != nullptr) {
+          auto function_iterator = function_ids.find(symbol->name());
+          if (function_iterator == function_ids.end()) {
+            function_iterator = function_ids.insert(std::make_pair(symbol->name(), function_ids.size() + 1U)).first;
+
+            const auto name = strings.index(symbol->name());
+            auto function = ProtobufMessage{};
+            function.varint(1U, function_iterator->second);
+            function.varint(2U, name);
+            function.varint(3U, name);
+            profile.bytes(5U, function.data());
+          }
+
+          auto line = ProtobufMessage{};
+          line.varint(1U, function_iterator->second);
+          location.bytes(4U, line.data());
+
+          mappings[mapping_iterator->second - 1U].second = true;
+        }
+      }
+    }
+
+    location.varint(3U, address);
+    profile.bytes(4U, location.data());
+  }
+
+  for (auto mapping_index = 0U; mapping_index < mappings.size(); ++mapping_index) {
+    const auto& [memory_mapping, has_functions] = mappings[mapping_index];
+
+    auto mapping = ProtobufMessage{};
+    mapping.varint(1U, mapping_index + 1U);
+    mapping.varint(2U, memory_mapping->begin());
+    mapping.varint(3U, memory_mapping->end());
+    mapping.varint(4U, memory_mapping->offset());
+    mapping.varint(5U, strings.index(memory_mapping->path()));
+    mapping.varint(7U, static_cast<std::uint64_t>(has_functions));
+    profile.bytes(3U, mapping.data());
+  }
+
+  /// Time, duration, period, and default sample type (the event).
+  profile.varint(9U, this->_time_nanos);
+  if (this->_time_range.has_value()) {
+    profile.varint(10U, this->_time_range->second - this->_time_range->first);
+  }
+  profile.bytes(11U, event_type.data());
+  profile.varint(12U, this->_period);
+  profile.varint(14U, strings.index(this->_event_name));
+
+  /// The string table is written last, after all strings were referenced.
+  for (const auto& string : strings.strings()) {
+    profile.bytes(6U, string);
+  }
+
+  stream.write(profile.data().data(), std::streamsize(profile.data().size()));
+}
+
+bool
+perf::PprofExporter::write(const std::string& file_name)
+{
+  auto stream = std::ofstream{ file_name, std::ios::out | std::ios::binary | std::ios::trunc };
+  if (!stream.is_open()) {
+    return false;
+  }
+
+  this->write(stream);
+
+  return stream.good();
+}
@@ -0,0 +1,187 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <perfcpp/raw_spill_reader.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+
+perf::RawSpillReader::RawSpillReader(const std::string& file_name)
+{
+  const auto file_descriptor = ::open(file_name.c_str(), O_RDONLY);
+  if (file_descriptor < 0) {
+    throw std::runtime_error{ "Could not open '" + file_name + "' (errno = " + std::to_string(errno) + ")." };
+  }
+
+  struct stat file_status
+  {};
+  if (::fstat(file_descriptor, &file_status) != 0 ||
+      std::size_t(file_status.st_size) < sizeof(raw_spill::file_header)) {
+    ::close(file_descriptor);
+    throw std::runtime_error{ "'" + file_name + "' is not a raw spill file." };
+  }
+
+  this->_size = std::size_t(file_status.st_size);
+  auto* data = ::mmap(nullptr, this->_size, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+  ::close(file_descriptor);
+  if (data == MAP_FAILED) {
+    throw std::runtime_error{ "Could not map '" + file_name + "' (errno = " + std::to_string(errno) + ")." };
+  }
+  this->_data = reinterpret_cast<const std::byte*>(data);
+  ::madvise(data, this->_size, MADV_SEQUENTIAL);
+
+  std::memcpy(&this->_header, this->_data, sizeof(raw_spill::file_header));
+  const auto counter_size = this->_header.attribute_size + sizeof(raw_spill::counter);
+  if (this->_header.magic != raw_spill::MAGIC || this->_header.version != raw_spill::VERSION ||
+      this->_header.count_counters == 0U || this->_header.sampling_counter_index >= this->_header.count_counters ||
+      sizeof(raw_spill::file_header) + this->_header.count_counters * counter_size > this->_header.data_offset ||
+      this->_header.data_offset > this->_size) {
+    this->close();
+    throw std::runtime_error{ "'" + file_name + "' is not a raw spill file." };
+  }
+
+  /// A file that was not closed (e.g., the recording process crashed) has no data size; the data reaches to the end.
+  if (this->_header.data_size == 0U || this->_header.data_offset + this->_header.data_size > this->_size) {
+    this->_header.data_size = this->_size - this->_header.data_offset;
+  }
+
+  /// Attributes and names of the counters.
+  auto counter_ids = std::vector<std::uint64_t>{};
+  for (auto i = 0U; i < this->_header.count_counters; ++i) {
+    const auto* counter_data = this->_data + sizeof(raw_spill::file_header) + i * counter_size;
+
+    auto attribute = perf_event_attr{};
+    std::memcpy(
+      &attribute, counter_data, std::min(std::size_t{ this->_header.attribute_size }, sizeof(perf_event_attr)));
+    this->_attributes.push_back(attribute);
+
+    auto counter = raw_spill::counter{};
+    std::memcpy(&counter, counter_data + this->_header.attribute_size, sizeof(raw_spill::counter));
+    counter.name.back() = '\0';
+    this->_counter_names.emplace_back(counter.name.data());
+    counter_ids.push_back(counter.id);
+  }
+
+  auto counter_names = std::vector<std::pair<std::uint64_t, std::string_view>>{};
+  for (auto i = 0U; i < this->_counter_names.size(); ++i) {
+    counter_names.emplace_back(counter_ids[i], this->_counter_names[i]);
+  }
+  this->_decoder.emplace(this->_attributes[this->_header.sampling_counter_index], std::move(counter_names));
+}
+
+perf::RawSpillReader::RawSpillReader(RawSpillReader&& other) noexcept
+  : _data(std::exchange(other._data, nullptr))
+  , _size(std::exchange(other._size, 0U))
+  , _header(other._header)
+  , _attributes(std::move(other._attributes))
+  , _counter_names(std::move(other._counter_names))
+  , _decoder(std::move(other._decoder))
+{
+}
+
+perf::RawSpillReader&
+perf::RawSpillReader::operator=(RawSpillReader&& other) noexcept
+{
+  if (this != &other) {
+    this->close();
+
+    this->_data = std::exchange(other._data, nullptr);
+    this->_size = std::exchange(other._size, 0U);
+    this->_header = other._header;
+    this->_attributes = std::move(other._attributes);
+    this->_counter_names = std::move(other._counter_names);
+    this->_decoder = std::move(other._decoder);
+  }
+
+  return *this;
+}
+
+perf::RawSpillReader::~RawSpillReader()
+{
+  this->close();
+}
+
+void
+perf::RawSpillReader::close()
+{
+  if (this->_data != nullptr) {
+    ::munmap(const_cast<std::byte*>(this->_data), this->_size);
+    this->_data = nullptr;
+  }
+}
+
+perf::SampleConfig
+perf::RawSpillReader::config() const noexcept
+{
+  const auto& spill_config = this->_header.config;
+
+  auto config = SampleConfig{};
+  if (spill_config.is_frequency) {
+    config.frequency(spill_config.frequency_or_period);
+  } else {
+    config.period(spill_config.frequency_or_period);
+  }
+  config.buffer_pages(spill_config.buffer_pages);
+  config.precise_ip(spill_config.precise_ip);
+  config.user_registers(Registers{ spill_config.user_registers });
+  config.kernel_registers(Registers{ spill_config.kernel_registers });
+  config.branch_type(spill_config.branch_type);
+  config.max_stack(spill_config.max_stack);
+  config.process_id(spill_config.process_id);
+  if (spill_config.cpu_id > -1) {
+    config.cpu_id(std::uint16_t(spill_config.cpu_id));
+  }
+
+  config.include_child_threads(static_cast<bool>(spill_config.include & (1U << 0U)));
+  config.include_kernel(static_cast<bool>(spill_config.include & (1U << 1U)));
+  config.include_user(static_cast<bool>(spill_config.include & (1U << 2U)));
+  config.include_hypervisor(static_cast<bool>(spill_config.include & (1U << 3U)));
+  config.include_idle(static_cast<bool>(spill_config.include & (1U << 4U)));
+  config.include_guest(static_cast<bool>(spill_config.include & (1U << 5U)));
+
+  return config;
+}
+
+void
+perf::RawSpillReader::for_each_record(const std::function<void(const perf_event_header&)>& callback) const
+{
+  auto position = this->_header.data_offset;
+  const auto end = this->_header.data_offset + this->_header.data_size;
+
+  while (position + sizeof(perf_event_header) <= end) {
+    const auto* record = reinterpret_cast<const perf_event_header*>(this->_data + position);
+
+    /// Stop at a corrupted (or truncated) record.
+    if (record->size < sizeof(perf_event_header) || position + record->size > end) {
+      break;
+    }
+
+    callback(*record);
+
+    position += record->size;
+  }
+}
+
+void
+perf::RawSpillReader::for_each_sample(const std::function<void(Sample&&)>& callback) const
+{
+  this->for_each_record([this, &callback](const perf_event_header& record) {
+    if (record.type == PERF_RECORD_SAMPLE || SampleDecoder::is_context_switch(record)) {
+      callback(this->_decoder->decode(record));
+    }
+  });
+}
+
+std::vector<perf::Sample>
+perf::RawSpillReader::result() const
+{
+  auto result = std::vector<Sample>{};
+  result.reserve(2048U);
+
+  this->for_each_sample([&result](Sample&& sample) { result.push_back(std::move(sample)); });
+
+  return result;
+}
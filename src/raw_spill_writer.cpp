@@ -0,0 +1,180 @@
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <perfcpp/raw_spill_writer.h>
+#include <stdexcept>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <vector>
+
+/**
+ * Writes all vectors to the file at the given offset, retrying on partial writes.
+ *
+ * @param file_descriptor File descriptor to write to.
+ * @param vectors Data to write (modified while writing).
+ * @param offset Offset in the file.
+ * @return True, if all data was written.
+ */
+static bool
+pwritev_all(const std::int32_t file_descriptor, std::vector<iovec>&& vectors, off_t offset)
+{
+  auto* begin = vectors.data();
+  auto count = vectors.size();
+
+  while (count > 0U) {
+    const auto written = ::pwritev(file_descriptor, begin, std::int32_t(count), offset);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+
+    offset += written;
+
+    /// Skip the vectors that were written completely and shorten the first one that was written partially.
+    auto remaining = std::size_t(written);
+    while (count > 0U && remaining >= begin->iov_len) {
+      remaining -= begin->iov_len;
+      ++begin;
+      --count;
+    }
+    if (count > 0U) {
+      begin->iov_base = reinterpret_cast<std::byte*>(begin->iov_base) + remaining;
+      begin->iov_len -= remaining;
+    }
+  }
+
+  return true;
+}
+
+perf::RawSpillWriter::RawSpillWriter(const std::string& file_name, Sampler& sampler)
+  : _sampler(sampler)
+{
+  if (sampler._buffer == nullptr || sampler._group.empty()) {
+    throw std::runtime_error{ "The sampler needs to be started before spilling its ring buffer." };
+  }
+
+  this->_file_descriptor = ::open(file_name.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (this->_file_descriptor < 0) {
+    throw std::runtime_error{ "Could not create '" + file_name + "' (errno = " + std::to_string(errno) + ")." };
+  }
+
+  /// Configuration of the sampler.
+  const auto& config = sampler._config;
+  auto& spill_config = this->_header.config;
+  spill_config.sample_type = sampler._sample_type;
+  spill_config.buffer_pages = config.buffer_pages();
+  spill_config.frequency_or_period = config.frequency_or_period();
+  spill_config.is_frequency = static_cast<std::uint8_t>(config.is_frequency());
+  spill_config.user_registers = config.user_registers().mask();
+  spill_config.kernel_registers = config.kernel_registers().mask();
+  spill_config.branch_type = config.branch_type();
+  spill_config.process_id = config.process_id();
+  spill_config.cpu_id = config.cpu_id().has_value() ? std::int32_t{ config.cpu_id().value() } : -1;
+  spill_config.max_stack = config.max_stack();
+  spill_config.precise_ip = config.precise_ip();
+  spill_config.include = std::uint8_t(
+    (std::uint8_t(config.is_include_child_threads()) << 0U) | (std::uint8_t(config.is_include_kernel()) << 1U) |
+    (std::uint8_t(config.is_include_user()) << 2U) | (std::uint8_t(config.is_include_hypervisor()) << 3U) |
+    (std::uint8_t(config.is_include_idle()) << 4U) | (std::uint8_t(config.is_include_guest()) << 5U));
+
+  /// If the leader is an "auxiliary" counter (like on Sapphire Rapid), the second counter is sampled.
+  this->_header.sampling_counter_index = sampler._group.member(0U).is_auxiliary() && sampler._group.size() > 1U;
+  this->_header.count_counters = std::uint32_t(sampler._group.size());
+  this->_header.data_offset =
+    sizeof(raw_spill::file_header) + sampler._group.size() * (sizeof(perf_event_attr) + sizeof(raw_spill::counter));
+
+  /// Header, followed by attribute, id, and name of every counter.
+  auto counters = std::vector<std::byte>{};
+  counters.reserve(this->_header.data_offset);
+  counters.resize(sizeof(raw_spill::file_header));
+  std::memcpy(counters.data(), &this->_header, sizeof(raw_spill::file_header));
+  for (auto i = 0U; i < sampler._group.size(); ++i) {
+    auto counter = raw_spill::counter{};
+    counter.id = sampler._group.member(i).id();
+    const auto& name = sampler._counter_names[i];
+    std::memcpy(counter.name.data(), name.data(), std::min(name.size(), counter.name.size() - 1U));
+
+    const auto offset = counters.size();
+    counters.resize(offset + sizeof(perf_event_attr) + sizeof(raw_spill::counter));
+    std::memcpy(counters.data() + offset, &sampler._group.member(i).event_attribute(), sizeof(perf_event_attr));
+    std::memcpy(counters.data() + offset + sizeof(perf_event_attr), &counter, sizeof(raw_spill::counter));
+  }
+
+  if (!pwritev_all(this->_file_descriptor, std::vector<iovec>{ iovec{ counters.data(), counters.size() } }, 0)) {
+    ::close(this->_file_descriptor);
+    throw std::runtime_error{ "Could not write the header of '" + file_name + "'." };
+  }
+}
+
+perf::RawSpillWriter::~RawSpillWriter()
+{
+  if (this->_file_descriptor > -1) {
+    static_cast<void>(this->close());
+  }
+}
+
+bool
+perf::RawSpillWriter::drain()
+{
+  if (this->_file_descriptor < 0) {
+    return false;
+  }
+
+  /// Records are located between data_tail and data_head (both are only growing; the position in the buffer is the
+  /// value modulo the buffer size). The kernel writes data_head, we own data_tail.
+  auto* mmap_page = reinterpret_cast<perf_event_mmap_page*>(this->_sampler._buffer);
+  const auto head = mmap_page->data_head;
+  std::atomic_thread_fence(std::memory_order_acquire);
+  const auto tail = mmap_page->data_tail;
+  if (head == tail) {
+    return true;
+  }
+
+  auto* ring_buffer = reinterpret_cast<std::byte*>(this->_sampler._buffer) + 4096U;
+  const auto ring_buffer_size = (this->_sampler._config.buffer_pages() - 1U) * 4096U;
+  const auto ring_begin = tail % ring_buffer_size;
+  const auto ring_size = head - tail;
+  const auto first_part_size = std::min(ring_size, ring_buffer_size - ring_begin);
+
+  /// Write straight from the ring buffer; the second part holds the records that wrapped around.
+  auto vectors = std::vector<iovec>{ iovec{ ring_buffer + ring_begin, first_part_size } };
+  if (ring_size > first_part_size) {
+    vectors.push_back(iovec{ ring_buffer, ring_size - first_part_size });
+  }
+
+  if (!pwritev_all(
+        this->_file_descriptor, std::move(vectors), off_t(this->_header.data_offset + this->_header.data_size))) {
+    return false;
+  }
+  this->_header.data_size += ring_size;
+
+  /// Release the space to the kernel only after the records were copied.
+  std::atomic_thread_fence(std::memory_order_release);
+  mmap_page->data_tail = head;
+
+  return true;
+}
+
+bool
+perf::RawSpillWriter::close()
+{
+  if (this->_file_descriptor < 0) {
+    return false;
+  }
+
+  const auto is_drained = this->drain();
+
+  /// Complete the header with the size of the data.
+  const auto is_written =
+    ::pwrite(this->_file_descriptor, &this->_header, sizeof(raw_spill::file_header), 0) ==
+    static_cast<ssize_t>(sizeof(raw_spill::file_header));
+
+  const auto is_closed = ::close(this->_file_descriptor) == 0;
+  this->_file_descriptor = -1;
+
+  return is_drained && is_written && is_closed;
+}
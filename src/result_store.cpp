@@ -0,0 +1,574 @@
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <perfcpp/output_buffer.h>
+#include <perfcpp/result_store.h>
+#include <perfcpp/system_info.h>
+#include <sstream>
+
+/**
+ * Appends the number to the line (shortest representation that reads back to the same value); non-finite values
+ * are appended as null.
+ */
+static void
+append_number(perf::OutputBuffer& line, const double value)
+{
+  if (std::isfinite(value)) {
+    line.append(value);
+  } else {
+    line.append("null");
+  }
+}
+
+/**
+ * Appends the code point to the string, encoded as UTF-8.
+ */
+static void
+append_utf8(std::string& string, const std::uint32_t code_point)
+{
+  if (code_point < 0x80U) {
+    string += char(code_point);
+  } else if (code_point < 0x800U) {
+    string += char(0xC0U | (code_point >> 6U));
+    string += char(0x80U | (code_point & 0x3FU));
+  } else if (code_point < 0x10000U) {
+    string += char(0xE0U | (code_point >> 12U));
+    string += char(0x80U | ((code_point >> 6U) & 0x3FU));
+    string += char(0x80U | (code_point & 0x3FU));
+  } else {
+    string += char(0xF0U | (code_point >> 18U));
+    string += char(0x80U | ((code_point >> 12U) & 0x3FU));
+    string += char(0x80U | ((code_point >> 6U) & 0x3FU));
+    string += char(0x80U | (code_point & 0x3FU));
+  }
+}
+
+/**
+ * Parses the four hex digits of an escaped UTF-16 code unit.
+ */
+static std::optional<std::uint32_t>
+parse_code_unit(std::string_view& json)
+{
+  auto code_unit = std::uint32_t{ 0U };
+  if (json.size() < 4U || std::from_chars(json.data(), json.data() + 4U, code_unit, 16).ptr != json.data() + 4U) {
+    return std::nullopt;
+  }
+  json.remove_prefix(4U);
+
+  return code_unit;
+}
+
+static void
+skip_whitespace(std::string_view& json) noexcept
+{
+  const auto begin = json.find_first_not_of(" \t\n\r");
+  json.remove_prefix(begin != std::string_view::npos ? begin : json.size());
+}
+
+/**
+ * Consumes the given character (after whitespace), if it is the next one.
+ */
+static bool
+consume(std::string_view& json, const char character) noexcept
+{
+  skip_whitespace(json);
+  if (!json.empty() && json.front() == character) {
+    json.remove_prefix(1U);
+    return true;
+  }
+
+  return false;
+}
+
+static std::optional<std::string>
+parse_string(std::string_view& json)
+{
+  if (!consume(json, '"')) {
+    return std::nullopt;
+  }
+
+  auto string = std::string{};
+  while (!json.empty() && json.front() != '"') {
+    if (json.front() != '\\') {
+      string += json.front();
+      json.remove_prefix(1U);
+      continue;
+    }
+
+    if (json.size() < 2U) {
+      return std::nullopt;
+    }
+    const auto escaped = json[1U];
+    json.remove_prefix(2U);
+    switch (escaped) {
+      case 'b':
+        string += '\b';
+        break;
+      case 'f':
+        string += '\f';
+        break;
+      case 'n':
+        string += '\n';
+        break;
+      case 'r':
+        string += '\r';
+        break;
+      case 't':
+        string += '\t';
+        break;
+      case 'u': {
+        auto code_point = parse_code_unit(json);
+        if (!code_point.has_value()) {
+          return std::nullopt;
+        }
+
+        /// Code points beyond the basic multilingual plane are escaped as a pair of UTF-16 surrogates.
+        if (*code_point >= 0xD800U && *code_point < 0xDC00U) {
+          if (json.substr(0U, 2U) != "\\u") {
+            return std::nullopt;
+          }
+          json.remove_prefix(2U);
+          const auto low_surrogate = parse_code_unit(json);
+          if (!low_surrogate.has_value() || *low_surrogate < 0xDC00U || *low_surrogate >= 0xE000U) {
+            return std::nullopt;
+          }
+          code_point = 0x10000U + ((*code_point - 0xD800U) << 10U) + (*low_surrogate - 0xDC00U);
+        } else if (*code_point >= 0xDC00U && *code_point < 0xE000U) {
+          return std::nullopt;
+        }
+
+        append_utf8(string, code_point.value());
+        break;
+      }
+      default:
+        string += escaped;
+    }
+  }
+
+  if (!consume(json, '"')) {
+    return std::nullopt;
+  }
+
+  return string;
+}
+
+/**
+ * Parses a number; null is parsed as NaN.
+ */
+static std::optional<double>
+parse_number(std::string_view& json)
+{
+  skip_whitespace(json);
+  if (json.substr(0U, 4U) == "null") {
+    json.remove_prefix(4U);
+    return std::numeric_limits<double>::quiet_NaN();
+  }
+
+  auto value = .0;
+  const auto [end, error] = std::from_chars(json.data(), json.data() + json.size(), value);
+  if (error != std::errc{}) {
+    return std::nullopt;
+  }
+  json.remove_prefix(std::size_t(end - json.data()));
+
+  return value;
+}
+
+/**
+ * Parses an object, calling the callback with the key of every member; the callback parses the value.
+ */
+template <typename F>
+static bool
+parse_object(std::string_view& json, F&& parse_member)
+{
+  if (!consume(json, '{')) {
+    return false;
+  }
+  if (consume(json, '}')) {
+    return true;
+  }
+
+  do {
+    auto key = parse_string(json);
+    if (!key.has_value() || !consume(json, ':') || !parse_member(key.value(), json)) {
+      return false;
+    }
+  } while (consume(json, ','));
+
+  return consume(json, '}');
+}
+
+/**
+ * Skips a value of any type (e.g., of unknown members).
+ */
+static bool
+skip_value(std::string_view& json)
+{
+  skip_whitespace(json);
+  if (json.empty()) {
+    return false;
+  }
+
+  if (json.front() == '"') {
+    return parse_string(json).has_value();
+  }
+  if (json.front() == '{') {
+    return parse_object(json, [](const std::string&, std::string_view& value) { return skip_value(value); });
+  }
+  if (json.front() == '[') {
+    json.remove_prefix(1U);
+    if (consume(json, ']')) {
+      return true;
+    }
+    do {
+      if (!skip_value(json)) {
+        return false;
+      }
+    } while (consume(json, ','));
+    return consume(json, ']');
+  }
+  for (const auto literal : { std::string_view{ "true" }, std::string_view{ "false" } }) {
+    if (json.substr(0U, literal.size()) == literal) {
+      json.remove_prefix(literal.size());
+      return true;
+    }
+  }
+
+  return parse_number(json).has_value();
+}
+
+/**
+ * Parses a single line of the store.
+ */
+static std::optional<perf::StoredResult>
+parse_line(std::string_view json)
+{
+  auto benchmark = std::optional<std::string>{};
+  auto timestamp = std::uint64_t{ 0U };
+  auto metadata = std::array<std::string, 4U>{};
+  auto values = std::optional<std::vector<std::pair<std::string, double>>>{};
+
+  const auto is_parsed = parse_object(json, [&](const std::string& key, std::string_view& value) {
+    if (key == "benchmark") {
+      benchmark = parse_string(value);
+      return benchmark.has_value();
+    }
+
+    if (key == "timestamp") {
+      const auto number = parse_number(value);
+      timestamp = number.has_value() && *number >= .0 ? std::uint64_t(*number) : 0U;
+      return number.has_value();
+    }
+
+    if (key == "metadata") {
+      return parse_object(value, [&metadata](const std::string& metadata_key, std::string_view& metadata_value) {
+        constexpr auto keys = std::array<std::string_view, 4U>{ "cpu_model", "kernel", "git_sha", "config" };
+        const auto iterator = std::find(keys.begin(), keys.end(), metadata_key);
+        if (iterator == keys.end()) {
+          return skip_value(metadata_value);
+        }
+
+        auto string = parse_string(metadata_value);
+        if (string.has_value()) {
+          metadata[std::size_t(std::distance(keys.begin(), iterator))] = std::move(string.value());
+        }
+        return string.has_value();
+      });
+    }
+
+    if (key == "values") {
+      const auto begin = value;
+      if (!skip_value(value)) {
+        return false;
+      }
+      values = perf::ResultStore::parse_values(begin.substr(0U, begin.size() - value.size()));
+      return values.has_value();
+    }
+
+    return skip_value(value);
+  });
+
+  if (!is_parsed || !benchmark.has_value() || !values.has_value()) {
+    return std::nullopt;
+  }
+
+  return perf::StoredResult{ std::move(benchmark.value()),
+                             perf::RunMetadata{ timestamp,
+                                                std::move(metadata[0U]),
+                                                std::move(metadata[1U]),
+                                                std::move(metadata[2U]),
+                                                std::move(metadata[3U]) },
+                             std::move(values.value()) };
+}
+
+perf::RunMetadata
+perf::RunMetadata::current(std::string git_sha, std::string config)
+{
+  const auto timestamp =
+    std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+
+  return RunMetadata{ std::uint64_t(timestamp),
+                      SystemInfo::cpu_model(),
+                      SystemInfo::kernel_release(),
+                      std::move(git_sha),
+                      std::move(config) };
+}
+
+std::optional<double>
+perf::StoredResult::get(const std::string_view name) const noexcept
+{
+  if (auto iterator = std::find_if(
+        this->_values.begin(), this->_values.end(), [name](const auto& value) { return value.first == name; });
+      iterator != this->_values.end()) {
+    return iterator->second;
+  }
+
+  return std::nullopt;
+}
+
+bool
+perf::ResultStore::append(const std::string_view benchmark,
+                          const std::vector<std::pair<std::string, double>>& values,
+                          const RunMetadata& metadata) const
+{
+  auto line = OutputBuffer{ 256U };
+  line.append("{\"benchmark\":");
+  line.append_json_string(benchmark);
+  line.append(",\"timestamp\":");
+  line.append(metadata.timestamp());
+
+  line.append(",\"metadata\":{\"cpu_model\":");
+  line.append_json_string(metadata.cpu_model());
+  line.append(",\"kernel\":");
+  line.append_json_string(metadata.kernel());
+  line.append(",\"git_sha\":");
+  line.append_json_string(metadata.git_sha());
+  line.append(",\"config\":");
+  line.append_json_string(metadata.config());
+
+  line.append("},\"values\":{");
+  for (auto i = 0U; i < values.size(); ++i) {
+    if (i > 0U) {
+      line.append(',');
+    }
+    line.append_json_string(values[i].first);
+    line.append(':');
+    append_number(line, values[i].second);
+  }
+  line.append("}}\n");
+
+  /// Write the line at once, such that concurrent writers append complete lines.
+  auto file = std::ofstream{ this->_file_name, std::ios::app };
+  if (!file.is_open()) {
+    return false;
+  }
+  file.write(line.view().data(), std::streamsize(line.view().size()));
+  file.flush();
+
+  return file.good();
+}
+
+bool
+perf::ResultStore::append(const std::string_view benchmark,
+                          const CounterResult& result,
+                          const RunMetadata& metadata) const
+{
+  auto values = std::vector<std::pair<std::string, double>>{};
+  for (const auto& [name, value] : result) {
+    values.emplace_back(std::string{ name }, value);
+  }
+
+  return this->append(benchmark, values, metadata);
+}
+
+bool
+perf::ResultStore::append(const std::string_view benchmark,
+                          const BenchmarkResult& result,
+                          const RunMetadata& metadata) const
+{
+  auto values = std::vector<std::pair<std::string, double>>{};
+  for (const auto& [name, statistics] : result) {
+    values.emplace_back(std::string{ name }, statistics.median());
+  }
+  values.emplace_back("time (ns)", result.time().median());
+
+  return this->append(benchmark, values, metadata);
+}
+
+std::vector<perf::StoredResult>
+perf::ResultStore::read() const
+{
+  auto results = std::vector<StoredResult>{};
+
+  auto file = std::ifstream{ this->_file_name };
+  auto line = std::string{};
+  while (std::getline(file, line)) {
+    if (auto result = parse_line(line); result.has_value()) {
+      results.push_back(std::move(result.value()));
+    }
+  }
+
+  return results;
+}
+
+std::vector<perf::StoredResult>
+perf::ResultStore::read(const std::string_view benchmark) const
+{
+  auto results = this->read();
+  results.erase(std::remove_if(results.begin(),
+                               results.end(),
+                               [benchmark](const auto& result) { return result.benchmark() != benchmark; }),
+                results.end());
+
+  return results;
+}
+
+std::optional<std::vector<std::pair<std::string, double>>>
+perf::ResultStore::parse_values(std::string_view json)
+{
+  auto values = std::vector<std::pair<std::string, double>>{};
+  const auto is_parsed = parse_object(json, [&values](const std::string& key, std::string_view& value) {
+    const auto number = parse_number(value);
+    if (number.has_value()) {
+      values.emplace_back(key, number.value());
+    }
+    return number.has_value();
+  });
+
+  skip_whitespace(json);
+  if (!is_parsed || !json.empty()) {
+    return std::nullopt;
+  }
+
+  return values;
+}
+
+std::string_view
+perf::RegressionCheck::to_string(const Verdict verdict) noexcept
+{
+  switch (verdict) {
+    case Verdict::Regression:
+      return "regression";
+    case Verdict::Improvement:
+      return "improvement";
+    case Verdict::Unchanged:
+      return "unchanged";
+    case Verdict::InsufficientHistory:
+      return "insufficient history";
+  }
+
+  return "";
+}
+
+bool
+perf::RegressionReport::has_regression() const noexcept
+{
+  return std::any_of(this->_checks.begin(), this->_checks.end(), [](const auto& check) {
+    return check.verdict() == RegressionCheck::Verdict::Regression;
+  });
+}
+
+std::string
+perf::RegressionReport::to_string() const
+{
+  auto stream = std::stringstream{};
+  stream << std::fixed << std::setprecision(2);
+
+  stream << this->_benchmark << " (git sha '" << this->_metadata.git_sha() << "', " << this->_count_baseline_runs
+         << " baseline runs)\n";
+  stream << std::setw(32) << std::left << "counter" << std::right << std::setw(16) << "value" << std::setw(16)
+         << "baseline" << std::setw(12) << "change" << std::setw(10) << "score"
+         << "  verdict\n";
+
+  for (const auto& check : this->_checks) {
+    stream << std::setw(32) << std::left << check.name() << std::right << std::setw(16) << check.value()
+           << std::setw(16) << check.baseline() << std::setw(11) << check.relative_change() * 100. << "%"
+           << std::setw(10) << check.score() << "  " << RegressionCheck::to_string(check.verdict()) << "\n";
+  }
+
+  return stream.str();
+}
+
+std::optional<perf::RegressionReport>
+perf::RegressionDetector::check(const std::vector<StoredResult>& history, const std::string_view benchmark) const
+{
+  const auto latest = std::find_if(
+    history.rbegin(), history.rend(), [benchmark](const auto& result) { return result.benchmark() == benchmark; });
+  if (latest == history.rend()) {
+    return std::nullopt;
+  }
+
+  /// The baseline consists of the preceding runs on the same CPU model with the same configuration.
+  auto baseline = std::vector<const StoredResult*>{};
+  for (auto iterator = std::next(latest); iterator != history.rend() && baseline.size() < this->_window; ++iterator) {
+    if (iterator->benchmark() == benchmark && iterator->metadata().cpu_model() == latest->metadata().cpu_model() &&
+        iterator->metadata().config() == latest->metadata().config()) {
+      baseline.push_back(&*iterator);
+    }
+  }
+
+  auto checks = std::vector<RegressionCheck>{};
+  for (const auto& [name, value] : *latest) {
+    auto baseline_values = std::vector<double>{};
+    for (const auto* result : baseline) {
+      if (const auto baseline_value = result->get(name); baseline_value.has_value() && std::isfinite(*baseline_value)) {
+        baseline_values.push_back(baseline_value.value());
+      }
+    }
+
+    if (baseline_values.size() < std::max(this->_min_baseline_runs, std::size_t{ 1U }) || !std::isfinite(value)) {
+      const auto median = !baseline_values.empty() ? Statistics{ baseline_values }.median()
+                                                   : std::numeric_limits<double>::quiet_NaN();
+      checks.emplace_back(name,
+                          value,
+                          median,
+                          std::numeric_limits<double>::quiet_NaN(),
+                          std::numeric_limits<double>::quiet_NaN(),
+                          RegressionCheck::Verdict::InsufficientHistory);
+      continue;
+    }
+
+    /// Robust location and scale of the baseline: median and median absolute deviation.
+    const auto median = Statistics{ baseline_values }.median();
+    for (auto& baseline_value : baseline_values) {
+      baseline_value = std::abs(baseline_value - median);
+    }
+    const auto deviation = 1.4826 * Statistics{ std::move(baseline_values) }.median();
+
+    /// Positive differences are worse than the baseline.
+    const auto is_higher_better =
+      std::find(this->_higher_is_better.begin(), this->_higher_is_better.end(), name) != this->_higher_is_better.end();
+    const auto worse_difference = is_higher_better ? median - value : value - median;
+
+    auto relative_change = .0;
+    if (median != .0) {
+      relative_change = (value - median) / std::abs(median);
+    } else if (value != .0) {
+      relative_change = std::copysign(std::numeric_limits<double>::infinity(), value);
+    }
+    const auto worse_relative_change = is_higher_better ? -relative_change : relative_change;
+
+    auto score = .0;
+    if (deviation > .0) {
+      score = worse_difference / deviation;
+    } else if (worse_difference != .0) {
+      score = std::copysign(std::numeric_limits<double>::infinity(), worse_difference);
+    }
+
+    auto verdict = RegressionCheck::Verdict::Unchanged;
+    if (score > this->_threshold && worse_relative_change > this->_min_relative_change) {
+      verdict = RegressionCheck::Verdict::Regression;
+    } else if (score < -this->_threshold && worse_relative_change < -this->_min_relative_change) {
+      verdict = RegressionCheck::Verdict::Improvement;
+    }
+
+    checks.emplace_back(name, value, median, relative_change, score, verdict);
+  }
+
+  return RegressionReport{ latest->benchmark(), latest->metadata(), baseline.size(), std::move(checks) };
+}
@@ -0,0 +1,504 @@
+#include <cstddef>
+#include <perfcpp/sample_decoder.h>
+
+/// Sample types and flags introduced by newer Linux Kernels; defined by value to decode records of any origin.
+constexpr static auto SAMPLE_AUX = std::uint64_t(1U) << 20U;
+constexpr static auto SAMPLE_CGROUP = std::uint64_t(1U) << 21U;
+constexpr static auto SAMPLE_DATA_PAGE_SIZE = std::uint64_t(1U) << 22U;
+constexpr static auto SAMPLE_CODE_PAGE_SIZE = std::uint64_t(1U) << 23U;
+constexpr static auto SAMPLE_WEIGHT_STRUCT = std::uint64_t(1U) << 24U;
+constexpr static auto SAMPLE_BRANCH_HW_INDEX = std::uint64_t(1U) << 17U;
+constexpr static auto FORMAT_LOST = std::uint64_t(1U) << 4U;
+constexpr static auto RECORD_SWITCH = std::uint32_t{ 14U };
+constexpr static auto RECORD_SWITCH_CPU_WIDE = std::uint32_t{ 15U };
+constexpr static auto RECORD_MISC_SWITCH_OUT = std::uint16_t(1U << 13U);
+constexpr static auto RECORD_MISC_SWITCH_OUT_PREEMPT = std::uint16_t(1U << 14U);
+
+bool
+perf::SampleDecoder::is_context_switch(const perf_event_header& record) noexcept
+{
+  return record.type == RECORD_SWITCH || record.type == RECORD_SWITCH_CPU_WIDE;
+}
+
+perf::Sample
+perf::SampleDecoder::decode(const perf_event_header& record) const
+{
+  auto mode = Sample::Mode::Unknown;
+  if (static_cast<bool>(record.misc & PERF_RECORD_MISC_KERNEL)) {
+    mode = Sample::Mode::Kernel;
+  } else if (static_cast<bool>(record.misc & PERF_RECORD_MISC_USER)) {
+    mode = Sample::Mode::User;
+  } else if (static_cast<bool>(record.misc & PERF_RECORD_MISC_HYPERVISOR)) {
+    mode = Sample::Mode::Hypervisor;
+  } else if (static_cast<bool>(record.misc & PERF_RECORD_MISC_GUEST_KERNEL)) {
+    mode = Sample::Mode::GuestKernel;
+  } else if (static_cast<bool>(record.misc & PERF_RECORD_MISC_GUEST_USER)) {
+    mode = Sample::Mode::GuestUser;
+  }
+
+  auto sample = Sample{ mode };
+
+  if (SampleDecoder::is_context_switch(record)) {
+    this->decode_context_switch(record, sample);
+    return sample;
+  }
+
+  auto sample_ptr = std::uintptr_t(reinterpret_cast<const void*>(&record + 1U));
+  const auto record_end = std::uintptr_t(reinterpret_cast<const void*>(&record)) + record.size;
+
+  /// Fields are only read if they are located within the record; decoding stops at the first field of a corrupted (or
+  /// truncated) record that exceeds the record.
+  const auto is_in_record = [&sample_ptr, record_end](const std::uint64_t size) {
+    return sample_ptr <= record_end && size <= record_end - sample_ptr;
+  };
+
+  /// Fields up to the read format have a fixed size.
+  auto fixed_size = std::uint64_t{ 0U };
+  for (const auto type : { PERF_SAMPLE_IDENTIFIER,
+                           PERF_SAMPLE_IP,
+                           PERF_SAMPLE_TID,
+                           PERF_SAMPLE_TIME,
+                           PERF_SAMPLE_ADDR,
+                           PERF_SAMPLE_ID,
+                           PERF_SAMPLE_STREAM_ID,
+                           PERF_SAMPLE_CPU,
+                           PERF_SAMPLE_PERIOD }) {
+    if (this->_sample_type & type) {
+      fixed_size += sizeof(std::uint64_t);
+    }
+  }
+  if (!is_in_record(fixed_size)) {
+    return sample;
+  }
+
+  if (this->_sample_type & PERF_SAMPLE_IDENTIFIER) {
+    sample.sample_id(*reinterpret_cast<const std::uint64_t*>(sample_ptr));
+    sample_ptr += sizeof(std::uint64_t);
+  }
+
+  if (this->_sample_type & PERF_SAMPLE_IP) {
+    sample.instruction_pointer(*reinterpret_cast<const std::uintptr_t*>(sample_ptr));
+    sample_ptr += sizeof(std::uint64_t);
+  }
+
+  if (this->_sample_type & PERF_SAMPLE_TID) {
+    sample.process_id(*reinterpret_cast<const std::uint32_t*>(sample_ptr));
+    sample_ptr += sizeof(std::uint32_t);
+
+    sample.thread_id(*reinterpret_cast<const std::uint32_t*>(sample_ptr));
+    sample_ptr += sizeof(std::uint32_t);
+  }
+
+  if (this->_sample_type & PERF_SAMPLE_TIME) {
+    sample.timestamp(*reinterpret_cast<const std::uint64_t*>(sample_ptr));
+    sample_ptr += sizeof(std::uint64_t);
+  }
+
+  if (this->_sample_type & PERF_SAMPLE_ADDR) {
+    sample.logical_memory_address(*reinterpret_cast<const std::uint64_t*>(sample_ptr));
+    sample_ptr += sizeof(std::uint64_t);
+  }
+
+  if (this->_sample_type & PERF_SAMPLE_ID) {
+    sample.id(*reinterpret_cast<const std::uint64_t*>(sample_ptr));
+    sample_ptr += sizeof(std::uint64_t);
+  }
+
+  if (this->_sample_type & PERF_SAMPLE_STREAM_ID) {
+    sample_ptr += sizeof(std::uint64_t);
+  }
+
+  if (this->_sample_type & PERF_SAMPLE_CPU) {
+    sample.cpu_id(*reinterpret_cast<const std::uint32_t*>(sample_ptr));
+    sample_ptr += sizeof(std::uint64_t);
+  }
+
+  if (this->_sample_type & PERF_SAMPLE_PERIOD) {
+    sample.period(*reinterpret_cast<const std::uint64_t*>(sample_ptr));
+    sample_ptr += sizeof(std::uint64_t);
+  }
+
+  if (this->_sample_type & PERF_SAMPLE_READ) {
+    if (!this->decode_counter_values(sample, sample_ptr, record_end)) {
+      return sample;
+    }
+  }
+
+  if (this->_sample_type & PERF_SAMPLE_CALLCHAIN) {
+    if (!is_in_record(sizeof(std::uint64_t))) {
+      return sample;
+    }
+    const auto callchain_size = (*reinterpret_cast<const std::uint64_t*>(sample_ptr));
+    sample_ptr += sizeof(std::uint64_t);
+
+    if (callchain_size > (record_end - sample_ptr) / sizeof(std::uint64_t)) {
+      return sample;
+    }
+
+    if (callchain_size > 0U) {
+      auto callchain = std::vector<std::uintptr_t>{};
+      callchain.reserve(callchain_size);
+
+      const auto* instruction_pointers = reinterpret_cast<const std::uint64_t*>(sample_ptr);
+      for (auto index = 0U; index < callchain_size; ++index) {
+        callchain.push_back(std::uintptr_t{ instruction_pointers[index] });
+      }
+
+      sample.callchain(std::move(callchain));
+
+      sample_ptr += callchain_size * sizeof(std::uint64_t);
+    }
+  }
+
+  if (this->_sample_type & PERF_SAMPLE_RAW) {
+    /// The size includes padding, such that size and data are aligned to 8 bytes.
+    if (!is_in_record(sizeof(std::uint32_t))) {
+      return sample;
+    }
+    const auto raw_size = *reinterpret_cast<const std::uint32_t*>(sample_ptr);
+    sample_ptr += sizeof(std::uint32_t);
+
+    if (!is_in_record(raw_size)) {
+      return sample;
+    }
+    sample_ptr += raw_size;
+  }
+
+  if (this->_sample_type & PERF_SAMPLE_BRANCH_STACK) {
+    const auto hw_index_size = (this->_branch_sample_type & SAMPLE_BRANCH_HW_INDEX) ? sizeof(std::uint64_t) : 0U;
+    if (!is_in_record(sizeof(std::uint64_t) + hw_index_size)) {
+      return sample;
+    }
+    const auto count_branches = *reinterpret_cast<const std::uint64_t*>(sample_ptr);
+    sample_ptr += sizeof(std::uint64_t) + hw_index_size;
+
+    if (count_branches > (record_end - sample_ptr) / sizeof(perf_branch_entry)) {
+      return sample;
+    }
+
+    if (count_branches > 0U) {
+      auto branches = std::vector<Branch>{};
+      branches.reserve(count_branches);
+
+      const auto* sampled_branches = reinterpret_cast<const perf_branch_entry*>(sample_ptr);
+      for (auto i = 0U; i < count_branches; ++i) {
+        const auto& branch = sampled_branches[i];
+        branches.emplace_back(branch.from,
+                              branch.to,
+                              branch.mispred,
+                              branch.predicted,
+                              branch.in_tx,
+                              branch.abort,
+                              branch.cycles,
+                              std::uint8_t(branch.type));
+      }
+
+      sample.branches(std::move(branches));
+    }
+
+    sample_ptr += sizeof(perf_branch_entry) * count_branches;
+  }
+
+  if (this->_sample_type & PERF_SAMPLE_REGS_USER) {
+    auto registers = SampleDecoder::decode_registers(sample_ptr, record_end, this->_count_user_registers);
+    if (!registers.has_value()) {
+      return sample;
+    }
+
+    auto& [abi, user_registers] = registers.value();
+    sample.user_registers_abi(abi);
+    if (!user_registers.empty()) {
+      sample.user_registers(std::move(user_registers));
+    }
+  }
+
+  if (this->_sample_type & PERF_SAMPLE_STACK_USER) {
+    if (!is_in_record(sizeof(std::uint64_t))) {
+      return sample;
+    }
+    const auto stack_size = *reinterpret_cast<const std::uint64_t*>(sample_ptr);
+    sample_ptr += sizeof(std::uint64_t);
+
+    /// The dynamic size is only present for a non-empty stack.
+    const auto dynamic_size_size = stack_size > 0U ? sizeof(std::uint64_t) : 0U;
+    if (stack_size > record_end - sample_ptr || !is_in_record(stack_size + dynamic_size_size)) {
+      return sample;
+    }
+    sample_ptr += stack_size + dynamic_size_size;
+  }
+
+  if ((this->_sample_type & (PERF_SAMPLE_WEIGHT | SAMPLE_WEIGHT_STRUCT)) && !is_in_record(sizeof(std::uint64_t))) {
+    return sample;
+  }
+
+  if (this->_sample_type & PERF_SAMPLE_WEIGHT) {
+    sample.weight(perf::Weight{ std::uint32_t(*reinterpret_cast<const std::uint64_t*>(sample_ptr)) });
+    sample_ptr += sizeof(std::uint64_t);
+  } else if (this->_sample_type & SAMPLE_WEIGHT_STRUCT) {
+    /// The weight struct holds a 32-bit and two 16-bit values (var1_dw, var2_w, var3_w).
+    const auto var1 = *reinterpret_cast<const std::uint32_t*>(sample_ptr);
+    const auto var2 = *reinterpret_cast<const std::uint16_t*>(sample_ptr + sizeof(std::uint32_t));
+    const auto var3 =
+      *reinterpret_cast<const std::uint16_t*>(sample_ptr + sizeof(std::uint32_t) + sizeof(std::uint16_t));
+    sample.weight(perf::Weight{ var1, var2, var3 });
+
+    sample_ptr += sizeof(std::uint64_t);
+  }
+
+  if ((this->_sample_type & PERF_SAMPLE_DATA_SRC) && !is_in_record(sizeof(std::uint64_t))) {
+    return sample;
+  }
+
+  if (this->_sample_type & PERF_SAMPLE_DATA_SRC) {
+    sample.data_src(perf::DataSource{ *reinterpret_cast<const std::uint64_t*>(sample_ptr) });
+    sample_ptr += sizeof(std::uint64_t);
+  }
+
+  if (this->_sample_type & PERF_SAMPLE_TRANSACTION) {
+    sample_ptr += sizeof(std::uint64_t);
+  }
+
+  if (this->_sample_type & PERF_SAMPLE_REGS_INTR) {
+    auto registers = SampleDecoder::decode_registers(sample_ptr, record_end, this->_count_kernel_registers);
+    if (!registers.has_value()) {
+      return sample;
+    }
+
+    auto& [abi, kernel_registers] = registers.value();
+    sample.kernel_registers_abi(abi);
+    if (!kernel_registers.empty()) {
+      sample.kernel_registers(std::move(kernel_registers));
+    }
+  }
+
+  /// The remaining fields have a fixed size.
+  fixed_size = 0U;
+  for (const auto type : { std::uint64_t(PERF_SAMPLE_PHYS_ADDR),
+                           SAMPLE_CGROUP,
+                           SAMPLE_DATA_PAGE_SIZE,
+                           SAMPLE_CODE_PAGE_SIZE }) {
+    if (this->_sample_type & type) {
+      fixed_size += sizeof(std::uint64_t);
+    }
+  }
+  if (!is_in_record(fixed_size)) {
+    return sample;
+  }
+
+  if (this->_sample_type & PERF_SAMPLE_PHYS_ADDR) {
+    sample.physical_memory_address(*reinterpret_cast<const std::uint64_t*>(sample_ptr));
+    sample_ptr += sizeof(std::uint64_t);
+  }
+
+  if (this->_sample_type & SAMPLE_CGROUP) {
+    sample_ptr += sizeof(std::uint64_t);
+  }
+
+  if (this->_sample_type & SAMPLE_DATA_PAGE_SIZE) {
+    sample.data_page_size(*reinterpret_cast<const std::uint64_t*>(sample_ptr));
+    sample_ptr += sizeof(std::uint64_t);
+  }
+
+  if (this->_sample_type & SAMPLE_CODE_PAGE_SIZE) {
+    sample.code_page_size(*reinterpret_cast<const std::uint64_t*>(sample_ptr));
+    sample_ptr += sizeof(std::uint64_t);
+  }
+
+  /// PERF_SAMPLE_AUX is the last field and not decoded.
+  static_cast<void>(SAMPLE_AUX);
+
+  return sample;
+}
+
+bool
+perf::SampleDecoder::decode_counter_values(Sample& sample,
+                                           std::uintptr_t& sample_ptr,
+                                           const std::uintptr_t record_end) const
+{
+  /// Number of values per counter and of the values in front of the counters.
+  const auto count_values_per_counter = 1U + static_cast<std::uint64_t>((this->_read_format & PERF_FORMAT_ID) != 0U) +
+                                        static_cast<std::uint64_t>((this->_read_format & FORMAT_LOST) != 0U);
+  const auto count_time_values =
+    static_cast<std::uint64_t>((this->_read_format & PERF_FORMAT_TOTAL_TIME_ENABLED) != 0U) +
+    static_cast<std::uint64_t>((this->_read_format & PERF_FORMAT_TOTAL_TIME_RUNNING) != 0U);
+  const auto count_available_values =
+    sample_ptr <= record_end ? std::uint64_t((record_end - sample_ptr) / sizeof(std::uint64_t)) : 0U;
+
+  auto count_counters = std::uint64_t{ 1U };
+  if (this->_read_format & PERF_FORMAT_GROUP) {
+    if (count_available_values < 1U) {
+      return false;
+    }
+    count_counters = *reinterpret_cast<const std::uint64_t*>(sample_ptr);
+  }
+
+  const auto count_prefix_values = static_cast<std::uint64_t>((this->_read_format & PERF_FORMAT_GROUP) != 0U) +
+                                   count_time_values;
+  if (count_available_values < count_prefix_values ||
+      count_counters > (count_available_values - count_prefix_values) / count_values_per_counter) {
+    return false;
+  }
+
+  const auto read_value = [&sample_ptr]() {
+    const auto value = *reinterpret_cast<const std::uint64_t*>(sample_ptr);
+    sample_ptr += sizeof(std::uint64_t);
+    return value;
+  };
+
+  /// Looks up the name of a counter by its id or, if the read format has no ids, by its index.
+  const auto counter_name = [this](const std::uint64_t index,
+                                   const std::uint64_t id) -> std::optional<std::string_view> {
+    if (this->_read_format & PERF_FORMAT_ID) {
+      for (const auto& [counter_id, name] : this->_counter_names) {
+        if (counter_id == id) {
+          return name;
+        }
+      }
+      return std::nullopt;
+    }
+
+    return index < this->_counter_names.size() ? std::make_optional(this->_counter_names[index].second)
+                                               : std::nullopt;
+  };
+
+  auto counter_values = std::vector<std::pair<std::string_view, double>>{};
+
+  if (this->_read_format & PERF_FORMAT_GROUP) {
+    const auto count_members = read_value();
+
+    if (this->_read_format & PERF_FORMAT_TOTAL_TIME_ENABLED) {
+      sample_ptr += sizeof(std::uint64_t);
+    }
+    if (this->_read_format & PERF_FORMAT_TOTAL_TIME_RUNNING) {
+      sample_ptr += sizeof(std::uint64_t);
+    }
+
+    for (auto index = 0U; index < count_members; ++index) {
+      const auto value = read_value();
+      const auto id = (this->_read_format & PERF_FORMAT_ID) ? read_value() : 0U;
+      if (this->_read_format & FORMAT_LOST) {
+        sample_ptr += sizeof(std::uint64_t);
+      }
+
+      if (const auto name = counter_name(index, id); name.has_value()) {
+        counter_values.emplace_back(name.value(), double(value));
+      }
+    }
+  } else {
+    const auto value = read_value();
+
+    if (this->_read_format & PERF_FORMAT_TOTAL_TIME_ENABLED) {
+      sample_ptr += sizeof(std::uint64_t);
+    }
+    if (this->_read_format & PERF_FORMAT_TOTAL_TIME_RUNNING) {
+      sample_ptr += sizeof(std::uint64_t);
+    }
+
+    const auto id = (this->_read_format & PERF_FORMAT_ID) ? read_value() : 0U;
+    if (this->_read_format & FORMAT_LOST) {
+      sample_ptr += sizeof(std::uint64_t);
+    }
+
+    if (const auto name = counter_name(0U, id); name.has_value()) {
+      counter_values.emplace_back(name.value(), double(value));
+    }
+  }
+
+  if (!counter_values.empty()) {
+    sample.counter_result(CounterResult{ std::move(counter_values) });
+  }
+
+  return true;
+}
+
+std::optional<std::pair<std::uint64_t, std::vector<std::uint64_t>>>
+perf::SampleDecoder::decode_registers(std::uintptr_t& sample_ptr,
+                                      const std::uintptr_t record_end,
+                                      const std::uint64_t count_registers)
+{
+  if (sample_ptr > record_end || record_end - sample_ptr < sizeof(std::uint64_t)) {
+    return std::nullopt;
+  }
+  const auto abi = *reinterpret_cast<const std::uint64_t*>(sample_ptr);
+  sample_ptr += sizeof(std::uint64_t);
+
+  /// Register values are only recorded if the ABI is known (i.e., not PERF_SAMPLE_REGS_ABI_NONE).
+  auto registers = std::vector<std::uint64_t>{};
+  if (abi != PERF_SAMPLE_REGS_ABI_NONE && count_registers > 0U) {
+    if (count_registers > (record_end - sample_ptr) / sizeof(std::uint64_t)) {
+      return std::nullopt;
+    }
+
+    const auto* values = reinterpret_cast<const std::uint64_t*>(sample_ptr);
+    registers.assign(values, values + count_registers);
+
+    sample_ptr += sizeof(std::uint64_t) * count_registers;
+  }
+
+  return std::make_pair(abi, std::move(registers));
+}
+
+void
+perf::SampleDecoder::decode_context_switch(const perf_event_header& record, Sample& sample) const
+{
+  const auto is_out = static_cast<bool>(record.misc & RECORD_MISC_SWITCH_OUT);
+  const auto is_preempt = static_cast<bool>(record.misc & RECORD_MISC_SWITCH_OUT_PREEMPT);
+
+  const auto* record_begin = reinterpret_cast<const std::byte*>(&record);
+  const auto* record_end = record_begin + record.size;
+
+  /// CPU-wide records name the next (when switching out) or previous (when switching in) process and thread.
+  if (record.type == RECORD_SWITCH_CPU_WIDE && record.size >= sizeof(perf_event_header) + 2U * sizeof(std::uint32_t)) {
+    const auto* ids = reinterpret_cast<const std::uint32_t*>(&record + 1U);
+    sample.context_switch(ContextSwitch{ is_out, is_preempt, ids[0U], ids[1U] });
+  } else {
+    sample.context_switch(ContextSwitch{ is_out, is_preempt });
+  }
+
+  /// The sample id fields (sample_id_all) are located at the end of the record.
+  auto sample_id_size = std::size_t{ 0U };
+  for (const auto type : { PERF_SAMPLE_TID,
+                           PERF_SAMPLE_TIME,
+                           PERF_SAMPLE_ID,
+                           PERF_SAMPLE_STREAM_ID,
+                           PERF_SAMPLE_CPU,
+                           PERF_SAMPLE_IDENTIFIER }) {
+    if (this->_sample_type & type) {
+      sample_id_size += sizeof(std::uint64_t);
+    }
+  }
+  if (record_begin + sizeof(perf_event_header) + sample_id_size > record_end) {
+    return;
+  }
+
+  auto sample_ptr = std::uintptr_t(reinterpret_cast<const void*>(record_end - sample_id_size));
+
+  if (this->_sample_type & PERF_SAMPLE_TID) {
+    sample.process_id(*reinterpret_cast<const std::uint32_t*>(sample_ptr));
+    sample.thread_id(*reinterpret_cast<const std::uint32_t*>(sample_ptr + sizeof(std::uint32_t)));
+    sample_ptr += sizeof(std::uint64_t);
+  }
+
+  if (this->_sample_type & PERF_SAMPLE_TIME) {
+    sample.timestamp(*reinterpret_cast<const std::uint64_t*>(sample_ptr));
+    sample_ptr += sizeof(std::uint64_t);
+  }
+
+  if (this->_sample_type & PERF_SAMPLE_ID) {
+    sample.id(*reinterpret_cast<const std::uint64_t*>(sample_ptr));
+    sample_ptr += sizeof(std::uint64_t);
+  }
+
+  if (this->_sample_type & PERF_SAMPLE_STREAM_ID) {
+    sample_ptr += sizeof(std::uint64_t);
+  }
+
+  if (this->_sample_type & PERF_SAMPLE_CPU) {
+    sample.cpu_id(*reinterpret_cast<const std::uint32_t*>(sample_ptr));
+    sample_ptr += sizeof(std::uint64_t);
+  }
+
+  if (this->_sample_type & PERF_SAMPLE_IDENTIFIER) {
+    sample.sample_id(*reinterpret_cast<const std::uint64_t*>(sample_ptr));
+  }
+}
@@ -0,0 +1,503 @@
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <perfcpp/sample_file_reader.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+bool
+perf::SampleFileFilter::may_match(const sample_file::chunk_entry& chunk) const noexcept
+{
+  if (this->_time.has_value() && chunk.has_time &&
+      (chunk.max_time < this->_time->first || chunk.min_time >= this->_time->second)) {
+    return false;
+  }
+
+  if (this->_thread_id.has_value() && chunk.has_thread_id &&
+      (this->_thread_id.value() < chunk.min_thread_id || this->_thread_id.value() > chunk.max_thread_id ||
+       !((chunk.thread_id_bitmap >> (this->_thread_id.value() % 64U)) & 1U))) {
+    return false;
+  }
+
+  /// Chunks without timestamps (or thread ids) cannot be matched.
+  return !((this->_time.has_value() && !chunk.has_time) || (this->_thread_id.has_value() && !chunk.has_thread_id));
+}
+
+bool
+perf::SampleFileFilter::matches(const std::optional<std::uint64_t> time,
+                                const std::optional<std::uint32_t> thread_id) const noexcept
+{
+  if (this->_time.has_value() &&
+      (!time.has_value() || time.value() < this->_time->first || time.value() >= this->_time->second)) {
+    return false;
+  }
+
+  return !this->_thread_id.has_value() || thread_id == this->_thread_id;
+}
+
+perf::SampleFileReader::SampleFileReader(const std::string& file_name)
+{
+  const auto file_descriptor = ::open(file_name.c_str(), O_RDONLY);
+  if (file_descriptor < 0) {
+    throw std::runtime_error{ "Could not open '" + file_name + "' (errno = " + std::to_string(errno) + ")." };
+  }
+
+  struct stat file_status
+  {};
+  if (::fstat(file_descriptor, &file_status) != 0 ||
+      std::size_t(file_status.st_size) < sizeof(sample_file::file_header)) {
+    ::close(file_descriptor);
+    throw std::runtime_error{ "'" + file_name + "' is not a sample file." };
+  }
+
+  this->_size = std::size_t(file_status.st_size);
+  auto* data = ::mmap(nullptr, this->_size, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+  ::close(file_descriptor);
+  if (data == MAP_FAILED) {
+    throw std::runtime_error{ "Could not map '" + file_name + "' (errno = " + std::to_string(errno) + ")." };
+  }
+  this->_data = reinterpret_cast<const std::uint8_t*>(data);
+
+  /// Header and chunk index; sizes are compared against the remaining bytes, such that corrupted sizes cannot overflow.
+  std::memcpy(&this->_header, this->_data, sizeof(sample_file::file_header));
+  const auto is_in_file = [size = this->_size](const std::uint64_t offset, const std::uint64_t length) {
+    return offset <= size && length <= size - offset;
+  };
+  if (this->_header.magic != sample_file::MAGIC || this->_header.version != sample_file::VERSION ||
+      this->_header.count_columns != sample_file::COUNT_COLUMNS ||
+      this->_header.count_chunks > this->_size / sizeof(sample_file::chunk_entry) ||
+      !is_in_file(this->_header.chunk_index_offset, this->_header.count_chunks * sizeof(sample_file::chunk_entry)) ||
+      !is_in_file(this->_header.stack_table_offset, this->_header.stack_table_size) ||
+      !is_in_file(this->_header.counter_name_table_offset, this->_header.counter_name_table_size)) {
+    this->close();
+    throw std::runtime_error{ "'" + file_name + "' is not a sample file or incomplete." };
+  }
+
+  this->_chunks.resize(this->_header.count_chunks);
+  std::memcpy(this->_chunks.data(),
+              this->_data + this->_header.chunk_index_offset,
+              this->_header.count_chunks * sizeof(sample_file::chunk_entry));
+
+  /// Every chunk must lie within the file, its columns must be ordered within the chunk, and every column must hold
+  /// the presence bitmap of all samples of the chunk.
+  auto count_samples = std::uint64_t{ 0U };
+  for (const auto& chunk : this->_chunks) {
+    auto is_valid = is_in_file(chunk.offset, chunk.size);
+    const auto presence_size = SampleFileReader::presence_size(chunk);
+    for (auto column = 0U; column < sample_file::COUNT_COLUMNS; ++column) {
+      const auto column_end = column + 1U < sample_file::COUNT_COLUMNS ? chunk.column_offsets[column + 1U] : chunk.size;
+      is_valid &= chunk.column_offsets[column] <= column_end && column_end <= chunk.size &&
+                  presence_size <= column_end - chunk.column_offsets[column];
+    }
+    count_samples += chunk.count_samples;
+
+    if (!is_valid) {
+      this->close();
+      throw std::runtime_error{ "The chunk index of '" + file_name + "' is corrupted." };
+    }
+  }
+
+  if (count_samples != this->_header.count_samples || !this->read_tables()) {
+    this->close();
+    throw std::runtime_error{ "'" + file_name + "' is corrupted." };
+  }
+}
+
+bool
+perf::SampleFileReader::read_tables()
+{
+  /// Locate the callchains of the stack table; they are only decoded when needed. Every callchain takes at least one
+  /// byte (its length), and every entry at least one more.
+  const auto* cursor = this->_data + this->_header.stack_table_offset;
+  const auto* stack_table_end = cursor + this->_header.stack_table_size;
+  if (this->_header.count_stacks > this->_header.stack_table_size) {
+    return false;
+  }
+
+  this->_stack_offsets.reserve(this->_header.count_stacks);
+  for (auto index = 0U; index < this->_header.count_stacks; ++index) {
+    this->_stack_offsets.push_back(std::uint64_t(cursor - this->_data));
+
+    const auto length = SampleFileReader::read_varint(cursor, stack_table_end);
+    if (length > sample_file::MAX_LIST_LENGTH || length > std::uint64_t(stack_table_end - cursor)) {
+      return false;
+    }
+    for (auto i = 0U; i < length; ++i) {
+      static_cast<void>(SampleFileReader::read_varint(cursor, stack_table_end));
+    }
+  }
+
+  /// Counter name table: Length of every name, followed by the characters.
+  cursor = this->_data + this->_header.counter_name_table_offset;
+  const auto* counter_name_table_end = cursor + this->_header.counter_name_table_size;
+  if (this->_header.count_counter_names > this->_header.counter_name_table_size) {
+    return false;
+  }
+
+  this->_counter_names.reserve(this->_header.count_counter_names);
+  for (auto index = 0U; index < this->_header.count_counter_names; ++index) {
+    const auto length = SampleFileReader::read_varint(cursor, counter_name_table_end);
+    if (length > std::uint64_t(counter_name_table_end - cursor)) {
+      return false;
+    }
+
+    this->_counter_names.emplace_back(reinterpret_cast<const char*>(cursor), std::size_t(length));
+    cursor += length;
+  }
+
+  return true;
+}
+
+perf::SampleFileReader::SampleFileReader(SampleFileReader&& other) noexcept
+  : _data(std::exchange(other._data, nullptr))
+  , _size(std::exchange(other._size, 0U))
+  , _header(other._header)
+  , _chunks(std::move(other._chunks))
+  , _stack_offsets(std::move(other._stack_offsets))
+  , _counter_names(std::move(other._counter_names))
+{
+}
+
+perf::SampleFileReader&
+perf::SampleFileReader::operator=(SampleFileReader&& other) noexcept
+{
+  if (this != &other) {
+    this->close();
+
+    this->_data = std::exchange(other._data, nullptr);
+    this->_size = std::exchange(other._size, 0U);
+    this->_header = other._header;
+    this->_chunks = std::move(other._chunks);
+    this->_stack_offsets = std::move(other._stack_offsets);
+    this->_counter_names = std::move(other._counter_names);
+  }
+
+  return *this;
+}
+
+perf::SampleFileReader::~SampleFileReader()
+{
+  this->close();
+}
+
+void
+perf::SampleFileReader::close()
+{
+  if (this->_data != nullptr) {
+    ::munmap(const_cast<std::uint8_t*>(this->_data), this->_size);
+    this->_data = nullptr;
+  }
+}
+
+void
+perf::SampleFileReader::for_each_sample(const std::function<void(Sample&&)>& callback,
+                                        const SampleFileFilter& filter) const
+{
+  using sample_file::Column;
+
+  for (const auto& chunk : this->_chunks) {
+    if (!filter.may_match(chunk)) {
+      continue;
+    }
+
+    /// Presence bitmaps of every column, cursors into the values of every column, and the last value of delta-encoded
+    /// columns.
+    const auto* chunk_begin = this->_data + chunk.offset;
+    const auto presence_size = SampleFileReader::presence_size(chunk);
+    auto presences = std::array<const std::uint8_t*, sample_file::COUNT_COLUMNS>{};
+    auto cursors = std::array<const std::uint8_t*, sample_file::COUNT_COLUMNS>{};
+    auto ends = std::array<const std::uint8_t*, sample_file::COUNT_COLUMNS>{};
+    auto last_values = std::array<std::uint64_t, sample_file::COUNT_COLUMNS>{};
+    for (auto column = 0U; column < sample_file::COUNT_COLUMNS; ++column) {
+      presences[column] = chunk_begin + chunk.column_offsets[column];
+      cursors[column] = presences[column] + presence_size;
+      ends[column] = column + 1U < sample_file::COUNT_COLUMNS ? chunk_begin + chunk.column_offsets[column + 1U]
+                                                              : chunk_begin + chunk.size;
+    }
+
+    auto index = std::uint64_t{ 0U };
+    const auto is_present = [&presences, &index](const Column column) {
+      return bool((presences[std::size_t(column)][index / 8U] >> (index % 8U)) & 1U);
+    };
+
+    const auto next = [&cursors, &ends, &is_present](const Column column) -> std::optional<std::uint64_t> {
+      if (!is_present(column)) {
+        return std::nullopt;
+      }
+
+      return SampleFileReader::read_varint(cursors[std::size_t(column)], ends[std::size_t(column)]);
+    };
+
+    const auto next_delta = [&cursors, &ends, &last_values, &is_present](
+                              const Column column) -> std::optional<std::uint64_t> {
+      if (!is_present(column)) {
+        return std::nullopt;
+      }
+
+      const auto delta = SampleFileReader::read_varint(cursors[std::size_t(column)], ends[std::size_t(column)]);
+      auto& last_value = last_values[std::size_t(column)];
+      last_value += std::uint64_t(SampleFileReader::unzigzag(delta));
+      return last_value;
+    };
+
+    for (index = 0U; index < chunk.count_samples; ++index) {
+      /// All columns are read to advance the cursors; the sample is only built if it matches the filter.
+      const auto mode = next(Column::Mode);
+      const auto time = next_delta(Column::Time);
+      const auto instruction_pointer = next_delta(Column::InstructionPointer);
+      const auto process_id = next(Column::ProcessId);
+      const auto thread_id = next(Column::ThreadId);
+      const auto cpu_id = next(Column::CPU);
+      const auto period = next(Column::Period);
+      const auto logical_memory_address = next_delta(Column::LogicalMemoryAddress);
+      const auto physical_memory_address = next_delta(Column::PhysicalMemoryAddress);
+      const auto data_source = next(Column::DataSource);
+      const auto weight_latency = next(Column::WeightLatency);
+      const auto weight_var2 = next(Column::WeightVar2);
+      const auto weight_var3 = next(Column::WeightVar3);
+      const auto data_page_size = next(Column::DataPageSize);
+      const auto code_page_size = next(Column::CodePageSize);
+      const auto stack_index = next(Column::Callchain);
+      const auto sample_id = next(Column::SampleId);
+      const auto id = next(Column::Id);
+
+      /// Counter values: index of the name and the bits of the value.
+      const auto has_counter_values = is_present(Column::CounterValues);
+      auto counter_values = std::vector<std::pair<std::string_view, double>>{};
+      auto& counter_values_cursor = cursors[std::size_t(Column::CounterValues)];
+      const auto* counter_values_end = ends[std::size_t(Column::CounterValues)];
+      if (has_counter_values) {
+        const auto length =
+          SampleFileReader::read_length(counter_values_cursor, counter_values_end, sample_file::MAX_LIST_LENGTH);
+        counter_values.reserve(length);
+        for (auto i = 0U; i < length; ++i) {
+          const auto name_index = SampleFileReader::read_varint(counter_values_cursor, counter_values_end);
+          const auto bits = SampleFileReader::read_varint(counter_values_cursor, counter_values_end);
+          if (name_index >= this->_counter_names.size()) {
+            throw std::runtime_error{ "The counter values of the sample file are corrupted." };
+          }
+
+          auto value = 0.;
+          std::memcpy(&value, &bits, sizeof(double));
+          counter_values.emplace_back(this->_counter_names[name_index], value);
+        }
+      }
+
+      /// Branches: addresses relative to the previous address of the column, flags, and cycles.
+      auto branches = std::optional<std::vector<Branch>>{};
+      auto& branches_cursor = cursors[std::size_t(Column::Branches)];
+      const auto* branches_end = ends[std::size_t(Column::Branches)];
+      if (is_present(Column::Branches)) {
+        const auto length = SampleFileReader::read_length(branches_cursor, branches_end, sample_file::MAX_LIST_LENGTH);
+        branches.emplace();
+        branches->reserve(length);
+
+        auto& last_address = last_values[std::size_t(Column::Branches)];
+        for (auto i = 0U; i < length; ++i) {
+          const auto from = last_address += std::uint64_t(
+            SampleFileReader::unzigzag(SampleFileReader::read_varint(branches_cursor, branches_end)));
+          const auto to = last_address += std::uint64_t(
+            SampleFileReader::unzigzag(SampleFileReader::read_varint(branches_cursor, branches_end)));
+          const auto flags = SampleFileReader::read_varint(branches_cursor, branches_end);
+          const auto cycles = SampleFileReader::read_varint(branches_cursor, branches_end);
+
+          branches->emplace_back(std::uintptr_t(from),
+                                 std::uintptr_t(to),
+                                 bool(flags & sample_file::BRANCH_MISPREDICTED),
+                                 bool(flags & sample_file::BRANCH_PREDICTED),
+                                 bool(flags & sample_file::BRANCH_IN_TRANSACTION),
+                                 bool(flags & sample_file::BRANCH_TRANSACTION_ABORT),
+                                 std::uint16_t(cycles),
+                                 std::uint8_t(flags >> sample_file::BRANCH_TYPE_SHIFT));
+        }
+      }
+
+      /// Registers: ABI (if known), followed by the values.
+      const auto next_registers = [&cursors, &ends, &is_present](const Column column) {
+        auto& cursor = cursors[std::size_t(column)];
+        const auto* end = ends[std::size_t(column)];
+
+        auto registers = std::make_pair(std::optional<std::uint64_t>{}, std::optional<std::vector<std::uint64_t>>{});
+        if (is_present(column)) {
+          const auto length = SampleFileReader::read_length(cursor, end, sample_file::MAX_REGISTERS);
+          if (SampleFileReader::read_varint(cursor, end) != 0U) {
+            registers.first = SampleFileReader::read_varint(cursor, end);
+          }
+          if (length > 0U) {
+            registers.second.emplace();
+            registers.second->reserve(length);
+            for (auto i = 0U; i < length; ++i) {
+              registers.second->push_back(SampleFileReader::read_varint(cursor, end));
+            }
+          }
+        }
+
+        return registers;
+      };
+      auto user_registers = next_registers(Column::UserRegisters);
+      auto kernel_registers = next_registers(Column::KernelRegisters);
+
+      /// Context switch: flags, followed by the process and thread id (if recorded).
+      auto context_switch = std::optional<ContextSwitch>{};
+      if (const auto flags = next(Column::ContextSwitch); flags.has_value()) {
+        auto& context_switch_cursor = cursors[std::size_t(Column::ContextSwitch)];
+        const auto* context_switch_end = ends[std::size_t(Column::ContextSwitch)];
+        const auto is_out = bool(flags.value() & sample_file::CONTEXT_SWITCH_OUT);
+        const auto is_preempt = bool(flags.value() & sample_file::CONTEXT_SWITCH_PREEMPT);
+        if (flags.value() & (sample_file::CONTEXT_SWITCH_PROCESS_ID | sample_file::CONTEXT_SWITCH_THREAD_ID)) {
+          const auto switch_process_id = (flags.value() & sample_file::CONTEXT_SWITCH_PROCESS_ID)
+                                           ? SampleFileReader::read_varint(context_switch_cursor, context_switch_end)
+                                           : 0U;
+          const auto switch_thread_id = (flags.value() & sample_file::CONTEXT_SWITCH_THREAD_ID)
+                                          ? SampleFileReader::read_varint(context_switch_cursor, context_switch_end)
+                                          : 0U;
+          context_switch = ContextSwitch{
+            is_out, is_preempt, std::uint32_t(switch_process_id), std::uint32_t(switch_thread_id)
+          };
+        } else {
+          context_switch = ContextSwitch{ is_out, is_preempt };
+        }
+      }
+
+      const auto sample_thread_id =
+        thread_id.has_value() ? std::make_optional(std::uint32_t(thread_id.value())) : std::nullopt;
+      if (!filter.matches(time, sample_thread_id)) {
+        continue;
+      }
+
+      auto sample = Sample{ Sample::Mode(mode.value_or(Sample::Mode::Unknown)) };
+      if (time.has_value()) {
+        sample.timestamp(time.value());
+      }
+      if (instruction_pointer.has_value()) {
+        sample.instruction_pointer(std::uintptr_t(instruction_pointer.value()));
+      }
+      if (process_id.has_value()) {
+        sample.process_id(std::uint32_t(process_id.value()));
+      }
+      if (sample_thread_id.has_value()) {
+        sample.thread_id(sample_thread_id.value());
+      }
+      if (cpu_id.has_value()) {
+        sample.cpu_id(std::uint32_t(cpu_id.value()));
+      }
+      if (period.has_value()) {
+        sample.period(period.value());
+      }
+      if (logical_memory_address.has_value()) {
+        sample.logical_memory_address(std::uintptr_t(logical_memory_address.value()));
+      }
+      if (physical_memory_address.has_value()) {
+        sample.physical_memory_address(std::uintptr_t(physical_memory_address.value()));
+      }
+      if (data_source.has_value()) {
+        sample.data_src(DataSource{ data_source.value() });
+      }
+      if (weight_latency.has_value()) {
+        sample.weight(Weight{ std::uint32_t(weight_latency.value()),
+                              std::uint16_t(weight_var2.value_or(0U)),
+                              std::uint16_t(weight_var3.value_or(0U)) });
+      }
+      if (data_page_size.has_value()) {
+        sample.data_page_size(data_page_size.value());
+      }
+      if (code_page_size.has_value()) {
+        sample.code_page_size(code_page_size.value());
+      }
+      if (stack_index.has_value() && stack_index.value() < this->_stack_offsets.size()) {
+        sample.callchain(this->callchain(stack_index.value()));
+      }
+      if (sample_id.has_value()) {
+        sample.sample_id(sample_id.value());
+      }
+      if (id.has_value()) {
+        sample.id(id.value());
+      }
+      if (has_counter_values) {
+        sample.counter_result(CounterResult{ std::move(counter_values) });
+      }
+      if (branches.has_value()) {
+        sample.branches(std::move(branches.value()));
+      }
+      if (user_registers.first.has_value()) {
+        sample.user_registers_abi(user_registers.first.value());
+      }
+      if (user_registers.second.has_value()) {
+        sample.user_registers(std::move(user_registers.second.value()));
+      }
+      if (kernel_registers.first.has_value()) {
+        sample.kernel_registers_abi(kernel_registers.first.value());
+      }
+      if (kernel_registers.second.has_value()) {
+        sample.kernel_registers(std::move(kernel_registers.second.value()));
+      }
+      if (context_switch.has_value()) {
+        sample.context_switch(context_switch.value());
+      }
+
+      callback(std::move(sample));
+    }
+  }
+}
+
+std::vector<perf::Sample>
+perf::SampleFileReader::result(const SampleFileFilter& filter) const
+{
+  auto result = std::vector<Sample>{};
+  result.reserve(filter.time().has_value() || filter.thread_id().has_value() ? 2048U : this->_header.count_samples);
+
+  this->for_each_sample([&result](Sample&& sample) { result.push_back(std::move(sample)); }, filter);
+
+  return result;
+}
+
+std::vector<std::uintptr_t>
+perf::SampleFileReader::callchain(const std::uint64_t index) const
+{
+  const auto* cursor = this->_data + this->_stack_offsets[index];
+  const auto* end = this->_data + this->_header.stack_table_offset + this->_header.stack_table_size;
+
+  /// The length was checked against the size of the stack table when opening the file.
+  const auto length = std::min(SampleFileReader::read_varint(cursor, end), std::uint64_t(end - cursor));
+
+  auto callchain = std::vector<std::uintptr_t>{};
+  callchain.reserve(length);
+
+  auto instruction_pointer = std::uint64_t{ 0U };
+  for (auto i = 0U; i < length; ++i) {
+    instruction_pointer += std::uint64_t(SampleFileReader::unzigzag(SampleFileReader::read_varint(cursor, end)));
+    callchain.push_back(std::uintptr_t(instruction_pointer));
+  }
+
+  return callchain;
+}
+
+std::uint64_t
+perf::SampleFileReader::read_varint(const std::uint8_t*& cursor, const std::uint8_t* end) noexcept
+{
+  auto value = std::uint64_t{ 0U };
+  for (auto shift = 0U; cursor < end && shift < 64U; shift += 7U) {
+    const auto byte = *cursor++;
+    value |= std::uint64_t(byte & 0x7FU) << shift;
+    if (!(byte & 0x80U)) {
+      break;
+    }
+  }
+
+  return value;
+}
+
+std::size_t
+perf::SampleFileReader::read_length(const std::uint8_t*& cursor, const std::uint8_t* end, const std::size_t max_length)
+{
+  const auto length = SampleFileReader::read_varint(cursor, end);
+  if (length > max_length || length > std::uint64_t(end - cursor)) {
+    throw std::runtime_error{ "The sample file holds a corrupted list." };
+  }
+
+  return std::size_t(length);
+}
@@ -0,0 +1,347 @@
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <perfcpp/sample_file_writer.h>
+#include <stdexcept>
+
+perf::SampleFileWriter::SampleFileWriter(const std::string& file_name, const std::uint32_t chunk_size)
+  : _output(file_name, std::ios::binary | std::ios::trunc)
+  , _chunk_size(std::max(chunk_size, 1U))
+{
+  if (!this->_output.is_open()) {
+    throw std::runtime_error{ "Could not create '" + file_name + "'." };
+  }
+
+  /// The header is rewritten when closing the file, as soon as all offsets are known.
+  this->_output.write(reinterpret_cast<const char*>(&this->_header), sizeof(sample_file::file_header));
+}
+
+perf::SampleFileWriter::~SampleFileWriter()
+{
+  if (!this->_is_closed) {
+    static_cast<void>(this->close());
+  }
+}
+
+void
+perf::SampleFileWriter::add(const std::vector<Sample>& samples)
+{
+  for (const auto& sample : samples) {
+    this->add(sample);
+  }
+}
+
+void
+perf::SampleFileWriter::add(const Sample& sample)
+{
+  using sample_file::Column;
+
+  /// Reject the sample before appending any column, such that the columns stay consistent.
+  const auto& counter_result = sample.counter_result();
+  const auto& branches = sample.branches();
+  const auto& user_registers = sample.user_registers();
+  const auto& kernel_registers = sample.kernel_registers();
+  const auto& callchain = sample.callchain();
+  if ((counter_result.has_value() &&
+       std::size_t(std::distance(counter_result->begin(), counter_result->end())) > sample_file::MAX_LIST_LENGTH) ||
+      (branches.has_value() && branches->size() > sample_file::MAX_LIST_LENGTH) ||
+      (user_registers.has_value() && user_registers->size() > sample_file::MAX_REGISTERS) ||
+      (kernel_registers.has_value() && kernel_registers->size() > sample_file::MAX_REGISTERS) ||
+      (callchain.has_value() && callchain->size() > sample_file::MAX_LIST_LENGTH)) {
+    throw std::runtime_error{ "The sample holds more counter values, branches, registers, or callchain entries than "
+                              "the sample file can store." };
+  }
+
+  /// Every eighth sample starts a new byte of the presence bitmaps.
+  if (this->_count_chunk_samples % 8U == 0U) {
+    for (auto& presence : this->_presence) {
+      presence.push_back(0U);
+    }
+  }
+
+  this->append(Column::Mode, std::make_optional(std::uint64_t(sample.mode())));
+  this->append_delta(Column::Time, sample.time());
+  this->append_delta(Column::InstructionPointer, sample.instruction_pointer());
+  this->append(Column::ProcessId, sample.process_id());
+  this->append(Column::ThreadId, sample.thread_id());
+  this->append(Column::CPU, sample.cpu_id());
+  this->append(Column::Period, sample.period());
+  this->append_delta(Column::LogicalMemoryAddress, sample.logical_memory_address());
+  this->append_delta(Column::PhysicalMemoryAddress, sample.physical_memory_address());
+
+  const auto data_source = sample.data_src();
+  this->append(Column::DataSource,
+               data_source.has_value() ? std::make_optional(data_source->value()) : std::optional<std::uint64_t>{});
+
+  const auto weight = sample.weight();
+  const auto no_weight = std::optional<std::uint32_t>{};
+  this->append(Column::WeightLatency, weight.has_value() ? std::make_optional(weight->latency()) : no_weight);
+  this->append(Column::WeightVar2, weight.has_value() ? std::make_optional(weight->var2()) : no_weight);
+  this->append(Column::WeightVar3, weight.has_value() ? std::make_optional(weight->var3()) : no_weight);
+
+  this->append(Column::DataPageSize, sample.data_page_size());
+  this->append(Column::CodePageSize, sample.code_page_size());
+
+  this->append(Column::Callchain,
+               callchain.has_value() ? std::make_optional(this->stack_index(callchain.value()))
+                                     : std::optional<std::uint64_t>{});
+
+  this->append(Column::SampleId, sample.sample_id());
+  this->append(Column::Id, sample.id());
+  this->append_lists(sample);
+
+  /// Statistics of the chunk, used by readers to skip the chunk.
+  if (const auto time = sample.time(); time.has_value()) {
+    this->_chunk.min_time = this->_chunk.has_time ? std::min(this->_chunk.min_time, time.value()) : time.value();
+    this->_chunk.max_time = this->_chunk.has_time ? std::max(this->_chunk.max_time, time.value()) : time.value();
+    this->_chunk.has_time = 1U;
+  }
+
+  if (const auto thread_id = sample.thread_id(); thread_id.has_value()) {
+    this->_chunk.min_thread_id =
+      this->_chunk.has_thread_id ? std::min(this->_chunk.min_thread_id, thread_id.value()) : thread_id.value();
+    this->_chunk.max_thread_id =
+      this->_chunk.has_thread_id ? std::max(this->_chunk.max_thread_id, thread_id.value()) : thread_id.value();
+    this->_chunk.thread_id_bitmap |= std::uint64_t(1U) << (thread_id.value() % 64U);
+    this->_chunk.has_thread_id = 1U;
+  }
+
+  if (++this->_count_chunk_samples == this->_chunk_size) {
+    this->flush_chunk();
+  }
+}
+
+bool
+perf::SampleFileWriter::close()
+{
+  if (this->_is_closed) {
+    return false;
+  }
+  this->_is_closed = true;
+
+  if (this->_count_chunk_samples > 0U) {
+    this->flush_chunk();
+  }
+
+  /// Stack table.
+  this->_header.stack_table_offset = std::uint64_t(this->_output.tellp());
+  this->_header.count_stacks = this->_stack_indices.size();
+  this->_header.stack_table_size = this->_stack_table.size();
+  this->_output.write(reinterpret_cast<const char*>(this->_stack_table.data()),
+                      std::streamsize(this->_stack_table.size()));
+
+  /// Counter name table.
+  this->_header.counter_name_table_offset = std::uint64_t(this->_output.tellp());
+  this->_header.count_counter_names = this->_counter_name_indices.size();
+  this->_header.counter_name_table_size = this->_counter_name_table.size();
+  this->_output.write(reinterpret_cast<const char*>(this->_counter_name_table.data()),
+                      std::streamsize(this->_counter_name_table.size()));
+
+  /// Chunk index.
+  this->_header.chunk_index_offset = std::uint64_t(this->_output.tellp());
+  this->_header.count_chunks = this->_chunk_index.size();
+  this->_output.write(reinterpret_cast<const char*>(this->_chunk_index.data()),
+                      std::streamsize(this->_chunk_index.size() * sizeof(sample_file::chunk_entry)));
+
+  /// Header, now holding all offsets.
+  this->_output.seekp(0);
+  this->_output.write(reinterpret_cast<const char*>(&this->_header), sizeof(sample_file::file_header));
+
+  this->_output.close();
+
+  return !this->_output.fail();
+}
+
+template <typename T>
+void
+perf::SampleFileWriter::append(const sample_file::Column column, const std::optional<T> value)
+{
+  if (value.has_value()) {
+    this->mark_present(column);
+    SampleFileWriter::append_varint(this->_columns[std::size_t(column)], std::uint64_t(value.value()));
+  }
+}
+
+template <typename T>
+void
+perf::SampleFileWriter::append_delta(const sample_file::Column column, const std::optional<T> value)
+{
+  if (value.has_value()) {
+    auto& last_value = this->_last_values[std::size_t(column)];
+    const auto delta = std::int64_t(std::uint64_t(value.value()) - last_value);
+    last_value = std::uint64_t(value.value());
+
+    this->mark_present(column);
+    SampleFileWriter::append_varint(this->_columns[std::size_t(column)], SampleFileWriter::zigzag(delta));
+  }
+}
+
+void
+perf::SampleFileWriter::append_lists(const Sample& sample)
+{
+  using sample_file::Column;
+
+  const auto& counter_result = sample.counter_result();
+  const auto& branches = sample.branches();
+
+  /// Counter values: index of the name and the bits of the value.
+  auto& counter_values_column = this->_columns[std::size_t(Column::CounterValues)];
+  if (counter_result.has_value()) {
+    this->mark_present(Column::CounterValues);
+    SampleFileWriter::append_varint(counter_values_column,
+                                    std::uint64_t(std::distance(counter_result->begin(), counter_result->end())));
+    for (const auto& [name, value] : counter_result.value()) {
+      auto bits = std::uint64_t{ 0U };
+      std::memcpy(&bits, &value, sizeof(double));
+
+      SampleFileWriter::append_varint(counter_values_column, this->counter_name_index(name));
+      SampleFileWriter::append_varint(counter_values_column, bits);
+    }
+  }
+
+  /// Branches: addresses relative to the previous address of the column, flags, and cycles.
+  auto& branches_column = this->_columns[std::size_t(Column::Branches)];
+  if (branches.has_value()) {
+    this->mark_present(Column::Branches);
+    SampleFileWriter::append_varint(branches_column, branches->size());
+
+    auto& last_address = this->_last_values[std::size_t(Column::Branches)];
+    for (const auto& branch : branches.value()) {
+      for (const auto address : { branch.instruction_pointer_from(), branch.instruction_pointer_to() }) {
+        SampleFileWriter::append_varint(branches_column,
+                                        SampleFileWriter::zigzag(std::int64_t(std::uint64_t(address) - last_address)));
+        last_address = std::uint64_t(address);
+      }
+
+      const auto flags = (branch.is_mispredicted() ? sample_file::BRANCH_MISPREDICTED : 0U) |
+                         (branch.is_predicted() ? sample_file::BRANCH_PREDICTED : 0U) |
+                         (branch.is_in_transaction() ? sample_file::BRANCH_IN_TRANSACTION : 0U) |
+                         (branch.is_transaction_abort() ? sample_file::BRANCH_TRANSACTION_ABORT : 0U) |
+                         (std::uint64_t(branch.type()) << sample_file::BRANCH_TYPE_SHIFT);
+      SampleFileWriter::append_varint(branches_column, flags);
+      SampleFileWriter::append_varint(branches_column, branch.cycles());
+    }
+  }
+
+  this->append_registers(Column::UserRegisters, sample.user_registers_abi(), sample.user_registers());
+  this->append_registers(Column::KernelRegisters, sample.kernel_registers_abi(), sample.kernel_registers());
+
+  /// Context switch: flags, followed by the process and thread id (if recorded).
+  auto& context_switch_column = this->_columns[std::size_t(Column::ContextSwitch)];
+  if (const auto context_switch = sample.context_switch(); context_switch.has_value()) {
+    const auto flags = (context_switch->is_out() ? sample_file::CONTEXT_SWITCH_OUT : 0U) |
+                       (context_switch->is_preempt() ? sample_file::CONTEXT_SWITCH_PREEMPT : 0U) |
+                       (context_switch->process_id().has_value() ? sample_file::CONTEXT_SWITCH_PROCESS_ID : 0U) |
+                       (context_switch->thread_id().has_value() ? sample_file::CONTEXT_SWITCH_THREAD_ID : 0U);
+    this->mark_present(Column::ContextSwitch);
+    SampleFileWriter::append_varint(context_switch_column, flags);
+    if (context_switch->process_id().has_value()) {
+      SampleFileWriter::append_varint(context_switch_column, context_switch->process_id().value());
+    }
+    if (context_switch->thread_id().has_value()) {
+      SampleFileWriter::append_varint(context_switch_column, context_switch->thread_id().value());
+    }
+  }
+}
+
+void
+perf::SampleFileWriter::append_registers(const sample_file::Column column,
+                                         const std::optional<std::uint64_t> abi,
+                                         const std::optional<std::vector<std::uint64_t>>& registers)
+{
+  auto& buffer = this->_columns[std::size_t(column)];
+  if (!abi.has_value() && !registers.has_value()) {
+    return;
+  }
+
+  this->mark_present(column);
+  SampleFileWriter::append_varint(buffer, registers.has_value() ? registers->size() : 0U);
+  SampleFileWriter::append_varint(buffer, abi.has_value() ? 1U : 0U);
+  if (abi.has_value()) {
+    SampleFileWriter::append_varint(buffer, abi.value());
+  }
+  if (registers.has_value()) {
+    for (const auto value : registers.value()) {
+      SampleFileWriter::append_varint(buffer, value);
+    }
+  }
+}
+
+std::uint64_t
+perf::SampleFileWriter::counter_name_index(const std::string_view name)
+{
+  auto name_string = std::string{ name };
+  if (auto iterator = this->_counter_name_indices.find(name_string); iterator != this->_counter_name_indices.end()) {
+    return iterator->second;
+  }
+
+  /// Append the name to the counter name table: Length, followed by the characters.
+  SampleFileWriter::append_varint(this->_counter_name_table, name.size());
+  this->_counter_name_table.insert(this->_counter_name_table.end(), name.begin(), name.end());
+
+  const auto index = std::uint64_t(this->_counter_name_indices.size());
+  this->_counter_name_indices.insert(std::make_pair(std::move(name_string), index));
+
+  return index;
+}
+
+std::uint64_t
+perf::SampleFileWriter::stack_index(const std::vector<std::uintptr_t>& callchain)
+{
+  if (auto iterator = this->_stack_indices.find(callchain); iterator != this->_stack_indices.end()) {
+    return iterator->second;
+  }
+
+  /// Append the callchain to the stack table: Length, followed by delta-encoded instruction pointers.
+  SampleFileWriter::append_varint(this->_stack_table, callchain.size());
+  auto last_instruction_pointer = std::uint64_t{ 0U };
+  for (const auto instruction_pointer : callchain) {
+    SampleFileWriter::append_varint(
+      this->_stack_table, SampleFileWriter::zigzag(std::int64_t(instruction_pointer - last_instruction_pointer)));
+    last_instruction_pointer = instruction_pointer;
+  }
+
+  const auto index = std::uint64_t(this->_stack_indices.size());
+  this->_stack_indices.insert(std::make_pair(callchain, index));
+
+  return index;
+}
+
+void
+perf::SampleFileWriter::flush_chunk()
+{
+  this->_chunk.offset = std::uint64_t(this->_output.tellp());
+  this->_chunk.count_samples = this->_count_chunk_samples;
+
+  auto size = std::uint64_t{ 0U };
+  for (auto column = 0U; column < sample_file::COUNT_COLUMNS; ++column) {
+    this->_chunk.column_offsets[column] = std::uint32_t(size);
+    size += this->_presence[column].size() + this->_columns[column].size();
+
+    this->_output.write(reinterpret_cast<const char*>(this->_presence[column].data()),
+                        std::streamsize(this->_presence[column].size()));
+    this->_output.write(reinterpret_cast<const char*>(this->_columns[column].data()),
+                        std::streamsize(this->_columns[column].size()));
+    this->_presence[column].clear();
+    this->_columns[column].clear();
+  }
+  this->_chunk.size = size;
+
+  this->_header.count_samples += this->_count_chunk_samples;
+  this->_chunk_index.push_back(this->_chunk);
+
+  /// Reset the chunk; every chunk starts delta-encoding from zero, such that it can be decoded on its own.
+  this->_chunk = sample_file::chunk_entry{};
+  this->_count_chunk_samples = 0U;
+  this->_last_values.fill(0U);
+}
+
+void
+perf::SampleFileWriter::append_varint(std::vector<std::uint8_t>& buffer, std::uint64_t value)
+{
+  while (value >= 0x80U) {
+    buffer.push_back(std::uint8_t(value | 0x80U));
+    value >>= 7U;
+  }
+  buffer.push_back(std::uint8_t(value));
+}
@@ -0,0 +1,458 @@
+#include <algorithm>
+#include <perfcpp/sample_writer.h>
+#include <perfcpp/sampler.h>
+#include <stdexcept>
+
+/**
+ * Translates the mode of a sample into a name.
+ *
+ * @param mode Mode of the sample.
+ * @return Name of the mode.
+ */
+static std::string_view
+mode_name(const perf::Sample::Mode mode) noexcept
+{
+  switch (mode) {
+    case perf::Sample::Mode::Kernel:
+      return "kernel";
+    case perf::Sample::Mode::User:
+      return "user";
+    case perf::Sample::Mode::Hypervisor:
+      return "hypervisor";
+    case perf::Sample::Mode::GuestKernel:
+      return "guest_kernel";
+    case perf::Sample::Mode::GuestUser:
+      return "guest_user";
+    default:
+      return "unknown";
+  }
+}
+
+perf::SampleWriter::SampleWriter(const std::string& file_name,
+                                 const Sampler& sampler,
+                                 const Format format,
+                                 const std::size_t buffer_size)
+  : SampleWriter(file_name,
+                 sampler.sample_type(),
+                 std::vector<std::string>{ sampler.counter_names().begin(), sampler.counter_names().end() },
+                 format,
+                 buffer_size)
+{
+}
+
+perf::SampleWriter::SampleWriter(const std::string& file_name,
+                                 const std::uint64_t sample_type,
+                                 std::vector<std::string> counter_names,
+                                 const Format format,
+                                 const std::size_t buffer_size)
+  : _output(file_name, std::ios::out | std::ios::binary | std::ios::trunc)
+  , _sample_type(sample_type)
+  , _format(format)
+  , _buffer(_output, buffer_size)
+  , _counter_names(std::move(counter_names))
+{
+  if ((this->_sample_type & Sampler::Type::CounterValues) && this->_counter_names.empty()) {
+    throw std::runtime_error{ "Writing sampled counter values needs the names of the sampled counters." };
+  }
+
+  if (!this->_output.is_open()) {
+    throw std::runtime_error{ "Could not create '" + file_name + "'." };
+  }
+
+  if (this->_format == Format::CSV) {
+    this->write_csv_header();
+  }
+}
+
+perf::SampleWriter::~SampleWriter()
+{
+  if (!this->_is_closed) {
+    static_cast<void>(this->close());
+  }
+}
+
+void
+perf::SampleWriter::write(const Sample& sample)
+{
+  if (sample.context_switch().has_value()) {
+    return;
+  }
+
+  if (this->_format == Format::CSV) {
+    this->write_csv(sample);
+  } else {
+    this->write_json(sample);
+  }
+
+  ++this->_count_samples;
+}
+
+void
+perf::SampleWriter::write(const std::vector<Sample>& samples)
+{
+  for (const auto& sample : samples) {
+    this->write(sample);
+  }
+}
+
+bool
+perf::SampleWriter::flush()
+{
+  return this->_buffer.flush();
+}
+
+bool
+perf::SampleWriter::close()
+{
+  if (this->_is_closed) {
+    return false;
+  }
+
+  const auto is_flushed = this->flush();
+  this->_output.close();
+  this->_is_closed = true;
+
+  return is_flushed && !this->_output.fail();
+}
+
+void
+perf::SampleWriter::begin_field(const std::string_view name, const bool is_first)
+{
+  if (!is_first) {
+    this->_buffer.append(',');
+  }
+  this->_buffer.append('"');
+  this->_buffer.append(name);
+  this->_buffer.append("\":");
+}
+
+void
+perf::SampleWriter::write_csv_header()
+{
+  this->_buffer.append("mode");
+
+  if (this->_sample_type & Sampler::Type::Identifier) {
+    this->_buffer.append(",sample_id");
+  }
+  if (this->_sample_type & Sampler::Type::InstructionPointer) {
+    this->_buffer.append(",instruction_pointer");
+  }
+  if (this->_sample_type & Sampler::Type::ThreadId) {
+    this->_buffer.append(",process_id,thread_id");
+  }
+  if (this->_sample_type & Sampler::Type::Time) {
+    this->_buffer.append(",time");
+  }
+  if (this->_sample_type & Sampler::Type::LogicalMemAddress) {
+    this->_buffer.append(",logical_memory_address");
+  }
+  if (this->_sample_type & Sampler::Type::CPU) {
+    this->_buffer.append(",cpu_id");
+  }
+  if (this->_sample_type & Sampler::Type::Period) {
+    this->_buffer.append(",period");
+  }
+
+  /// One column per sampled counter.
+  if (this->_sample_type & Sampler::Type::CounterValues) {
+    for (const auto& name : this->_counter_names) {
+      this->_buffer.append(',');
+      this->_buffer.append(name);
+    }
+  }
+
+  if (this->_sample_type & Sampler::Type::Callchain) {
+    this->_buffer.append(",callchain");
+  }
+  if (this->_sample_type & Sampler::Type::BranchStack) {
+    this->_buffer.append(",branches");
+  }
+  if (this->_sample_type & Sampler::Type::UserRegisters) {
+    this->_buffer.append(",user_registers");
+  }
+  if (this->_sample_type & Sampler::Type::KernelRegisters) {
+    this->_buffer.append(",kernel_registers");
+  }
+  if (this->_sample_type & Sampler::Type::WeightStruct) {
+    this->_buffer.append(",weight,weight_var2,weight_var3");
+  } else if (this->_sample_type & Sampler::Type::Weight) {
+    this->_buffer.append(",weight");
+  }
+  if (this->_sample_type & Sampler::Type::DataSource) {
+    this->_buffer.append(",data_source");
+  }
+  if (this->_sample_type & Sampler::Type::PhysicalMemAddress) {
+    this->_buffer.append(",physical_memory_address");
+  }
+  if (this->_sample_type & Sampler::Type::DataPageSize) {
+    this->_buffer.append(",data_page_size");
+  }
+  if (this->_sample_type & Sampler::Type::CodePageSize) {
+    this->_buffer.append(",code_page_size");
+  }
+
+  this->_buffer.append('\n');
+}
+
+void
+perf::SampleWriter::write_csv(const Sample& sample)
+{
+  /// Values that are missing in the sample remain empty.
+  const auto append_optional = [this](const auto value) {
+    this->_buffer.append(',');
+    if (value.has_value()) {
+      this->_buffer.append(std::uint64_t(value.value()));
+    }
+  };
+  const auto append_optional_hex = [this](const auto value) {
+    this->_buffer.append(',');
+    if (value.has_value()) {
+      this->_buffer.append_hex(std::uint64_t(value.value()));
+    }
+  };
+  const auto append_list = [this](const auto& list, const bool is_hex) {
+    this->_buffer.append(',');
+    if (list.has_value()) {
+      for (auto i = 0U; i < list->size(); ++i) {
+        if (i > 0U) {
+          this->_buffer.append('|');
+        }
+        if (is_hex) {
+          this->_buffer.append_hex(std::uint64_t((*list)[i]));
+        } else {
+          this->_buffer.append(std::uint64_t((*list)[i]));
+        }
+      }
+    }
+  };
+
+  this->_buffer.append(mode_name(sample.mode()));
+
+  if (this->_sample_type & Sampler::Type::Identifier) {
+    append_optional(sample.sample_id());
+  }
+  if (this->_sample_type & Sampler::Type::InstructionPointer) {
+    append_optional_hex(sample.instruction_pointer());
+  }
+  if (this->_sample_type & Sampler::Type::ThreadId) {
+    append_optional(sample.process_id());
+    append_optional(sample.thread_id());
+  }
+  if (this->_sample_type & Sampler::Type::Time) {
+    append_optional(sample.time());
+  }
+  if (this->_sample_type & Sampler::Type::LogicalMemAddress) {
+    append_optional_hex(sample.logical_memory_address());
+  }
+  if (this->_sample_type & Sampler::Type::CPU) {
+    append_optional(sample.cpu_id());
+  }
+  if (this->_sample_type & Sampler::Type::Period) {
+    append_optional(sample.period());
+  }
+  if (this->_sample_type & Sampler::Type::CounterValues) {
+    for (const auto& name : this->_counter_names) {
+      this->_buffer.append(',');
+      if (sample.counter_result().has_value()) {
+        if (const auto value = sample.counter_result()->get(name); value.has_value()) {
+          this->_buffer.append(value.value());
+        }
+      }
+    }
+  }
+  if (this->_sample_type & Sampler::Type::Callchain) {
+    append_list(sample.callchain(), true);
+  }
+  if (this->_sample_type & Sampler::Type::BranchStack) {
+    /// Branches are written as "from>to", marked with a trailing '!' if mispredicted, and separated by '|'.
+    this->_buffer.append(',');
+    if (sample.branches().has_value()) {
+      for (auto i = 0U; i < sample.branches()->size(); ++i) {
+        const auto& branch = (*sample.branches())[i];
+        if (i > 0U) {
+          this->_buffer.append('|');
+        }
+        this->_buffer.append_hex(branch.instruction_pointer_from());
+        this->_buffer.append('>');
+        this->_buffer.append_hex(branch.instruction_pointer_to());
+        if (branch.is_mispredicted()) {
+          this->_buffer.append('!');
+        }
+      }
+    }
+  }
+  if (this->_sample_type & Sampler::Type::UserRegisters) {
+    append_list(sample.user_registers(), false);
+  }
+  if (this->_sample_type & Sampler::Type::KernelRegisters) {
+    append_list(sample.kernel_registers(), false);
+  }
+  if (this->_sample_type & (Sampler::Type::Weight | Sampler::Type::WeightStruct)) {
+    const auto weight = sample.weight();
+    append_optional(weight.has_value() ? std::make_optional(weight->latency()) : std::nullopt);
+    if (this->_sample_type & Sampler::Type::WeightStruct) {
+      append_optional(weight.has_value() ? std::make_optional(weight->var2()) : std::nullopt);
+      append_optional(weight.has_value() ? std::make_optional(weight->var3()) : std::nullopt);
+    }
+  }
+  if (this->_sample_type & Sampler::Type::DataSource) {
+    const auto data_source = sample.data_src();
+    append_optional_hex(data_source.has_value() ? std::make_optional(data_source->value()) : std::nullopt);
+  }
+  if (this->_sample_type & Sampler::Type::PhysicalMemAddress) {
+    append_optional_hex(sample.physical_memory_address());
+  }
+  if (this->_sample_type & Sampler::Type::DataPageSize) {
+    append_optional(sample.data_page_size());
+  }
+  if (this->_sample_type & Sampler::Type::CodePageSize) {
+    append_optional(sample.code_page_size());
+  }
+
+  this->_buffer.append('\n');
+}
+
+void
+perf::SampleWriter::write_json(const Sample& sample)
+{
+  /// Values that are missing in the sample are written as null; addresses are written as hex strings.
+  const auto append_optional = [this](const std::string_view name, const auto value) {
+    this->begin_field(name, false);
+    if (value.has_value()) {
+      this->_buffer.append(std::uint64_t(value.value()));
+    } else {
+      this->_buffer.append("null");
+    }
+  };
+  const auto append_optional_hex = [this](const std::string_view name, const auto value) {
+    this->begin_field(name, false);
+    if (value.has_value()) {
+      this->_buffer.append('"');
+      this->_buffer.append_hex(std::uint64_t(value.value()));
+      this->_buffer.append('"');
+    } else {
+      this->_buffer.append("null");
+    }
+  };
+  const auto append_list = [this](const std::string_view name, const auto& list, const bool is_hex) {
+    this->begin_field(name, false);
+    if (list.has_value()) {
+      this->_buffer.append('[');
+      for (auto i = 0U; i < list->size(); ++i) {
+        if (i > 0U) {
+          this->_buffer.append(',');
+        }
+        if (is_hex) {
+          this->_buffer.append('"');
+          this->_buffer.append_hex(std::uint64_t((*list)[i]));
+          this->_buffer.append('"');
+        } else {
+          this->_buffer.append(std::uint64_t((*list)[i]));
+        }
+      }
+      this->_buffer.append(']');
+    } else {
+      this->_buffer.append("null");
+    }
+  };
+
+  this->_buffer.append('{');
+  this->begin_field("mode", true);
+  this->_buffer.append('"');
+  this->_buffer.append(mode_name(sample.mode()));
+  this->_buffer.append('"');
+
+  if (this->_sample_type & Sampler::Type::Identifier) {
+    append_optional("sample_id", sample.sample_id());
+  }
+  if (this->_sample_type & Sampler::Type::InstructionPointer) {
+    append_optional_hex("instruction_pointer", sample.instruction_pointer());
+  }
+  if (this->_sample_type & Sampler::Type::ThreadId) {
+    append_optional("process_id", sample.process_id());
+    append_optional("thread_id", sample.thread_id());
+  }
+  if (this->_sample_type & Sampler::Type::Time) {
+    append_optional("time", sample.time());
+  }
+  if (this->_sample_type & Sampler::Type::LogicalMemAddress) {
+    append_optional_hex("logical_memory_address", sample.logical_memory_address());
+  }
+  if (this->_sample_type & Sampler::Type::CPU) {
+    append_optional("cpu_id", sample.cpu_id());
+  }
+  if (this->_sample_type & Sampler::Type::Period) {
+    append_optional("period", sample.period());
+  }
+  if (this->_sample_type & Sampler::Type::CounterValues) {
+    this->begin_field("counters", false);
+    if (sample.counter_result().has_value()) {
+      /// Serialize the counter values straight into the output buffer, growing the requested space until they fit.
+      for (auto size = std::size_t{ 256U };; size *= 2U) {
+        auto* begin = this->_buffer.reserve(size);
+        if (auto* end = sample.counter_result()->to_json(begin, begin + size); end != nullptr) {
+          this->_buffer.commit(std::size_t(end - begin));
+          break;
+        }
+      }
+    } else {
+      this->_buffer.append("null");
+    }
+  }
+  if (this->_sample_type & Sampler::Type::Callchain) {
+    append_list("callchain", sample.callchain(), true);
+  }
+  if (this->_sample_type & Sampler::Type::BranchStack) {
+    this->begin_field("branches", false);
+    if (sample.branches().has_value()) {
+      this->_buffer.append('[');
+      for (auto i = 0U; i < sample.branches()->size(); ++i) {
+        const auto& branch = (*sample.branches())[i];
+        if (i > 0U) {
+          this->_buffer.append(',');
+        }
+        this->_buffer.append("{\"from\":\"");
+        this->_buffer.append_hex(branch.instruction_pointer_from());
+        this->_buffer.append("\",\"to\":\"");
+        this->_buffer.append_hex(branch.instruction_pointer_to());
+        this->_buffer.append(branch.is_mispredicted() ? "\",\"mispredicted\":true" : "\",\"mispredicted\":false");
+        this->_buffer.append(",\"cycles\":");
+        this->_buffer.append(std::uint64_t{ branch.cycles() });
+        this->_buffer.append('}');
+      }
+      this->_buffer.append(']');
+    } else {
+      this->_buffer.append("null");
+    }
+  }
+  if (this->_sample_type & Sampler::Type::UserRegisters) {
+    append_list("user_registers", sample.user_registers(), false);
+  }
+  if (this->_sample_type & Sampler::Type::KernelRegisters) {
+    append_list("kernel_registers", sample.kernel_registers(), false);
+  }
+  if (this->_sample_type & (Sampler::Type::Weight | Sampler::Type::WeightStruct)) {
+    const auto weight = sample.weight();
+    append_optional("weight", weight.has_value() ? std::make_optional(weight->latency()) : std::nullopt);
+    if (this->_sample_type & Sampler::Type::WeightStruct) {
+      append_optional("weight_var2", weight.has_value() ? std::make_optional(weight->var2()) : std::nullopt);
+      append_optional("weight_var3", weight.has_value() ? std::make_optional(weight->var3()) : std::nullopt);
+    }
+  }
+  if (this->_sample_type & Sampler::Type::DataSource) {
+    const auto data_source = sample.data_src();
+    append_optional_hex("data_source",
+                        data_source.has_value() ? std::make_optional(data_source->value()) : std::nullopt);
+  }
+  if (this->_sample_type & Sampler::Type::PhysicalMemAddress) {
+    append_optional_hex("physical_memory_address", sample.physical_memory_address());
+  }
+  if (this->_sample_type & Sampler::Type::DataPageSize) {
+    append_optional("data_page_size", sample.data_page_size());
+  }
+  if (this->_sample_type & Sampler::Type::CodePageSize) {
+    append_optional("code_page_size", sample.code_page_size());
+  }
+
+  this->_buffer.append("}\n");
+}
@@ -1,9 +1,11 @@
 #include <algorithm>
 #include <asm/unistd.h>
+#include <atomic>
 #include <cstring>
 #include <exception>
 #include <iostream>
 #include <numeric>
+#include <perfcpp/sample_decoder.h>
 #include <perfcpp/sampler.h>
 #include <stdexcept>
 #include <sys/ioctl.h>
@@ -56,6 +58,10 @@ perf::Sampler::open()
     /// Only the second counter is the "real" sampling counter.
     const auto is_secret_leader = is_leader_auxiliary_counter && counter_index == 1U;
 
+    /// The buffer is mapped for the counter that records the samples.
+    const auto is_sampling_counter =
+      is_leader_auxiliary_counter && this->_group.size() > 1U ? is_secret_leader : is_leader;
+
     auto& perf_event = counter.event_attribute();
     std::memset(&perf_event, 0, sizeof(perf_event_attr));
     perf_event.type = counter.type();
@@ -75,6 +81,12 @@ perf::Sampler::open()
     if (is_leader || is_secret_leader) {
       perf_event.sample_type = this->_sample_type;
 
+      /// With more than one counter, consumers of the records (e.g., perf.data files) assign them to their counter
+      /// by the identifier.
+      if (this->_group.size() > 1U) {
+        perf_event.sample_type |= PERF_SAMPLE_IDENTIFIER;
+      }
+
       if (this->_config.is_frequency()) {
         perf_event.freq = 1U;
         perf_event.sample_freq = this->_config.frequency_or_period();
@@ -86,8 +98,22 @@ perf::Sampler::open()
         perf_event.branch_sample_type = this->_config.branch_type();
       }
 
-      if (is_leader) {
+      /// Side-band records (mappings, commands, and context switches) are written into the buffer of the counter that
+      /// emits them.
+      if (is_sampling_counter) {
         perf_event.mmap = 1U;
+        perf_event.comm = 1U;
+
+        /// Context switch records carry thread id, time, and CPU (as far as sampled) only with sample_id_all.
+        if (this->_config.is_context_switch()) {
+          perf_event.context_switch = 1U;
+          perf_event.sample_id_all = 1U;
+        }
+      }
+
+      if (this->_config.clock_id().has_value()) {
+        perf_event.use_clockid = 1U;
+        perf_event.clockid = this->_config.clock_id().value();
       }
 
       if (this->_sample_type & static_cast<std::uint64_t>(Type::Callchain)) {
@@ -137,6 +163,8 @@ perf::Sampler::open()
       this->_last_error = errno;
       return false;
     }
+
+    ::ioctl(file_descriptor, PERF_EVENT_IOC_ID, &counter.id());
   }
 
   /// Open the mapped buffer.
@@ -185,224 +213,92 @@ std::vector<perf::Sample>
 perf::Sampler::result() const
 {
   auto result = std::vector<Sample>{};
-  if (this->_buffer == nullptr) {
-    return result;
-  }
-
-  auto* mmap_page = reinterpret_cast<perf_event_mmap_page*>(this->_buffer);
-
-  /// When the ringbuffer is empty or already read, there is nothing to do.
-  if (mmap_page->data_tail >= mmap_page->data_head) {
-    return result;
-  }
-
   result.reserve(2048U);
 
-  /// The buffer starts at page 1 (from 0).
-  auto iterator = std::uintptr_t(this->_buffer) + 4096U;
-
-  /// data_head is the size (in bytes) of the samples.
-  const auto end = iterator + mmap_page->data_head;
-
-  while (iterator < end) {
-    auto* event_header = reinterpret_cast<perf_event_header*>(iterator);
-
-    if (event_header->type == PERF_RECORD_SAMPLE) {
-      auto mode = Sample::Mode::Unknown;
-      if (static_cast<bool>(event_header->misc & PERF_RECORD_MISC_KERNEL)) {
-        mode = Sample::Mode::Kernel;
-      } else if (static_cast<bool>(event_header->misc & PERF_RECORD_MISC_USER)) {
-        mode = Sample::Mode::User;
-      } else if (static_cast<bool>(event_header->misc & PERF_RECORD_MISC_HYPERVISOR)) {
-        mode = Sample::Mode::Hypervisor;
-      } else if (static_cast<bool>(event_header->misc & PERF_RECORD_MISC_GUEST_KERNEL)) {
-        mode = Sample::Mode::GuestKernel;
-      } else if (static_cast<bool>(event_header->misc & PERF_RECORD_MISC_GUEST_USER)) {
-        mode = Sample::Mode::GuestUser;
-      }
-
-      auto sample = Sample{ mode };
-
-      auto sample_ptr = std::uintptr_t(reinterpret_cast<void*>(event_header + 1U));
-
-      if (this->_sample_type & perf::Sampler::Type::Identifier) {
-        sample.sample_id(*reinterpret_cast<std::uint64_t*>(sample_ptr));
-        sample_ptr += sizeof(std::uint64_t);
-      }
-
-      if (this->_sample_type & perf::Sampler::Type::InstructionPointer) {
-        sample.instruction_pointer(*reinterpret_cast<std::uintptr_t*>(sample_ptr));
-        sample_ptr += sizeof(std::uintptr_t);
-      }
-
-      if (this->_sample_type & perf::Sampler::Type::ThreadId) {
-        sample.process_id(*reinterpret_cast<std::uint32_t*>(sample_ptr));
-        sample_ptr += sizeof(std::uint32_t);
-
-        sample.thread_id(*reinterpret_cast<std::uint32_t*>(sample_ptr));
-        sample_ptr += sizeof(std::uint32_t);
-      }
-
-      if (this->_sample_type & perf::Sampler::Type::Time) {
-        sample.timestamp(*reinterpret_cast<std::uint64_t*>(sample_ptr));
-        sample_ptr += sizeof(std::uint64_t);
-      }
-
-      if (this->_sample_type & perf::Sampler::Type::LogicalMemAddress) {
-        sample.logical_memory_address(*reinterpret_cast<std::uint64_t*>(sample_ptr));
-        sample_ptr += sizeof(std::uint64_t);
-      }
-
-      if (this->_sample_type & perf::Sampler::Type::CPU) {
-        sample.cpu_id(*reinterpret_cast<std::uint32_t*>(sample_ptr));
-        sample_ptr += sizeof(std::uint64_t);
-      }
-
-      if (this->_sample_type & perf::Sampler::Type::Period) {
-        sample.period(*reinterpret_cast<std::uint64_t*>(sample_ptr));
-        sample_ptr += sizeof(std::uint64_t);
-      }
-
-      if (this->_sample_type & perf::Sampler::Type::CounterValues) {
-        auto* read_format = reinterpret_cast<Sampler::read_format*>(sample_ptr);
-        const auto count_counter_values = read_format->count_members;
-
-        if (count_counter_values == this->_group.size()) {
-          auto counter_values = std::vector<std::pair<std::string_view, double>>{};
-          for (auto counter_id = 0U; counter_id < this->_group.size(); ++counter_id) {
-            counter_values.emplace_back(this->_counter_names[counter_id],
-                                        double(read_format->values[counter_id].value));
-          }
-
-          sample.counter_result(CounterResult{ std::move(counter_values) });
-        }
-
-        sample_ptr +=
-          sizeof(Sampler::read_format::count_members) + count_counter_values * sizeof(Sampler::read_format::value);
-      }
-
-      if (this->_sample_type & perf::Sampler::Type::Callchain) {
-        const auto callchain_size = (*reinterpret_cast<std::uint64_t*>(sample_ptr));
-        sample_ptr += sizeof(std::uint64_t);
-
-        if (callchain_size > 0U) {
-          auto callchain = std::vector<std::uintptr_t>{};
-          callchain.reserve(callchain_size);
-
-          auto* instruction_pointers = reinterpret_cast<std::uint64_t*>(sample_ptr);
-          for (auto index = 0U; index < callchain_size; ++index) {
-            callchain.push_back(std::uintptr_t{ instruction_pointers[index] });
-          }
+  this->for_each_sample([&result](Sample&& sample) { result.push_back(std::move(sample)); });
 
-          sample.callchain(std::move(callchain));
-
-          sample_ptr += callchain_size * sizeof(std::uint64_t);
-        }
-      }
-
-      if (this->_sample_type & perf::Sampler::BranchStack) {
-        const auto count_branches = *reinterpret_cast<std::uint64_t*>(sample_ptr);
-        sample_ptr += sizeof(std::uint64_t);
-
-        if (count_branches > 0U) {
-          auto branches = std::vector<Branch>{};
-          branches.reserve(count_branches);
-
-          auto* sampled_branches = reinterpret_cast<perf_branch_entry*>(sample_ptr);
-          for (auto i = 0U; i < count_branches; ++i) {
-            const auto& branch = sampled_branches[i];
-            branches.emplace_back(
-              branch.from, branch.to, branch.mispred, branch.predicted, branch.in_tx, branch.abort, branch.cycles);
-          }
-
-          sample.branches(std::move(branches));
-        }
-
-        sample_ptr += sizeof(perf_branch_entry) * count_branches;
-      }
-
-      if (this->_sample_type & perf::Sampler::UserRegisters) {
-        const auto abi = *reinterpret_cast<std::uint64_t*>(sample_ptr);
-        sample.user_registers_abi(abi);
-        sample_ptr += sizeof(std::uint64_t);
-
-        const auto count_user_registers = this->_config.user_registers().size();
-        if (count_user_registers > 0U) {
-          auto user_registers = std::vector<std::uint64_t>{};
-          user_registers.reserve(count_user_registers);
-
-          const auto* perf_user_registers = reinterpret_cast<std::uint64_t*>(sample_ptr);
-          for (auto register_id = 0U; register_id < count_user_registers; ++register_id) {
-            user_registers.push_back(perf_user_registers[register_id]);
-          }
-
-          sample.user_registers(std::move(user_registers));
-
-          sample_ptr += sizeof(std::uint64_t) * count_user_registers;
-        }
-      }
-
-      if (this->_sample_type & perf::Sampler::Type::Weight) {
-        sample.weight(perf::Weight{ std::uint32_t(*reinterpret_cast<std::uint64_t*>(sample_ptr)) });
-        sample_ptr += sizeof(std::uint64_t);
-      }
-#ifndef NO_PERF_SAMPLE_WEIGHT_STRUCT
-      else if (this->_sample_type & perf::Sampler::Type::WeightStruct) {
-        const auto weight_struct = *reinterpret_cast<perf_sample_weight*>(sample_ptr);
-        sample.weight(perf::Weight{ weight_struct.var1_dw, weight_struct.var2_w, weight_struct.var3_w });
+  return result;
+}
 
-        sample_ptr += sizeof(perf_sample_weight);
-      }
-#endif
+std::uint64_t
+perf::Sampler::count_buffered_bytes() const noexcept
+{
+  if (this->_buffer == nullptr) {
+    return 0U;
+  }
 
-      if (this->_sample_type & perf::Sampler::Type::DataSource) {
-        sample.data_src(perf::DataSource{ *reinterpret_cast<std::uint64_t*>(sample_ptr) });
-        sample_ptr += sizeof(std::uint64_t);
-      }
+  const auto* mmap_page = reinterpret_cast<const perf_event_mmap_page*>(this->_buffer);
+  const auto head = mmap_page->data_head;
+  std::atomic_thread_fence(std::memory_order_acquire);
+  const auto tail = mmap_page->data_tail;
 
-      if (this->_sample_type & perf::Sampler::KernelRegisters) {
-        const auto abi = *reinterpret_cast<std::uint64_t*>(sample_ptr);
-        sample.kernel_registers_abi(abi);
-        sample_ptr += sizeof(std::uint64_t);
+  return head > tail ? head - tail : 0U;
+}
 
-        const auto count_kernel_registers = this->_config.kernel_registers().size();
-        if (count_kernel_registers > 0U) {
-          auto kernel_registers = std::vector<std::uint64_t>{};
-          kernel_registers.reserve(count_kernel_registers);
+void
+perf::Sampler::for_each_sample(const std::function<void(Sample&&)>& callback) const
+{
+  if (this->_buffer == nullptr) {
+    return;
+  }
 
-          const auto* perf_kernel_registers = reinterpret_cast<std::uint64_t*>(sample_ptr);
-          for (auto register_id = 0U; register_id < count_kernel_registers; ++register_id) {
-            kernel_registers.push_back(perf_kernel_registers[register_id]);
-          }
+  auto* mmap_page = reinterpret_cast<perf_event_mmap_page*>(this->_buffer);
 
-          sample.user_registers(std::move(kernel_registers));
+  /// Records are located between data_tail and data_head (both are only growing; the position in the buffer is the
+  /// value modulo the buffer size). data_tail is only advanced when the buffer is drained (see RawSpillWriter).
+  const auto head = mmap_page->data_head;
+  std::atomic_thread_fence(std::memory_order_acquire);
+  const auto tail = mmap_page->data_tail;
 
-          sample_ptr += sizeof(std::uint64_t) * count_kernel_registers;
-        }
-      }
+  /// When the ringbuffer is empty or already read, there is nothing to do.
+  if (tail >= head) {
+    return;
+  }
 
-      if (this->_sample_type & perf::Sampler::Type::PhysicalMemAddress) {
-        sample.physical_memory_address(*reinterpret_cast<std::uint64_t*>(sample_ptr));
-        sample_ptr += sizeof(std::uint64_t);
-      }
+  /// The buffer starts at page 1 (from 0).
+  const auto* ring_buffer = reinterpret_cast<const std::byte*>(this->_buffer) + 4096U;
+  const auto ring_buffer_size = (this->_config.buffer_pages() - 1U) * 4096U;
 
-      if (this->_sample_type & perf::Sampler::Type::DataPageSize) {
-        sample.data_page_size(*reinterpret_cast<std::uint64_t*>(sample_ptr));
-        sample_ptr += sizeof(std::uint64_t);
-      }
+  /// The decoder follows the attribute of the sampling counter; if the leader is an "auxiliary" counter (like on
+  /// Sapphire Rapid), the second counter is sampled.
+  const auto sampling_counter_index = this->_group.member(0U).is_auxiliary() && this->_group.size() > 1U ? 1U : 0U;
+  auto counter_names = std::vector<std::pair<std::uint64_t, std::string_view>>{};
+  for (auto counter_index = 0U; counter_index < this->_group.size(); ++counter_index) {
+    counter_names.emplace_back(this->_group.member(counter_index).id(), this->_counter_names[counter_index]);
+  }
+  const auto decoder =
+    SampleDecoder{ this->_group.member(sampling_counter_index).event_attribute(), std::move(counter_names) };
+
+  /// Records wrapping around the end of the ring buffer are copied into a contiguous (8-byte aligned) buffer.
+  auto wrapped_record = std::vector<std::uint64_t>{};
+
+  for (auto position = tail; position < head;) {
+    /// Records (and their headers) are 8-byte aligned, the header never wraps around.
+    const auto offset = position % ring_buffer_size;
+    const auto* event_header = reinterpret_cast<const perf_event_header*>(ring_buffer + offset);
+    const auto record_size = std::uint64_t{ event_header->size };
+    if (record_size == 0U) {
+      break;
+    }
 
-      if (this->_sample_type & perf::Sampler::Type::CodePageSize) {
-        sample.code_page_size(*reinterpret_cast<std::uint64_t*>(sample_ptr));
+    if (event_header->type == PERF_RECORD_SAMPLE || SampleDecoder::is_context_switch(*event_header)) {
+      if (offset + record_size <= ring_buffer_size) {
+        callback(decoder.decode(*event_header));
+      } else {
+        const auto first_part_size = ring_buffer_size - offset;
+        wrapped_record.resize((record_size + sizeof(std::uint64_t) - 1U) / sizeof(std::uint64_t));
+        std::memcpy(wrapped_record.data(), event_header, first_part_size);
+        std::memcpy(reinterpret_cast<std::byte*>(wrapped_record.data()) + first_part_size,
+                    ring_buffer,
+                    record_size - first_part_size);
+
+        callback(decoder.decode(*reinterpret_cast<const perf_event_header*>(wrapped_record.data())));
       }
-
-      result.push_back(sample);
     }
 
     /// Go to the next sample.
-    iterator += event_header->size;
+    position += record_size;
   }
-
-  return result;
 }
 
 std::vector<perf::Sample>
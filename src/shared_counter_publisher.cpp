@@ -0,0 +1,176 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <new>
+#include <perfcpp/shared_counter_publisher.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <unistd.h>
+
+perf::SharedCounterPublisher::SharedCounterPublisher(std::string name, const std::uint32_t capacity)
+  : _name(std::move(name))
+  , _size(sizeof(shared_counter::table_header) + std::size_t{ capacity } * sizeof(shared_counter::entry))
+{
+  if (this->_name.empty() || this->_name.find('/') != std::string::npos) {
+    throw std::runtime_error{ "'" + this->_name + "' is not a valid name for shared counters." };
+  }
+
+  /// Replace segments left by earlier (e.g., crashed) publishers; readers attached to them keep their mapping.
+  const auto segment_name = shared_counter::segment_name(this->_name);
+  ::shm_unlink(segment_name.c_str());
+
+  const auto file_descriptor = ::shm_open(segment_name.c_str(), O_CREAT | O_EXCL | O_RDWR | O_CLOEXEC, 0644);
+  if (file_descriptor < 0) {
+    throw std::runtime_error{ "Could not create shared memory '" + segment_name + "' (errno = " +
+                              std::to_string(errno) + ")." };
+  }
+
+  if (::ftruncate(file_descriptor, off_t(this->_size)) != 0) {
+    ::close(file_descriptor);
+    ::shm_unlink(segment_name.c_str());
+    throw std::runtime_error{ "Could not resize shared memory '" + segment_name + "' (errno = " +
+                              std::to_string(errno) + ")." };
+  }
+
+  this->_data = ::mmap(nullptr, this->_size, PROT_READ | PROT_WRITE, MAP_SHARED, file_descriptor, 0);
+  ::close(file_descriptor);
+  if (this->_data == MAP_FAILED) {
+    this->_data = nullptr;
+    ::shm_unlink(segment_name.c_str());
+    throw std::runtime_error{ "Could not map shared memory '" + segment_name + "' (errno = " + std::to_string(errno) +
+                              ")." };
+  }
+
+  /// Create the entries and the header in the (zero-initialized) segment.
+  this->_entries = reinterpret_cast<shared_counter::entry*>(reinterpret_cast<std::byte*>(this->_data) +
+                                                            sizeof(shared_counter::table_header));
+  for (auto i = 0U; i < capacity; ++i) {
+    new (&this->_entries[i]) shared_counter::entry{};
+  }
+
+  this->_header = new (this->_data) shared_counter::table_header{};
+  this->_header->entry_size = sizeof(shared_counter::entry);
+  this->_header->capacity = capacity;
+  this->_header->process_id = std::int32_t(::getpid());
+}
+
+perf::SharedCounterPublisher::~SharedCounterPublisher()
+{
+  this->stop();
+
+  if (this->_data != nullptr) {
+    ::munmap(this->_data, this->_size);
+    ::shm_unlink(shared_counter::segment_name(this->_name).c_str());
+  }
+}
+
+bool
+perf::SharedCounterPublisher::publish(const CounterResult& result)
+{
+  /// Begin the update: readers seeing an odd sequence (or a sequence that changed while reading) retry.
+  const auto sequence = this->_header->sequence.load(std::memory_order_relaxed);
+  this->_header->sequence.store(sequence + 1U, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  auto is_all_published = true;
+  auto index = std::uint64_t{ 0U };
+  for (const auto& [name, value] : result) {
+    const auto entry_index = this->entry_index(name, index++);
+    if (entry_index < this->_header->capacity) {
+      auto bits = std::uint64_t{ 0U };
+      std::memcpy(&bits, &value, sizeof(double));
+      this->_entries[entry_index].value.store(bits, std::memory_order_relaxed);
+    } else {
+      is_all_published = false;
+    }
+  }
+
+  const auto time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::system_clock::now().time_since_epoch());
+  this->_header->time.store(std::uint64_t(time.count()), std::memory_order_relaxed);
+
+  /// Complete the update.
+  this->_header->sequence.store(sequence + 2U, std::memory_order_release);
+
+  return is_all_published;
+}
+
+bool
+perf::SharedCounterPublisher::start(std::function<CounterResult()>&& source, const std::chrono::milliseconds interval)
+{
+  if (this->_publisher_thread.joinable()) {
+    return false;
+  }
+
+  this->_is_stopped = false;
+  this->_publisher_thread = std::thread{ [this, source = std::move(source), interval] {
+    static_cast<void>(this->publish(source()));
+
+    /// Publish after every interval and a last time when stopped, such that readers keep the final values.
+    auto is_stopped = false;
+    while (!is_stopped) {
+      {
+        auto lock = std::unique_lock{ this->_stop_mutex };
+        is_stopped = this->_stop_condition.wait_for(lock, interval, [this] { return this->_is_stopped; });
+      }
+      static_cast<void>(this->publish(source()));
+    }
+  } };
+
+  return true;
+}
+
+void
+perf::SharedCounterPublisher::stop()
+{
+  if (!this->_publisher_thread.joinable()) {
+    return;
+  }
+
+  {
+    const auto lock = std::lock_guard{ this->_stop_mutex };
+    this->_is_stopped = true;
+  }
+  this->_stop_condition.notify_one();
+  this->_publisher_thread.join();
+}
+
+std::uint64_t
+perf::SharedCounterPublisher::entry_index(const std::string_view name, const std::uint64_t expected_index)
+{
+  /// Names are not truncated, since names sharing a prefix would be published into the same entry.
+  if (name.size() > MAX_NAME_LENGTH) {
+    return this->_header->capacity;
+  }
+
+  const auto count_entries = this->_header->count_entries.load(std::memory_order_relaxed);
+
+  const auto is_entry = [this, name](const std::uint64_t index) {
+    const auto& entry_name = this->_entries[index].name;
+    return std::string_view{ entry_name.data(), std::strlen(entry_name.data()) } == name;
+  };
+
+  /// Results of the same counter list the values always in the same order.
+  if (expected_index < count_entries && is_entry(expected_index)) {
+    return expected_index;
+  }
+
+  for (auto index = std::uint64_t{ 0U }; index < count_entries; ++index) {
+    if (is_entry(index)) {
+      return index;
+    }
+  }
+
+  if (count_entries == this->_header->capacity) {
+    return this->_header->capacity;
+  }
+
+  /// Add the entry: the name is written before the entry becomes visible to readers and never changed.
+  auto& entry = this->_entries[count_entries];
+  std::copy(name.begin(), name.end(), entry.name.begin());
+  entry.name[name.size()] = '\0';
+  this->_header->count_entries.store(count_entries + 1U, std::memory_order_release);
+
+  return count_entries;
+}
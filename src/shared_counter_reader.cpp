@@ -0,0 +1,121 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <perfcpp/shared_counter_reader.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+
+perf::SharedCounterReader::SharedCounterReader(const std::string& name)
+{
+  const auto segment_name = shared_counter::segment_name(name);
+  const auto file_descriptor = ::shm_open(segment_name.c_str(), O_RDONLY | O_CLOEXEC, 0);
+  if (file_descriptor < 0) {
+    throw std::runtime_error{ "Could not open shared memory '" + segment_name + "' (errno = " + std::to_string(errno) +
+                              ")." };
+  }
+
+  struct stat file_status
+  {};
+  if (::fstat(file_descriptor, &file_status) != 0 ||
+      std::size_t(file_status.st_size) < sizeof(shared_counter::table_header)) {
+    ::close(file_descriptor);
+    throw std::runtime_error{ "'" + segment_name + "' is not a table of shared counters." };
+  }
+
+  this->_size = std::size_t(file_status.st_size);
+  auto* data = ::mmap(nullptr, this->_size, PROT_READ, MAP_SHARED, file_descriptor, 0);
+  ::close(file_descriptor);
+  if (data == MAP_FAILED) {
+    throw std::runtime_error{ "Could not map shared memory '" + segment_name + "' (errno = " + std::to_string(errno) +
+                              ")." };
+  }
+  this->_data = data;
+
+  this->_header = reinterpret_cast<const shared_counter::table_header*>(data);
+  this->_entries = reinterpret_cast<const shared_counter::entry*>(reinterpret_cast<const std::byte*>(data) +
+                                                                  sizeof(shared_counter::table_header));
+  if (this->_header->magic != shared_counter::MAGIC || this->_header->version != shared_counter::VERSION ||
+      this->_header->entry_size != sizeof(shared_counter::entry) ||
+      sizeof(shared_counter::table_header) + std::size_t{ this->_header->capacity } * sizeof(shared_counter::entry) >
+        this->_size) {
+    this->close();
+    throw std::runtime_error{ "'" + segment_name + "' is not a table of shared counters." };
+  }
+}
+
+perf::SharedCounterReader::SharedCounterReader(SharedCounterReader&& other) noexcept
+  : _data(std::exchange(other._data, nullptr))
+  , _size(std::exchange(other._size, 0U))
+  , _header(std::exchange(other._header, nullptr))
+  , _entries(std::exchange(other._entries, nullptr))
+{
+}
+
+perf::SharedCounterReader&
+perf::SharedCounterReader::operator=(SharedCounterReader&& other) noexcept
+{
+  if (this != &other) {
+    this->close();
+    this->_data = std::exchange(other._data, nullptr);
+    this->_size = std::exchange(other._size, 0U);
+    this->_header = std::exchange(other._header, nullptr);
+    this->_entries = std::exchange(other._entries, nullptr);
+  }
+
+  return *this;
+}
+
+perf::SharedCounterReader::~SharedCounterReader()
+{
+  this->close();
+}
+
+std::optional<std::uint64_t>
+perf::SharedCounterReader::read(std::vector<std::pair<std::string_view, double>>& values,
+                                const std::uint32_t max_retries) const
+{
+  for (auto attempt = 0U; attempt < max_retries; ++attempt) {
+    const auto sequence = this->_header->sequence.load(std::memory_order_acquire);
+
+    /// The publisher is updating the values.
+    if ((sequence & 1U) != 0U) {
+      continue;
+    }
+
+    /// Names of published entries never change; only the values need to be consistent.
+    const auto count_entries =
+      std::min(this->_header->count_entries.load(std::memory_order_acquire), std::uint64_t{ this->_header->capacity });
+    values.clear();
+    for (auto index = std::uint64_t{ 0U }; index < count_entries; ++index) {
+      const auto& entry = this->_entries[index];
+      const auto bits = entry.value.load(std::memory_order_relaxed);
+      auto value = .0;
+      std::memcpy(&value, &bits, sizeof(double));
+      values.emplace_back(std::string_view{ entry.name.data(), ::strnlen(entry.name.data(), entry.name.size()) },
+                          value);
+    }
+    const auto time = this->_header->time.load(std::memory_order_relaxed);
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (this->_header->sequence.load(std::memory_order_relaxed) == sequence) {
+      return time;
+    }
+  }
+
+  return std::nullopt;
+}
+
+void
+perf::SharedCounterReader::close()
+{
+  if (this->_data != nullptr) {
+    ::munmap(const_cast<void*>(this->_data), this->_size);
+    this->_data = nullptr;
+    this->_header = nullptr;
+    this->_entries = nullptr;
+  }
+}
@@ -0,0 +1,29 @@
+#include <perfcpp/symbol_resolver.h>
+
+std::optional<perf::BinaryAddress>
+perf::SymbolResolver::translate(const std::uintptr_t instruction_pointer)
+{
+  const auto* mapping = this->_memory_map.find(instruction_pointer);
+  if (mapping == nullptr || !mapping->is_file()) {
+    return std::nullopt;
+  }
+
+  const auto offset = mapping->file_offset(instruction_pointer);
+  if (const auto address = this->elf_file(mapping->path()).virtual_address(offset); address.has_value()) {
+    return BinaryAddress{ *mapping, address.value() };
+  }
+
+  /// Binaries that are not readable (anymore) are described by their file offsets.
+  return BinaryAddress{ *mapping, offset };
+}
+
+const perf::ElfFile&
+perf::SymbolResolver::elf_file(const std::string& path)
+{
+  auto iterator = this->_elf_files.find(path);
+  if (iterator == this->_elf_files.end()) {
+    iterator = this->_elf_files.insert(std::make_pair(path, ElfFile::read(path, this->_include_symbols))).first;
+  }
+
+  return iterator->second;
+}
@@ -0,0 +1,32 @@
+#include <fstream>
+#include <perfcpp/system_info.h>
+#include <sys/utsname.h>
+
+std::string
+perf::SystemInfo::cpu_model()
+{
+  auto file = std::ifstream{ "/proc/cpuinfo" };
+  auto line = std::string{};
+  while (std::getline(file, line)) {
+    if (line.rfind("model name", 0U) == 0U || line.rfind("cpu model", 0U) == 0U) {
+      if (const auto separator = line.find(':'); separator != std::string::npos) {
+        const auto begin = line.find_first_not_of(" \t", separator + 1U);
+        if (begin != std::string::npos) {
+          return line.substr(begin, line.find_last_not_of(" \t") + 1U - begin);
+        }
+      }
+    }
+  }
+
+  return "unknown";
+}
+
+std::string
+perf::SystemInfo::kernel_release()
+{
+  if (auto system_name = utsname{}; ::uname(&system_name) == 0) {
+    return system_name.release;
+  }
+
+  return "unknown";
+}
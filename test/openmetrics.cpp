@@ -0,0 +1,143 @@
+#include <arpa/inet.h>
+#include <array>
+#include <cstdint>
+#include <iostream>
+#include <netinet/in.h>
+#include <perfcpp/openmetrics_exporter.h>
+#include <string>
+#include <string_view>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+/**
+ * Serves the exposition on a local port and scrapes it via HTTP: The response must hold every value of every source
+ * as a separate metric family, also if names collide after replacing the chars that are invalid in metric names.
+ */
+
+static std::uint32_t count_failures = 0U;
+
+static void
+check(const bool is_satisfied, const std::string& message)
+{
+  if (!is_satisfied) {
+    std::cerr << "FAILED: " << message << std::endl;
+    ++count_failures;
+  }
+}
+
+/**
+ * Sends a request to the server on the given local port and reads the full response.
+ *
+ * @return The response, or an empty string if the server could not be reached.
+ */
+static std::string
+request(const std::uint16_t port, const std::string_view request)
+{
+  const auto socket_file_descriptor = ::socket(AF_INET, SOCK_STREAM, 0);
+  if (socket_file_descriptor < 0) {
+    return std::string{};
+  }
+
+  auto socket_address = sockaddr_in{};
+  socket_address.sin_family = AF_INET;
+  socket_address.sin_port = htons(port);
+  socket_address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+  auto response = std::string{};
+  if (::connect(socket_file_descriptor, reinterpret_cast<sockaddr*>(&socket_address), sizeof(socket_address)) == 0 &&
+      ::send(socket_file_descriptor, request.data(), request.size(), MSG_NOSIGNAL) == ssize_t(request.size())) {
+    /// The server closes the connection after answering.
+    auto buffer = std::array<char, 4096U>{};
+    auto read_size = ::recv(socket_file_descriptor, buffer.data(), buffer.size(), 0);
+    while (read_size > 0) {
+      response.append(buffer.data(), std::size_t(read_size));
+      read_size = ::recv(socket_file_descriptor, buffer.data(), buffer.size(), 0);
+    }
+  }
+
+  ::close(socket_file_descriptor);
+  return response;
+}
+
+/**
+ * @return True, if the text contains the given line.
+ */
+static bool
+has_line(const std::string_view text, const std::string_view line)
+{
+  for (auto position = text.find(line); position != std::string_view::npos; position = text.find(line, position + 1U)) {
+    const auto end = position + line.size();
+    if ((position == 0U || text[position - 1U] == '\n') && end < text.size() && text[end] == '\n') {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+int
+main()
+{
+  auto counter_definitions = perf::CounterDefinition{};
+  auto exporter = perf::OpenMetricsExporter{ counter_definitions };
+
+  /// Both names become "perf_cache_misses" after replacing the invalid chars.
+  exporter.add("app \"one\"", [] {
+    return perf::CounterResult{ std::vector<std::pair<std::string_view, double>>{
+      { "cache-misses", 10. }, { "cache_misses", 20. }, { "cycles-per-instruction", .5 } } };
+  });
+
+  /// Live values of a running counter, read by the server thread; software events only, such that the test runs on
+  /// machines without hardware counters (e.g., in VMs).
+  auto event_counter = perf::EventCounter{ counter_definitions };
+  const auto is_counting = event_counter.add("page-faults") && event_counter.start();
+  if (is_counting) {
+    exporter.add("counter", event_counter);
+  }
+
+  check(exporter.serve(0U), "could not serve on a local port");
+  check(exporter.port() != 0U, "the port of the server is unknown");
+
+  const auto response = request(exporter.port(), "GET /metrics HTTP/1.1\r\nHost: localhost\r\n\r\n");
+  const auto body_begin = response.find("\r\n\r\n");
+  const auto body = body_begin != std::string::npos ? std::string_view{ response }.substr(body_begin + 4U)
+                                                    : std::string_view{};
+
+  check(response.rfind("HTTP/1.1 200 OK\r\n", 0U) == 0U, "the scrape was not answered with 200 OK");
+  check(response.find("Content-Type: application/openmetrics-text") != std::string::npos,
+        "the response has no OpenMetrics content type");
+  check(response.find("Content-Length: " + std::to_string(body.size()) + "\r\n") != std::string::npos,
+        "the content length does not match the body");
+
+  check(has_line(body, "# TYPE perf_cache_misses counter"), "missing family perf_cache_misses");
+  check(has_line(body, "perf_cache_misses_total{source=\"app \\\"one\\\"\"} 10"), "missing value of cache-misses");
+  check(has_line(body, "# TYPE perf_cache_misses_2 counter"), "colliding name cache_misses is not disambiguated");
+  check(has_line(body, "perf_cache_misses_2_total{source=\"app \\\"one\\\"\"} 20"), "missing value of cache_misses");
+  check(has_line(body, "# TYPE perf_cycles_per_instruction gauge"), "metric is not exposed as gauge");
+  check(has_line(body, "perf_cycles_per_instruction{source=\"app \\\"one\\\"\"} 0.5"), "missing value of the metric");
+  if (is_counting) {
+    check(has_line(body, "# TYPE perf_page_faults counter"), "missing family of the running counter");
+    check(body.find("perf_page_faults_total{source=\"counter\"} ") != std::string_view::npos,
+          "missing live value of the running counter");
+  }
+  check(body.size() >= 6U && body.substr(body.size() - 6U) == "# EOF\n", "the exposition does not end with # EOF");
+
+  check(request(exporter.port(), "GET /unknown HTTP/1.1\r\n\r\n").rfind("HTTP/1.1 404 ", 0U) == 0U,
+        "an unknown path was not answered with 404");
+  check(exporter.count_scrapes() == 1U, "the number of scrapes is not counted");
+
+  exporter.stop();
+  if (is_counting) {
+    event_counter.stop();
+  }
+
+  if (count_failures > 0U) {
+    std::cerr << count_failures << " checks failed." << std::endl;
+    return 1;
+  }
+
+  std::cout << "All checks passed." << std::endl;
+  return 0;
+}
@@ -0,0 +1,215 @@
+#include <array>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <perfcpp/perf_data_format.h>
+#include <perfcpp/perf_data_reader.h>
+#include <perfcpp/perf_data_writer.h>
+#include <perfcpp/sample_decoder.h>
+#include <perfcpp/sampler.h>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+/**
+ * Round trip of a sampler recording through the PerfDataWriter and PerfDataReader: The samples read from the file
+ * must equal the samples decoded from the live ring buffer, and every record must be assigned to its event. Context
+ * switches are recorded, such that all records carry the sample id fields. If the perf tool is installed, it must be
+ * able to read the file as well. Corrupted records and headers must be rejected instead of being read out of bounds.
+ *
+ * Exits with 77 (skipped) if sampling is not permitted (e.g., by perf_event_paranoid).
+ */
+
+static std::uint32_t count_failures = 0U;
+
+static void
+check(const bool is_satisfied, const std::string& message)
+{
+  if (!is_satisfied) {
+    std::cerr << "FAILED: " << message << std::endl;
+    ++count_failures;
+  }
+}
+
+/**
+ * Decodes records whose lengths exceed the record: the decoder must stop at the corrupted field.
+ */
+static void
+check_corrupted_records()
+{
+  auto attribute = perf_event_attr{};
+  attribute.sample_type = PERF_SAMPLE_IP | PERF_SAMPLE_CALLCHAIN | PERF_SAMPLE_BRANCH_STACK;
+  const auto decoder = perf::SampleDecoder{ attribute };
+
+  /// Header, instruction pointer, and a callchain length far beyond the record.
+  auto record = std::array<std::uint64_t, 4U>{};
+  auto header = perf_event_header{ PERF_RECORD_SAMPLE, PERF_RECORD_MISC_USER, std::uint16_t(sizeof(record)) };
+  std::memcpy(record.data(), &header, sizeof(perf_event_header));
+  record[1U] = 0x1000U;
+  record[2U] = std::uint64_t{ 1U } << 40U;
+
+  auto sample = decoder.decode(*reinterpret_cast<const perf_event_header*>(record.data()));
+  check(sample.instruction_pointer() == 0x1000U, "the instruction pointer of a corrupted record was not decoded");
+  check(!sample.callchain().has_value(), "a callchain exceeding the record was decoded");
+
+  /// An empty callchain followed by a branch stack length beyond the record.
+  record[2U] = 0U;
+  record[3U] = ~std::uint64_t{ 0U };
+  sample = decoder.decode(*reinterpret_cast<const perf_event_header*>(record.data()));
+  check(!sample.branches().has_value(), "a branch stack exceeding the record was decoded");
+
+  /// The length of the record is shorter than its fixed fields.
+  header.size = sizeof(perf_event_header);
+  std::memcpy(record.data(), &header, sizeof(perf_event_header));
+  sample = decoder.decode(*reinterpret_cast<const perf_event_header*>(record.data()));
+  check(!sample.instruction_pointer().has_value(), "a field behind the end of the record was decoded");
+}
+
+/**
+ * Points the id section of the first event beyond the end of the file: the reader must reject the file.
+ */
+static void
+check_corrupted_ids(const std::string& file_name)
+{
+  auto file = std::fstream{ file_name, std::ios::in | std::ios::out | std::ios::binary };
+  auto header = perf::perf_data::file_header{};
+  file.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+  const auto ids_section_offset =
+    header.attributes.offset + header.attribute_size - sizeof(perf::perf_data::file_section);
+  auto ids_section = perf::perf_data::file_section{};
+  file.seekg(std::streamoff(ids_section_offset));
+  file.read(reinterpret_cast<char*>(&ids_section), sizeof(ids_section));
+
+  const auto corrupted_ids_section = perf::perf_data::file_section{ ids_section.offset, std::uint64_t{ 1U } << 40U };
+  file.seekp(std::streamoff(ids_section_offset));
+  file.write(reinterpret_cast<const char*>(&corrupted_ids_section), sizeof(corrupted_ids_section));
+  file.close();
+
+  try {
+    const auto reader = perf::PerfDataReader{ file_name };
+    check(false, "the reader accepted a corrupted id section");
+  } catch (std::runtime_error&) {
+  }
+}
+
+int
+main()
+{
+  check_corrupted_records();
+
+  const auto file_name = (std::filesystem::temp_directory_path() /
+                          ("perf-cpp-test-" + std::to_string(::getpid()) + ".data"))
+                           .string();
+
+  /// Record software events only, such that the test runs on machines without hardware counters (e.g., in VMs).
+  auto counter_definitions = perf::CounterDefinition{};
+  auto config = perf::SampleConfig{};
+  config.period(50000U);
+  config.context_switch(true);
+  auto sampler = perf::Sampler{ counter_definitions,
+                                std::vector<std::string>{ "cpu-clock", "page-faults" },
+                                perf::Sampler::Type::InstructionPointer | perf::Sampler::Type::ThreadId |
+                                  perf::Sampler::Type::Time | perf::Sampler::Type::Period,
+                                config };
+
+  if (!sampler.start()) {
+    std::cout << "Skipped: could not start sampling (errno = " << sampler.last_error() << ")." << std::endl;
+    return 77;
+  }
+
+  auto data = std::vector<std::uint64_t>(1U << 22U);
+  auto value = std::uint64_t{ 0U };
+  for (auto repetition = 0U; repetition < 20U; ++repetition) {
+    for (auto i = 0U; i < data.size(); ++i) {
+      data[i] += i;
+      value += data[i];
+    }
+  }
+  asm volatile("" : "+r,m"(value) : : "memory");
+
+  sampler.stop();
+
+  const auto live_samples = sampler.result();
+  const auto is_written = perf::PerfDataWriter::write(file_name, sampler);
+  sampler.close();
+
+  check(!live_samples.empty(), "the sampler recorded no samples");
+  check(is_written, "could not write " + file_name);
+  if (!is_written) {
+    return 1;
+  }
+
+  try {
+    const auto reader = perf::PerfDataReader{ file_name };
+
+    /// Both counters are written as events with their names; samples carry the identifier of their event.
+    check(reader.attributes().size() == 2U, "expected two attributes");
+    check(reader.event_names() == std::vector<std::string>{ "cpu-clock", "page-faults" }, "unexpected event names");
+    for (const auto& attribute : reader.attributes()) {
+      check((attribute.sample_type & PERF_SAMPLE_IDENTIFIER) != 0U, "attribute without PERF_SAMPLE_IDENTIFIER");
+    }
+
+    const auto samples = reader.result();
+    check(samples.size() == live_samples.size(),
+          "read " + std::to_string(samples.size()) + " samples, recorded " + std::to_string(live_samples.size()));
+    for (auto i = 0U; i < std::min(samples.size(), live_samples.size()); ++i) {
+      check(samples[i].sample_id().has_value() && samples[i].sample_id() == live_samples[i].sample_id(),
+            "sample " + std::to_string(i) + " has a different identifier");
+      check(samples[i].instruction_pointer() == live_samples[i].instruction_pointer() &&
+              samples[i].thread_id() == live_samples[i].thread_id() && samples[i].time() == live_samples[i].time() &&
+              samples[i].period() == live_samples[i].period(),
+            "sample " + std::to_string(i) + " differs from the recorded sample");
+    }
+
+    /// The synthesized records name the process and map this executable. With sample_id_all, they end with the
+    /// sample id fields (thread id, time, and identifier) like the records of the kernel.
+    const auto executable = std::filesystem::canonical("/proc/self/exe").string();
+    const auto sample_id_size = 3U * sizeof(std::uint64_t);
+    const auto sampling_identifier = live_samples.empty() ? std::nullopt : live_samples.front().sample_id();
+    auto is_comm_found = false;
+    auto is_executable_mapped = false;
+    reader.for_each_record([&](const perf_event_header& record) {
+      const auto* begin = reinterpret_cast<const char*>(&record);
+      auto identifier = std::uint64_t{ 0U };
+      std::memcpy(&identifier, begin + record.size - sizeof(std::uint64_t), sizeof(std::uint64_t));
+
+      if (record.type == PERF_RECORD_COMM) {
+        const auto* command = begin + sizeof(perf::perf_data::comm_record);
+        const auto command_size = (std::strlen(command) + 1U + 7U) & ~std::size_t{ 7U };
+        check(record.size == sizeof(perf::perf_data::comm_record) + command_size + sample_id_size,
+              "COMM record without sample id fields");
+        check(identifier == sampling_identifier, "COMM record with a different identifier");
+        is_comm_found = true;
+      } else if (record.type == PERF_RECORD_MMAP) {
+        const auto* path = begin + sizeof(perf::perf_data::mmap_record);
+        if (executable == path) {
+          const auto path_size = (std::strlen(path) + 1U + 7U) & ~std::size_t{ 7U };
+          check(record.size == sizeof(perf::perf_data::mmap_record) + path_size + sample_id_size,
+                "MMAP record without sample id fields");
+          check(identifier == sampling_identifier, "MMAP record with a different identifier");
+          is_executable_mapped = true;
+        }
+      }
+    });
+    check(is_comm_found, "no COMM record");
+    check(is_executable_mapped, "no MMAP record of " + executable);
+  } catch (std::runtime_error& exception) {
+    check(false, exception.what());
+  }
+
+  /// Let the perf tool parse the file, if installed.
+  if (std::system("command -v perf > /dev/null 2>&1") == 0) {
+    const auto command = "perf script -i " + file_name + " > /dev/null";
+    check(std::system(command.c_str()) == 0, "perf script could not read " + file_name);
+  }
+
+  check_corrupted_ids(file_name);
+
+  std::filesystem::remove(file_name);
+
+  return count_failures == 0U ? 0 : 1;
+}
@@ -0,0 +1,215 @@
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <perfcpp/sample_file_format.h>
+#include <perfcpp/sample_file_reader.h>
+#include <perfcpp/sample_file_writer.h>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+/**
+ * Round trip of samples through the SampleFileWriter and SampleFileReader: All fields of the samples read from the file
+ * must equal the written ones. Files with corrupted lengths must be rejected instead of being read out of bounds.
+ */
+
+static std::uint32_t count_failures = 0U;
+
+static void
+check(const bool is_satisfied, const std::string& message)
+{
+  if (!is_satisfied) {
+    std::cerr << "FAILED: " << message << std::endl;
+    ++count_failures;
+  }
+}
+
+/**
+ * @return A sample holding every field with values derived from the index.
+ */
+static perf::Sample
+make_sample(const std::uint64_t index)
+{
+  auto sample = perf::Sample{ perf::Sample::Mode::User };
+  sample.timestamp(1000U + index * 10U);
+  sample.instruction_pointer(0x400000U + index * 4U);
+  sample.thread_id(std::uint32_t(42U + index % 3U));
+  sample.sample_id(index);
+  sample.id(7U);
+  sample.callchain(std::vector<std::uintptr_t>{ 0x401000U, 0x402000U + (index % 2U) * 0x10U, 0x403000U });
+  sample.counter_result(perf::CounterResult{ std::vector<std::pair<std::string_view, double>>{
+    { "cycles", double(index) * 1.5 }, { "instructions", double(index) * 2. } } });
+  sample.branches(std::vector<perf::Branch>{
+    perf::Branch{ 0x401010U, 0x401100U, true, false, false, false, 12U },
+    perf::Branch{ 0x401120U, 0x400F00U, false, true, true, false, 3U, PERF_BR_IND_CALL } });
+  sample.user_registers_abi(2U);
+  sample.user_registers(std::vector<std::uint64_t>{ index, 0U, ~std::uint64_t{ 0U } });
+  if (index % 4U == 0U) {
+    sample.context_switch(perf::ContextSwitch{ true, index % 8U == 0U, 41U, std::uint32_t(42U + index % 3U) });
+  }
+
+  return sample;
+}
+
+static bool
+is_equal(const perf::Sample& left, const perf::Sample& right)
+{
+  auto is_equal = left.mode() == right.mode() && left.time() == right.time() &&
+                  left.instruction_pointer() == right.instruction_pointer() && left.thread_id() == right.thread_id() &&
+                  left.sample_id() == right.sample_id() && left.id() == right.id() && left.period() == right.period() &&
+                  left.logical_memory_address() == right.logical_memory_address() &&
+                  left.data_src().has_value() == right.data_src().has_value() &&
+                  (!left.data_src().has_value() || left.data_src()->value() == right.data_src()->value()) &&
+                  left.callchain() == right.callchain() && left.user_registers_abi() == right.user_registers_abi() &&
+                  left.user_registers() == right.user_registers() &&
+                  left.kernel_registers_abi() == right.kernel_registers_abi() &&
+                  left.kernel_registers().has_value() == right.kernel_registers().has_value();
+
+  is_equal &= left.counter_result().has_value() == right.counter_result().has_value();
+  if (is_equal && left.counter_result().has_value()) {
+    for (const auto& [name, value] : left.counter_result().value()) {
+      is_equal &= right.counter_result()->get(name) == value;
+    }
+  }
+
+  is_equal &= left.branches().has_value() == right.branches().has_value() &&
+              (!left.branches().has_value() || left.branches()->size() == right.branches()->size());
+  if (is_equal && left.branches().has_value()) {
+    for (auto i = 0U; i < left.branches()->size(); ++i) {
+      const auto& left_branch = left.branches().value()[i];
+      const auto& right_branch = right.branches().value()[i];
+      is_equal &= left_branch.instruction_pointer_from() == right_branch.instruction_pointer_from() &&
+                  left_branch.instruction_pointer_to() == right_branch.instruction_pointer_to() &&
+                  left_branch.is_mispredicted() == right_branch.is_mispredicted() &&
+                  left_branch.is_predicted() == right_branch.is_predicted() &&
+                  left_branch.is_in_transaction() == right_branch.is_in_transaction() &&
+                  left_branch.is_transaction_abort() == right_branch.is_transaction_abort() &&
+                  left_branch.cycles() == right_branch.cycles() && left_branch.type() == right_branch.type();
+    }
+  }
+
+  is_equal &= left.context_switch().has_value() == right.context_switch().has_value();
+  if (is_equal && left.context_switch().has_value()) {
+    is_equal &= left.context_switch()->is_out() == right.context_switch()->is_out() &&
+                left.context_switch()->is_preempt() == right.context_switch()->is_preempt() &&
+                left.context_switch()->process_id() == right.context_switch()->process_id() &&
+                left.context_switch()->thread_id() == right.context_switch()->thread_id();
+  }
+
+  return is_equal;
+}
+
+/**
+ * Overwrites bytes of the file.
+ */
+static void
+patch(const std::string& file_name, const std::uint64_t offset, const void* data, const std::size_t size)
+{
+  auto file = std::fstream{ file_name, std::ios::in | std::ios::out | std::ios::binary };
+  file.seekp(std::streamoff(offset));
+  file.write(reinterpret_cast<const char*>(data), std::streamsize(size));
+}
+
+static bool
+is_rejected(const std::string& file_name)
+{
+  try {
+    const auto reader = perf::SampleFileReader{ file_name };
+    static_cast<void>(reader.result());
+  } catch (std::runtime_error&) {
+    return true;
+  }
+
+  return false;
+}
+
+int
+main()
+{
+  const auto file_name = (std::filesystem::temp_directory_path() /
+                          ("perf-cpp-test-" + std::to_string(::getpid()) + ".samples"))
+                           .string();
+
+  /// Write samples into multiple chunks.
+  auto samples = std::vector<perf::Sample>{};
+  {
+    auto writer = perf::SampleFileWriter{ file_name, 16U };
+    for (auto index = 0U; index < 100U; ++index) {
+      samples.push_back(make_sample(index));
+      writer.add(samples.back());
+    }
+
+    /// Values at the limits of their types, which must not collide with missing values; the first address of the
+    /// column in the chunk is 2^63 apart from zero, such that its zigzag-encoded difference is the maximal value.
+    auto limit_sample = perf::Sample{ perf::Sample::Mode::Kernel };
+    limit_sample.logical_memory_address(std::uintptr_t{ 1U } << 63U);
+    limit_sample.sample_id(~std::uint64_t{ 0U });
+    limit_sample.id(~std::uint64_t{ 0U });
+    limit_sample.period(~std::uint64_t{ 0U });
+    limit_sample.data_src(perf::DataSource{ ~std::uint64_t{ 0U } });
+    limit_sample.user_registers_abi(~std::uint64_t{ 0U });
+    limit_sample.user_registers(std::vector<std::uint64_t>{ ~std::uint64_t{ 0U } });
+    samples.push_back(limit_sample);
+    writer.add(limit_sample);
+
+    /// Callchains longer than the format allows are rejected.
+    auto sample = perf::Sample{ perf::Sample::Mode::User };
+    sample.callchain(std::vector<std::uintptr_t>(perf::sample_file::MAX_LIST_LENGTH + 1U, 0x401000U));
+    auto is_too_long_rejected = false;
+    try {
+      writer.add(sample);
+    } catch (std::runtime_error&) {
+      is_too_long_rejected = true;
+    }
+    check(is_too_long_rejected, "the writer accepted an overlong callchain");
+
+    writer.close();
+  }
+
+  /// Read the samples back.
+  {
+    const auto reader = perf::SampleFileReader{ file_name };
+    const auto result = reader.result();
+    check(result.size() == samples.size(),
+          "expected " + std::to_string(samples.size()) + " samples, read " + std::to_string(result.size()));
+    for (auto index = 0U; index < std::min(result.size(), samples.size()); ++index) {
+      check(is_equal(samples[index], result[index]), "sample " + std::to_string(index) + " differs");
+    }
+  }
+
+  /// Corrupt the length of the first callchain in the stack table.
+  auto header = perf::sample_file::file_header{};
+  auto original_length = std::array<std::uint8_t, 4U>{};
+  {
+    auto file = std::ifstream{ file_name, std::ios::binary };
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    file.seekg(std::streamoff(header.stack_table_offset));
+    file.read(reinterpret_cast<char*>(original_length.data()), std::streamsize(original_length.size()));
+  }
+  const auto overlong_length = std::array<std::uint8_t, 4U>{ 0xFFU, 0xFFU, 0xFFU, 0x7FU };
+  patch(file_name, header.stack_table_offset, overlong_length.data(), overlong_length.size());
+  check(is_rejected(file_name), "the reader accepted a corrupted callchain length");
+  patch(file_name, header.stack_table_offset, original_length.data(), original_length.size());
+  check(!is_rejected(file_name), "the reader rejected the restored file");
+
+  /// Corrupt the number of callchains.
+  auto count_stacks = std::uint64_t{ 1U } << 40U;
+  patch(file_name, offsetof(perf::sample_file::file_header, count_stacks), &count_stacks, sizeof(count_stacks));
+  check(is_rejected(file_name), "the reader accepted a corrupted number of callchains");
+
+  std::remove(file_name.c_str());
+
+  if (count_failures > 0U) {
+    std::cerr << count_failures << " checks failed." << std::endl;
+    return 1;
+  }
+
+  std::cout << "Read " << samples.size() << " samples." << std::endl;
+  return 0;
+}
@@ -0,0 +1,225 @@
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <perfcpp/result_store.h>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/**
+ * Stores benchmark results with run metadata in an append-only history (JSON lines) and checks the latest runs for
+ * regressions against a rolling baseline, e.g., as performance gate on local machines or in CI.
+ *
+ * Usage:
+ *   perf-history append <store> <benchmark> [file with values as JSON object, default: stdin]
+ *                       [--git-sha <sha>] [--config <description>]
+ *   perf-history check <store> [benchmark ...] [--window <runs>] [--min-runs <runs>] [--threshold <robust stddevs>]
+ *                      [--min-change <relative change>] [--higher-is-better <counter>]
+ *   perf-history list <store>
+ *
+ * The values are read as flat JSON object, e.g., the output of perf::CounterResult::to_json().
+ * "check" exits with 2 if any benchmark regressed.
+ */
+
+static void
+print_usage(const char* program)
+{
+  std::cerr << "Usage:\n"
+            << "  " << program
+            << " append <store> <benchmark> [values file, default: stdin] [--git-sha <sha>] [--config <description>]\n"
+            << "  " << program
+            << " check <store> [benchmark ...] [--window <runs>] [--min-runs <runs>] [--threshold <stddevs>] "
+               "[--min-change <ratio>] [--higher-is-better <counter>]\n"
+            << "  " << program << " list <store>" << std::endl;
+}
+
+/**
+ * @return The revision of the git repository in the working directory, or an empty string.
+ */
+static std::string
+current_git_sha()
+{
+  auto* pipe = ::popen("git rev-parse HEAD 2>/dev/null", "r");
+  if (pipe == nullptr) {
+    return std::string{};
+  }
+
+  auto sha = std::string{};
+  auto buffer = std::array<char, 128U>{};
+  while (std::fgets(buffer.data(), int(buffer.size()), pipe) != nullptr) {
+    sha += buffer.data();
+  }
+  ::pclose(pipe);
+
+  sha.erase(std::remove_if(sha.begin(), sha.end(), [](const char character) { return std::isspace(character); }),
+            sha.end());
+  return sha;
+}
+
+static int
+append(const perf::ResultStore& store,
+       const std::string& benchmark,
+       const std::vector<std::string>& arguments,
+       std::string git_sha,
+       std::string config)
+{
+  auto json = std::string{};
+  if (arguments.empty() || arguments.front() == "-") {
+    json.assign(std::istreambuf_iterator<char>{ std::cin }, std::istreambuf_iterator<char>{});
+  } else {
+    auto file = std::ifstream{ arguments.front() };
+    if (!file.is_open()) {
+      std::cerr << "Could not open '" << arguments.front() << "'." << std::endl;
+      return 1;
+    }
+    json.assign(std::istreambuf_iterator<char>{ file }, std::istreambuf_iterator<char>{});
+  }
+
+  const auto values = perf::ResultStore::parse_values(json);
+  if (!values.has_value()) {
+    std::cerr << "Could not parse the values; expected a flat JSON object of numbers." << std::endl;
+    return 1;
+  }
+
+  if (git_sha.empty()) {
+    git_sha = current_git_sha();
+  }
+
+  if (!store.append(benchmark, values.value(), perf::RunMetadata::current(std::move(git_sha), std::move(config)))) {
+    std::cerr << "Could not append to the store." << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
+
+static int
+check(const perf::ResultStore& store, std::vector<std::string> benchmarks, const perf::RegressionDetector& detector)
+{
+  const auto history = store.read();
+
+  /// Check all benchmarks of the store, if none is given.
+  if (benchmarks.empty()) {
+    for (const auto& result : history) {
+      if (std::find(benchmarks.begin(), benchmarks.end(), result.benchmark()) == benchmarks.end()) {
+        benchmarks.push_back(result.benchmark());
+      }
+    }
+  }
+
+  auto is_any_regressed = false;
+  for (const auto& benchmark : benchmarks) {
+    const auto report = detector.check(history, benchmark);
+    if (!report.has_value()) {
+      std::cerr << "No runs of '" << benchmark << "' found." << std::endl;
+      return 1;
+    }
+
+    std::cout << report->to_string() << std::endl;
+    is_any_regressed |= report->has_regression();
+  }
+
+  std::cout << (is_any_regressed ? "Regression detected." : "No regression detected.") << std::endl;
+  return is_any_regressed ? 2 : 0;
+}
+
+static int
+list(const perf::ResultStore& store)
+{
+  const auto history = store.read();
+
+  auto benchmarks = std::vector<std::pair<std::string, std::size_t>>{};
+  for (const auto& result : history) {
+    auto iterator = std::find_if(benchmarks.begin(), benchmarks.end(), [&result](const auto& benchmark) {
+      return benchmark.first == result.benchmark();
+    });
+    if (iterator == benchmarks.end()) {
+      benchmarks.emplace_back(result.benchmark(), 1U);
+    } else {
+      ++iterator->second;
+    }
+  }
+
+  for (const auto& [benchmark, count_runs] : benchmarks) {
+    std::cout << benchmark << ": " << count_runs << " runs" << std::endl;
+  }
+
+  return 0;
+}
+
+int
+main(int argc, char** argv)
+{
+  if (argc < 3) {
+    print_usage(argv[0]);
+    return 1;
+  }
+
+  const auto command = std::string{ argv[1] };
+  const auto store = perf::ResultStore{ argv[2] };
+
+  /// Split options from positional arguments.
+  auto arguments = std::vector<std::string>{};
+  auto git_sha = std::string{};
+  auto config = std::string{};
+  auto detector = perf::RegressionDetector{};
+  try {
+    for (auto index = 3; index < argc; ++index) {
+      const auto argument = std::string{ argv[index] };
+      if (argument.rfind("--", 0U) != 0U) {
+        arguments.push_back(argument);
+        continue;
+      }
+
+      if (index + 1 >= argc) {
+        std::cerr << "Missing value of '" << argument << "'." << std::endl;
+        return 1;
+      }
+      const auto value = std::string{ argv[++index] };
+
+      if (argument == "--git-sha") {
+        git_sha = value;
+      } else if (argument == "--config") {
+        config = value;
+      } else if (argument == "--window") {
+        detector.window(std::stoull(value));
+      } else if (argument == "--min-runs") {
+        detector.min_baseline_runs(std::stoull(value));
+      } else if (argument == "--threshold") {
+        detector.threshold(std::stod(value));
+      } else if (argument == "--min-change") {
+        detector.min_relative_change(std::stod(value));
+      } else if (argument == "--higher-is-better") {
+        detector.higher_is_better(value);
+      } else {
+        std::cerr << "Unknown option '" << argument << "'." << std::endl;
+        return 1;
+      }
+    }
+  } catch (std::logic_error&) {
+    std::cerr << "Invalid option value." << std::endl;
+    return 1;
+  }
+
+  if (command == "append" && !arguments.empty()) {
+    const auto benchmark = arguments.front();
+    arguments.erase(arguments.begin());
+    return append(store, benchmark, arguments, std::move(git_sha), std::move(config));
+  }
+
+  if (command == "check") {
+    return check(store, std::move(arguments), detector);
+  }
+
+  if (command == "list") {
+    return list(store);
+  }
+
+  print_usage(argv[0]);
+  return 1;
+}
@@ -0,0 +1,76 @@
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <perfcpp/shared_counter_reader.h>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Monitors counters published into shared memory by a perf::SharedCounterPublisher of another process: prints the
+ * values and their change per second periodically.
+ *
+ * Usage: perf-monitor <name> [interval in ms, default 1000] [number of updates, default unlimited]
+ */
+int
+main(int argc, char** argv)
+{
+  if (argc < 2) {
+    std::cerr << "Usage: " << argv[0] << " <name> [interval in ms] [number of updates]" << std::endl;
+    return 1;
+  }
+
+  const auto name = std::string{ argv[1] };
+  const auto interval = std::chrono::milliseconds{ argc > 2 ? std::stoull(argv[2]) : 1000U };
+  const auto count_updates = argc > 3 ? std::stoull(argv[3]) : 0U;
+
+  auto reader = std::optional<perf::SharedCounterReader>{};
+  try {
+    reader.emplace(name);
+  } catch (std::runtime_error& exception) {
+    std::cerr << exception.what() << std::endl;
+    return 1;
+  }
+  std::cout << "Monitoring '" << name << "' of process " << reader->process_id() << "." << std::endl;
+  std::cout << std::fixed << std::setprecision(2);
+
+  auto values = std::vector<std::pair<std::string_view, double>>{};
+  auto last_values = std::vector<double>{};
+  auto last_time = std::uint64_t{ 0U };
+
+  for (auto update = 0ULL; count_updates == 0U || update < count_updates; ++update) {
+    const auto time = reader->read(values);
+    if (!time.has_value()) {
+      std::cerr << "Could not read a consistent snapshot." << std::endl;
+    } else if (time.value() == 0U) {
+      std::cout << "Nothing published yet." << std::endl;
+    } else {
+      /// Change per second since the last update; entries are only appended, their index stays the same.
+      const auto seconds = double(time.value() - last_time) / 1e9;
+      std::cout << "\n" << std::setw(40) << std::left << "name" << std::setw(20) << std::right << "value"
+                << std::setw(20) << "per second" << "\n";
+      for (auto index = 0U; index < values.size(); ++index) {
+        const auto& [value_name, value] = values[index];
+        std::cout << std::setw(40) << std::left << value_name << std::setw(20) << std::right << value;
+        if (index < last_values.size() && last_time > 0U && time.value() > last_time) {
+          std::cout << std::setw(20) << (value - last_values[index]) / seconds;
+        }
+        std::cout << "\n";
+      }
+      std::cout << std::flush;
+
+      last_values.resize(values.size());
+      for (auto index = 0U; index < values.size(); ++index) {
+        last_values[index] = values[index].second;
+      }
+      last_time = time.value();
+    }
+
+    std::this_thread::sleep_for(interval);
+  }
+
+  return 0;
+}